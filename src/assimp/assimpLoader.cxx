@@ -35,6 +35,12 @@
 #include "animBundleNode.h"
 #include "animChannelMatrixXfmTable.h"
 #include "pvector.h"
+#include "trueClock.h"
+#include "workerPool.h"
+#include "mutexHolder.h"
+#include "geomVertexArrayDataHandle.h"
+
+#include <type_traits>
 
 #include "pandaIOSystem.h"
 #include "pandaLogger.h"
@@ -45,23 +51,14 @@ using std::ostringstream;
 using std::stringstream;
 using std::string;
 
-struct BoneWeight {
-  CPT(JointVertexTransform) joint_vertex_xform;
-  float weight;
-
-  BoneWeight(CPT(JointVertexTransform) joint_vertex_xform, float weight)
-    : joint_vertex_xform(joint_vertex_xform), weight(weight)
-  {}
-};
-typedef pvector<BoneWeight> BoneWeightList;
-
 /**
  *
  */
 AssimpLoader::
 AssimpLoader() :
   _error (false),
-  _geoms (nullptr) {
+  _geoms (nullptr),
+  _anim_cache_bonemap_size (0) {
 
   PandaLogger::set_default();
   _importer.SetIOHandler(new PandaIOSystem);
@@ -140,12 +137,21 @@ read(const Filename &filename) {
     }
   }
 
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
   _scene = _importer.ReadFile(_filename.c_str(), flags);
   if (_scene == nullptr) {
     _error = true;
     return false;
   }
 
+  if (assimp_cat.is_debug()) {
+    assimp_cat.debug()
+      << "Imported " << _filename << " in "
+      << clock->get_short_time() - start << " s\n";
+  }
+
   _error = false;
   return true;
 }
@@ -164,35 +170,71 @@ build_graph() {
 
   _root = new ModelRoot(_filename.get_basename());
 
-  // Import all of the embedded textures first.
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  double stage_start = start;
+
+  WorkerPool pool(assimp_num_threads);
+  if (assimp_cat.is_debug()) {
+    assimp_cat.debug()
+      << "Building scene graph for " << _filename << " with up to "
+      << pool.get_num_threads() << " threads\n";
+  }
+
+  // Import all of the embedded textures first.  These are independent of
+  // each other, so they may be decoded in parallel.
   _textures = new PT(Texture)[_scene->mNumTextures];
-  for (size_t i = 0; i < _scene->mNumTextures; ++i) {
+  WorkerPool::prepare_image_threads();
+  pool.run((int)_scene->mNumTextures, [this](int i) {
     load_texture(i);
-  }
+  });
+  report_stage_time("textures", _scene->mNumTextures, stage_start);
 
   // Then the materials.
   _mat_states = new CPT(RenderState)[_scene->mNumMaterials];
   for (size_t i = 0; i < _scene->mNumMaterials; ++i) {
     load_material(i);
   }
+  report_stage_time("materials", _scene->mNumMaterials, stage_start);
 
-  // And then the meshes.
+  // And then the meshes.  Those with bones are converted first, one at a
+  // time, since they add to the shared bone map; the rest only read it, and
+  // each writes only its own slot in the arrays, so they may be converted in
+  // parallel.
   _geoms = new PT(Geom)[_scene->mNumMeshes];
   _geom_matindices = new unsigned int[_scene->mNumMeshes];
   _characters = new PT(Character)[_scene->mNumMeshes];
+  pvector<int> static_meshes;
   for (size_t i = 0; i < _scene->mNumMeshes; ++i) {
-    load_mesh(i);
+    if (_scene->mMeshes[i]->HasBones()) {
+      load_mesh(i);
+    } else {
+      static_meshes.push_back((int)i);
+    }
   }
+  pool.run((int)static_meshes.size(), [&](int n) {
+    load_mesh(static_meshes[n]);
+  });
+  report_stage_time("meshes", _scene->mNumMeshes, stage_start);
 
   // And now the node structure.
   if (_scene->mRootNode != nullptr) {
     load_node(*_scene->mRootNode, _root);
   }
+  report_stage_time("nodes", 0, stage_start);
 
   // And lastly, the lights.
   for (size_t i = 0; i < _scene->mNumLights; ++i) {
     load_light(*_scene->mLights[i]);
   }
+  report_stage_time("lights", _scene->mNumLights, stage_start);
+
+  if (assimp_cat.is_debug()) {
+    assimp_cat.debug(false)
+      << "  total: " << clock->get_short_time() - start << " s\n";
+  }
+
+  _anim_cache.clear();
 
   delete[] _textures;
   delete[] _mat_states;
@@ -201,6 +243,26 @@ build_graph() {
   delete[] _characters;
 }
 
+/**
+ * Writes the time spent in one stage of build_graph() to the debug output,
+ * and resets stage_start to the current time for the next stage.
+ */
+void AssimpLoader::
+report_stage_time(const char *stage, size_t count, double &stage_start) {
+  double now = TrueClock::get_global_ptr()->get_short_time();
+  if (assimp_cat.is_debug()) {
+    assimp_cat.debug(false)
+      << "  " << stage;
+    if (count != 0) {
+      assimp_cat.debug(false)
+        << " (" << count << ")";
+    }
+    assimp_cat.debug(false)
+      << ": " << now - stage_start << " s\n";
+  }
+  stage_start = now;
+}
+
 /**
  * Finds a node by name.
  */
@@ -544,6 +606,45 @@ create_anim_channel(const aiAnimation &anim, AnimBundle *bundle, AnimGroup *pare
   }
 }
 
+/**
+ * Copies num_components values from each of num_rows source elements, which
+ * are src_stride bytes apart, into a floating-point vertex column starting at
+ * dest, whose rows are dest_stride bytes apart.
+ */
+template<class Component>
+static void
+copy_column(unsigned char *dest, size_t dest_stride,
+            const Component *src, size_t src_stride,
+            size_t num_rows, int num_components) {
+  const unsigned char *src_p = (const unsigned char *)src;
+
+  if (std::is_same<Component, PN_stdfloat>::value) {
+    size_t row_size = num_components * sizeof(PN_stdfloat);
+    if (dest_stride == row_size && src_stride == row_size) {
+      // The column fills the whole row on both sides; copy it in one go.
+      memcpy(dest, src_p, row_size * num_rows);
+      return;
+    }
+    for (size_t i = 0; i < num_rows; ++i) {
+      memcpy(dest, src_p, row_size);
+      dest += dest_stride;
+      src_p += src_stride;
+    }
+
+  } else {
+    for (size_t i = 0; i < num_rows; ++i) {
+      const Component *s = (const Component *)src_p;
+      PN_stdfloat d[4];
+      for (int c = 0; c < num_components; ++c) {
+        d[c] = (PN_stdfloat)s[c];
+      }
+      memcpy(dest, d, num_components * sizeof(PN_stdfloat));
+      dest += dest_stride;
+      src_p += src_stride;
+    }
+  }
+}
+
 /**
  * Converts an aiMesh into a Geom.
  */
@@ -553,6 +654,7 @@ load_mesh(size_t index) {
 
   // Check if we need to make a Character
   PT(Character) character = nullptr;
+  pvector<const aiNode *> anim_roots;
   if (mesh.HasBones()) {
     if (assimp_cat.is_debug()) {
       assimp_cat.debug()
@@ -581,6 +683,11 @@ load_mesh(size_t index) {
         root = root->mParent;
       }
 
+      // The animations are converted for each bone that is itself a root.
+      if (root->mName == bone.mName) {
+        anim_roots.push_back(root);
+      }
+
       // Don't process this root if we already have a joint for it
       if (character->find_joint(root->mName.C_Str())) {
         continue;
@@ -590,10 +697,18 @@ load_mesh(size_t index) {
     }
   }
 
-  // Create transform blend table
+  // Collect the bone weights of each vertex, in compressed sparse row form:
+  // the weights of vertex i are those in [weight_start[i], weight_start[i +
+  // 1]) of weight_bones and weight_values.
   PT(TransformBlendTable) tbtable = new TransformBlendTable;
-  pvector<BoneWeightList> bone_weights(mesh.mNumVertices);
+  pvector<CPT(JointVertexTransform)> bone_transforms;
+  pvector<unsigned int> weight_start;
+  pvector<unsigned int> weight_bones;
+  pvector<PN_stdfloat> weight_values;
   if (character) {
+    bone_transforms.resize(mesh.mNumBones);
+    weight_start.assign(mesh.mNumVertices + 1, 0);
+
     for (size_t i = 0; i < mesh.mNumBones; ++i) {
       const aiBone &bone = *mesh.mBones[i];
       CharacterJoint *joint = character->find_joint(bone.mName.C_Str());
@@ -605,17 +720,35 @@ load_mesh(size_t index) {
         continue;
       }
 
-      CPT(JointVertexTransform) jvt = new JointVertexTransform(joint);
-
+      bone_transforms[i] = new JointVertexTransform(joint);
       for (size_t j = 0; j < bone.mNumWeights; ++j) {
-          const aiVertexWeight &weight = bone.mWeights[j];
+        ++weight_start[bone.mWeights[j].mVertexId + 1];
+      }
+    }
+
+    for (size_t i = 0; i < mesh.mNumVertices; ++i) {
+      weight_start[i + 1] += weight_start[i];
+    }
+    weight_bones.resize(weight_start[mesh.mNumVertices]);
+    weight_values.resize(weight_start[mesh.mNumVertices]);
 
-          bone_weights[weight.mVertexId].push_back(BoneWeight(jvt, weight.mWeight));
+    pvector<unsigned int> next_weight(weight_start.begin(), weight_start.end() - 1);
+    for (size_t i = 0; i < mesh.mNumBones; ++i) {
+      if (bone_transforms[i] == nullptr) {
+        continue;
+      }
+      const aiBone &bone = *mesh.mBones[i];
+      for (size_t j = 0; j < bone.mNumWeights; ++j) {
+        const aiVertexWeight &weight = bone.mWeights[j];
+        unsigned int w = next_weight[weight.mVertexId]++;
+        weight_bones[w] = (unsigned int)i;
+        weight_values[w] = weight.mWeight;
       }
     }
   }
 
-  // Create the vertex format.
+  // Create the vertex format.  The texture coordinates get only as many
+  // components as the mesh actually uses.
   PT(GeomVertexArrayFormat) aformat = new GeomVertexArrayFormat;
   aformat->add_column(InternalName::get_vertex(), 3, Geom::NT_stdfloat, Geom::C_point);
   if (mesh.HasNormals()) {
@@ -625,22 +758,50 @@ load_mesh(size_t index) {
     aformat->add_column(InternalName::get_color(), 4, Geom::NT_stdfloat, Geom::C_color);
   }
   unsigned int num_uvs = mesh.GetNumUVChannels();
-  if (num_uvs > 0) {
+  pvector<CPT(InternalName)> uv_names(num_uvs);
+  pvector<int> uv_components(num_uvs);
+  for (unsigned int u = 0; u < num_uvs; ++u) {
     // UV sets are named texcoord, texcoord.1, texcoord.2...
-    aformat->add_column(InternalName::get_texcoord(), 3, Geom::NT_stdfloat, Geom::C_texcoord);
-    for (unsigned int u = 1; u < num_uvs; ++u) {
+    if (u == 0) {
+      uv_names[u] = InternalName::get_texcoord();
+    } else {
       ostringstream out;
       out << u;
-      aformat->add_column(InternalName::get_texcoord_name(out.str()), 3, Geom::NT_stdfloat, Geom::C_texcoord);
+      uv_names[u] = InternalName::get_texcoord_name(out.str());
     }
+    uv_components[u] = (mesh.mNumUVComponents[u] == 2) ? 2 : 3;
+    aformat->add_column(uv_names[u], uv_components[u], Geom::NT_stdfloat, Geom::C_texcoord);
   }
 
   PT(GeomVertexArrayFormat) tb_aformat = new GeomVertexArrayFormat;
   tb_aformat->add_column(InternalName::make("transform_blend"), 1, Geom::NT_uint16, Geom::C_index);
 
-  // Check to see if we need to convert any animations
-  for (size_t i = 0; i < _scene->mNumAnimations; ++i) {
+  // Check to see if we need to convert any animations.  A mesh without bones
+  // can't match any.
+  for (size_t i = 0; character != nullptr && i < _scene->mNumAnimations; ++i) {
     aiAnimation &ai_anim = *_scene->mAnimations[i];
+
+    // If an earlier mesh with the same root bones already converted this
+    // animation, and no bones have been added since, it will have come out
+    // the same; share its tables.
+    AnimCacheKey key(i, anim_roots);
+    if (_anim_cache_bonemap_size != _bonemap.size()) {
+      _anim_cache.clear();
+      _anim_cache_bonemap_size = _bonemap.size();
+    }
+    AnimCache::const_iterator ci = _anim_cache.find(key);
+    if (ci != _anim_cache.end()) {
+      if ((*ci).second != nullptr) {
+        PT(AnimBundle) bundle = (*ci).second->copy_bundle();
+        bundle->set_name(mesh.mName.C_Str());
+        for (const aiNode *root : anim_roots) {
+          PT(AnimBundleNode) bundle_node = new AnimBundleNode(root->mName.C_Str(), bundle);
+          character->add_child(bundle_node);
+        }
+      }
+      continue;
+    }
+
     bool convert_anim = false;
 
     if (assimp_cat.is_debug()) {
@@ -660,6 +821,7 @@ load_mesh(size_t index) {
       }
     }
 
+    PT(AnimBundle) bundle;
     if (convert_anim) {
       if (assimp_cat.is_debug()) {
         assimp_cat.debug()
@@ -688,28 +850,19 @@ load_mesh(size_t index) {
           << "Frames " << frames << "\n";
       }
 
-      PT(AnimBundle) bundle = new AnimBundle(mesh.mName.C_Str(), fps, frames);
+      bundle = new AnimBundle(mesh.mName.C_Str(), fps, frames);
       PT(AnimGroup) skeleton = new AnimGroup(bundle, "<skeleton>");
 
-      for (size_t i = 0; i < mesh.mNumBones; ++i) {
-        const aiBone &bone = *mesh.mBones[i];
-
-        // Find the root bone node
-        const aiNode *root = _bonemap[bone.mName.C_Str()];
-        while (root->mParent && _bonemap.find(root->mParent->mName.C_Str()) != _bonemap.end()) {
-          root = root->mParent;
-        }
-
-        // Only convert root nodes
-        if (root->mName == bone.mName) {
-          create_anim_channel(ai_anim, bundle, skeleton, *root);
+      for (const aiNode *root : anim_roots) {
+        create_anim_channel(ai_anim, bundle, skeleton, *root);
 
-          // Attach the animation to the character node
-          PT(AnimBundleNode) bundle_node = new AnimBundleNode(bone.mName.C_Str(), bundle);
-          character->add_child(bundle_node);
-        }
+        // Attach the animation to the character node
+        PT(AnimBundleNode) bundle_node = new AnimBundleNode(root->mName.C_Str(), bundle);
+        character->add_child(bundle_node);
       }
     }
+
+    _anim_cache[key] = bundle;
   }
 
   // TODO: if there is only one UV set, hackily iterate over the texture
@@ -733,61 +886,53 @@ load_mesh(size_t index) {
   }
   vdata->unclean_set_num_rows(mesh.mNumVertices);
 
-  // Read out the vertices.
-  GeomVertexWriter vertex (vdata, InternalName::get_vertex());
-  for (size_t i = 0; i < mesh.mNumVertices; ++i) {
-    const aiVector3D &vec = mesh.mVertices[i];
-    vertex.add_data3(vec.x, vec.y, vec.z);
-  }
-
-  // Now the normals, if any.
-  if (mesh.HasNormals()) {
-    GeomVertexWriter normal (vdata, InternalName::get_normal());
-    for (size_t i = 0; i < mesh.mNumVertices; ++i) {
-      const aiVector3D &vec = mesh.mNormals[i];
-      normal.add_data3(vec.x, vec.y, vec.z);
+  // Copy the vertices, normals, colors and texture coordinates straight out
+  // of Assimp's arrays into the vertex array.  We only import the first set
+  // of vertex colors.
+  const GeomVertexFormat *vformat = vdata->get_format();
+  size_t num_rows = mesh.mNumVertices;
+  if (num_rows > 0) {
+    int array_index = vformat->get_array_with(InternalName::get_vertex());
+    size_t stride = vformat->get_array(array_index)->get_stride();
+    PT(GeomVertexArrayDataHandle) handle = vdata->modify_array_handle(array_index);
+    unsigned char *data = handle->get_write_pointer();
+
+    copy_column(data + vformat->get_column(InternalName::get_vertex())->get_start(), stride,
+                &mesh.mVertices[0].x, sizeof(aiVector3D), num_rows, 3);
+
+    if (mesh.HasNormals()) {
+      copy_column(data + vformat->get_column(InternalName::get_normal())->get_start(), stride,
+                  &mesh.mNormals[0].x, sizeof(aiVector3D), num_rows, 3);
     }
-  }
 
-  // Vertex colors, if any.  We only import the first set.
-  if (mesh.HasVertexColors(0)) {
-    GeomVertexWriter color (vdata, InternalName::get_color());
-    for (size_t i = 0; i < mesh.mNumVertices; ++i) {
-      const aiColor4D &col = mesh.mColors[0][i];
-      color.add_data4(col.r, col.g, col.b, col.a);
+    if (mesh.HasVertexColors(0)) {
+      copy_column(data + vformat->get_column(InternalName::get_color())->get_start(), stride,
+                  &mesh.mColors[0][0].r, sizeof(aiColor4D), num_rows, 4);
     }
-  }
 
-  // Now the texture coordinates.
-  if (num_uvs > 0) {
-    // UV sets are named texcoord, texcoord.1, texcoord.2...
-    GeomVertexWriter texcoord0 (vdata, InternalName::get_texcoord());
-    for (size_t i = 0; i < mesh.mNumVertices; ++i) {
-      const aiVector3D &vec = mesh.mTextureCoords[0][i];
-      texcoord0.add_data3(vec.x, vec.y, vec.z);
-    }
-    for (unsigned int u = 1; u < num_uvs; ++u) {
-      ostringstream out;
-      out << u;
-      GeomVertexWriter texcoord (vdata, InternalName::get_texcoord_name(out.str()));
-      for (size_t i = 0; i < mesh.mNumVertices; ++i) {
-        const aiVector3D &vec = mesh.mTextureCoords[u][i];
-        texcoord.add_data3(vec.x, vec.y, vec.z);
-      }
+    for (unsigned int u = 0; u < num_uvs; ++u) {
+      copy_column(data + vformat->get_column(uv_names[u])->get_start(), stride,
+                  &mesh.mTextureCoords[u][0].x, sizeof(aiVector3D), num_rows,
+                  uv_components[u]);
     }
   }
 
   // Now the transform blend table
-  if (character) {
-    GeomVertexWriter transform_blend (vdata, InternalName::get_transform_blend());
-
-    for (size_t i = 0; i < mesh.mNumVertices; ++i) {
+  if (character && num_rows > 0) {
+    CPT(InternalName) tb_name = InternalName::get_transform_blend();
+    int array_index = vformat->get_array_with(tb_name);
+    size_t stride = vformat->get_array(array_index)->get_stride();
+    PT(GeomVertexArrayDataHandle) handle = vdata->modify_array_handle(array_index);
+    unsigned char *p = handle->get_write_pointer() + vformat->get_column(tb_name)->get_start();
+
+    for (size_t i = 0; i < num_rows; ++i) {
       TransformBlend tblend;
-
-      for (size_t j = 0; j < bone_weights[i].size(); ++j) {
-        tblend.add_transform(bone_weights[i][j].joint_vertex_xform, bone_weights[i][j].weight);
+      for (unsigned int w = weight_start[i]; w < weight_start[i + 1]; ++w) {
+        tblend.add_transform(bone_transforms[weight_bones[w]], weight_values[w]);
       }
-      transform_blend.add_data1i(tbtable->add_blend(tblend));
+      uint16_t blend_index = (uint16_t)tbtable->add_blend(tblend);
+      memcpy(p, &blend_index, sizeof(blend_index));
+      p += stride;
     }
 
     tbtable->set_rows(SparseArray::lower_on(vdata->get_num_rows()));
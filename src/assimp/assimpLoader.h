@@ -18,7 +18,9 @@
 #include "filename.h"
 #include "modelRoot.h"
 #include "texture.h"
+#include "animBundle.h"
 #include "pmap.h"
+#include "pvector.h"
 
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
@@ -26,7 +28,6 @@
 class Character;
 class CharacterJointBundle;
 class PartGroup;
-class AnimBundle;
 class AnimGroup;
 
 struct char_cmp {
@@ -68,6 +69,16 @@ private:
   BoneMap _bonemap;
   PT(Character) *_characters;
 
+  // The animations converted for the skinned meshes, by animation index and
+  // root bones.  These remain valid only as long as no new bones are added
+  // to _bonemap.
+  typedef std::pair<size_t, pvector<const aiNode *> > AnimCacheKey;
+  typedef pmap<AnimCacheKey, PT(AnimBundle) > AnimCache;
+  AnimCache _anim_cache;
+  size_t _anim_cache_bonemap_size;
+
+  void report_stage_time(const char *stage, size_t count, double &stage_start);
+
   const aiNode *find_node(const aiNode &root, const aiString &name);
 
   void load_texture(size_t index);
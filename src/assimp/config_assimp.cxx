@@ -86,6 +86,21 @@ ConfigVariableDouble assimp_smooth_normal_angle
           "normals. Note that you may need to clear the model-cache after "
           "changing this."));
 
+ConfigVariableBool assimp_mmap_files
+("assimp-mmap-files", true,
+ PRC_DESC("Set this true to map model files that reside on disk directly "
+          "into memory, rather than reading them through a stream, when "
+          "they are imported via Assimp.  Files in a multifile, or that "
+          "are compressed, are always read through the virtual file "
+          "system."));
+
+ConfigVariableInt assimp_num_threads
+("assimp-num-threads", 0,
+ PRC_DESC("The number of threads to use for converting the meshes and "
+          "embedded textures of a model imported via Assimp.  Set this to "
+          "1 to convert them one at a time, or to 0 to use the value of "
+          "pandatool-num-threads."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -19,7 +19,31 @@ using std::ios;
  *
  */
 PandaIOStream::
-PandaIOStream(std::istream &stream) : _istream(stream) {
+PandaIOStream(std::istream &stream) :
+  _istream(&stream),
+  _mapped(nullptr),
+  _pos(0)
+{
+}
+
+/**
+ * Creates a stream that reads from the indicated file mapping, which it takes
+ * ownership of.
+ */
+PandaIOStream::
+PandaIOStream(MappedFile *mapped) :
+  _istream(nullptr),
+  _mapped(mapped),
+  _pos(0)
+{
+}
+
+/**
+ *
+ */
+PandaIOStream::
+~PandaIOStream() {
+  delete _mapped;
 }
 
 /**
@@ -27,10 +51,14 @@ PandaIOStream(std::istream &stream) : _istream(stream) {
  */
 size_t PandaIOStream::
 FileSize() const {
-  std::streampos cur = _istream.tellg();
-  _istream.seekg(0, ios::end);
-  std::streampos end = _istream.tellg();
-  _istream.seekg(cur, ios::beg);
+  if (_istream == nullptr) {
+    return _mapped->get_size();
+  }
+
+  std::streampos cur = _istream->tellg();
+  _istream->seekg(0, ios::end);
+  std::streampos end = _istream->tellg();
+  _istream->seekg(cur, ios::beg);
   return end;
 }
 
@@ -47,8 +75,20 @@ Flush() {
  */
 size_t PandaIOStream::
 Read(void *buffer, size_t size, size_t count) {
-  _istream.read((char*) buffer, size * count);
-  return _istream.gcount();
+  if (_istream == nullptr) {
+    // Like fread, this returns the number of whole elements read.
+    size_t file_size = _mapped->get_size();
+    if (size == 0 || _pos >= file_size) {
+      return 0;
+    }
+    count = std::min(count, (file_size - _pos) / size);
+    memcpy(buffer, _mapped->get_data() + _pos, size * count);
+    _pos += size * count;
+    return count;
+  }
+
+  _istream->read((char*) buffer, size * count);
+  return _istream->gcount();
 }
 
 /**
@@ -56,17 +96,44 @@ Read(void *buffer, size_t size, size_t count) {
  */
 aiReturn PandaIOStream::
 Seek(size_t offset, aiOrigin origin) {
+  if (_istream == nullptr) {
+    size_t pos;
+    switch (origin) {
+    case aiOrigin_SET:
+      pos = offset;
+      break;
+
+    case aiOrigin_CUR:
+      pos = _pos + offset;
+      break;
+
+    case aiOrigin_END:
+      pos = _mapped->get_size() + offset;
+      break;
+
+    default:
+      nassertr(false, AI_FAILURE);
+      return AI_FAILURE;
+    }
+
+    if (pos > _mapped->get_size()) {
+      return AI_FAILURE;
+    }
+    _pos = pos;
+    return AI_SUCCESS;
+  }
+
   switch (origin) {
   case aiOrigin_SET:
-    _istream.seekg(offset, ios::beg);
+    _istream->seekg(offset, ios::beg);
     break;
 
   case aiOrigin_CUR:
-    _istream.seekg(offset, ios::cur);
+    _istream->seekg(offset, ios::cur);
     break;
 
   case aiOrigin_END:
-    _istream.seekg(offset, ios::end);
+    _istream->seekg(offset, ios::end);
     break;
 
   default:
@@ -75,7 +142,7 @@ Seek(size_t offset, aiOrigin origin) {
     break;
   }
 
-  if (_istream.good()) {
+  if (_istream->good()) {
     return AI_SUCCESS;
   } else {
     return AI_FAILURE;
@@ -87,7 +154,10 @@ Seek(size_t offset, aiOrigin origin) {
  */
 size_t PandaIOStream::
 Tell() const {
-  return _istream.tellg();
+  if (_istream == nullptr) {
+    return _pos;
+  }
+  return _istream->tellg();
 }
 
 /**
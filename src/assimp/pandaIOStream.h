@@ -15,19 +15,22 @@
 #define PANDAIOSTREAM_H
 
 #include "config_assimp.h"
+#include "mappedFile.h"
 
 #include <assimp/IOStream.hpp>
 
 class PandaIOSystem;
 
 /**
- * Custom implementation of Assimp::IOStream.  It simply wraps around an
- * istream object, and is unable to write.
+ * Custom implementation of Assimp::IOStream.  It either wraps around an
+ * istream object, or, for a file on disk, reads directly out of a memory
+ * mapping of the file.  It is unable to write.
  */
 class PandaIOStream : public Assimp::IOStream {
 public:
   PandaIOStream(std::istream &stream);
-  virtual ~PandaIOStream() {};
+  PandaIOStream(MappedFile *mapped);
+  virtual ~PandaIOStream();
 
   size_t FileSize() const;
   void Flush();
@@ -37,7 +40,11 @@ public:
   size_t Write(const void *buffer, size_t size, size_t count);
 
 private:
-  std::istream &_istream;
+  std::istream *_istream;
+
+  // These are used instead of _istream if the file is memory-mapped.
+  MappedFile *_mapped;
+  size_t _pos;
 
   friend class PandaIOSystem;
 };
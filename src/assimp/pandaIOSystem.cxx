@@ -13,6 +13,8 @@
 
 #include "pandaIOSystem.h"
 #include "pandaIOStream.h"
+#include "virtualFileSimple.h"
+#include "virtualFileMountSystem.h"
 
 /**
  * Initializes the object with the given VFS, or the global one if none was
@@ -37,7 +39,10 @@ Exists(const char *file) const {
 void PandaIOSystem::
 Close(Assimp::IOStream *file) {
   PandaIOStream *pstr = (PandaIOStream*) file;
-  _vfs->close_read_file(&pstr->_istream);
+  if (pstr->_istream != nullptr) {
+    _vfs->close_read_file(pstr->_istream);
+  }
+  delete pstr;
 }
 
 /**
@@ -72,6 +77,13 @@ Open(const char *file, const char *mode) {
   Filename fn = Filename::from_os_specific(file);
 
   if (mode[0] == 'r') {
+    if (assimp_mmap_files) {
+      PandaIOStream *stream = map_file(fn);
+      if (stream != nullptr) {
+        return stream;
+      }
+    }
+
     std::istream *stream = _vfs->open_read_file(file, true);
     if (stream == nullptr) {
       return nullptr;
@@ -83,3 +95,39 @@ Open(const char *file, const char *mode) {
     return nullptr;
   }
 }
+
+/**
+ * If the indicated file is an ordinary, uncompressed file on disk, maps it
+ * into memory and returns a stream that reads from the mapping, so that the
+ * importer can read it without copying it through an istream.  Returns NULL
+ * if the file should be read through the virtual file system instead.
+ */
+PandaIOStream *PandaIOSystem::
+map_file(const Filename &filename) const {
+  std::string ext = filename.get_extension();
+  if (ext == "pz" || ext == "gz") {
+    return nullptr;
+  }
+
+  PT(VirtualFile) vfile = _vfs->get_file(filename);
+  if (vfile == nullptr ||
+      !vfile->is_of_type(VirtualFileSimple::get_class_type())) {
+    return nullptr;
+  }
+
+  VirtualFileSimple *simple = DCAST(VirtualFileSimple, vfile);
+  VirtualFileMount *mount = simple->get_mount();
+  if (simple->is_implicit_pz_file() ||
+      !mount->is_of_type(VirtualFileMountSystem::get_class_type())) {
+    return nullptr;
+  }
+
+  Filename physical(DCAST(VirtualFileMountSystem, mount)->get_physical_filename(),
+                    simple->get_local_filename());
+  MappedFile *mapped = new MappedFile;
+  if (!mapped->open(physical)) {
+    delete mapped;
+    return nullptr;
+  }
+  return new PandaIOStream(mapped);
+}
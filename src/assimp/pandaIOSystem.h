@@ -19,6 +19,8 @@
 
 #include <assimp/IOSystem.hpp>
 
+class PandaIOStream;
+
 /**
  * Custom implementation of Assimp::IOSystem.
  */
@@ -34,6 +36,8 @@ public:
   Assimp::IOStream *Open(const char *file, const char *mode);
 
 private:
+  PandaIOStream *map_file(const Filename &filename) const;
+
   VirtualFileSystem *_vfs;
 };
 
@@ -19,10 +19,11 @@
 #begin bin_target
   #define TARGET bam-info
   #define LOCAL_LIBS \
-    progbase
+    progbase pandatoolbase
 
   #define SOURCES \
-    bamInfo.cxx bamInfo.h
+    bamInfo.cxx bamInfo.h \
+    bamStreamAnalyzer.cxx bamStreamAnalyzer.h bamStreamAnalyzer.I
 
   #define INSTALL_HEADERS
 #end bin_target
@@ -32,7 +33,7 @@
 #begin bin_target
   #define TARGET egg2bam
   #define LOCAL_LIBS \
-    eggbase progbase
+    eggbase progbase pandatoolbase
 
   #define SOURCES \
     eggToBam.cxx eggToBam.h
@@ -51,10 +52,22 @@
 #begin bin_target
   #define TARGET pts2bam
   #define LOCAL_LIBS \
-   progbase
+   progbase pandatoolbase
 
   #define SOURCES \
-    ptsToBam.cxx ptsToBam.h
+    ptsNumber.cxx ptsNumber.h \
+    ptsToBam.cxx ptsToBam.I ptsToBam.h
 #end bin_target
 
+#begin test_bin_target
+  #define TARGET test_pts_number
+  #define LOCAL_LIBS \
+    pandatoolbase
+
+  #define SOURCES \
+    ptsNumber.cxx ptsNumber.h \
+    test_pts_number.cxx
+
+#end test_bin_target
+
 #endif // HAVE_EGG
@@ -12,6 +12,7 @@
  */
 
 #include "bamInfo.h"
+#include "bamStreamAnalyzer.h"
 
 #include "bamFile.h"
 #include "pandaNode.h"
@@ -53,6 +54,29 @@ BamInfo() {
      "Output verbose information about the each Geom in the Bam file.",
      &BamInfo::dispatch_none, &_verbose_geoms);
 
+  add_option
+    ("stats", "", 0,
+     "Instead of describing the objects in the bam file, report where its "
+     "bytes go: the count and size of the objects of each type, the size of "
+     "the vertex data in each vertex format, the size and compression of "
+     "each texture, and the largest objects.  The file is read one object "
+     "at a time, without building its scene graph, so this works on files "
+     "too large to load.",
+     &BamInfo::dispatch_none, &_stats);
+
+  add_option
+    ("top", "n", 0,
+     "Specifies the number of the largest objects to list with -stats.  The "
+     "default is 20.",
+     &BamInfo::dispatch_int, nullptr, &_max_top_objects);
+
+  add_option
+    ("json", "", 0,
+     "Writes the -stats report to standard output as JSON, rather than as "
+     "text.  This implies -stats.",
+     &BamInfo::dispatch_none, &_json);
+
+  _max_top_objects = 20;
   _num_scene_graphs = 0;
 }
 
@@ -62,6 +86,11 @@ BamInfo() {
  */
 void BamInfo::
 run() {
+  if (_stats || _json) {
+    run_stats();
+    return;
+  }
+
   bool okflag = true;
 
   Filenames::const_iterator fi;
@@ -103,6 +132,43 @@ handle_args(ProgramBase::Args &args) {
 }
 
 
+/**
+ * Reports the sizes of the objects in each of the bam files, for -stats.
+ */
+void BamInfo::
+run_stats() {
+  bool okflag = true;
+
+  if (_json) {
+    std::cout << "{\"files\": [";
+  }
+
+  for (size_t i = 0; i < _filenames.size(); ++i) {
+    BamStreamAnalyzer analyzer;
+    analyzer.set_max_top_objects(_max_top_objects);
+    if (!analyzer.analyze(_filenames[i])) {
+      okflag = false;
+    }
+
+    if (_json) {
+      std::cout << (i == 0 ? "\n" : ",\n");
+      analyzer.write_json(std::cout);
+    } else {
+      analyzer.write(nout, 0);
+      nout << "\n";
+    }
+  }
+
+  if (_json) {
+    std::cout << "\n]}\n";
+  }
+
+  if (!okflag) {
+    // Exit with an error if any of the files was unreadable.
+    exit(1);
+  }
+}
+
 /**
  * Reads a single Bam file and displays its contents.  Returns true if
  * successful, false on error.
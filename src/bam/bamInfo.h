@@ -43,6 +43,7 @@ protected:
 private:
   typedef pvector<TypedWritable *> Objects;
 
+  void run_stats();
   bool get_info(const Filename &filename);
   void describe_scene_graph(PandaNode *node);
   void describe_texture(Texture *tex);
@@ -57,6 +58,9 @@ private:
   bool _ls;
   bool _verbose_transitions;
   bool _verbose_geoms;
+  bool _stats;
+  int _max_top_objects;
+  bool _json;
 
   int _num_scene_graphs;
   SceneGraphAnalyzer _analyzer;
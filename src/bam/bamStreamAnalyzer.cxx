@@ -0,0 +1,1007 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file bamStreamAnalyzer.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "bamStreamAnalyzer.h"
+
+#include "bam.h"
+#include "bamEnums.h"
+#include "datagram.h"
+#include "datagramInputFile.h"
+#include "geomEnums.h"
+#include "texture.h"
+#include "indent.h"
+#include "jsonOutput.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * Returns part as a percentage of whole, formatted to one decimal place.
+ */
+static std::string
+format_percent(uint64_t part, uint64_t whole) {
+  std::ostringstream strm;
+  strm << std::fixed << std::setprecision(1)
+       << (whole == 0 ? 0.0 : 100.0 * (double)part / (double)whole);
+  return strm.str();
+}
+
+/**
+ *
+ */
+BamStreamAnalyzer::FormatUsage::
+FormatUsage() :
+  _num_vertex_datas(0)
+{
+}
+
+/**
+ *
+ */
+BamStreamAnalyzer::TextureInfo::
+TextureInfo() :
+  _bytes(0),
+  _has_rawdata(false),
+  _decoded(false),
+  _texture_type(0),
+  _format(0),
+  _compression(0),
+  _x_size(0),
+  _y_size(0),
+  _z_size(1),
+  _component_type(0),
+  _ram_image_compression(0),
+  _num_ram_images(0),
+  _ram_image_bytes(0)
+{
+}
+
+/**
+ *
+ */
+BamStreamAnalyzer::FormatSummary::
+FormatSummary() :
+  _num_vertex_datas(0),
+  _num_rows(0),
+  _bytes(0)
+{
+}
+
+/**
+ *
+ */
+BamStreamAnalyzer::
+BamStreamAnalyzer() {
+  _max_top_objects = 20;
+  _file_major = 0;
+  _file_minor = 0;
+  _file_big_endian = false;
+  _file_stdfloat_double = false;
+  _long_object_ids = false;
+  _file_bytes = 0;
+  _num_objects = 0;
+  _object_bytes = 0;
+  _num_file_data = 0;
+  _file_data_bytes = 0;
+}
+
+/**
+ * Reads the indicated bam file from beginning to end, tallying its contents.
+ * Returns true if the whole file was read, or false if it could not be read
+ * or was truncated or corrupt; in the latter case, the results describe the
+ * part of the file before the error.
+ */
+bool BamStreamAnalyzer::
+analyze(const Filename &filename) {
+  _filename = filename;
+
+  DatagramInputFile din;
+  if (!din.open(filename)) {
+    _error = "Unable to read.";
+    return false;
+  }
+
+  std::string head;
+  if (!din.read_header(head, _bam_header.size()) || head != _bam_header) {
+    _error = "Not a bam file.";
+    return false;
+  }
+  _file_bytes = head.size();
+
+  Datagram dg;
+  if (!din.get_datagram(dg) || !read_header(dg)) {
+    if (_error.empty()) {
+      _error = "Invalid bam header.";
+    }
+    return false;
+  }
+  _file_bytes += 4 + dg.get_length();
+
+  if (_file_major != _bam_major_ver || _file_minor < 21) {
+    // Older files don't mark the beginning of each object, so we can't walk
+    // them without decoding every object.
+    std::ostringstream strm;
+    strm << "Bam version " << _file_major << "." << _file_minor
+         << " is too old to analyze; 6.21 or later is required.";
+    _error = strm.str();
+    return false;
+  }
+
+  while (din.get_datagram(dg)) {
+    uint64_t offset = _file_bytes;
+    size_t length = dg.get_length();
+
+    // Very large datagrams have an extended length prefix.
+    _file_bytes += (length >= 0xffffffff ? 12 : 4) + length;
+
+    if (!read_datagram(dg, offset)) {
+      return false;
+    }
+  }
+
+  if (!din.is_eof() || din.is_error()) {
+    _error = "File is truncated or corrupt.";
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Writes the results of analyze() as text.
+ */
+void BamStreamAnalyzer::
+write(std::ostream &out, int indent_level) const {
+  indent(out, indent_level) << _filename;
+  if (_file_major != 0) {
+    out << " : Bam version " << _file_major << "." << _file_minor << ", "
+        << (_file_big_endian ? "big-endian" : "little-endian") << ", "
+        << (_file_stdfloat_double ? 64 : 32) << "-bit floats";
+  }
+  out << ".\n";
+
+  if (!_error.empty()) {
+    indent(out, indent_level + 2) << _error << "\n";
+  }
+
+  indent(out, indent_level + 2)
+    << _num_objects << " objects in " << _object_bytes << " bytes, of "
+    << _file_bytes << " bytes in the file";
+  if (_num_file_data != 0) {
+    out << "; " << _num_file_data << " embedded files in "
+        << _file_data_bytes << " bytes";
+  }
+  out << ".\n";
+
+  // The bytes of each object include its header, but not the length prefix
+  // of its datagram.
+  pvector<const TypeInfo *> types;
+  get_type_order(types);
+  if (!types.empty()) {
+    out << "\n";
+    indent(out, indent_level + 2) << "By type:\n";
+    indent(out, indent_level + 4)
+      << std::setw(10) << "count" << std::setw(14) << "bytes"
+      << std::setw(7) << "%" << std::setw(12) << "largest" << "  type\n";
+    for (const TypeInfo *type : types) {
+      indent(out, indent_level + 4)
+        << std::setw(10) << type->_count << std::setw(14) << type->_bytes
+        << std::setw(7) << format_percent(type->_bytes, _object_bytes)
+        << std::setw(12) << type->_max_bytes << "  " << type->_name << "\n";
+    }
+  }
+
+  // The bytes of a vertex format are the bytes of vertex data in all of the
+  // arrays that use it.
+  FormatSummaries summaries;
+  get_format_summaries(summaries);
+  if (!summaries.empty()) {
+    pvector<FormatSummaries::const_iterator> order;
+    for (FormatSummaries::const_iterator si = summaries.begin();
+         si != summaries.end(); ++si) {
+      order.push_back(si);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](FormatSummaries::const_iterator a,
+                        FormatSummaries::const_iterator b) {
+      return (*a).second._bytes > (*b).second._bytes;
+    });
+
+    out << "\n";
+    indent(out, indent_level + 2) << "By vertex format:\n";
+    indent(out, indent_level + 4)
+      << std::setw(10) << "vdatas" << std::setw(14) << "rows"
+      << std::setw(14) << "bytes" << std::setw(7) << "%" << "  format\n";
+    for (FormatSummaries::const_iterator si : order) {
+      const FormatSummary &summary = (*si).second;
+      indent(out, indent_level + 4)
+        << std::setw(10) << summary._num_vertex_datas
+        << std::setw(14) << summary._num_rows
+        << std::setw(14) << summary._bytes
+        << std::setw(7) << format_percent(summary._bytes, _object_bytes)
+        << "  " << (*si).first << "\n";
+    }
+  }
+
+  pvector<const TextureInfo *> textures;
+  get_texture_order(textures);
+  if (!textures.empty()) {
+    out << "\n";
+    indent(out, indent_level + 2) << "Textures:\n";
+    indent(out, indent_level + 4)
+      << std::setw(14) << "bytes" << std::setw(14) << "ram image"
+      << "  size, format, compression, name\n";
+    for (const TextureInfo *tex : textures) {
+      indent(out, indent_level + 4) << std::setw(14) << tex->_bytes;
+      if (!tex->_decoded) {
+        out << std::setw(14) << "?" << "  ?";
+      } else {
+        out << std::setw(14) << tex->_ram_image_bytes << "  "
+            << describe_texture_size(*tex) << ", "
+            << Texture::format_format((Texture::Format)tex->_format) << ", ";
+        if (tex->_has_rawdata) {
+          out << Texture::format_compression_mode
+            ((Texture::CompressionMode)tex->_ram_image_compression);
+        } else {
+          out << "no ram image";
+        }
+      }
+      out << ", " << tex->_name;
+      if (!tex->_filename.empty()) {
+        out << " (" << tex->_filename << ")";
+      }
+      out << "\n";
+    }
+  }
+
+  TopObjects top;
+  get_top_order(top);
+  if (!top.empty()) {
+    out << "\n";
+    indent(out, indent_level + 2) << "Largest objects:\n";
+    indent(out, indent_level + 4)
+      << std::setw(14) << "bytes" << std::setw(14) << "offset" << "  type\n";
+    for (const TopObject &object : top) {
+      indent(out, indent_level + 4)
+        << std::setw(14) << object._bytes << std::setw(14) << object._offset
+        << "  " << get_type_name(object._type);
+      if (!object._label.empty()) {
+        out << " " << object._label;
+      }
+      out << "\n";
+    }
+  }
+}
+
+/**
+ * Writes the results of analyze() as a JSON object.
+ */
+void BamStreamAnalyzer::
+write_json(std::ostream &out) const {
+  out << "{\"filename\": ";
+  write_json_string(out, _filename.to_os_specific());
+  out << ",\n \"bam_version\": \"" << _file_major << "." << _file_minor
+      << "\", \"big_endian\": " << (_file_big_endian ? "true" : "false")
+      << ", \"stdfloat_double\": " << (_file_stdfloat_double ? "true" : "false");
+  if (!_error.empty()) {
+    out << ",\n \"error\": ";
+    write_json_string(out, _error);
+  }
+  out << ",\n \"file_bytes\": " << _file_bytes
+      << ", \"num_objects\": " << _num_objects
+      << ", \"object_bytes\": " << _object_bytes
+      << ", \"num_file_data\": " << _num_file_data
+      << ", \"file_data_bytes\": " << _file_data_bytes;
+
+  pvector<const TypeInfo *> types;
+  get_type_order(types);
+  out << ",\n \"types\": [";
+  for (size_t i = 0; i < types.size(); ++i) {
+    const TypeInfo *type = types[i];
+    out << (i == 0 ? "\n  " : ",\n  ") << "{\"type\": ";
+    write_json_string(out, type->_name);
+    out << ", \"count\": " << type->_count << ", \"bytes\": " << type->_bytes
+        << ", \"max_bytes\": " << type->_max_bytes << "}";
+  }
+  out << "]";
+
+  FormatSummaries summaries;
+  get_format_summaries(summaries);
+  out << ",\n \"vertex_formats\": [";
+  bool first = true;
+  for (FormatSummaries::const_iterator si = summaries.begin();
+       si != summaries.end(); ++si) {
+    const FormatSummary &summary = (*si).second;
+    out << (first ? "\n  " : ",\n  ") << "{\"format\": ";
+    write_json_string(out, (*si).first);
+    out << ", \"vertex_datas\": " << summary._num_vertex_datas
+        << ", \"rows\": " << summary._num_rows
+        << ", \"bytes\": " << summary._bytes << "}";
+    first = false;
+  }
+  out << "]";
+
+  pvector<const TextureInfo *> textures;
+  get_texture_order(textures);
+  out << ",\n \"textures\": [";
+  for (size_t i = 0; i < textures.size(); ++i) {
+    const TextureInfo *tex = textures[i];
+    out << (i == 0 ? "\n  " : ",\n  ") << "{\"name\": ";
+    write_json_string(out, tex->_name);
+    out << ", \"filename\": ";
+    write_json_string(out, tex->_filename);
+    out << ", \"bytes\": " << tex->_bytes;
+    if (tex->_decoded) {
+      out << ", \"texture_type\": ";
+      write_json_string(out, Texture::format_texture_type
+                        ((Texture::TextureType)tex->_texture_type));
+      out << ", \"x_size\": " << tex->_x_size
+          << ", \"y_size\": " << tex->_y_size
+          << ", \"z_size\": " << tex->_z_size << ", \"format\": ";
+      write_json_string(out, Texture::format_format((Texture::Format)tex->_format));
+      out << ", \"compression\": ";
+      write_json_string(out, Texture::format_compression_mode
+                        ((Texture::CompressionMode)tex->_compression));
+      out << ", \"has_ram_image\": " << (tex->_has_rawdata ? "true" : "false");
+      if (tex->_has_rawdata) {
+        out << ", \"component_type\": ";
+        write_json_string(out, Texture::format_component_type
+                          ((Texture::ComponentType)tex->_component_type));
+        out << ", \"ram_image_compression\": ";
+        write_json_string(out, Texture::format_compression_mode
+                          ((Texture::CompressionMode)tex->_ram_image_compression));
+        out << ", \"ram_images\": " << tex->_num_ram_images
+            << ", \"ram_image_bytes\": " << tex->_ram_image_bytes;
+      }
+    }
+    out << "}";
+  }
+  out << "]";
+
+  TopObjects top;
+  get_top_order(top);
+  out << ",\n \"largest_objects\": [";
+  for (size_t i = 0; i < top.size(); ++i) {
+    out << (i == 0 ? "\n  " : ",\n  ") << "{\"type\": ";
+    write_json_string(out, get_type_name(top[i]._type));
+    out << ", \"bytes\": " << top[i]._bytes
+        << ", \"offset\": " << top[i]._offset << ", \"label\": ";
+    write_json_string(out, top[i]._label);
+    out << "}";
+  }
+  out << "]}";
+}
+
+/**
+ * Reads the first datagram of the bam file, which gives its version and
+ * encoding.  Returns true on success, false on failure.
+ *
+ * The byte order recorded here is only reported; see Cursor.
+ */
+bool BamStreamAnalyzer::
+read_header(const Datagram &dg) {
+  const unsigned char *data = (const unsigned char *)dg.get_data();
+  Cursor c(data, data + dg.get_length(), false, false);
+
+  _file_major = c.get_uint16();
+  _file_minor = c.get_uint16();
+  int endian = c.get_uint8();
+  if (c.is_ok() && endian != BamEnums::BE_bigendian &&
+      endian != BamEnums::BE_littleendian) {
+    std::ostringstream strm;
+    strm << "Unknown byte order " << endian << " in bam header.";
+    _error = strm.str();
+    return false;
+  }
+  _file_big_endian = (endian == BamEnums::BE_bigendian);
+  if (_file_minor >= 27) {
+    _file_stdfloat_double = (c.get_uint8() != 0);
+  }
+  return c.is_ok();
+}
+
+/**
+ * Tallies one datagram of the bam file, which begins at the indicated offset
+ * within it.  Returns true on success, false if the datagram is invalid.
+ */
+bool BamStreamAnalyzer::
+read_datagram(const Datagram &dg, uint64_t offset) {
+  const unsigned char *data = (const unsigned char *)dg.get_data();
+  size_t length = dg.get_length();
+  Cursor c(data, data + length, _long_object_ids, _file_stdfloat_double);
+
+  switch (c.get_uint8()) {
+  case BamEnums::BOC_push:
+  case BamEnums::BOC_adjunct:
+    {
+      int type = read_handle(c);
+      if (!c.is_ok()) {
+        std::ostringstream strm;
+        strm << "Invalid object header at offset " << offset << ".";
+        _error = strm.str();
+        return false;
+      }
+      read_object(type, c, length, offset);
+    }
+    break;
+
+  case BamEnums::BOC_pop:
+  case BamEnums::BOC_remove:
+    // These only manage the reader's bookkeeping.
+    break;
+
+  case BamEnums::BOC_file_data:
+    ++_num_file_data;
+    _file_data_bytes += length;
+    break;
+
+  default:
+    {
+      std::ostringstream strm;
+      strm << "Invalid datagram at offset " << offset << ".";
+      _error = strm.str();
+    }
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Reads a type index from the datagram, the same way BamReader does: the
+ * first time each type appears in the file, its index is followed by its
+ * name and its parent types.  Returns the index.
+ */
+int BamStreamAnalyzer::
+read_handle(Cursor &c) {
+  int type = c.get_uint16();
+  if (type == 0 || _types.find(type) != _types.end()) {
+    return type;
+  }
+
+  TypeInfo info;
+  info._kind = K_other;
+  info._count = 0;
+  info._bytes = 0;
+  info._max_bytes = 0;
+
+  Cursor start = c;
+  info._name = c.get_string();
+  int num_parents = c.get_uint8();
+  for (int i = 0; i < num_parents && c.is_ok(); ++i) {
+    read_handle(c);
+  }
+
+  if (!c.is_ok() || info._name.empty()) {
+    // This isn't a type definition after all.  That can only happen if the
+    // type was first written within an object that we didn't decode, so we
+    // won't learn its name.
+    c = start;
+    std::ostringstream strm;
+    strm << "(type " << type << ")";
+    info._name = strm.str();
+
+  } else if (info._name == "GeomVertexData") {
+    info._kind = K_vertex_data;
+  } else if (info._name == "GeomVertexArrayData") {
+    info._kind = K_array_data;
+  } else if (info._name == "GeomVertexFormat") {
+    info._kind = K_vertex_format;
+  } else if (info._name == "GeomVertexArrayFormat") {
+    info._kind = K_array_format;
+  } else if (info._name == "InternalName") {
+    info._kind = K_internal_name;
+  } else if (info._name == "Texture") {
+    info._kind = K_texture;
+  }
+
+  _types[type] = info;
+  return type;
+}
+
+/**
+ * Decodes the object that begins at the indicated cursor with the indicated
+ * function, which must consume the object exactly.  Returns true on success,
+ * filling in object_id and record, or false if the object can't be decoded.
+ *
+ * The writer switches to 32-bit object IDs the first time it writes the ID
+ * 0xffff, which may have happened within an object that we skipped over.  So
+ * if the object doesn't decode with 16-bit IDs, we try 32-bit IDs too, and
+ * use them from then on if they fit.
+ */
+template<class Record>
+bool BamStreamAnalyzer::
+decode(const Cursor &start,
+       bool (BamStreamAnalyzer::*func)(Cursor &, Record &) const,
+       int &object_id, Record &record) {
+  Cursor c = start;
+  record = Record();
+  object_id = c.get_object_id();
+  if ((this->*func)(c, record) && c.is_at_end()) {
+    _long_object_ids = c._long_object_ids;
+    return true;
+  }
+
+  if (!start._long_object_ids) {
+    c = start;
+    c._long_object_ids = true;
+    record = Record();
+    object_id = c.get_object_id();
+    if ((this->*func)(c, record) && c.is_at_end()) {
+      _long_object_ids = true;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Tallies one object, whose datagram is bytes long and begins at the
+ * indicated offset within the file.  The cursor is positioned just after the
+ * object's type, at its object ID.
+ */
+void BamStreamAnalyzer::
+read_object(int type, const Cursor &c, size_t bytes, uint64_t offset) {
+  Types::iterator ti = _types.find(type);
+  if (ti == _types.end()) {
+    TypeInfo info;
+    info._name = "(none)";
+    info._kind = K_other;
+    info._count = 0;
+    info._bytes = 0;
+    info._max_bytes = 0;
+    ti = _types.insert(Types::value_type(type, info)).first;
+  }
+  TypeInfo &info = (*ti).second;
+  ++info._count;
+  info._bytes += bytes;
+  info._max_bytes = std::max(info._max_bytes, bytes);
+
+  ++_num_objects;
+  _object_bytes += bytes;
+
+  TopObject top;
+  top._bytes = bytes;
+  top._type = type;
+  top._offset = offset;
+
+  int object_id = 0;
+  switch (info._kind) {
+  case K_other:
+    {
+      // We only need to read the object ID, in case it is the one that
+      // switches the file to 32-bit IDs.
+      Cursor id_cursor = c;
+      id_cursor.get_object_id();
+      _long_object_ids = id_cursor._long_object_ids;
+    }
+    break;
+
+  case K_vertex_data:
+    {
+      VertexData vdata;
+      if (decode(c, &BamStreamAnalyzer::decode_vertex_data, object_id, vdata)) {
+        ++_format_usages[vdata._format]._num_vertex_datas;
+
+        // The arrays will appear later in the file, since they were queued
+        // for writing when this object was written.
+        for (size_t i = 0; i < vdata._arrays.size(); ++i) {
+          PendingArray &pending = _pending_arrays[vdata._arrays[i]];
+          pending._format = vdata._format;
+          pending._slot = (int)i;
+          pending._vertex_data_name = vdata._name;
+        }
+        top._label = vdata._name;
+      }
+    }
+    break;
+
+  case K_array_data:
+    {
+      uint64_t data_bytes;
+      if (decode(c, &BamStreamAnalyzer::decode_array_data, object_id, data_bytes)) {
+        // An array that no GeomVertexData claims holds the vertex indices of
+        // a GeomPrimitive, or is shared with a vertex data already counted.
+        PendingArrays::iterator pi = _pending_arrays.find(object_id);
+        if (pi != _pending_arrays.end()) {
+          const PendingArray &pending = (*pi).second;
+          FormatUsage &usage = _format_usages[pending._format];
+          if ((int)usage._array_bytes.size() <= pending._slot) {
+            usage._array_bytes.resize(pending._slot + 1, 0);
+          }
+          usage._array_bytes[pending._slot] += data_bytes;
+
+          std::ostringstream strm;
+          strm << pending._vertex_data_name << " array " << pending._slot;
+          top._label = strm.str();
+          _pending_arrays.erase(pi);
+        }
+      }
+    }
+    break;
+
+  case K_vertex_format:
+    {
+      VertexFormat format;
+      if (decode(c, &BamStreamAnalyzer::decode_vertex_format, object_id, format)) {
+        _vertex_formats[object_id] = format;
+      }
+    }
+    break;
+
+  case K_array_format:
+    {
+      ArrayFormat format;
+      if (decode(c, &BamStreamAnalyzer::decode_array_format, object_id, format)) {
+        _array_formats[object_id] = format;
+      }
+    }
+    break;
+
+  case K_internal_name:
+    {
+      std::string name;
+      if (decode(c, &BamStreamAnalyzer::decode_internal_name, object_id, name)) {
+        _internal_names[object_id] = name;
+      }
+    }
+    break;
+
+  case K_texture:
+    {
+      TextureInfo tex;
+      if (decode(c, &BamStreamAnalyzer::decode_texture, object_id, tex)) {
+        tex._decoded = true;
+      } else {
+        // We don't understand this texture's layout, but the name comes
+        // first, so we can at least report that.
+        tex = TextureInfo();
+        Cursor name_cursor = c;
+        name_cursor.get_object_id();
+        tex._name = name_cursor.get_string();
+        tex._filename = name_cursor.get_string();
+        if (!name_cursor.is_ok()) {
+          tex._name = "?";
+          tex._filename.clear();
+        }
+      }
+      tex._bytes = bytes;
+      top._label = tex._name;
+      _textures.push_back(tex);
+    }
+    break;
+  }
+
+  add_top_object(top);
+}
+
+/**
+ * Records the object as one of the largest in the file, if it is.
+ */
+void BamStreamAnalyzer::
+add_top_object(const TopObject &top) {
+  if (_max_top_objects <= 0) {
+    return;
+  }
+
+  // _top_objects is a heap with the smallest object at the front.
+  if ((int)_top_objects.size() < _max_top_objects) {
+    _top_objects.push_back(top);
+    std::push_heap(_top_objects.begin(), _top_objects.end());
+
+  } else if (top < _top_objects.front()) {
+    std::pop_heap(_top_objects.begin(), _top_objects.end());
+    _top_objects.back() = top;
+    std::push_heap(_top_objects.begin(), _top_objects.end());
+  }
+}
+
+/**
+ * Decodes the body of a GeomVertexData, as written by
+ * GeomVertexData::write_datagram().
+ */
+bool BamStreamAnalyzer::
+decode_vertex_data(Cursor &c, VertexData &vdata) const {
+  vdata._name = c.get_string();
+  vdata._format = c.get_object_id();
+  c.get_uint8();  // usage hint
+  int num_arrays = c.get_uint16();
+  for (int i = 0; i < num_arrays && c.is_ok(); ++i) {
+    vdata._arrays.push_back(c.get_object_id());
+  }
+  c.get_object_id();  // transform table
+  c.get_object_id();  // transform blend table
+  c.get_object_id();  // slider table
+  return c.is_ok();
+}
+
+/**
+ * Decodes the body of a GeomVertexArrayData, and returns the size of its
+ * data.
+ */
+bool BamStreamAnalyzer::
+decode_array_data(Cursor &c, uint64_t &data_bytes) const {
+  c.get_object_id();  // array format
+  c.get_uint8();  // usage hint
+  data_bytes = c.get_uint32();
+  c.skip_bytes(data_bytes);
+  return c.is_ok();
+}
+
+/**
+ * Decodes the body of a GeomVertexFormat.
+ */
+bool BamStreamAnalyzer::
+decode_vertex_format(Cursor &c, VertexFormat &format) const {
+  // The GeomVertexAnimationSpec.
+  c.get_uint8();  // animation type
+  c.get_uint16();  // num transforms
+  c.get_uint8();  // indexed transforms
+
+  int num_arrays = c.get_uint16();
+  for (int i = 0; i < num_arrays && c.is_ok(); ++i) {
+    format._arrays.push_back(c.get_object_id());
+  }
+  return c.is_ok();
+}
+
+/**
+ * Decodes the body of a GeomVertexArrayFormat, including its columns.
+ */
+bool BamStreamAnalyzer::
+decode_array_format(Cursor &c, ArrayFormat &format) const {
+  format._stride = c.get_uint16();
+  c.get_uint16();  // total bytes
+  c.get_uint8();  // pad to
+  if (_file_minor >= 37) {
+    c.get_uint16();  // divisor
+  }
+
+  int num_columns = c.get_uint16();
+  for (int i = 0; i < num_columns && c.is_ok(); ++i) {
+    format._column_names.push_back(c.get_object_id());
+    format._column_components.push_back(c.get_uint8());
+    format._column_numeric_types.push_back(c.get_uint8());
+    c.get_uint8();  // contents
+    c.get_uint16();  // start
+    if (_file_minor >= 29) {
+      c.get_uint8();  // column alignment
+    }
+  }
+  return c.is_ok();
+}
+
+/**
+ * Decodes the body of an InternalName.
+ */
+bool BamStreamAnalyzer::
+decode_internal_name(Cursor &c, std::string &name) const {
+  name = c.get_string();
+  return c.is_ok();
+}
+
+/**
+ * Decodes the body of a Texture, as written by Texture::write_datagram(): the
+ * header, the properties, and the RAM images, if the texture has them.
+ */
+bool BamStreamAnalyzer::
+decode_texture(Cursor &c, TextureInfo &tex) const {
+  tex._name = c.get_string();
+  tex._filename = c.get_string();
+  c.get_string();  // alpha filename
+  c.get_uint8();  // primary file num channels
+  c.get_uint8();  // alpha file channel
+  tex._has_rawdata = (c.get_uint8() != 0);
+  tex._texture_type = c.get_uint8();
+  if (_file_minor >= 32) {
+    c.get_uint8();  // has read mipmaps
+  }
+
+  // The default sampler: the wrap modes and filter types, the anisotropic
+  // degree, the border color and, since 6.36, the lod settings.
+  c.skip_bytes(5);
+  c.get_uint16();
+  c.skip_stdfloats(_file_minor >= 36 ? 7 : 4);
+
+  tex._compression = c.get_uint8();
+  c.get_uint8();  // quality level
+  tex._format = c.get_uint8();
+  c.get_uint8();  // num components
+  if (tex._texture_type == Texture::TT_buffer_texture) {
+    c.get_uint8();  // usage hint
+  }
+  if (_file_minor >= 28) {
+    c.get_uint8();  // auto texture scale
+  }
+  tex._x_size = c.get_uint32();  // original file size
+  tex._y_size = c.get_uint32();
+
+  if (c.get_uint8() != 0) {
+    // The simple RAM image.
+    c.get_uint32();  // x size
+    c.get_uint32();  // y size
+    c.get_uint32();  // date generated
+    c.skip_bytes(c.get_uint32());
+  }
+
+  if (_file_minor >= 45) {
+    if (c.get_uint8() != 0) {
+      c.skip_stdfloats(4);  // clear color
+    }
+  }
+
+  if (tex._has_rawdata) {
+    tex._x_size = c.get_uint32();
+    tex._y_size = c.get_uint32();
+    tex._z_size = c.get_uint32();
+    if (_file_minor >= 30) {
+      c.skip_bytes(12);  // pad size
+    }
+    if (_file_minor >= 26) {
+      c.get_uint32();  // num views
+    }
+    tex._component_type = c.get_uint8();
+    c.get_uint8();  // component width
+    tex._ram_image_compression = c.get_uint8();
+
+    tex._num_ram_images = c.get_uint8();
+    for (int n = 0; n < tex._num_ram_images && c.is_ok(); ++n) {
+      c.get_uint32();  // page size
+      size_t image_bytes = c.get_uint32();
+      c.skip_bytes(image_bytes);
+      tex._ram_image_bytes += image_bytes;
+    }
+  }
+
+  return c.is_ok();
+}
+
+/**
+ * Fills types with the types that appear in the file, from the most bytes to
+ * the fewest.
+ */
+void BamStreamAnalyzer::
+get_type_order(pvector<const TypeInfo *> &types) const {
+  for (Types::const_iterator ti = _types.begin(); ti != _types.end(); ++ti) {
+    // Types that only appear as the parent of another type have no objects.
+    if ((*ti).second._count != 0) {
+      types.push_back(&(*ti).second);
+    }
+  }
+  std::stable_sort(types.begin(), types.end(),
+                   [](const TypeInfo *a, const TypeInfo *b) {
+    return a->_bytes > b->_bytes;
+  });
+}
+
+/**
+ * Totals the vertex data by format.  Separate format objects that describe
+ * the same format, as happens when several files were combined into one, are
+ * counted together.
+ */
+void BamStreamAnalyzer::
+get_format_summaries(FormatSummaries &summaries) const {
+  for (FormatUsages::const_iterator ui = _format_usages.begin();
+       ui != _format_usages.end(); ++ui) {
+    const FormatUsage &usage = (*ui).second;
+    FormatSummary &summary = summaries[describe_format((*ui).first)];
+    summary._num_vertex_datas += usage._num_vertex_datas;
+    for (uint64_t array_bytes : usage._array_bytes) {
+      summary._bytes += array_bytes;
+    }
+
+    // The number of rows is the same in every array, so we count it from
+    // the first.
+    VertexFormats::const_iterator fi = _vertex_formats.find((*ui).first);
+    if (!usage._array_bytes.empty() && fi != _vertex_formats.end() &&
+        !(*fi).second._arrays.empty()) {
+      ArrayFormats::const_iterator ai =
+        _array_formats.find((*fi).second._arrays[0]);
+      if (ai != _array_formats.end() && (*ai).second._stride != 0) {
+        summary._num_rows += usage._array_bytes[0] / (*ai).second._stride;
+      }
+    }
+  }
+}
+
+/**
+ * Returns a one-line description of the GeomVertexFormat with the indicated
+ * object ID, listing the columns of each of its arrays.
+ */
+std::string BamStreamAnalyzer::
+describe_format(int format) const {
+  VertexFormats::const_iterator fi = _vertex_formats.find(format);
+  if (fi == _vertex_formats.end()) {
+    return "(unknown format)";
+  }
+
+  std::ostringstream strm;
+  const pvector<int> &arrays = (*fi).second._arrays;
+  for (size_t a = 0; a < arrays.size(); ++a) {
+    if (a != 0) {
+      strm << " | ";
+    }
+    ArrayFormats::const_iterator ai = _array_formats.find(arrays[a]);
+    if (ai == _array_formats.end()) {
+      strm << "?";
+      continue;
+    }
+
+    const ArrayFormat &array_format = (*ai).second;
+    for (size_t i = 0; i < array_format._column_names.size(); ++i) {
+      if (i != 0) {
+        strm << ", ";
+      }
+      pmap<int, std::string>::const_iterator ni =
+        _internal_names.find(array_format._column_names[i]);
+      strm << (ni != _internal_names.end() ? (*ni).second : std::string("?"))
+           << "(" << array_format._column_components[i] << " "
+           << (GeomEnums::NumericType)array_format._column_numeric_types[i]
+           << ")";
+    }
+  }
+
+  return strm.str();
+}
+
+/**
+ * Fills textures with the textures in the file, from the most bytes to the
+ * fewest.
+ */
+void BamStreamAnalyzer::
+get_texture_order(pvector<const TextureInfo *> &textures) const {
+  for (const TextureInfo &tex : _textures) {
+    textures.push_back(&tex);
+  }
+  std::stable_sort(textures.begin(), textures.end(),
+                   [](const TextureInfo *a, const TextureInfo *b) {
+    return a->_bytes > b->_bytes;
+  });
+}
+
+/**
+ * Fills top with the largest objects in the file, from largest to smallest.
+ */
+void BamStreamAnalyzer::
+get_top_order(TopObjects &top) const {
+  top = _top_objects;
+  std::sort(top.begin(), top.end());
+}
+
+/**
+ * Returns the name of the type with the indicated index.
+ */
+std::string BamStreamAnalyzer::
+get_type_name(int type) const {
+  Types::const_iterator ti = _types.find(type);
+  if (ti == _types.end()) {
+    return "(none)";
+  }
+  return (*ti).second._name;
+}
+
+/**
+ * Returns the size of the texture as a string like "512 x 512" or "64 x 64 x
+ * 6".
+ */
+std::string BamStreamAnalyzer::
+describe_texture_size(const TextureInfo &tex) {
+  std::ostringstream strm;
+  strm << tex._x_size << " x " << tex._y_size;
+  if (tex._z_size != 1) {
+    strm << " x " << tex._z_size;
+  }
+  return strm.str();
+}
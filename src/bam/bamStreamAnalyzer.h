@@ -0,0 +1,244 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file bamStreamAnalyzer.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef BAMSTREAMANALYZER_H
+#define BAMSTREAMANALYZER_H
+
+#include "pandatoolbase.h"
+
+#include "filename.h"
+#include "pmap.h"
+#include "pvector.h"
+
+class Datagram;
+
+/**
+ * Reports where the bytes go in a bam file, without reading its objects into
+ * memory.
+ *
+ * Rather than handing the file to a BamReader, which must construct every
+ * object and hold them all until the file is resolved, this walks the
+ * datagrams of the file one at a time and decodes only the object headers:
+ * the type of each object, and its object ID.  This is enough to tally the
+ * count and size of the objects of each type, and the largest objects in the
+ * file.
+ *
+ * A handful of types are decoded further, to break the totals down by vertex
+ * format and by texture: GeomVertexData, GeomVertexArrayData,
+ * GeomVertexFormat, GeomVertexArrayFormat, InternalName and Texture.  Each of
+ * these is accepted only if it decodes to exactly the length of its
+ * datagram; any that don't are still counted, but left out of the breakdown.
+ *
+ * Memory use is proportional to the number of types, vertex formats and
+ * textures in the file, not to its size.
+ */
+class BamStreamAnalyzer {
+public:
+  BamStreamAnalyzer();
+
+  INLINE void set_max_top_objects(int max_top_objects);
+
+  bool analyze(const Filename &filename);
+
+  void write(std::ostream &out, int indent_level) const;
+  void write_json(std::ostream &out) const;
+
+private:
+  // The types whose objects we decode.
+  enum Kind {
+    K_other,
+    K_vertex_data,
+    K_array_data,
+    K_vertex_format,
+    K_array_format,
+    K_internal_name,
+    K_texture,
+  };
+
+  // Reads little-endian values from a datagram.  A read past the end of the
+  // datagram returns zero and marks the cursor failed, rather than asserting.
+  // The fields of a bam datagram are little-endian whatever the file's byte
+  // order; that only applies to the raw vertex data, which is skipped, not
+  // decoded.
+  class Cursor {
+  public:
+    INLINE Cursor(const unsigned char *begin, const unsigned char *end,
+                  bool long_object_ids, bool stdfloat_double);
+
+    INLINE bool is_ok() const;
+    INLINE bool is_at_end() const;
+
+    INLINE uint8_t get_uint8();
+    INLINE uint16_t get_uint16();
+    INLINE uint32_t get_uint32();
+    INLINE int get_object_id();
+    INLINE std::string get_string();
+    INLINE void skip_bytes(size_t num_bytes);
+    INLINE void skip_stdfloats(int num_floats);
+
+    const unsigned char *_p;
+    const unsigned char *_end;
+    bool _ok;
+    bool _long_object_ids;
+    bool _stdfloat_double;
+  };
+
+  class TypeInfo {
+  public:
+    std::string _name;
+    Kind _kind;
+    int _count;
+    uint64_t _bytes;
+    size_t _max_bytes;
+  };
+  typedef pmap<int, TypeInfo> Types;
+
+  class ArrayFormat {
+  public:
+    int _stride;
+    pvector<int> _column_names;
+    pvector<int> _column_components;
+    pvector<int> _column_numeric_types;
+  };
+  typedef pmap<int, ArrayFormat> ArrayFormats;
+
+  class VertexFormat {
+  public:
+    pvector<int> _arrays;
+  };
+  typedef pmap<int, VertexFormat> VertexFormats;
+
+  class VertexData {
+  public:
+    std::string _name;
+    int _format;
+    pvector<int> _arrays;
+  };
+
+  // The bytes of vertex data that use each GeomVertexFormat object.
+  class FormatUsage {
+  public:
+    FormatUsage();
+
+    int _num_vertex_datas;
+    pvector<uint64_t> _array_bytes;
+  };
+  typedef pmap<int, FormatUsage> FormatUsages;
+
+  // A GeomVertexArrayData that a GeomVertexData has referenced, but that has
+  // not yet appeared in the file.
+  class PendingArray {
+  public:
+    int _format;
+    int _slot;
+    std::string _vertex_data_name;
+  };
+  typedef pmap<int, PendingArray> PendingArrays;
+
+  class TextureInfo {
+  public:
+    TextureInfo();
+
+    std::string _name;
+    std::string _filename;
+    size_t _bytes;
+    bool _has_rawdata;
+    bool _decoded;
+    int _texture_type;
+    int _format;
+    int _compression;
+    int _x_size, _y_size, _z_size;
+    int _component_type;
+    int _ram_image_compression;
+    int _num_ram_images;
+    uint64_t _ram_image_bytes;
+  };
+  typedef pvector<TextureInfo> Textures;
+
+  class TopObject {
+  public:
+    INLINE bool operator < (const TopObject &other) const;
+
+    size_t _bytes;
+    int _type;
+    uint64_t _offset;
+    std::string _label;
+  };
+  typedef pvector<TopObject> TopObjects;
+
+  // The breakdown by vertex format, merged across the format objects that
+  // describe the same format.
+  class FormatSummary {
+  public:
+    FormatSummary();
+
+    int _num_vertex_datas;
+    uint64_t _num_rows;
+    uint64_t _bytes;
+  };
+  typedef pmap<std::string, FormatSummary> FormatSummaries;
+
+  bool read_header(const Datagram &dg);
+  bool read_datagram(const Datagram &dg, uint64_t offset);
+  int read_handle(Cursor &c);
+  void read_object(int type, const Cursor &c, size_t bytes, uint64_t offset);
+  void add_top_object(const TopObject &top);
+
+  template<class Record>
+  bool decode(const Cursor &start,
+              bool (BamStreamAnalyzer::*func)(Cursor &, Record &) const,
+              int &object_id, Record &record);
+
+  bool decode_vertex_data(Cursor &c, VertexData &vdata) const;
+  bool decode_array_data(Cursor &c, uint64_t &data_bytes) const;
+  bool decode_vertex_format(Cursor &c, VertexFormat &format) const;
+  bool decode_array_format(Cursor &c, ArrayFormat &format) const;
+  bool decode_internal_name(Cursor &c, std::string &name) const;
+  bool decode_texture(Cursor &c, TextureInfo &tex) const;
+
+  void get_type_order(pvector<const TypeInfo *> &types) const;
+  void get_format_summaries(FormatSummaries &summaries) const;
+  std::string describe_format(int format) const;
+  void get_texture_order(pvector<const TextureInfo *> &textures) const;
+  void get_top_order(TopObjects &top) const;
+  std::string get_type_name(int type) const;
+  static std::string describe_texture_size(const TextureInfo &tex);
+
+  int _max_top_objects;
+
+  Filename _filename;
+  int _file_major, _file_minor;
+  bool _file_big_endian;
+  bool _file_stdfloat_double;
+  bool _long_object_ids;
+  std::string _error;
+
+  uint64_t _file_bytes;
+  int _num_objects;
+  uint64_t _object_bytes;
+  int _num_file_data;
+  uint64_t _file_data_bytes;
+
+  Types _types;
+  ArrayFormats _array_formats;
+  VertexFormats _vertex_formats;
+  FormatUsages _format_usages;
+  PendingArrays _pending_arrays;
+  pmap<int, std::string> _internal_names;
+  Textures _textures;
+  TopObjects _top_objects;
+};
+
+#include "bamStreamAnalyzer.I"
+
+#endif
@@ -34,14 +34,63 @@
 #include "datagramIterator.h"
 #include "datagram.h"
 #include "virtualFileSystem.h"
+#include "jsonOutput.h"
+#include "workerPool.h"
+#include "trueClock.h"
+#include "mutexHolder.h"
+#include "eggData.h"
+#include "dSearchPath.h"
+#include "string_utils.h"
+#include "vector_string.h"
 
 /**
  *
  */
 EggToBam::TxoTexture::
 TxoTexture() {
-  _img_timestamp = 0;
-  _alpha_img_timestamp = 0;
+  _hashed = false;
+}
+
+/**
+ * Returns true if the other record describes the same txo file, made from the
+ * same source images with the same options.
+ */
+bool EggToBam::TxoTexture::
+matches(const TxoTexture &other) const {
+  return (_hashed && other._hashed &&
+          _txo_filename == other._txo_filename &&
+          _img_filename == other._img_filename &&
+          _img_hash == other._img_hash &&
+          _alpha_img_filename == other._alpha_img_filename &&
+          _alpha_img_hash == other._alpha_img_hash &&
+          _options == other._options);
+}
+
+/**
+ *
+ */
+EggToBam::TextureJob::
+TextureJob(Texture *tex) :
+  _tex(tex),
+  _cache_hit(false),
+  _wrote_txo(false),
+  _hash_time(0.0),
+  _load_time(0.0),
+  _mipmap_time(0.0),
+  _compress_time(0.0),
+  _write_time(0.0)
+{
+}
+
+/**
+ *
+ */
+EggToBam::ConvertResult::
+ConvertResult() :
+  _num_textures(0),
+  _num_txo_written(0),
+  _num_txo_cached(0)
+{
 }
 
 /**
@@ -49,7 +98,8 @@ TxoTexture() {
  */
 EggToBam::
 EggToBam() :
-  EggToSomething("Bam", ".bam", true, false)
+  EggToSomething("Bam", ".bam", true, false),
+  _texture_cvar(_texture_lock)
 {
   set_program_brief("convert .egg files to .bam files");
   set_program_description
@@ -201,11 +251,47 @@ EggToBam() :
 
   add_option
     ("txocache", "filename", 0,
-     "Specifies the filename to the .txo cache file.  This is used not not "
+     "Specifies the filename to the .txo cache file.  This is used not to "
      "write the same .txo file over and over again that is referenced by "
-     "multiple models.",
+     "multiple models.  A .txo file is rewritten only if the contents of its "
+     "source images, or the options it is converted with, have changed.",
      &EggToBam::dispatch_filename, &_got_txo_cache, &_txo_cache);
 
+  add_option
+    ("batch", "manifest", 0,
+     "Converts many egg files in one run, rather than just one, so that "
+     "startup is paid only once and textures shared between the egg files "
+     "are loaded and converted only once.  The manifest file lists one "
+     "conversion per line: the egg file to read and the bam file to write, "
+     "separated by whitespace, or by a tab if the filenames contain spaces.  "
+     "Blank lines and lines beginning with # are ignored.  If the manifest "
+     "is named -, it is read from standard input, and each conversion "
+     "starts as soon as its line arrives.  No egg file or output file should "
+     "be named on the command line with -batch.  Note that -pd is not "
+     "inferred from each output filename in this mode.",
+     &EggToBam::dispatch_filename, &_got_batch, &_batch_manifest);
+
+  add_option
+    ("batchlog", "filename", 0,
+     "Writes a machine-readable record of each conversion performed with "
+     "-batch to the indicated file, as one JSON object per line, in the "
+     "order the conversions finish.  The default is to write these records "
+     "to standard output.",
+     &EggToBam::dispatch_filename, &_got_batch_log, &_batch_log_filename);
+
+  add_option
+    ("j", "threads", 0,
+     "Process the textures using the indicated number of threads, when "
+     "using -rawtex or -txo.  With -batch, this is instead the number of egg "
+     "files converted at once.  The default is taken from the "
+     "pandatool-num-threads config variable."
+#ifndef HAVE_SQUISH
+     "  Since your Panda is not compiled with the libsquish library, "
+     "-ctex always uses one thread."
+#endif  // HAVE_SQUISH
+     ,
+     &EggToBam::dispatch_int, nullptr, &_num_threads);
+
   add_option
     ("load-display", "display name", 0,
      "Specifies the particular display module to load to perform the texture "
@@ -231,6 +317,13 @@ EggToBam() :
   _egg_suppress_hidden = 1;
   _tex_txopz = false;
   _ctex_quality = "best";
+  _num_threads = 0;
+  _txo_cache_modified = false;
+  _batch_in = nullptr;
+  _batch_log = nullptr;
+  _batch_line_number = 0;
+  _batch_num_jobs = 0;
+  _batch_num_failed = 0;
 }
 
 /**
@@ -269,18 +362,6 @@ run() {
     load_prc_file_data("prc", prc);
   }
 
-  if (!_got_coordinate_system) {
-    // If the user didn't specify otherwise, ensure the coordinate system is
-    // Z-up.
-    _data->set_coordinate_system(CS_zup_right);
-  }
-
-  PT(PandaNode) root = load_egg_data(_data);
-  if (root == nullptr) {
-    nout << "Unable to build scene graph from egg file.\n";
-    exit(1);
-  }
-
   if (_tex_ctex) {
 #ifndef HAVE_SQUISH
     if (!make_buffer()) {
@@ -290,160 +371,30 @@ run() {
 #endif  // HAVE_SQUISH
   }
 
-  bool cache_modified = false;
-
-  if (_tex_txo || _tex_txopz || (_tex_ctex && _tex_rawdata)) {
-    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
-
-    if ((_tex_txo || _tex_txopz) && _got_txo_cache) {
-      std::cerr << "Loading txo cache " << _txo_cache.get_fullpath() << "\n";
-      _txo_cache.set_binary();
-      vector_uchar data;
-      if (vfs->read_file(_txo_cache, data, true)) {
-        Datagram dg(data);
-        DatagramIterator di(dg);
-
-        uint32_t num_textures = di.get_uint32();
-        for (uint32_t i = 0; i < num_textures; i++) {
-          TxoTexture txo_tex;
-          txo_tex._txo_filename = di.get_string();
-          txo_tex._img_filename = di.get_string();
-          txo_tex._img_timestamp = di.get_uint64();
-          txo_tex._alpha_img_filename = di.get_string();
-          txo_tex._alpha_img_timestamp = di.get_uint64();
-          _txo_textures[txo_tex._txo_filename] = txo_tex;
-        }
-      }
-    }
-
-    collect_textures(root);
-    Textures::iterator ti;
-    for (ti = _textures.begin(); ti != _textures.end(); ++ti) {
-      Texture *tex = (*ti);
-
-      if (!_tex_rawdata && !tex->get_loaded_from_txo()) {
-        // Check if we've already written this txo in the past.
-
-        Filename txo_filename = tex->get_fullpath().get_filename_index(0);
-        txo_filename.set_extension(_tex_txopz ? "txo.pz" : "txo");
-        if (_tex_txopz) {
-          // We use this clumsy syntax so that the new extension appears to be two
-          // separate extensions, .txo followed by .pz, which is what
-          // Texture::write() expects to find.
-          txo_filename = Filename(txo_filename.get_fullpath());
-        }
-
-        TxoTextures::const_iterator it = _txo_textures.find(txo_filename);
-        if (it != _txo_textures.end()) {
-          // We have.  If the original image timestamps are the same, there is
-          // no need to write the txo again.
-          const TxoTexture &txo_tex = (*it).second;
-          if (txo_tex._img_timestamp == tex->get_fullpath().get_timestamp() &&
-              txo_tex._alpha_img_timestamp == tex->get_alpha_fullpath().get_timestamp()) {
-            // Everything is the same, don't write a txo.
-            std::cerr << txo_filename.get_fullpath() << " does not need to be rewritten.\n";
-
-            // Just modify the texture to reference the txo instead.
-            set_txo_data(tex, txo_tex);
-
-            continue;
-          }
-        }
-      }
-
-      tex->get_ram_image();
-      bool want_mipmaps = (_tex_mipmap || tex->uses_mipmaps());
-      if (want_mipmaps) {
-        // Generate mipmap levels.
-        tex->generate_ram_mipmap_images();
-      }
-
-      if (_tex_ctex) {
-#ifdef HAVE_SQUISH
-        if (!tex->compress_ram_image()) {
-          nout << "  couldn't compress " << tex->get_name() << "\n";
-        }
-        tex->set_compression(Texture::CM_on);
-#else  // HAVE_SQUISH
-        tex->set_keep_ram_image(true);
-        bool has_mipmap_levels = (tex->get_num_ram_mipmap_images() > 1);
-        if (!_engine->extract_texture_data(tex, _gsg)) {
-          nout << "  couldn't compress " << tex->get_name() << "\n";
-        }
-        if (!has_mipmap_levels && !want_mipmaps) {
-          // Make sure we didn't accidentally introduce mipmap levels by
-          // rendezvousing through the graphics card.
-          tex->clear_ram_mipmap_images();
-        }
-        tex->set_keep_ram_image(false);
-#endif  // HAVE_SQUISH
-      }
-
-      if ((_tex_txo || _tex_txopz) && !tex->get_loaded_from_txo()) {
-        TxoTexture txo_tex;
-        txo_tex._txo_filename = tex->get_fullpath().get_filename_index(0);
-        txo_tex._txo_filename.set_extension(_tex_txopz ? "txo.pz" : "txo");
-        if (_tex_txopz) {
-          // We use this clumsy syntax so that the new extension appears to be two
-          // separate extensions, .txo followed by .pz, which is what
-          // Texture::write() expects to find.
-          txo_tex._txo_filename = Filename(txo_tex._txo_filename.get_fullpath());
-        }
-        txo_tex._img_filename = tex->get_fullpath().get_filename_index(0);
-        txo_tex._img_timestamp = txo_tex._img_filename.get_timestamp();
-        txo_tex._alpha_img_filename = tex->get_alpha_fullpath().get_filename_index(0);
-        txo_tex._alpha_img_timestamp = txo_tex._alpha_img_filename.get_timestamp();
-        _txo_textures[txo_tex._txo_filename] = txo_tex;
-
-        cache_modified = true;
-
-        convert_txo(tex, txo_tex);
-      }
-    }
+  bool use_cache = ((_tex_txo || _tex_txopz) && _got_txo_cache);
+  if (use_cache) {
+    read_txo_cache();
+  }
 
-    if ((_tex_txo || _tex_txopz) && _got_txo_cache && cache_modified) {
-      std::cerr << "Writing txo cache " << _txo_cache.get_fullpath() << "\n";
-      _txo_cache.set_binary();
-
-      Datagram dg;
-      dg.add_uint32(_txo_textures.size());
-
-      for (TxoTextures::const_iterator it = _txo_textures.begin();
-           it != _txo_textures.end(); ++it) {
-        const TxoTexture &tex = (*it).second;
-        dg.add_string(tex._txo_filename.get_fullpath());
-        dg.add_string(tex._img_filename.get_fullpath());
-        dg.add_uint64(tex._img_timestamp);
-        dg.add_string(tex._alpha_img_filename.get_fullpath());
-        dg.add_uint64(tex._alpha_img_timestamp);
-      }
+  bool okflag;
+  if (_got_batch) {
+    run_batch();
+    okflag = (_batch_num_failed == 0);
 
-      if (!vfs->write_file(_txo_cache, (const unsigned char *)dg.get_data(),
-                           dg.get_length(), false)) {
-        std::cerr << "Couldn't write txo cache\n";
-      }
-    }
-  }
+  } else {
+    // This should be guaranteed because we pass false to the constructor,
+    // above.
+    nassertv(has_output_filename());
 
-  if (_ls) {
-    root->ls(nout, 0);
+    ConvertResult result;
+    okflag = convert_egg(_data, get_output_filename(), nout, result);
   }
 
-  // This should be guaranteed because we pass false to the constructor,
-  // above.
-  nassertv(has_output_filename());
-
-  Filename filename = get_output_filename();
-  filename.make_dir();
-  nout << "Writing " << filename << "\n";
-  BamFile bam_file;
-  if (!bam_file.open_write(filename)) {
-    nout << "Error in writing.\n";
-    exit(1);
+  if (use_cache && _txo_cache_modified) {
+    write_txo_cache();
   }
 
-  if (!bam_file.write_object(root)) {
-    nout << "Error in writing.\n";
+  if (!okflag) {
     exit(1);
   }
 }
@@ -470,27 +421,298 @@ handle_args(ProgramBase::Args &args) {
     _path_replace->_path_store = PS_absolute;
   }
 
+  if (_got_batch) {
+    // The egg files are named in the manifest instead.
+    if (!args.empty()) {
+      nout << "No egg file or output file may be named on the command line "
+           << "with -batch.\n";
+      return false;
+    }
+    return true;
+  }
+
   return EggToSomething::handle_args(args);
 }
 
+/**
+ * This is called after the command line has been completely processed, and
+ * it gives the program a chance to do some last-minute processing and
+ * validation of the options and arguments.  It should return true if
+ * everything is fine, false if there is an error.
+ */
+bool EggToBam::
+post_command_line() {
+  if (_got_batch) {
+    // There is no single egg file to read, or bam file to write, in -batch
+    // mode.
+    return EggBase::post_command_line();
+  }
+
+  return EggToSomething::post_command_line();
+}
+
+/**
+ * Builds the scene graph for the indicated egg data, processes its textures,
+ * and writes it to the indicated bam file.  Messages are written to out.
+ * Returns true on success, false on failure.
+ */
+bool EggToBam::
+convert_egg(EggData *data, const Filename &bam_filename, std::ostream &out,
+            ConvertResult &result) {
+  if (_got_coordinate_system) {
+    data->set_coordinate_system(_coordinate_system);
+  } else {
+    // If the user didn't specify otherwise, ensure the coordinate system is
+    // Z-up.
+    data->set_coordinate_system(CS_zup_right);
+  }
+
+  PT(PandaNode) root = load_egg_data(data);
+  if (root == nullptr) {
+    out << "Unable to build scene graph from egg file.\n";
+    return false;
+  }
+
+  if (_tex_txo || _tex_txopz || (_tex_ctex && _tex_rawdata)) {
+    Textures textures;
+    collect_textures(root, textures);
+    process_textures(textures, out, result);
+  }
+
+  if (_ls) {
+    root->ls(out, 0);
+  }
+
+  Filename filename = bam_filename;
+  filename.make_dir();
+  out << "Writing " << filename << "\n";
+  BamFile bam_file;
+  if (!bam_file.open_write(filename)) {
+    out << "Error in writing.\n";
+    return false;
+  }
+
+  if (!bam_file.write_object(root)) {
+    out << "Error in writing.\n";
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Performs all of the conversions listed in the -batch manifest.  Each
+ * thread takes the next line from the manifest as soon as it has finished
+ * its previous conversion.
+ */
+void EggToBam::
+run_batch() {
+  pifstream manifest_file;
+  if (_batch_manifest == "-") {
+    _batch_in = &std::cin;
+  } else {
+    _batch_manifest.set_text();
+    if (!_batch_manifest.open_read(manifest_file)) {
+      nout << "Cannot read " << _batch_manifest << "\n";
+      exit(1);
+    }
+    _batch_in = &manifest_file;
+  }
+
+  pofstream log_file;
+  if (_got_batch_log) {
+    _batch_log_filename.set_text();
+    _batch_log_filename.make_dir();
+    if (!_batch_log_filename.open_write(log_file)) {
+      nout << "Cannot write " << _batch_log_filename << "\n";
+      exit(1);
+    }
+    _batch_log = &log_file;
+  } else {
+    _batch_log = &std::cout;
+  }
+
+  _batch_line_number = 0;
+  _batch_num_jobs = 0;
+  _batch_num_failed = 0;
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  int num_threads = _num_threads;
+#ifndef HAVE_SQUISH
+  if (_tex_ctex) {
+    // The graphics context may only be used by one thread.
+    num_threads = 1;
+  }
+#endif  // HAVE_SQUISH
+
+  // Each job loads its egg file's textures.
+  WorkerPool::prepare_image_threads();
+
+  WorkerPool pool(num_threads);
+  pool.run(pool.get_num_threads(), [&](int) {
+    Filename egg_filename, bam_filename;
+    int line_number;
+    while (read_batch_job(egg_filename, bam_filename, line_number)) {
+      double job_start = clock->get_short_time();
+      std::ostringstream out;
+      ConvertResult result;
+
+      bool success = false;
+      if (bam_filename.empty()) {
+        out << "Expected an egg filename and a bam filename on line "
+            << line_number << " of " << _batch_manifest << ".\n";
+      } else {
+        PT(EggData) data = new EggData;
+        success = (load_batch_egg(egg_filename, data, out) &&
+                   convert_egg(data, bam_filename, out, result));
+      }
+
+      report_batch_job(line_number, egg_filename, bam_filename, success,
+                       clock->get_short_time() - job_start, out.str(),
+                       result);
+    }
+  });
+
+  nout << "Converted " << _batch_num_jobs - _batch_num_failed << " of "
+       << _batch_num_jobs << " egg files in " << clock->get_short_time() - start
+       << " s with " << pool.get_num_threads() << " threads";
+  if (_batch_num_failed != 0) {
+    nout << "; " << _batch_num_failed << " failed";
+  }
+  nout << ".\n";
+
+  _batch_in = nullptr;
+  _batch_log = nullptr;
+}
+
+/**
+ * Reads the next conversion from the -batch manifest.  Returns true if there
+ * is one, or false if the manifest has been exhausted.  If the line can't be
+ * understood, bam_filename is left empty.
+ */
+bool EggToBam::
+read_batch_job(Filename &egg_filename, Filename &bam_filename,
+               int &line_number) {
+  MutexHolder holder(_batch_lock);
+
+  std::string line;
+  while (std::getline(*_batch_in, line)) {
+    ++_batch_line_number;
+    line = trim(line);
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    vector_string words;
+    tokenize(line, words, (line.find('\t') != std::string::npos) ? "\t" : " ", true);
+
+    egg_filename = Filename();
+    bam_filename = Filename();
+    if (!words.empty()) {
+      egg_filename = Filename::from_os_specific(trim(words[0]));
+    }
+    if (words.size() == 2) {
+      bam_filename = Filename::from_os_specific(trim(words[1]));
+    }
+
+    line_number = _batch_line_number;
+    ++_batch_num_jobs;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Reads the indicated egg file for -batch, and prepares it in the same way
+ * that EggReader prepares an egg file named on the command line.  Returns
+ * true on success, false on failure.
+ */
+bool EggToBam::
+load_batch_egg(const Filename &egg_filename, EggData *data,
+               std::ostream &out) const {
+  if (!data->read(egg_filename)) {
+    out << "Unable to read " << egg_filename << "\n";
+    return false;
+  }
+
+  if (_noabs && data->original_had_absolute_pathnames()) {
+    out << egg_filename.get_basename()
+        << " includes absolute pathnames!\n";
+    return false;
+  }
+
+  DSearchPath file_path;
+  file_path.append_directory(egg_filename.get_dirname());
+
+  if (_force_complete) {
+    if (!data->load_externals(file_path)) {
+      out << "Unable to load external references from " << egg_filename << "\n";
+      return false;
+    }
+  }
+
+  // Now resolve the filenames again according to the user's specified
+  // _path_replace.
+  convert_paths(data, _path_replace, file_path);
+
+  return true;
+}
+
+/**
+ * Reports the outcome of one -batch conversion, both to the user and to the
+ * -batchlog.
+ */
+void EggToBam::
+report_batch_job(int line_number, const Filename &egg_filename,
+                 const Filename &bam_filename, bool success, double elapsed,
+                 const std::string &messages, const ConvertResult &result) {
+  MutexHolder holder(_batch_lock);
+
+  nout << messages;
+  if (!success) {
+    ++_batch_num_failed;
+    nout << "Failed to convert " << egg_filename << "\n";
+  }
+
+  std::ostream &log = *_batch_log;
+  log << "{\"line\": " << line_number << ", \"egg\": ";
+  write_json_string(log, egg_filename.to_os_specific());
+  log << ", \"bam\": ";
+  write_json_string(log, bam_filename.to_os_specific());
+  log << ", \"status\": \"" << (success ? "ok" : "failed") << "\""
+      << ", \"seconds\": " << elapsed
+      << ", \"textures\": " << result._num_textures
+      << ", \"txo_written\": " << result._num_txo_written
+      << ", \"txo_cached\": " << result._num_txo_cached;
+  if (!success) {
+    log << ", \"messages\": ";
+    write_json_string(log, messages);
+  }
+  log << "}\n" << std::flush;
+}
+
+
 /**
  * Recursively walks the scene graph, looking for Texture references.
  */
 void EggToBam::
-collect_textures(PandaNode *node) {
-  collect_textures(node->get_state());
+collect_textures(PandaNode *node, Textures &textures) {
+  collect_textures(node->get_state(), textures);
   if (node->is_geom_node()) {
     GeomNode *geom_node = DCAST(GeomNode, node);
     int num_geoms = geom_node->get_num_geoms();
     for (int i = 0; i < num_geoms; ++i) {
-      collect_textures(geom_node->get_geom_state(i));
+      collect_textures(geom_node->get_geom_state(i), textures);
     }
   }
 
   PandaNode::Children children = node->get_children();
   int num_children = children.get_num_children();
   for (int i = 0; i < num_children; ++i) {
-    collect_textures(children.get_child(i));
+    collect_textures(children.get_child(i), textures);
   }
 }
 
@@ -498,37 +720,377 @@ collect_textures(PandaNode *node) {
  * Recursively walks the scene graph, looking for Texture references.
  */
 void EggToBam::
-collect_textures(const RenderState *state) {
+collect_textures(const RenderState *state, Textures &textures) {
   const TextureAttrib *tex_attrib = DCAST(TextureAttrib, state->get_attrib(TextureAttrib::get_class_type()));
   if (tex_attrib != nullptr) {
     int num_on_stages = tex_attrib->get_num_on_stages();
     for (int i = 0; i < num_on_stages; ++i) {
-      _textures.insert(tex_attrib->get_on_texture(tex_attrib->get_on_stage(i)));
+      textures.insert(tex_attrib->get_on_texture(tex_attrib->get_on_stage(i)));
     }
   }
 }
 
 /**
- * If the indicated Texture was not already loaded from a txo file, writes it
- * to a txo file and updates the Texture object to reference the new file.
+ * Reads the records of the txo files written by previous runs from the
+ * -txocache file.
+ */
+void EggToBam::
+read_txo_cache() {
+  std::cerr << "Loading txo cache " << _txo_cache.get_fullpath() << "\n";
+  _txo_cache.set_binary();
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  vector_uchar data;
+  if (!vfs->read_file(_txo_cache, data, true)) {
+    return;
+  }
+
+  Datagram dg(data);
+  DatagramIterator di(dg);
+
+  // Caches written before the records were keyed by content hash won't have
+  // this header, and those of version 1 kept a shorter hash.  They are simply
+  // discarded.
+  if (di.get_remaining_size() < 8 || di.get_fixed_string(4) != "txoc" ||
+      di.get_uint32() != 2) {
+    std::cerr << "Ignoring txo cache in an old format.\n";
+    return;
+  }
+
+  uint32_t num_textures = di.get_uint32();
+  for (uint32_t i = 0; i < num_textures; i++) {
+    TxoTexture txo_tex;
+    txo_tex._txo_filename = di.get_string();
+    txo_tex._img_filename = di.get_string();
+    txo_tex._img_hash.read_datagram(di);
+    txo_tex._alpha_img_filename = di.get_string();
+    txo_tex._alpha_img_hash.read_datagram(di);
+    txo_tex._options = di.get_string();
+    txo_tex._hashed = true;
+    _txo_textures[txo_tex._txo_filename] = txo_tex;
+  }
+}
+
+/**
+ * Writes the records of all the txo files we know about to the -txocache
+ * file.
+ */
+void EggToBam::
+write_txo_cache() {
+  std::cerr << "Writing txo cache " << _txo_cache.get_fullpath() << "\n";
+  _txo_cache.set_binary();
+
+  Datagram dg;
+  dg.append_data("txoc", 4);
+  dg.add_uint32(2);
+  dg.add_uint32(_txo_textures.size());
+
+  for (TxoTextures::const_iterator it = _txo_textures.begin();
+       it != _txo_textures.end(); ++it) {
+    const TxoTexture &tex = (*it).second;
+    dg.add_string(tex._txo_filename.get_fullpath());
+    dg.add_string(tex._img_filename.get_fullpath());
+    tex._img_hash.write_datagram(dg);
+    dg.add_string(tex._alpha_img_filename.get_fullpath());
+    tex._alpha_img_hash.write_datagram(dg);
+    dg.add_string(tex._options);
+  }
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  if (!vfs->write_file(_txo_cache, (const unsigned char *)dg.get_data(),
+                       dg.get_length(), false)) {
+    std::cerr << "Couldn't write txo cache\n";
+  }
+}
+
+/**
+ * Loads, mipmaps, compresses and writes out each of the indicated textures,
+ * as requested by the command-line options.  The textures are processed in
+ * parallel.  Messages are written to out, and the results are tallied in
+ * result.
+ *
+ * In -batch mode, this may be called by several threads at once.  Since the
+ * textures come from the TexturePool, an image shared by several egg files is
+ * the same Texture object in each of them; it is processed only by the first
+ * thread to claim it, and the others wait for it to be finished.
  */
 void EggToBam::
-convert_txo(Texture *tex, const TxoTexture &txo_tex) {
-  if (tex->write(txo_tex._txo_filename)) {
-    nout << "  Writing " << txo_tex._txo_filename;
-    if (tex->get_ram_image_compression() != Texture::CM_off) {
-      nout << " (compressed " << tex->get_ram_image_compression() << ")";
+process_textures(const Textures &textures, std::ostream &out,
+                 ConvertResult &result) {
+  TextureJobs jobs;
+  pvector<Texture *> others;
+  {
+    MutexHolder holder(_texture_lock);
+    for (Texture *tex : textures) {
+      if (_texture_states.insert(TextureStates::value_type(tex, TS_processing)).second) {
+        jobs.push_back(TextureJob(tex));
+      } else {
+        others.push_back(tex);
+      }
     }
-    nout << "\n";
-    set_txo_data(tex, txo_tex);
+  }
+
+  // In -batch mode, the parallelism comes from converting several egg files
+  // at once instead.
+  int num_threads = _got_batch ? 1 : _num_threads;
+#ifndef HAVE_SQUISH
+  if (_tex_ctex) {
+    // The graphics context may only be used by one thread.
+    num_threads = 1;
+  }
+#endif  // HAVE_SQUISH
+
+  // The jobs load the texture images.
+  WorkerPool::prepare_image_threads();
+
+  WorkerPool pool(num_threads);
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  pool.run((int)jobs.size(), [&](int i) {
+    process_texture(jobs[i]);
+  });
+
+  {
+    // Record the new txo files, and wait for any textures that are being
+    // processed on behalf of another egg file.
+    MutexHolder holder(_texture_lock);
+    for (const TextureJob &job : jobs) {
+      if (job._wrote_txo && job._txo_tex._hashed) {
+        _txo_textures[job._txo_tex._txo_filename] = job._txo_tex;
+        _txo_cache_modified = true;
+      }
+      _texture_states[job._tex] = TS_done;
+    }
+    if (!jobs.empty()) {
+      _texture_cvar.notify_all();
+    }
+    for (Texture *tex : others) {
+      while (_texture_states[tex] != TS_done) {
+        _texture_cvar.wait();
+      }
+    }
+  }
+
+  double elapsed = clock->get_short_time() - start;
+
+  if (_got_batch && (_tex_txo || _tex_txopz) && !_tex_rawdata) {
+    // Each texture now references its txo file, and nothing more is needed
+    // from its image; drop it, so that memory doesn't fill up with the
+    // textures of every egg file in the manifest.
+    for (const TextureJob &job : jobs) {
+      if (job._tex->get_loaded_from_txo()) {
+        job._tex->clear_ram_image();
+      }
+    }
+  }
+
+  // Now report the results, in order.
+  int num_cache_hits = 0;
+  double hash_time = 0.0, load_time = 0.0, mipmap_time = 0.0;
+  double compress_time = 0.0, write_time = 0.0;
+  for (const TextureJob &job : jobs) {
+    out << job._messages;
+    if (job._cache_hit) {
+      ++num_cache_hits;
+    }
+    if (job._wrote_txo) {
+      ++result._num_txo_written;
+    }
+    hash_time += job._hash_time;
+    load_time += job._load_time;
+    mipmap_time += job._mipmap_time;
+    compress_time += job._compress_time;
+    write_time += job._write_time;
+  }
+  result._num_textures += (int)textures.size();
+  result._num_txo_cached += num_cache_hits;
+
+  if (!jobs.empty()) {
+    out << "Processed " << jobs.size() << " textures in " << elapsed
+        << " s with " << pool.get_num_threads() << " threads";
+    if (_got_txo_cache) {
+      out << ", " << num_cache_hits << " found in txo cache";
+    }
+    if (!others.empty()) {
+      out << ", " << others.size() << " shared with other egg files";
+    }
+    out << ".\n  Time per stage (summed over threads): hash "
+        << hash_time << " s, load " << load_time << " s, mipmap "
+        << mipmap_time << " s, compress " << compress_time << " s, write "
+        << write_time << " s\n";
   }
 }
 
+/**
+ * Does the work on a single texture.  This may be called from several
+ * threads at once, for different textures, so it records its results in the
+ * job rather than modifying this object.
+ */
+void EggToBam::
+process_texture(TextureJob &job) const {
+  Texture *tex = job._tex;
+  TxoTexture &txo_tex = job._txo_tex;
+  std::ostringstream out;
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  double now;
+
+  bool want_mipmaps = (_tex_mipmap || tex->uses_mipmaps());
+  bool want_txo = ((_tex_txo || _tex_txopz) && !tex->get_loaded_from_txo());
+
+  if (want_txo) {
+    txo_tex._txo_filename = get_txo_filename(tex);
+    txo_tex._img_filename = tex->get_fullpath().get_filename_index(0);
+    txo_tex._alpha_img_filename = tex->get_alpha_fullpath().get_filename_index(0);
+    txo_tex._options = get_txo_options(tex, want_mipmaps);
+
+    if (_got_txo_cache) {
+      // The contents of the source images are only needed to check against
+      // the cache.
+      txo_tex._hashed =
+        hash_image(txo_tex._img_filename, txo_tex._img_hash) &&
+        hash_image(txo_tex._alpha_img_filename, txo_tex._alpha_img_hash);
+      if (!txo_tex._hashed) {
+        out << "Unable to read the source images of "
+            << txo_tex._txo_filename.get_fullpath()
+            << "; it will not be cached.\n";
+      }
+      now = clock->get_short_time();
+      job._hash_time = now - start;
+      start = now;
+    }
+
+    if (!_tex_rawdata) {
+      // Check if we've already written this txo in the past.
+      bool cached = false;
+      {
+        MutexHolder holder(_texture_lock);
+        TxoTextures::const_iterator it = _txo_textures.find(txo_tex._txo_filename);
+        cached = (it != _txo_textures.end() && (*it).second.matches(txo_tex));
+      }
+      if (cached &&
+          VirtualFileSystem::get_global_ptr()->exists(txo_tex._txo_filename)) {
+        // We have, from the same images with the same options, so there is
+        // no need to write it again.
+        out << txo_tex._txo_filename.get_fullpath() << " does not need to be rewritten.\n";
+
+        // Just modify the texture to reference the txo instead.
+        set_txo_data(tex, txo_tex);
+        job._cache_hit = true;
+        job._messages = out.str();
+        return;
+      }
+    }
+  }
+
+  tex->get_ram_image();
+  now = clock->get_short_time();
+  job._load_time = now - start;
+  start = now;
+
+  if (want_mipmaps) {
+    // Generate mipmap levels.
+    tex->generate_ram_mipmap_images();
+    now = clock->get_short_time();
+    job._mipmap_time = now - start;
+    start = now;
+  }
+
+  if (_tex_ctex) {
+#ifdef HAVE_SQUISH
+    if (!tex->compress_ram_image()) {
+      out << "  couldn't compress " << tex->get_name() << "\n";
+    }
+    tex->set_compression(Texture::CM_on);
+#else  // HAVE_SQUISH
+    tex->set_keep_ram_image(true);
+    bool has_mipmap_levels = (tex->get_num_ram_mipmap_images() > 1);
+    if (!_engine->extract_texture_data(tex, _gsg)) {
+      out << "  couldn't compress " << tex->get_name() << "\n";
+    }
+    if (!has_mipmap_levels && !want_mipmaps) {
+      // Make sure we didn't accidentally introduce mipmap levels by
+      // rendezvousing through the graphics card.
+      tex->clear_ram_mipmap_images();
+    }
+    tex->set_keep_ram_image(false);
+#endif  // HAVE_SQUISH
+    now = clock->get_short_time();
+    job._compress_time = now - start;
+    start = now;
+  }
+
+  if (want_txo) {
+    job._wrote_txo = convert_txo(tex, txo_tex, out);
+    job._write_time = clock->get_short_time() - start;
+  }
+
+  job._messages = out.str();
+}
+
+/**
+ * Returns the name of the txo file that should be written for the indicated
+ * texture.
+ */
+Filename EggToBam::
+get_txo_filename(Texture *tex) const {
+  Filename txo_filename = tex->get_fullpath().get_filename_index(0);
+  txo_filename.set_extension(_tex_txopz ? "txo.pz" : "txo");
+  if (_tex_txopz) {
+    // We use this clumsy syntax so that the new extension appears to be two
+    // separate extensions, .txo followed by .pz, which is what
+    // Texture::write() expects to find.
+    txo_filename = Filename(txo_filename.get_fullpath());
+  }
+  return txo_filename;
+}
+
+/**
+ * Returns a string describing the settings that affect the contents of the
+ * txo file written for the indicated texture, other than the source images
+ * themselves.
+ */
+std::string EggToBam::
+get_txo_options(Texture *tex, bool want_mipmaps) const {
+  std::ostringstream strm;
+  strm << "mipmap " << want_mipmaps
+       << " ctex " << _tex_ctex << " " << _ctex_quality
+       << " format " << tex->get_format()
+       << " type " << tex->get_component_type()
+       << " compression " << tex->get_compression()
+       << " quality " << tex->get_quality_level()
+       << " sampler " << tex->get_default_sampler();
+  return strm.str();
+}
+
+/**
+ * Writes the indicated Texture, which was not already loaded from a txo file,
+ * to a txo file and updates the Texture object to reference the new file.
+ * Returns true on success.
+ */
+bool EggToBam::
+convert_txo(Texture *tex, const TxoTexture &txo_tex, std::ostream &out) const {
+  if (!tex->write(txo_tex._txo_filename)) {
+    return false;
+  }
+
+  out << "  Writing " << txo_tex._txo_filename;
+  if (tex->get_ram_image_compression() != Texture::CM_off) {
+    out << " (compressed " << tex->get_ram_image_compression() << ")";
+  }
+  out << "\n";
+  set_txo_data(tex, txo_tex);
+  return true;
+}
+
 /**
  * Changes the indicated Texture to reference the .txo file.
  */
 void EggToBam::
-set_txo_data(Texture *tex, const TxoTexture &txo_tex) {
+set_txo_data(Texture *tex, const TxoTexture &txo_tex) const {
   tex->set_loaded_from_txo();
   tex->set_fullpath(txo_tex._txo_filename);
   tex->clear_alpha_fullpath();
@@ -545,6 +1107,34 @@ set_txo_data(Texture *tex, const TxoTexture &txo_tex) {
   tex->clear_alpha_filename();
 }
 
+/**
+ * Computes the hash of the indicated source image for the txo cache.  An
+ * empty filename, for a texture that has no such image, leaves the hash
+ * cleared.  Returns true on success, false if the file can't be read.
+ *
+ * Without OpenSSL, the contents can't be hashed, and the file's timestamp is
+ * recorded in the hash instead, as the cache did before it was keyed by
+ * content.
+ */
+bool EggToBam::
+hash_image(const Filename &filename, HashVal &hash) {
+  hash = HashVal();
+  if (filename.empty()) {
+    return true;
+  }
+#ifdef HAVE_OPENSSL
+  return hash.hash_file(filename);
+#else
+  uint64_t timestamp = (uint64_t)filename.get_timestamp();
+  if (timestamp == 0) {
+    return false;
+  }
+  hash.set_value(0, (uint32_t)timestamp);
+  hash.set_value(1, (uint32_t)(timestamp >> 32));
+  return true;
+#endif  // HAVE_OPENSSL
+}
+
 /**
  * Creates a GraphicsBuffer for communicating with the graphics card.
  */
@@ -18,9 +18,15 @@
 
 #include "eggToSomething.h"
 #include "pset.h"
+#include "pvector.h"
+#include "pmap.h"
+#include "pmutex.h"
+#include "hashVal.h"
+#include "conditionVarFull.h"
 #include "graphicsPipe.h"
 
 class PandaNode;
+class EggData;
 class RenderState;
 class Texture;
 class GraphicsEngine;
@@ -38,33 +44,106 @@ public:
 
 protected:
   virtual bool handle_args(Args &args);
+  virtual bool post_command_line();
 
 private:
   class TxoTexture {
   public:
     TxoTexture();
+    bool matches(const TxoTexture &other) const;
 
     Filename _txo_filename;
 
+    // The txo file is rewritten unless the source images have the same
+    // contents (or, without OpenSSL, the same timestamps), and the texture is
+    // converted with the same options, as when it was last written.
     Filename _img_filename;
-    time_t _img_timestamp;
+    HashVal _img_hash;
     Filename _alpha_img_filename;
-    time_t _alpha_img_timestamp;
+    HashVal _alpha_img_hash;
+    std::string _options;
+
+    // False if the source images couldn't be hashed; such a record never
+    // matches another.
+    bool _hashed;
+  };
+
+  // The work done on one texture by process_textures().
+  class TextureJob {
+  public:
+    TextureJob(Texture *tex);
+
+    Texture *_tex;
+    bool _cache_hit;
+    bool _wrote_txo;
+    TxoTexture _txo_tex;
+    std::string _messages;
+
+    // The time spent on each stage, in seconds.
+    double _hash_time;
+    double _load_time;
+    double _mipmap_time;
+    double _compress_time;
+    double _write_time;
   };
+  typedef pvector<TextureJob> TextureJobs;
 
-  void collect_textures(PandaNode *node);
-  void collect_textures(const RenderState *state);
-  void convert_txo(Texture *tex, const TxoTexture &txo_tex);
-  void set_txo_data(Texture *tex, const TxoTexture &txo_tex);
+  typedef pset<Texture *> Textures;
+
+  // The results of converting one egg file, for the -batch log.
+  class ConvertResult {
+  public:
+    ConvertResult();
+
+    int _num_textures;
+    int _num_txo_written;
+    int _num_txo_cached;
+  };
+
+  bool convert_egg(EggData *data, const Filename &bam_filename,
+                   std::ostream &out, ConvertResult &result);
+  void run_batch();
+  bool read_batch_job(Filename &egg_filename, Filename &bam_filename,
+                      int &line_number);
+  bool load_batch_egg(const Filename &egg_filename, EggData *data,
+                      std::ostream &out) const;
+  void report_batch_job(int line_number, const Filename &egg_filename,
+                        const Filename &bam_filename, bool success,
+                        double elapsed, const std::string &messages,
+                        const ConvertResult &result);
+
+  void collect_textures(PandaNode *node, Textures &textures);
+  void collect_textures(const RenderState *state, Textures &textures);
+  void read_txo_cache();
+  void write_txo_cache();
+  void process_textures(const Textures &textures, std::ostream &out,
+                        ConvertResult &result);
+  void process_texture(TextureJob &job) const;
+  Filename get_txo_filename(Texture *tex) const;
+  std::string get_txo_options(Texture *tex, bool want_mipmaps) const;
+  bool convert_txo(Texture *tex, const TxoTexture &txo_tex,
+                   std::ostream &out) const;
+  void set_txo_data(Texture *tex, const TxoTexture &txo_tex) const;
+  static bool hash_image(const Filename &filename, HashVal &hash);
 
   bool make_buffer();
 
 private:
-  typedef pset<Texture *> Textures;
-  Textures _textures;
-
   typedef pmap<Filename, TxoTexture> TxoTextures;
   TxoTextures _txo_textures;
+  bool _txo_cache_modified;
+
+  // Textures are shared by all the egg files converted in one run, by way of
+  // the TexturePool, so we make sure that each is processed only once, even
+  // by jobs running at the same time.  This also protects _txo_textures.
+  enum TextureState {
+    TS_processing,
+    TS_done,
+  };
+  typedef pmap<Texture *, TextureState> TextureStates;
+  TextureStates _texture_states;
+  mutable Mutex _texture_lock;
+  ConditionVarFull _texture_cvar;
 
   bool _has_egg_flatten;
   int _egg_flatten;
@@ -84,6 +163,19 @@ private:
   std::string _load_display;
   Filename _txo_cache;
   bool _got_txo_cache;
+  int _num_threads;
+
+  // These support -batch.
+  bool _got_batch;
+  Filename _batch_manifest;
+  bool _got_batch_log;
+  Filename _batch_log_filename;
+  std::istream *_batch_in;
+  std::ostream *_batch_log;
+  int _batch_line_number;
+  int _batch_num_jobs;
+  int _batch_num_failed;
+  Mutex _batch_lock;
 
   // The rest of this is required to support -ctex.
   PT(GraphicsPipe) _pipe;
@@ -0,0 +1,117 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file ptsNumber.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "ptsNumber.h"
+#include "string_utils.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+
+using std::string;
+
+/**
+ * Parses the next word on the line as a number, and advances p past it.
+ * Sets found to false if there are no more words.  As with
+ * string_to_double(), anything following the number within the word is
+ * ignored.
+ *
+ * This is much faster than strtod(), since it doesn't deal with the locale
+ * or round the last digit exactly, which doesn't matter for the
+ * single-precision coordinates of a point cloud.
+ */
+double
+parse_pts_number(const char *&p, const char *eol, bool &found) {
+  static const double powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+
+  while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) {
+    ++p;
+  }
+  if (p == eol) {
+    found = false;
+    return 0.0;
+  }
+  found = true;
+  const char *word = p;
+
+  bool negative = false;
+  if (*p == '-' || *p == '+') {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  // Collect up to 18 significant digits in an integer, and keep track of
+  // the power of ten by which it must be scaled.
+  uint64_t mantissa = 0;
+  int exponent = 0;
+  bool any_digits = false;
+  while (p < eol && isdigit((unsigned char)*p)) {
+    if (mantissa < 100000000000000000ull) {
+      mantissa = mantissa * 10 + (*p - '0');
+    } else {
+      ++exponent;
+    }
+    any_digits = true;
+    ++p;
+  }
+  if (p < eol && *p == '.') {
+    ++p;
+    while (p < eol && isdigit((unsigned char)*p)) {
+      if (mantissa < 100000000000000000ull) {
+        mantissa = mantissa * 10 + (*p - '0');
+        --exponent;
+      }
+      any_digits = true;
+      ++p;
+    }
+  }
+
+  if (any_digits && p < eol && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    bool negative_exponent = false;
+    if (q < eol && (*q == '-' || *q == '+')) {
+      negative_exponent = (*q == '-');
+      ++q;
+    }
+    if (q < eol && isdigit((unsigned char)*q)) {
+      int e = 0;
+      while (q < eol && isdigit((unsigned char)*q)) {
+        e = std::min(e * 10 + (*q - '0'), 10000);
+        ++q;
+      }
+      exponent += negative_exponent ? -e : e;
+      p = q;
+    }
+  }
+
+  while (p < eol && *p != ' ' && *p != '\t' && *p != '\r') {
+    ++p;
+  }
+
+  if (!any_digits) {
+    // Something unusual, like "nan".  Let the library deal with it.
+    string tail;
+    return string_to_double(string(word, p), tail);
+  }
+
+  double value = (double)mantissa;
+  if (exponent > 0) {
+    value *= (exponent <= 22) ? powers_of_ten[exponent] : pow(10.0, exponent);
+  } else if (exponent < 0) {
+    value /= (exponent >= -22) ? powers_of_ten[-exponent] : pow(10.0, -exponent);
+  }
+  return negative ? -value : value;
+}
@@ -15,13 +15,26 @@
 
 #include "config_putil.h"
 #include "geomPoints.h"
+#include "geomVertexData.h"
+#include "geomVertexWriter.h"
 #include "bamFile.h"
 #include "pandaNode.h"
 #include "geomNode.h"
+#include "mappedFile.h"
+#include "ptsNumber.h"
+#include "virtualFileSystem.h"
+#include "workerPool.h"
+#include "vector_string.h"
 #include "dcast.h"
 #include "string_utils.h"
 #include "config_egg2pg.h"
 
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
 using std::string;
 
 /**
@@ -53,7 +66,31 @@ PtsToBam() : WithOutputFile(true, false, true)
      "points.",
      &PtsToBam::dispatch_double, nullptr, &_decimate_divisor);
 
+  add_option
+    ("voxel", "size", 0,
+     "Decimates the point cloud by keeping only the first point found within "
+     "each cube of the indicated size.  Unlike -d, this thins out the dense "
+     "parts of the cloud while leaving the sparse parts alone.",
+     &PtsToBam::dispatch_double, &_got_voxel_size, &_voxel_size);
+
+  add_option
+    ("tile", "n", 0,
+     "Divides the point cloud into an octree of spatial tiles, each with at "
+     "most n points, and puts each tile in its own GeomNode, so that the "
+     "parts of a large cloud that are offscreen can be culled.",
+     &PtsToBam::dispatch_int, &_got_tile_size, &_tile_size);
+
+  add_option
+    ("j", "threads", 0,
+     "Parse the pts file using the indicated number of threads.  The default "
+     "is taken from the pandatool-num-threads config variable.  The output is "
+     "the same regardless of the number of threads.",
+     &PtsToBam::dispatch_int, nullptr, &_num_threads);
+
   _decimate_divisor = 1.0;
+  _voxel_size = 0.0;
+  _tile_size = 0;
+  _num_threads = 0;
 }
 
 /**
@@ -61,31 +98,150 @@ PtsToBam() : WithOutputFile(true, false, true)
  */
 void PtsToBam::
 run() {
-  pifstream pts;
-  _pts_filename.set_text();
-  if (!_pts_filename.open_read(pts)) {
-    nout << "Cannot open " << _pts_filename << "\n";
+  if (_got_voxel_size && _voxel_size <= 0.0) {
+    nout << "Invalid voxel size: " << _voxel_size << "\n";
+    exit(1);
+  }
+  if (_got_tile_size && _tile_size < 1) {
+    nout << "Invalid tile size: " << _tile_size << "\n";
     exit(1);
   }
 
-  _gnode = new GeomNode(_pts_filename.get_basename());
+  // Map the file into memory if we can, so that the threads can parse it
+  // directly.  Otherwise, for instance if it's compressed, read the whole
+  // thing through the vfs.
+  MappedFile mapped;
+  string contents;
+  const char *data;
+  size_t size;
+  if (mapped.open(_pts_filename)) {
+    data = mapped.get_data();
+    size = mapped.get_size();
+  } else {
+    VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+    if (!vfs->read_file(_pts_filename, contents, true)) {
+      nout << "Cannot open " << _pts_filename << "\n";
+      exit(1);
+    }
+    data = contents.data();
+    size = contents.size();
+  }
 
-  _num_points_expected = 0;
-  _num_points_found = 0;
-  _num_points_added = 0;
   _decimate_factor = 1.0 / std::max(1.0, _decimate_divisor);
-  _line_number = 0;
-  _point_number = 0;
-  _decimated_point_number = 0.0;
-  _num_vdatas = 0;
-  string line;
-  while (std::getline(pts, line)) {
-    process_line(line);
+  const char *begin = read_header(data, data + size);
+
+  WorkerPool pool(_num_threads);
+  make_chunks(begin, data + size, pool.get_num_threads());
+  int num_chunks = (int)_chunks.size();
+
+  if (_decimate_factor < 1.0) {
+    // The stride decimation depends on the index of each point within the
+    // whole file, so we must first count the points in each chunk.
+    pool.run(num_chunks, [&](int i) {
+      count_points(_chunks[i]);
+    });
+    uint64_t num_points = 0;
+    for (Chunk &chunk : _chunks) {
+      chunk._first_point = num_points;
+      num_points += chunk._num_points_found;
+    }
+  }
+
+  pool.run(num_chunks, [&](int i) {
+    parse_chunk(_chunks[i]);
+  });
+
+  uint64_t num_points_found = 0;
+  for (const Chunk &chunk : _chunks) {
+    num_points_found += chunk._num_points_found;
+  }
+
+  // The file contents are no longer needed once the chunks are parsed.
+  mapped.close();
+  string().swap(contents);
+
+  Points points;
+  merge_chunks(points);
+  _chunks.clear();
+
+  nout << "Found " << num_points_found << " points of "
+       << _num_points_expected << " expected.\n";
+
+  // Divide the points into tiles, or put them all into one.
+  _tiles.clear();
+  if (_got_tile_size && !points.empty()) {
+    LPoint3 min_point = points[0];
+    LPoint3 max_point = points[0];
+    for (const LPoint3 &point : points) {
+      min_point = min_point.fmin(point);
+      max_point = max_point.fmax(point);
+    }
+    make_tiles(points, 0, points.size(), min_point, max_point, "tile", 0);
+  } else {
+    Tile tile;
+    tile._name = _pts_filename.get_basename();
+    tile._begin = 0;
+    tile._end = points.size();
+    _tiles.push_back(tile);
+  }
+
+  // Each tile gets one Geom for every egg_max_vertices points.  These are all
+  // independent, so they can be built in parallel.
+  Pieces pieces;
+  size_t max_vertices = std::max((int)egg_max_vertices, 1);
+  for (size_t ti = 0; ti < _tiles.size(); ++ti) {
+    for (size_t pi = _tiles[ti]._begin; pi < _tiles[ti]._end; pi += max_vertices) {
+      Piece piece;
+      piece._tile = ti;
+      piece._begin = pi;
+      piece._end = std::min(pi + max_vertices, _tiles[ti]._end);
+      pieces.push_back(piece);
+    }
   }
-  close_vertex_data();
 
-  nout << "\nFound " << _num_points_found << " points of " << _num_points_expected << " expected.\n";
-  nout << "Generated " << _num_points_added << " points to bam file.\n";
+  // The pieces are built a batch at a time, starting from the end, and the
+  // points each batch has consumed are released before the next, so that
+  // the points and the finished Geoms are never both held in full.
+  size_t batch_size = (size_t)pool.get_num_threads() * 4;
+  size_t batch_end = pieces.size();
+  while (batch_end > 0) {
+    size_t batch_begin = (batch_end > batch_size) ? batch_end - batch_size : 0;
+    pool.run((int)(batch_end - batch_begin), [&](int i) {
+      Piece &piece = pieces[batch_begin + i];
+      piece._geom = make_geom(points, piece._begin, piece._end);
+    });
+    points.resize(pieces[batch_begin]._begin);
+    points.shrink_to_fit();
+    batch_end = batch_begin;
+  }
+
+  pvector<PT(GeomNode)> gnodes;
+  for (const Tile &tile : _tiles) {
+    gnodes.push_back(new GeomNode(tile._name));
+  }
+  for (const Piece &piece : pieces) {
+    gnodes[piece._tile]->add_geom(piece._geom);
+  }
+
+  PT(PandaNode) root;
+  if (_got_tile_size) {
+    root = new PandaNode(_pts_filename.get_basename());
+    for (GeomNode *gnode : gnodes) {
+      root->add_child(gnode);
+    }
+  } else {
+    root = gnodes[0].p();
+  }
+
+  uint64_t num_points_added = 0;
+  for (const Tile &tile : _tiles) {
+    num_points_added += tile._end - tile._begin;
+  }
+  nout << "Generated " << num_points_added << " points to bam file";
+  if (_got_tile_size) {
+    nout << " in " << _tiles.size() << " tiles";
+  }
+  nout << ".\n";
 
   // This should be guaranteed because we pass false to the constructor,
   // above.
@@ -100,7 +256,7 @@ run() {
     exit(1);
   }
 
-  if (!bam_file.write_object(_gnode.p())) {
+  if (!bam_file.write_object(root.p())) {
     nout << "Error in writing.\n";
     exit(1);
   }
@@ -127,107 +283,285 @@ handle_args(ProgramBase::Args &args) {
 }
 
 /**
- * Reads a single line from the pts file.
+ * Checks the first line of the pts file, which might be just the number of
+ * points in the file.  Returns the beginning of the point data.
  */
-void PtsToBam::
-process_line(const string &line) {
-  _line_number++;
+const char *PtsToBam::
+read_header(const char *begin, const char *end) {
+  _num_points_expected = 0;
+  if (begin == end || !isdigit((unsigned char)*begin)) {
+    return begin;
+  }
 
-  if (_line_number % 1000000 == 0) {
-    std::cerr << "." << std::flush;
+  const char *eol = (const char *)memchr(begin, '\n', end - begin);
+  if (eol == nullptr) {
+    eol = end;
   }
 
-  if (line.empty() || !isdigit(line[0])) {
-    return;
+  vector_string words;
+  tokenize(trim(string(begin, eol)), words, " \t", true);
+  if (words.size() != 1) {
+    return begin;
   }
 
-  if (_line_number == 1) {
-    // The first line might be just the number of points.
-    vector_string words;
-    tokenize(trim(line), words, " \t", true);
-    if (words.size() == 1) {
-      string tail;
-      _num_points_expected = string_to_int(words[0], tail);
-      nout << "Expecting " << _num_points_expected << " points, will generate "
-           << (int)(_num_points_expected * _decimate_factor) << "\n";
-      return;
-    }
+  _num_points_expected = strtoull(words[0].c_str(), nullptr, 10);
+  nout << "Expecting " << _num_points_expected << " points";
+  if (!_got_voxel_size) {
+    nout << ", will generate "
+         << (uint64_t)(_num_points_expected * _decimate_factor);
   }
+  nout << "\n";
+
+  return (eol < end) ? eol + 1 : end;
+}
+
+/**
+ * Divides the point data into chunks of whole lines, to be parsed by the
+ * indicated number of threads.
+ */
+void PtsToBam::
+make_chunks(const char *begin, const char *end, int num_threads) {
+  // We make several chunks per thread, so that the load stays balanced, but
+  // not so many that the per-chunk overhead matters.
+  static const size_t min_chunk_size = 1 << 20;
+  size_t size = end - begin;
+  size_t num_chunks = std::min(size / min_chunk_size, (size_t)num_threads * 8);
+  size_t chunk_size = size / std::max(num_chunks, (size_t)1) + 1;
+
+  _chunks.clear();
+  const char *p = begin;
+  while (p < end) {
+    const char *q = end;
+    if ((size_t)(end - p) > chunk_size) {
+      // Extend the chunk to the end of the line.
+      q = (const char *)memchr(p + chunk_size, '\n', end - (p + chunk_size));
+      q = (q == nullptr) ? end : q + 1;
+    }
 
-  // Here we might have a point.
-  _num_points_found++;
-  _decimated_point_number += _decimate_factor;
-  int point_number = int(_decimated_point_number);
-  if (point_number > _point_number) {
-    _point_number = point_number;
+    Chunk chunk;
+    chunk._begin = p;
+    chunk._end = q;
+    chunk._first_point = 0;
+    chunk._num_points_found = 0;
+    _chunks.push_back(chunk);
+    p = q;
+  }
+}
 
-    vector_string words;
-    tokenize(trim(line), words, " \t", true);
-    if (words.size() >= 3) {
-      add_point(words);
+/**
+ * Counts the lines within the chunk that describe points, without parsing
+ * them.
+ */
+void PtsToBam::
+count_points(Chunk &chunk) const {
+  uint64_t count = 0;
+  const char *p = chunk._begin;
+  while (p < chunk._end) {
+    if (isdigit((unsigned char)*p)) {
+      ++count;
+    }
+    const char *eol = (const char *)memchr(p, '\n', chunk._end - p);
+    if (eol == nullptr) {
+      break;
     }
+    p = eol + 1;
   }
+  chunk._num_points_found = count;
 }
 
 /**
- * Adds a point from the pts file.
+ * Parses the points within the chunk, applying the -d and -voxel
+ * decimation.
  */
 void PtsToBam::
-add_point(const vector_string &words) {
-  if (_data == nullptr || _data->get_num_rows() >= egg_max_vertices) {
-    open_vertex_data();
-  }
-
-  string tail;
-  double x, y, z;
-  x = string_to_double(words[0], tail);
-  y = string_to_double(words[1], tail);
-  z = string_to_double(words[2], tail);
-  _vertex.add_data3d(x, y, z);
-  _num_points_added++;
+parse_chunk(Chunk &chunk) const {
+  uint64_t index = chunk._first_point;
+  uint64_t count = 0;
+  VoxelSet voxels;
+
+  const char *p = chunk._begin;
+  while (p < chunk._end) {
+    const char *eol = (const char *)memchr(p, '\n', chunk._end - p);
+    if (eol == nullptr) {
+      eol = chunk._end;
+    }
+
+    // As before, only lines that begin with a digit describe points.
+    if (isdigit((unsigned char)*p)) {
+      ++count;
+      ++index;
+
+      // Keep every point at which the running total of the decimate factor
+      // passes another integer.
+      bool keep = (_decimate_factor >= 1.0 ||
+                   floor(index * _decimate_factor) > floor((index - 1) * _decimate_factor));
+
+      LPoint3 point;
+      if (keep && parse_point(p, eol, point)) {
+        if (!_got_voxel_size || voxels.insert(get_voxel_key(point)).second) {
+          chunk._points.push_back(point);
+        }
+      }
+    }
+
+    p = (eol < chunk._end) ? eol + 1 : chunk._end;
+  }
+
+  chunk._num_points_found = count;
+}
+
+/**
+ * Parses the first three words on the line as the coordinates of a point.
+ * Returns false if the line has fewer than three words.
+ */
+bool PtsToBam::
+parse_point(const char *p, const char *eol, LPoint3 &point) {
+  bool found;
+  double x = parse_pts_number(p, eol, found);
+  if (!found) {
+    return false;
+  }
+  double y = parse_pts_number(p, eol, found);
+  if (!found) {
+    return false;
+  }
+  double z = parse_pts_number(p, eol, found);
+  if (!found) {
+    return false;
+  }
+
+  point.set((PN_stdfloat)x, (PN_stdfloat)y, (PN_stdfloat)z);
+  return true;
 }
 
 /**
- * Creates a new GeomVertexData.
+ * Collects the points from all of the chunks, in file order, into points.  If
+ * -voxel is in effect, only the first point in each voxel is kept; each chunk
+ * has already done this for its own points.
+ *
+ * Each chunk's buffer is freed as soon as it has been appended, and the deque
+ * grows without reallocating, so the points are held only about once.
  */
 void PtsToBam::
-open_vertex_data() {
-  if (_data != nullptr) {
-    close_vertex_data();
+merge_chunks(Points &points) {
+  points.clear();
+
+  VoxelSet voxels;
+  for (Chunk &chunk : _chunks) {
+    if (_got_voxel_size) {
+      for (const LPoint3 &point : chunk._points) {
+        if (voxels.insert(get_voxel_key(point)).second) {
+          points.push_back(point);
+        }
+      }
+    } else {
+      points.insert(points.end(), chunk._points.begin(), chunk._points.end());
+    }
+
+    pvector<LPoint3>().swap(chunk._points);
   }
-  CPT(GeomVertexFormat) format = GeomVertexFormat::get_v3();
-  _data = new GeomVertexData("pts", format, GeomEnums::UH_static);
-  _vertex = GeomVertexWriter(_data, "vertex");
 }
 
 /**
- * Closes a previous GeomVertexData and adds it to the scene graph.
+ * Recursively divides the indicated range of points into the octants of the
+ * indicated box, until there are no more than _tile_size points in each, and
+ * records each nonempty octant as a tile.  The points are reordered so that
+ * each tile's points are contiguous.
  */
 void PtsToBam::
-close_vertex_data() {
-  if (_data == nullptr) {
+make_tiles(Points &points, size_t begin, size_t end,
+           const LPoint3 &min_point, const LPoint3 &max_point,
+           const string &name, int depth) {
+  // This keeps us from recursing forever on a pile of identical points.
+  static const int max_depth = 16;
+
+  if (begin == end) {
     return;
   }
+  if (end - begin <= (size_t)_tile_size || depth >= max_depth) {
+    Tile tile;
+    tile._name = name;
+    tile._begin = begin;
+    tile._end = end;
+    _tiles.push_back(tile);
+    return;
+  }
+
+  // Sort the points into octants: first into halves along X, then each half
+  // into quarters along Y, then each quarter into eighths along Z.  Octant i
+  // then has the points in [bounds[i], bounds[i + 1]).
+  LPoint3 center = (min_point + max_point) * 0.5f;
+  auto split = [&](size_t b, size_t e, int axis) {
+    return (size_t)(std::partition(points.begin() + b, points.begin() + e,
+      [&](const LPoint3 &point) {
+        return point[axis] < center[axis];
+      }) - points.begin());
+  };
+
+  size_t bounds[9];
+  bounds[0] = begin;
+  bounds[8] = end;
+  bounds[4] = split(bounds[0], bounds[8], 0);
+  bounds[2] = split(bounds[0], bounds[4], 1);
+  bounds[6] = split(bounds[4], bounds[8], 1);
+  for (int i = 0; i < 8; i += 2) {
+    bounds[i + 1] = split(bounds[i], bounds[i + 2], 2);
+  }
 
-  _num_vdatas++;
-  nout << "\nGenerating " << _num_points_added << " points in " << _num_vdatas << " GeomVertexDatas\n";
+  for (int i = 0; i < 8; ++i) {
+    LPoint3 child_min = min_point;
+    LPoint3 child_max = max_point;
+    for (int axis = 0; axis < 3; ++axis) {
+      if (i & (4 >> axis)) {
+        child_min[axis] = center[axis];
+      } else {
+        child_max[axis] = center[axis];
+      }
+    }
+    make_tiles(points, bounds[i], bounds[i + 1], child_min, child_max,
+               name + (char)('0' + i), depth + 1);
+  }
+}
 
-  PT(Geom) geom = new Geom(_data);
+/**
+ * Creates a Geom holding the points in the indicated range, which should be
+ * no more than egg_max_vertices.
+ */
+PT(Geom) PtsToBam::
+make_geom(const Points &points, size_t begin, size_t end) {
+  size_t num_points = end - begin;
+  CPT(GeomVertexFormat) format = GeomVertexFormat::get_v3();
+  PT(GeomVertexData) data = new GeomVertexData("pts", format, GeomEnums::UH_static);
+  data->unclean_set_num_rows((int)num_points);
+
+  Points::const_iterator pi = points.begin() + begin;
+  if (format->get_num_arrays() == 1 &&
+      format->get_array(0)->get_stride() == (int)sizeof(LPoint3)) {
+    // The points are already in the right layout, so we can copy them
+    // directly into the vertex array.
+    PT(GeomVertexArrayDataHandle) handle = data->modify_array_handle(0);
+    std::copy(pi, pi + num_points, (LPoint3 *)handle->get_write_pointer());
+  } else {
+    GeomVertexWriter vertex(data, "vertex");
+    for (size_t i = 0; i < num_points; ++i) {
+      vertex.set_data3(pi[i]);
+    }
+  }
 
-  int num_vertices = _data->get_num_rows();
+  PT(Geom) geom = new Geom(data);
+
+  int num_vertices = (int)num_points;
   int vertices_so_far = 0;
   while (num_vertices > 0) {
     int this_num_vertices = std::min(num_vertices, (int)egg_max_indices);
-    PT(GeomPrimitive) points = new GeomPoints(GeomEnums::UH_static);
-    points->add_consecutive_vertices(vertices_so_far, this_num_vertices);
-    geom->add_primitive(points);
+    PT(GeomPrimitive) prim = new GeomPoints(GeomEnums::UH_static);
+    prim->add_consecutive_vertices(vertices_so_far, this_num_vertices);
+    geom->add_primitive(prim);
     vertices_so_far += this_num_vertices;
     num_vertices -= this_num_vertices;
   }
 
-  _gnode->add_geom(geom);
-
-  _data = nullptr;
+  return geom;
 }
 
 int main(int argc, char *argv[]) {
@@ -19,10 +19,13 @@
 #include "programBase.h"
 #include "withOutputFile.h"
 #include "filename.h"
-#include "vector_string.h"
-#include "geomVertexData.h"
-#include "geomVertexWriter.h"
 #include "geomNode.h"
+#include "geom.h"
+#include "luse.h"
+#include "pvector.h"
+#include "pdeque.h"
+
+#include <unordered_set>
 
 /**
  *
@@ -37,28 +40,85 @@ protected:
   virtual bool handle_args(Args &args);
 
 private:
-  void process_line(const std::string &line);
-  void add_point(const vector_string &words);
+  // The pts file is divided into chunks of whole lines, which are parsed
+  // independently, each into its own buffer of points.
+  class Chunk {
+  public:
+    const char *_begin;
+    const char *_end;
+
+    // The number of point lines in the file before this chunk.
+    uint64_t _first_point;
+    uint64_t _num_points_found;
+    pvector<LPoint3> _points;
+  };
+  typedef pvector<Chunk> Chunks;
+
+  // All of the points, once the chunks have been merged.  This is a deque
+  // rather than a vector so that it grows, and is released from the end, a
+  // block at a time, without ever being reallocated.
+  typedef pdeque<LPoint3> Points;
+
+  // The integer coordinates of a cell of the -voxel grid.
+  class VoxelKey {
+  public:
+    INLINE bool operator == (const VoxelKey &other) const;
+    int64_t _x, _y, _z;
+  };
+  class VoxelHash {
+  public:
+    INLINE size_t operator () (const VoxelKey &key) const;
+  };
+  typedef std::unordered_set<VoxelKey, VoxelHash> VoxelSet;
 
-  void open_vertex_data();
-  void close_vertex_data();
+  // A leaf of the octree made by -tile, holding a contiguous range of the
+  // points.
+  class Tile {
+  public:
+    std::string _name;
+    size_t _begin;
+    size_t _end;
+  };
+  typedef pvector<Tile> Tiles;
+
+  // A run of the points within one tile, small enough for one Geom.
+  class Piece {
+  public:
+    size_t _tile;
+    size_t _begin;
+    size_t _end;
+    PT(Geom) _geom;
+  };
+  typedef pvector<Piece> Pieces;
+
+  const char *read_header(const char *begin, const char *end);
+  void make_chunks(const char *begin, const char *end, int num_threads);
+  void count_points(Chunk &chunk) const;
+  void parse_chunk(Chunk &chunk) const;
+  static bool parse_point(const char *p, const char *eol, LPoint3 &point);
+  INLINE VoxelKey get_voxel_key(const LPoint3 &point) const;
+  void merge_chunks(Points &points);
+
+  void make_tiles(Points &points, size_t begin, size_t end,
+                  const LPoint3 &min_point, const LPoint3 &max_point,
+                  const std::string &name, int depth);
+  static PT(Geom) make_geom(const Points &points, size_t begin, size_t end);
 
 private:
   Filename _pts_filename;
   double _decimate_divisor;
   double _decimate_factor;
+  bool _got_voxel_size;
+  double _voxel_size;
+  bool _got_tile_size;
+  int _tile_size;
+  int _num_threads;
 
-  int _line_number;
-  int _point_number;
-  int _num_points_expected;
-  int _num_points_found;
-  int _num_points_added;
-  int _num_vdatas;
-
-  double _decimated_point_number;
-  PT(GeomNode) _gnode;
-  PT(GeomVertexData) _data;
-  GeomVertexWriter _vertex;
+  uint64_t _num_points_expected;
+  Chunks _chunks;
+  Tiles _tiles;
 };
 
+#include "ptsToBam.I"
+
 #endif
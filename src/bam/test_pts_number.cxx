@@ -0,0 +1,141 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_pts_number.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "ptsNumber.h"
+#include "clockObject.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+// The parser is allowed to differ from strtod() by a few units in the last
+// place, far less than the precision of the floats it is stored in.
+static const double tolerance = 1e-14;
+
+/**
+ * Checks the result of parse_pts_number() on the indicated word against
+ * strtod().  Returns true if they agree.
+ */
+static bool
+check_word(const std::string &word) {
+  std::string line = " " + word + "\t7\r";
+  const char *p = line.data();
+  const char *eol = p + line.size();
+
+  bool found;
+  double value = parse_pts_number(p, eol, found);
+  double expected = strtod(word.c_str(), nullptr);
+
+  bool ok = found && p == line.data() + 1 + word.size();
+  if (ok) {
+    if (isnan(expected)) {
+      ok = isnan(value);
+    } else if (value != expected) {
+      ok = fabs(value - expected) <= fabs(expected) * tolerance;
+    }
+  }
+
+  // The next word must still be there.
+  if (ok) {
+    double next = parse_pts_number(p, eol, found);
+    ok = found && next == 7.0;
+    parse_pts_number(p, eol, found);
+    ok = ok && !found;
+  }
+
+  if (!ok) {
+    printf("\"%s\": got %.17g, expected %.17g\n", word.c_str(), value, expected);
+  }
+  return ok;
+}
+
+int
+main(int argc, char *argv[]) {
+  static const char *const fixed_words[] = {
+    "0", "-0", "+1", "1.", ".5", "-.5", "1e3", "1E-3", "2.5e+10",
+    "123456789012345678901234567890", "0.000000000000000000001234",
+    "1e308", "1e-307", "3.4028235e38", "1e", "1e+", "5x", "-17.25abc",
+  };
+
+  bool success = true;
+  for (const char *word : fixed_words) {
+    success = check_word(word) && success;
+  }
+
+  // Numbers in the formats that laser scanners write, and a few others.
+  static const char *const formats[] = {
+    "%.3f", "%.6f", "%.9f", "%.17g", "%e", "%.0f", "%d",
+  };
+  srand(1);
+  std::vector<std::string> words;
+  for (int i = 0; i < 200000; ++i) {
+    double mantissa = (double)rand() / RAND_MAX - 0.5;
+    double value = ldexp(mantissa, (rand() % 80) - 40);
+    const char *format = formats[i % (sizeof(formats) / sizeof(formats[0]))];
+    char buffer[64];
+    if (strcmp(format, "%d") == 0) {
+      sprintf(buffer, format, rand() - RAND_MAX / 2);
+    } else {
+      sprintf(buffer, format, value);
+    }
+    words.push_back(buffer);
+  }
+
+  int num_failed = 0;
+  for (const std::string &word : words) {
+    if (!check_word(word)) {
+      success = false;
+      if (++num_failed >= 20) {
+        break;
+      }
+    }
+  }
+
+  // Compare the speed of the two, on one long line of all the words.
+  std::string line;
+  for (const std::string &word : words) {
+    line += word;
+    line += ' ';
+  }
+  const char *eol = line.data() + line.size();
+
+  ClockObject *clock = ClockObject::get_global_clock();
+  double start = clock->get_real_time();
+  double sum = 0.0;
+  const char *p = line.data();
+  bool found = true;
+  while (found) {
+    sum += parse_pts_number(p, eol, found);
+  }
+  double parse_time = clock->get_real_time() - start;
+
+  start = clock->get_real_time();
+  double strtod_sum = 0.0;
+  p = line.data();
+  while (p < eol) {
+    char *end;
+    strtod_sum += strtod(p, &end);
+    p = end + 1;
+  }
+  double strtod_time = clock->get_real_time() - start;
+
+  printf("%d words: parse_pts_number %g s, strtod %g s (sums %g, %g)\n",
+         (int)words.size(), parse_time, strtod_time, sum, strtod_sum);
+
+  printf(success ? "ok\n" : "FAILED\n");
+  return success ? 0 : 1;
+}
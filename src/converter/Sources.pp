@@ -15,10 +15,27 @@
     somethingToEggConverter.I somethingToEggConverter.cxx \
     somethingToEggConverter.h \
     eggToSomethingConverter.I eggToSomethingConverter.cxx \
-    eggToSomethingConverter.h
+    eggToSomethingConverter.h \
+    externalReferenceCache.I externalReferenceCache.cxx \
+    externalReferenceCache.h \
+    indexHashTable.I indexHashTable.h \
+    nodeGeomBuilder.I nodeGeomBuilder.cxx nodeGeomBuilder.h
 
   #define INSTALL_HEADERS \
     somethingToEggConverter.I somethingToEggConverter.h \
-    eggToSomethingConverter.I eggToSomethingConverter.h
+    eggToSomethingConverter.I eggToSomethingConverter.h \
+    externalReferenceCache.I externalReferenceCache.h \
+    indexHashTable.I indexHashTable.h \
+    nodeGeomBuilder.I nodeGeomBuilder.h
 
 #end ss_lib_target
+
+#begin test_bin_target
+  #define TARGET test_external_refs
+  #define LOCAL_LIBS \
+    converter pandatoolbase
+
+  #define SOURCES \
+    test_external_refs.cxx
+
+#end test_bin_target
@@ -0,0 +1,223 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file externalReferenceCache.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "externalReferenceCache.h"
+#include "eggGroup.h"
+#include "eggPrimitive.h"
+#include "eggVertexPool.h"
+#include "eggTexture.h"
+#include "eggMaterial.h"
+#include "eggComment.h"
+#include "eggCoordinateSystem.h"
+#include "eggExternalReference.h"
+#include "mutexHolder.h"
+#include "dcast.h"
+
+/**
+ *
+ */
+ExternalReferenceCache::
+ExternalReferenceCache() :
+  _cvar(_lock),
+  _num_requests(0),
+  _num_hits(0),
+  _num_converted(0),
+  _convert_time(0.0),
+  _prefetch_time(0.0)
+{
+}
+
+/**
+ * Called before converting the external file identified by key.  Returns
+ * true if the caller should go ahead and convert it, in which case it must
+ * call end_convert() when it is done, or false if it has already been
+ * converted (or has failed to convert).  If another thread is already
+ * converting the same file, this waits for it to finish.
+ *
+ * A file must be claimed only by the thread that is about to convert it, so
+ * that nobody waits on a file whose conversion hasn't actually begun.
+ */
+bool ExternalReferenceCache::
+begin_convert(const std::string &key) {
+  MutexHolder holder(_lock);
+  Entries::iterator ei = _entries.find(key);
+  if (ei == _entries.end()) {
+    Entry &entry = _entries[key];
+    entry._state = ES_converting;
+    entry._cannot_copy = false;
+    return true;
+  }
+
+  while ((*ei).second._state == ES_converting) {
+    _cvar.wait();
+  }
+  return false;
+}
+
+/**
+ * Records the result of converting the external file identified by key,
+ * following a call to begin_convert() that returned true.  egg_data should
+ * be NULL if the conversion failed.
+ */
+void ExternalReferenceCache::
+end_convert(const std::string &key, EggData *egg_data, double elapsed) {
+  MutexHolder holder(_lock);
+  Entry &entry = _entries[key];
+  nassertv(entry._state == ES_converting);
+
+  entry._egg_data = egg_data;
+  entry._state = (egg_data != nullptr) ? ES_ready : ES_failed;
+  ++_num_converted;
+  _convert_time += elapsed;
+
+  _cvar.notify_all();
+}
+
+/**
+ * Parents the converted contents of the external file identified by key to
+ * egg_parent.  Returns IR_instanced on success, or IR_failed if the file
+ * failed to convert, in which case there is no point in trying again.
+ * Returns IR_convert_again if the contents cannot be copied for a second
+ * reference, or the file was never converted; in that case, the caller
+ * should convert the file itself.
+ */
+ExternalReferenceCache::InstanceResult ExternalReferenceCache::
+instance(const std::string &key, EggGroupNode *egg_parent) {
+  MutexHolder holder(_lock);
+  ++_num_requests;
+
+  Entries::iterator ei = _entries.find(key);
+  if (ei == _entries.end()) {
+    return IR_convert_again;
+  }
+  Entry &entry = (*ei).second;
+  if (entry._state == ES_failed) {
+    return IR_failed;
+  }
+  if (entry._state != ES_ready) {
+    return IR_convert_again;
+  }
+
+  if (entry._egg_data != nullptr) {
+    // This is the first reference; it gets the converted nodes themselves.
+    EggGroupNode::iterator ci;
+    for (ci = entry._egg_data->begin(); ci != entry._egg_data->end(); ++ci) {
+      entry._nodes.push_back(*ci);
+    }
+    egg_parent->steal_children(*entry._egg_data);
+    entry._egg_data = nullptr;
+    return IR_instanced;
+  }
+
+  if (entry._cannot_copy) {
+    return IR_convert_again;
+  }
+
+  // Copy into a temporary group first, so we don't leave a partial copy
+  // behind if we come across something we can't copy.
+  PT(EggGroup) temp = new EggGroup;
+  pvector<PT(EggNode) >::const_iterator ni;
+  for (ni = entry._nodes.begin(); ni != entry._nodes.end(); ++ni) {
+    if (!copy_node(*ni, temp)) {
+      entry._cannot_copy = true;
+      return IR_convert_again;
+    }
+  }
+
+  egg_parent->steal_children(*temp);
+  ++_num_hits;
+  return IR_instanced;
+}
+
+/**
+ * Records the elapsed wall-clock time spent in a parallel prefetch of
+ * external references, for reporting by write().
+ */
+void ExternalReferenceCache::
+add_prefetch_time(double elapsed) {
+  MutexHolder holder(_lock);
+  _prefetch_time += elapsed;
+}
+
+/**
+ * Writes a summary of the cache's activity.
+ */
+void ExternalReferenceCache::
+write(std::ostream &out) const {
+  out << _num_requests << " external references, " << _num_hits
+      << " instanced from " << _num_converted << " converted files ("
+      << _convert_time << " s converting";
+  if (_prefetch_time != 0.0) {
+    out << ", " << _prefetch_time << " s elapsed in parallel";
+  }
+  out << ")\n";
+}
+
+/**
+ * Copies the children of source to dest.  See copy_node().
+ */
+bool ExternalReferenceCache::
+copy_children(EggGroupNode *source, EggGroupNode *dest) {
+  EggGroupNode::iterator ci;
+  for (ci = source->begin(); ci != source->end(); ++ci) {
+    if (!copy_node(*ci, dest)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Adds a copy of the indicated node to dest, deep-copying the groups and
+ * primitives but sharing the vertex pools, textures, and materials, which
+ * are already present in the egg file from the first reference.  Returns
+ * false if the node can't be copied.
+ *
+ * This is also used by converters that instance a subtree of their own egg
+ * file, such as VRMLToEggConverter for a node that is USEd repeatedly.
+ */
+bool ExternalReferenceCache::
+copy_node(EggNode *node, EggGroupNode *dest) {
+  if (node->is_of_type(EggVertexPool::get_class_type()) ||
+      node->is_of_type(EggTexture::get_class_type()) ||
+      node->is_of_type(EggMaterial::get_class_type()) ||
+      node->is_of_type(EggComment::get_class_type()) ||
+      node->is_of_type(EggCoordinateSystem::get_class_type())) {
+    // These are shared with the first reference.
+    return true;
+
+  } else if (node->is_of_type(EggPrimitive::get_class_type())) {
+    dest->add_child(DCAST(EggPrimitive, node)->make_copy());
+    return true;
+
+  } else if (node->is_exact_type(EggGroup::get_class_type())) {
+    // The EggGroup copy constructor deliberately doesn't copy the children
+    // (and complains if there are any), so move them aside while we copy
+    // the group's own attributes.
+    EggGroup *group = DCAST(EggGroup, node);
+    PT(EggGroup) hold = new EggGroup;
+    hold->steal_children(*group);
+    PT(EggGroup) copy = new EggGroup(*group);
+    group->steal_children(*hold);
+
+    dest->add_child(copy);
+    return copy_children(group, copy);
+
+  } else if (node->is_exact_type(EggExternalReference::get_class_type())) {
+    dest->add_child(new EggExternalReference(*DCAST(EggExternalReference, node)));
+    return true;
+  }
+
+  // Animation tables and the like.
+  return false;
+}
@@ -0,0 +1,104 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file externalReferenceCache.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef EXTERNALREFERENCECACHE_H
+#define EXTERNALREFERENCECACHE_H
+
+#include "pandatoolbase.h"
+
+#include "referenceCount.h"
+#include "eggData.h"
+#include "eggNode.h"
+#include "eggGroupNode.h"
+#include "pmutex.h"
+#include "conditionVarFull.h"
+#include "pointerTo.h"
+#include "pvector.h"
+#include "pmap.h"
+
+/**
+ * Remembers the external references that have already been converted during
+ * one conversion run (see SomethingToEggConverter::set_merge_externals()),
+ * so that a file referenced many times is read and converted only once.
+ *
+ * The first reference to a file receives the converted nodes themselves;
+ * each later reference receives a copy of the groups and primitives, which
+ * share the vertex pools, textures, and materials of the first.
+ *
+ * The cache is shared by a converter and all of the copies it makes to
+ * convert its external references, which may run on several threads.
+ */
+class ExternalReferenceCache : public ReferenceCount {
+public:
+  ExternalReferenceCache();
+
+  enum InstanceResult {
+    IR_instanced,
+    IR_failed,
+    IR_convert_again,
+  };
+
+  bool begin_convert(const std::string &key);
+  void end_convert(const std::string &key, EggData *egg_data, double elapsed);
+
+  InstanceResult instance(const std::string &key, EggGroupNode *egg_parent);
+
+  INLINE int get_num_requests() const;
+  INLINE int get_num_hits() const;
+  INLINE int get_num_converted() const;
+  INLINE double get_convert_time() const;
+  void add_prefetch_time(double elapsed);
+
+  void write(std::ostream &out) const;
+
+  static bool copy_children(EggGroupNode *source, EggGroupNode *dest);
+  static bool copy_node(EggNode *node, EggGroupNode *dest);
+
+private:
+  enum EntryState {
+    ES_converting,
+    ES_ready,
+    ES_failed,
+  };
+
+  class Entry {
+  public:
+    EntryState _state;
+
+    // Until the first reference is instanced, this holds the converted
+    // data; afterwards, it is empty and _nodes lists the nodes that were
+    // given to the first reference.
+    PT(EggData) _egg_data;
+    pvector<PT(EggNode) > _nodes;
+
+    // Set if _nodes contains something that copy_children() can't copy, in
+    // which case later references must be converted afresh.
+    bool _cannot_copy;
+  };
+
+  typedef pmap<std::string, Entry> Entries;
+  Entries _entries;
+
+  Mutex _lock;
+  ConditionVarFull _cvar;
+
+  int _num_requests;
+  int _num_hits;
+  int _num_converted;
+  double _convert_time;
+  double _prefetch_time;
+};
+
+#include "externalReferenceCache.I"
+
+#endif
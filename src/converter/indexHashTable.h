@@ -0,0 +1,78 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file indexHashTable.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef INDEXHASHTABLE_H
+#define INDEXHASHTABLE_H
+
+#include "pandatoolbase.h"
+#include "pvector.h"
+
+/**
+ * A small open-addressing (linear probing) hash table that maps keys to
+ * integer indices.  It is used by the converters to deduplicate vertices, in
+ * place of a pmap, which costs one tree node per entry.
+ *
+ * The slot array is retained when the table is cleared, so that it serves as
+ * a reusable arena from one Geom to the next; clearing is a constant-time
+ * operation that simply bumps a generation counter.
+ *
+ * The Compare class must supply static get_hash() and is_equal() methods, in
+ * the same style as the comparators used by SimpleHashMap.
+ */
+template<class Key, class Compare>
+class IndexHashTable {
+public:
+  INLINE IndexHashTable();
+
+  INLINE int find(const Key &key) const;
+  INLINE std::pair<int, bool> insert(const Key &key, int value);
+  INLINE bool remove(const Key &key);
+  INLINE void clear();
+
+  INLINE size_t get_num_entries() const;
+  INLINE size_t get_table_size() const;
+  INLINE double get_load_factor() const;
+
+  INLINE void reset_stats();
+  void write_stats(std::ostream &out) const;
+
+private:
+  INLINE size_t find_slot(const Key &key, size_t hash) const;
+  INLINE size_t get_home(size_t hash) const;
+  INLINE bool is_occupied(size_t slot) const;
+  void grow();
+
+  class Slot {
+  public:
+    Key _key;
+    size_t _hash;
+    int _value;
+    unsigned int _generation;
+  };
+  typedef pvector<Slot> Slots;
+  Slots _slots;
+
+  size_t _num_entries;
+  int _shift;
+  unsigned int _generation;
+
+  // Statistics, accumulated since the last call to reset_stats().
+  mutable size_t _num_lookups;
+  mutable size_t _num_collisions;
+  mutable size_t _max_probe_length;
+  size_t _max_entries;
+};
+
+#include "indexHashTable.I"
+
+#endif
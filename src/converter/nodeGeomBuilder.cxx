@@ -0,0 +1,470 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file nodeGeomBuilder.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "nodeGeomBuilder.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexArrayFormat.h"
+#include "geomVertexWriter.h"
+#include "geomTriangles.h"
+#include "geomLinestrips.h"
+#include "geom.h"
+#include "internalName.h"
+#include "triangulator3.h"
+#include "config_egg2pg.h"
+#include "deg_2_rad.h"
+
+#include <algorithm>
+
+namespace {
+  // Sorts primitive indices so that primitives sharing a state and type are
+  // adjacent, while preserving the original order within each run.
+  class SortByBucket {
+  public:
+    SortByBucket(const pvector<int> &keys) : _keys(keys) { }
+    bool operator () (int a, int b) const {
+      return _keys[a] < _keys[b];
+    }
+    const pvector<int> &_keys;
+  };
+
+  // Sorts corner references by vertex position, for finding the polygons
+  // that share a vertex when smoothing normals.
+  class SortByPosition {
+  public:
+    SortByPosition(const pvector<NodeGeomBuilder::Vertex> &vertices) :
+      _vertices(vertices) { }
+    bool operator () (const std::pair<int, int> &a,
+                      const std::pair<int, int> &b) const {
+      return _vertices[a.first]._pos.compare_to(_vertices[b.first]._pos, 0.0) < 0;
+    }
+    const pvector<NodeGeomBuilder::Vertex> &_vertices;
+  };
+}
+
+/**
+ * Returns a hash code for the vertex that is consistent with operator ==.
+ */
+size_t NodeGeomBuilder::Vertex::
+get_hash() const {
+  size_t hash = _pos.get_hash();
+  if (_flags & VF_normal) {
+    hash = hash * 1000003 + _normal.get_hash();
+  }
+  if (_flags & VF_uv) {
+    hash = hash * 1000003 + _uv.get_hash();
+  }
+  if (_flags & VF_color) {
+    hash = hash * 1000003 + _color.get_hash();
+  }
+  return hash;
+}
+
+/**
+ *
+ */
+NodeGeomBuilder::
+NodeGeomBuilder(CoordinateSystem cs) : _cs(cs) {
+}
+
+/**
+ * Adds a polygon with the indicated vertices, in counterclockwise order.
+ * Vertices that don't specify a normal will receive one computed from the
+ * polygon; if smooth_angle is greater than zero, these normals are averaged
+ * with those of neighboring polygons that meet at less than this angle (in
+ * degrees).  Polygons with fewer than three vertices are ignored.
+ */
+void NodeGeomBuilder::
+add_polygon(const RenderState *state, const Vertex *vertices,
+            int num_vertices, double smooth_angle) {
+  if (num_vertices < 3) {
+    return;
+  }
+
+  Primitive prim;
+  prim._state_index = get_state_index(state);
+  prim._first_vertex = (int)_vertices.size();
+  prim._num_vertices = num_vertices;
+  prim._smooth_angle = smooth_angle;
+  prim._is_line = false;
+  _prims.push_back(prim);
+
+  _vertices.insert(_vertices.end(), vertices, vertices + num_vertices);
+}
+
+/**
+ * Adds an open line strip through the indicated vertices.
+ */
+void NodeGeomBuilder::
+add_line(const RenderState *state, const Vertex *vertices, int num_vertices) {
+  if (num_vertices < 2) {
+    return;
+  }
+
+  Primitive prim;
+  prim._state_index = get_state_index(state);
+  prim._first_vertex = (int)_vertices.size();
+  prim._num_vertices = num_vertices;
+  prim._smooth_angle = 0.0;
+  prim._is_line = true;
+  _prims.push_back(prim);
+
+  _vertices.insert(_vertices.end(), vertices, vertices + num_vertices);
+}
+
+/**
+ * Converts all of the primitives added so far into Geoms, which are added to
+ * the indicated GeomNode, and then resets the builder for more primitives.
+ */
+void NodeGeomBuilder::
+build(GeomNode *geom_node) {
+  compute_normals();
+
+  // Group the primitives by state and type, so that each group can be
+  // converted to as few Geoms as possible.
+  pvector<int> keys;
+  keys.reserve(_prims.size());
+  pvector<int> order;
+  order.reserve(_prims.size());
+  for (size_t pi = 0; pi < _prims.size(); ++pi) {
+    keys.push_back(_prims[pi]._state_index * 2 + (_prims[pi]._is_line ? 1 : 0));
+    order.push_back((int)pi);
+  }
+  std::stable_sort(order.begin(), order.end(), SortByBucket(keys));
+
+  Bucket bucket;
+  int current_key = -1;
+  for (size_t oi = 0; oi < order.size(); ++oi) {
+    const Primitive &prim = _prims[order[oi]];
+    int key = keys[order[oi]];
+    if (key != current_key) {
+      if (current_key != -1) {
+        close_bucket(bucket, geom_node);
+      }
+      current_key = key;
+      bucket._state = _states[prim._state_index];
+      bucket._is_line = prim._is_line;
+      bucket._vertices.clear();
+      bucket._flags = 0;
+      if (prim._is_line) {
+        bucket._prim = new GeomLinestrips(GeomEnums::UH_static);
+      } else {
+        bucket._prim = new GeomTriangles(GeomEnums::UH_static);
+      }
+    }
+
+    if (prim._is_line) {
+      emit_line(bucket, prim, geom_node);
+    } else {
+      emit_polygon(bucket, prim, geom_node);
+    }
+  }
+  if (current_key != -1) {
+    close_bucket(bucket, geom_node);
+  }
+
+  clear();
+}
+
+/**
+ * Discards all of the primitives added so far.
+ */
+void NodeGeomBuilder::
+clear() {
+  _vertices.clear();
+  _prims.clear();
+  _states.clear();
+  _state_indices.clear();
+  _unique_vertices.clear();
+}
+
+/**
+ * Returns the index number of the indicated state within _states, adding it
+ * if necessary.
+ */
+int NodeGeomBuilder::
+get_state_index(const RenderState *state) {
+  if (state == nullptr) {
+    state = RenderState::make_empty();
+  }
+  StateIndices::const_iterator si = _state_indices.find(state);
+  if (si != _state_indices.end()) {
+    return (*si).second;
+  }
+
+  int index = (int)_states.size();
+  _states.push_back(state);
+  _state_indices[state] = index;
+  return index;
+}
+
+/**
+ * Fills in a normal for each polygon vertex that doesn't already have one.
+ */
+void NodeGeomBuilder::
+compute_normals() {
+  pvector<LNormald> poly_normals(_prims.size(), LNormald::zero());
+
+  // The (vertex, primitive) pairs that want a smoothed normal.
+  pvector<std::pair<int, int> > smooth_corners;
+
+  for (size_t pi = 0; pi < _prims.size(); ++pi) {
+    const Primitive &prim = _prims[pi];
+    if (prim._is_line) {
+      continue;
+    }
+
+    bool any_missing = false;
+    for (int vi = 0; vi < prim._num_vertices && !any_missing; ++vi) {
+      any_missing = (_vertices[prim._first_vertex + vi]._flags & VF_normal) == 0;
+    }
+    if (!any_missing) {
+      continue;
+    }
+
+    poly_normals[pi] = get_polygon_normal(prim);
+    for (int vi = 0; vi < prim._num_vertices; ++vi) {
+      int index = prim._first_vertex + vi;
+      if ((_vertices[index]._flags & VF_normal) == 0) {
+        if (prim._smooth_angle > 0.0) {
+          smooth_corners.push_back(std::pair<int, int>(index, (int)pi));
+        } else {
+          _vertices[index].set_normal(poly_normals[pi]);
+        }
+      }
+    }
+  }
+
+  if (smooth_corners.empty()) {
+    return;
+  }
+
+  // Now average the normals of the polygons that meet at each position,
+  // considering only those that are within the smoothing angle of the
+  // polygon we are computing the normal for.
+  std::sort(smooth_corners.begin(), smooth_corners.end(), SortByPosition(_vertices));
+
+  size_t begin = 0;
+  while (begin < smooth_corners.size()) {
+    const LPoint3d &pos = _vertices[smooth_corners[begin].first]._pos;
+    size_t end = begin + 1;
+    while (end < smooth_corners.size() &&
+           _vertices[smooth_corners[end].first]._pos == pos) {
+      ++end;
+    }
+
+    for (size_t ci = begin; ci < end; ++ci) {
+      int pi = smooth_corners[ci].second;
+      const LNormald &normal = poly_normals[pi];
+      double cos_angle = cos(deg_2_rad(_prims[pi]._smooth_angle));
+
+      LNormald sum = LNormald::zero();
+      int last_pi = -1;
+      for (size_t cj = begin; cj < end; ++cj) {
+        int pj = smooth_corners[cj].second;
+        if (pj != last_pi && normal.dot(poly_normals[pj]) >= cos_angle) {
+          sum += poly_normals[pj];
+        }
+        last_pi = pj;
+      }
+      if (!sum.normalize()) {
+        sum = normal;
+      }
+      _vertices[smooth_corners[ci].first].set_normal(sum);
+    }
+
+    begin = end;
+  }
+}
+
+/**
+ * Returns the unit normal of the indicated polygon, by Newell's method,
+ * respecting the handedness of the coordinate system as
+ * EggPolygon::calculate_normal() does.
+ */
+LNormald NodeGeomBuilder::
+get_polygon_normal(const Primitive &prim) const {
+  LNormald normal = LNormald::zero();
+  for (int vi = 0; vi < prim._num_vertices; ++vi) {
+    const LPoint3d &p0 = _vertices[prim._first_vertex + vi]._pos;
+    const LPoint3d &p1 = _vertices[prim._first_vertex + (vi + 1) % prim._num_vertices]._pos;
+    normal[0] += (p0[1] - p1[1]) * (p0[2] + p1[2]);
+    normal[1] += (p0[2] - p1[2]) * (p0[0] + p1[0]);
+    normal[2] += (p0[0] - p1[0]) * (p0[1] + p1[1]);
+  }
+  if (!normal.normalize()) {
+    return LNormald::zero();
+  }
+
+  CoordinateSystem cs = _cs;
+  if (cs == CS_default) {
+    cs = get_default_coordinate_system();
+  }
+  if (!is_right_handed(cs)) {
+    normal = -normal;
+  }
+  return normal;
+}
+
+/**
+ * Adds the vertex to the bucket's current Geom, or returns the index of an
+ * identical vertex already there.
+ */
+int NodeGeomBuilder::
+add_bucket_vertex(Bucket &bucket, const Vertex &vertex) {
+  std::pair<int, bool> result =
+    _unique_vertices.insert(vertex, (int)bucket._vertices.size());
+  if (result.second) {
+    bucket._vertices.push_back(vertex);
+    bucket._flags |= vertex._flags;
+  }
+  return result.first;
+}
+
+/**
+ * Triangulates the indicated polygon and adds it to the bucket, first closing
+ * the bucket's current Geom if the polygon would not fit.
+ */
+void NodeGeomBuilder::
+emit_polygon(Bucket &bucket, const Primitive &prim, GeomNode *geom_node) {
+  const Vertex *verts = &_vertices[prim._first_vertex];
+  int num_vertices = prim._num_vertices;
+
+  Triangulator3 tri;
+  int num_tris = 1;
+  if (num_vertices != 3) {
+    for (int vi = 0; vi < num_vertices; ++vi) {
+      const LPoint3d &p = verts[vi]._pos;
+      tri.add_vertex(p[0], p[1], p[2]);
+      tri.add_polygon_vertex(vi);
+    }
+    tri.triangulate();
+    num_tris = tri.get_num_triangles();
+    if (num_tris == 0) {
+      return;
+    }
+  }
+
+  if (bucket._prim->get_num_vertices() + 3 * num_tris > egg_max_indices ||
+      bucket._vertices.size() + num_vertices > (size_t)egg_max_vertices) {
+    close_bucket(bucket, geom_node);
+  }
+
+  int indices[3];
+  if (num_vertices == 3) {
+    for (int vi = 0; vi < 3; ++vi) {
+      indices[vi] = add_bucket_vertex(bucket, verts[vi]);
+    }
+    bucket._prim->add_vertices(indices[0], indices[1], indices[2]);
+    bucket._prim->close_primitive();
+
+  } else {
+    for (int ti = 0; ti < num_tris; ++ti) {
+      indices[0] = add_bucket_vertex(bucket, verts[tri.get_triangle_v0(ti)]);
+      indices[1] = add_bucket_vertex(bucket, verts[tri.get_triangle_v1(ti)]);
+      indices[2] = add_bucket_vertex(bucket, verts[tri.get_triangle_v2(ti)]);
+      bucket._prim->add_vertices(indices[0], indices[1], indices[2]);
+      bucket._prim->close_primitive();
+    }
+  }
+}
+
+/**
+ * Adds the indicated line strip to the bucket, first closing the bucket's
+ * current Geom if the line would not fit.
+ */
+void NodeGeomBuilder::
+emit_line(Bucket &bucket, const Primitive &prim, GeomNode *geom_node) {
+  if (bucket._prim->get_num_vertices() + prim._num_vertices > egg_max_indices ||
+      bucket._vertices.size() + prim._num_vertices > (size_t)egg_max_vertices) {
+    close_bucket(bucket, geom_node);
+  }
+
+  for (int vi = 0; vi < prim._num_vertices; ++vi) {
+    bucket._prim->add_vertex(add_bucket_vertex(bucket, _vertices[prim._first_vertex + vi]));
+  }
+  bucket._prim->close_primitive();
+}
+
+/**
+ * Finishes the bucket's current Geom, if it has any primitives, and adds it
+ * to the GeomNode.  Prepares the bucket for a new Geom with the same state.
+ */
+void NodeGeomBuilder::
+close_bucket(Bucket &bucket, GeomNode *geom_node) {
+  if (bucket._prim->get_num_vertices() != 0) {
+    // Create a format that includes only the columns we actually used.
+    PT(GeomVertexArrayFormat) aformat = new GeomVertexArrayFormat;
+    aformat->add_column(InternalName::get_vertex(), 3,
+                        GeomEnums::NT_stdfloat, GeomEnums::C_point);
+    if (bucket._flags & VF_normal) {
+      aformat->add_column(InternalName::get_normal(), 3,
+                          GeomEnums::NT_stdfloat, GeomEnums::C_vector);
+    }
+    if (bucket._flags & VF_uv) {
+      aformat->add_column(InternalName::get_texcoord(), 2,
+                          GeomEnums::NT_stdfloat, GeomEnums::C_texcoord);
+    }
+    if (bucket._flags & VF_color) {
+      aformat->add_column(InternalName::get_color(), 4,
+                          GeomEnums::NT_uint8, GeomEnums::C_color);
+    }
+    CPT(GeomVertexFormat) format = GeomVertexFormat::register_format(aformat);
+
+    PT(GeomVertexData) vdata = new GeomVertexData("", format, GeomEnums::UH_static);
+    vdata->unclean_set_num_rows(bucket._vertices.size());
+    GeomVertexWriter vertex_writer(vdata, InternalName::get_vertex());
+    GeomVertexWriter normal_writer(vdata, InternalName::get_normal());
+    GeomVertexWriter texcoord_writer(vdata, InternalName::get_texcoord());
+    GeomVertexWriter color_writer(vdata, InternalName::get_color());
+
+    pvector<Vertex>::const_iterator vi;
+    for (vi = bucket._vertices.begin(); vi != bucket._vertices.end(); ++vi) {
+      const Vertex &vertex = (*vi);
+      vertex_writer.set_data3d(vertex._pos);
+      if (bucket._flags & VF_normal) {
+        normal_writer.set_data3d(vertex._normal);
+      }
+      if (bucket._flags & VF_uv) {
+        texcoord_writer.set_data2d(vertex._uv);
+      }
+      if (bucket._flags & VF_color) {
+        color_writer.set_data4(vertex._color);
+      }
+    }
+
+    CPT(GeomPrimitive) prim = bucket._prim;
+    LMatrix4 mat = LMatrix4::convert_mat(_cs, CS_default);
+    if (!mat.is_identity()) {
+      vdata->transform_vertices(mat);
+      if (!bucket._is_line && mat.get_upper_3().determinant() < 0.0f) {
+        // A change of handedness turns the triangles inside-out; flip them
+        // back.
+        prim = prim->reverse();
+      }
+    }
+
+    PT(Geom) geom = new Geom(vdata);
+    geom->add_primitive(prim);
+    geom_node->add_geom(geom, bucket._state);
+  }
+
+  if (bucket._is_line) {
+    bucket._prim = new GeomLinestrips(GeomEnums::UH_static);
+  } else {
+    bucket._prim = new GeomTriangles(GeomEnums::UH_static);
+  }
+  bucket._vertices.clear();
+  bucket._flags = 0;
+  _unique_vertices.clear();
+}
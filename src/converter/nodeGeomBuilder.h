@@ -0,0 +1,135 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file nodeGeomBuilder.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef NODEGEOMBUILDER_H
+#define NODEGEOMBUILDER_H
+
+#include "pandatoolbase.h"
+
+#include "indexHashTable.h"
+#include "coordinateSystem.h"
+#include "renderState.h"
+#include "geomNode.h"
+#include "geomPrimitive.h"
+#include "luse.h"
+#include "pvector.h"
+#include "pmap.h"
+
+/**
+ * A helper for the SomethingToEggConverters that support direct conversion
+ * to a PandaNode (see convert_to_node()), so that each of them needn't build
+ * an intermediate egg tree.
+ *
+ * The converter adds polygons and lines, each with a RenderState; the
+ * builder triangulates the polygons, synthesizes any missing normals
+ * (smoothing across polygons within a given angle, as
+ * EggGroupNode::recompute_vertex_normals() does), shares identical vertices,
+ * and emits one or more Geoms per state into a GeomNode.  A new Geom is
+ * started whenever egg-max-vertices or egg-max-indices would otherwise be
+ * exceeded.
+ */
+class NodeGeomBuilder {
+public:
+  enum VertexFlags {
+    VF_normal  = 0x0001,
+    VF_uv      = 0x0002,
+    VF_color   = 0x0004,
+  };
+
+  class Vertex {
+  public:
+    INLINE Vertex();
+    INLINE Vertex(const LPoint3d &pos);
+
+    INLINE void set_normal(const LNormald &normal);
+    INLINE void set_uv(const LTexCoordd &uv);
+    INLINE void set_color(const LColor &color);
+
+    INLINE bool operator == (const Vertex &other) const;
+    size_t get_hash() const;
+
+    LPoint3d _pos;
+    LNormald _normal;
+    LTexCoordd _uv;
+    LColor _color;
+    int _flags;
+  };
+
+  NodeGeomBuilder(CoordinateSystem cs = CS_default);
+
+  INLINE void set_coordinate_system(CoordinateSystem cs);
+  INLINE CoordinateSystem get_coordinate_system() const;
+
+  void add_polygon(const RenderState *state, const Vertex *vertices,
+                   int num_vertices, double smooth_angle = 0.0);
+  void add_line(const RenderState *state, const Vertex *vertices,
+                int num_vertices);
+  INLINE bool is_empty() const;
+
+  void build(GeomNode *geom_node);
+  void clear();
+
+private:
+  class Primitive {
+  public:
+    int _state_index;
+    int _first_vertex;
+    int _num_vertices;
+    double _smooth_angle;
+    bool _is_line;
+  };
+
+  class VertexCompare {
+  public:
+    INLINE static size_t get_hash(const Vertex &key);
+    INLINE static bool is_equal(const Vertex &a, const Vertex &b);
+  };
+  typedef IndexHashTable<Vertex, VertexCompare> UniqueVertices;
+
+  // One of these accumulates the current Geom for each state and primitive
+  // type.
+  class Bucket {
+  public:
+    CPT(RenderState) _state;
+    bool _is_line;
+    pvector<Vertex> _vertices;
+    PT(GeomPrimitive) _prim;
+    int _flags;
+  };
+  typedef pvector<Bucket> Buckets;
+
+  int get_state_index(const RenderState *state);
+  void compute_normals();
+  LNormald get_polygon_normal(const Primitive &prim) const;
+  int add_bucket_vertex(Bucket &bucket, const Vertex &vertex);
+  void emit_polygon(Bucket &bucket, const Primitive &prim,
+                    GeomNode *geom_node);
+  void emit_line(Bucket &bucket, const Primitive &prim, GeomNode *geom_node);
+  void close_bucket(Bucket &bucket, GeomNode *geom_node);
+
+  CoordinateSystem _cs;
+
+  pvector<Vertex> _vertices;
+  pvector<Primitive> _prims;
+
+  typedef pvector<CPT(RenderState)> States;
+  States _states;
+  typedef pmap<const RenderState *, int> StateIndices;
+  StateIndices _state_indices;
+
+  UniqueVertices _unique_vertices;
+};
+
+#include "nodeGeomBuilder.I"
+
+#endif
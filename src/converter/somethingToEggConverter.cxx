@@ -15,6 +15,11 @@
 
 #include "eggData.h"
 #include "eggExternalReference.h"
+#include "workerPool.h"
+#include "virtualFileSystem.h"
+#include "trueClock.h"
+#include "thread.h"
+#include "pset.h"
 
 /**
  *
@@ -65,6 +70,9 @@ SomethingToEggConverter::
 void SomethingToEggConverter::
 set_egg_data(EggData *egg_data) {
   _egg_data = egg_data;
+
+  // Nodes cached from a previous conversion may not be shared with this one.
+  _ext_cache = nullptr;
 }
 
 /**
@@ -126,6 +134,10 @@ convert_to_node(const LoaderOptions &options, const Filename &filename) {
  * egg_parent.  Otherwise, only a reference to a similarly named egg file is
  * parented to egg_parent.
  *
+ * Each file is converted only once per conversion; further references to the
+ * same file receive a copy of the first conversion, or fail at once if the
+ * first conversion failed.
+ *
  * The parameters orig_filename and searchpath are as those passed to
  * convert_model_path().
  *
@@ -135,20 +147,33 @@ bool SomethingToEggConverter::
 handle_external_reference(EggGroupNode *egg_parent,
                           const Filename &ref_filename) {
   if (_merge_externals) {
-    SomethingToEggConverter *ext = make_copy();
-    PT(EggData) egg_data = new EggData;
-    egg_data->set_coordinate_system(get_egg_data()->get_coordinate_system());
-    ext->set_egg_data(egg_data);
-
-    if (!ext->convert_file(ref_filename)) {
-      delete ext;
-      nout << "Unable to read external reference: " << ref_filename << "\n";
+    ExternalReferenceCache *cache = get_or_make_external_cache();
+    std::string key = get_external_key(ref_filename);
+    if (cache->begin_convert(key)) {
+      convert_external(key, ref_filename);
+    }
+    switch (cache->instance(key, egg_parent)) {
+    case ExternalReferenceCache::IR_instanced:
+      return true;
+
+    case ExternalReferenceCache::IR_failed:
+      // It has already failed once, and said so.
+      _error = true;
+      return false;
+
+    case ExternalReferenceCache::IR_convert_again:
+      break;
+    }
+
+    // The file contains something that can't be copied for a second
+    // reference.  Convert it again, on its own.
+    PT(EggData) egg_data = read_external(ref_filename);
+    if (egg_data == nullptr) {
       _error = true;
       return false;
     }
 
     egg_parent->steal_children(*egg_data);
-    delete ext;
     return true;
 
   } else {
@@ -163,3 +188,133 @@ handle_external_reference(EggGroupNode *egg_parent,
 
   return true;
 }
+
+/**
+ * May be called by a converter before it begins to walk its source file,
+ * with the list of all of the external references the file contains, to
+ * convert them in parallel, in advance of the calls to
+ * handle_external_reference() that will need them.  This does nothing unless
+ * the merge_externals flag is true.
+ */
+void SomethingToEggConverter::
+prefetch_external_references(const pvector<Filename> &ref_filenames) {
+  if (!_merge_externals || ref_filenames.empty()) {
+    return;
+  }
+
+  ExternalReferenceCache *cache = get_or_make_external_cache();
+
+  // Collect each distinct file.  A file is not claimed until its job
+  // actually starts, because a file converted by one job may itself refer to
+  // another file in the list; that nested reference must be free to convert
+  // the file on the spot rather than wait for a job that hasn't started.
+  pvector<Filename> filenames;
+  pvector<std::string> keys;
+  pset<std::string> seen;
+  pvector<Filename>::const_iterator fi;
+  for (fi = ref_filenames.begin(); fi != ref_filenames.end(); ++fi) {
+    std::string key = get_external_key(*fi);
+    if (seen.insert(key).second) {
+      filenames.push_back(*fi);
+      keys.push_back(key);
+    }
+  }
+
+  if (filenames.empty()) {
+    return;
+  }
+
+  // If we are ourselves converting an external reference on a worker
+  // thread, don't start yet more threads.
+  int num_threads = 0;
+  if (Thread::get_current_thread() != Thread::get_main_thread()) {
+    num_threads = 1;
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  WorkerPool pool(num_threads);
+  pool.run((int)filenames.size(), [&](int n) {
+    if (cache->begin_convert(keys[n])) {
+      convert_external(keys[n], filenames[n]);
+    }
+  });
+
+  if (num_threads != 1) {
+    cache->add_prefetch_time(clock->get_short_time() - start);
+  }
+}
+
+/**
+ * Returns the cache of external references for the current conversion,
+ * creating it if necessary.
+ */
+ExternalReferenceCache *SomethingToEggConverter::
+get_or_make_external_cache() {
+  if (_ext_cache == nullptr) {
+    _ext_cache = new ExternalReferenceCache;
+  }
+  return _ext_cache;
+}
+
+/**
+ * Returns the string by which the conversion of the indicated external file
+ * is known in the cache: its fully-resolved path, together with the options
+ * that affect how it is converted.
+ */
+std::string SomethingToEggConverter::
+get_external_key(const Filename &ref_filename) const {
+  Filename fullpath = ref_filename;
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  vfs->resolve_filename(fullpath, get_model_path());
+  fullpath.make_absolute();
+
+  std::ostringstream strm;
+  strm << get_name() << ":"
+       << (int)_egg_data->get_coordinate_system() << ":"
+       << _allow_errors << ":"
+       << fullpath.get_fullpath();
+  return strm.str();
+}
+
+/**
+ * Converts the indicated external file on behalf of the cache, following a
+ * call to ExternalReferenceCache::begin_convert() that returned true.  This
+ * may be called from a worker thread.
+ */
+void SomethingToEggConverter::
+convert_external(const std::string &key, const Filename &ref_filename) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  PT(EggData) egg_data = read_external(ref_filename);
+
+  _ext_cache->end_convert(key, egg_data, clock->get_short_time() - start);
+}
+
+/**
+ * Reads and converts the indicated external file with a copy of this
+ * converter, and returns the resulting egg data, or NULL on failure.
+ */
+PT(EggData) SomethingToEggConverter::
+read_external(const Filename &ref_filename) {
+  SomethingToEggConverter *ext = make_copy();
+  PT(EggData) egg_data = new EggData;
+  egg_data->set_coordinate_system(get_egg_data()->get_coordinate_system());
+  ext->set_egg_data(egg_data);
+
+  // The copy shares our cache, so that the external references it contains
+  // in turn are also converted only once.
+  ext->_ext_cache = _ext_cache;
+
+  bool okflag = ext->convert_file(ref_filename);
+  delete ext;
+
+  if (!okflag) {
+    nout << "Unable to read external reference: " << ref_filename << "\n";
+    return nullptr;
+  }
+
+  return egg_data;
+}
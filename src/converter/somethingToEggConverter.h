@@ -23,6 +23,8 @@
 #include "pointerTo.h"
 #include "distanceUnit.h"
 #include "pandaNode.h"
+#include "externalReferenceCache.h"
+#include "pvector.h"
 
 class EggData;
 class EggGroupNode;
@@ -109,12 +111,20 @@ public:
 
   bool handle_external_reference(EggGroupNode *egg_parent,
                                  const Filename &ref_filename);
+  void prefetch_external_references(const pvector<Filename> &ref_filenames);
+  INLINE ExternalReferenceCache *get_external_cache() const;
 
   INLINE Filename convert_model_path(const Filename &orig_filename);
 
   // Set this true to treat errors as warnings and generate output anyway.
   bool _allow_errors;
 
+private:
+  ExternalReferenceCache *get_or_make_external_cache();
+  std::string get_external_key(const Filename &ref_filename) const;
+  void convert_external(const std::string &key, const Filename &ref_filename);
+  PT(EggData) read_external(const Filename &ref_filename);
+
 protected:
   PT(PathReplace) _path_replace;
 
@@ -138,6 +148,10 @@ protected:
 
   bool _merge_externals;
 
+  // This is shared with the copies made to convert external references,
+  // and discarded by set_egg_data().
+  PT(ExternalReferenceCache) _ext_cache;
+
   PT(EggData) _egg_data;
 
   bool _error;
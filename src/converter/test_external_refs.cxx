@@ -0,0 +1,180 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_external_refs.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "somethingToEggConverter.h"
+#include "config_pandatoolbase.h"
+#include "config_egg.h"
+#include "eggData.h"
+#include "eggGroup.h"
+#include "pmap.h"
+#include "pmutex.h"
+#include "mutexHolder.h"
+
+/**
+ * A converter for imaginary files, each of which consists of nothing but a
+ * group named for the file, and a list of the other files it references.
+ * The files themselves don't exist; their references are looked up in
+ * _files, and a file that isn't listed there fails to convert.  The number
+ * of attempts to convert each file is counted in _attempts.
+ */
+class TestConverter : public SomethingToEggConverter {
+public:
+  virtual SomethingToEggConverter *make_copy() {
+    return new TestConverter(*this);
+  }
+  virtual std::string get_name() const {
+    return "Test";
+  }
+  virtual std::string get_extension() const {
+    return "test";
+  }
+  virtual bool convert_file(const Filename &filename);
+
+  typedef pmap<std::string, pvector<Filename> > Files;
+  static Files _files;
+
+  typedef pmap<std::string, int> Attempts;
+  static Attempts _attempts;
+  static Mutex _attempts_lock;
+};
+
+TestConverter::Files TestConverter::_files;
+TestConverter::Attempts TestConverter::_attempts;
+Mutex TestConverter::_attempts_lock;
+
+/**
+ * Adds the group for the file, and merges in the files it references, after
+ * first prefetching them all, as a real converter would.
+ */
+bool TestConverter::
+convert_file(const Filename &filename) {
+  std::string name = filename.get_basename_wo_extension();
+  {
+    MutexHolder holder(_attempts_lock);
+    ++_attempts[name];
+  }
+
+  Files::const_iterator fi = _files.find(name);
+  if (fi == _files.end()) {
+    return false;
+  }
+
+  EggGroup *group = new EggGroup(name);
+  get_egg_data()->add_child(group);
+
+  const pvector<Filename> &refs = (*fi).second;
+  prefetch_external_references(refs);
+  bool okflag = true;
+  for (const Filename &ref : refs) {
+    if (!handle_external_reference(group, ref)) {
+      okflag = false;
+    }
+  }
+  return okflag;
+}
+
+/**
+ * Returns the number of groups with the indicated name at or below node.
+ */
+static int
+count_groups(EggNode *node, const std::string &name) {
+  int count = (node->is_of_type(EggGroup::get_class_type()) &&
+               node->get_name() == name) ? 1 : 0;
+  if (node->is_of_type(EggGroupNode::get_class_type())) {
+    EggGroupNode *group = DCAST(EggGroupNode, node);
+    for (EggNode *child : *group) {
+      count += count_groups(child, name);
+    }
+  }
+  return count;
+}
+
+/**
+ * Converts a.test, which references b.test and c.test, where b.test also
+ * references c.test.  The nested reference to c.test is made while c.test's
+ * own prefetch job may not yet have started, which once deadlocked.
+ */
+static bool
+run_test(int num_threads) {
+  pandatool_num_threads.set_value(num_threads);
+
+  TestConverter converter;
+  converter.set_merge_externals(true);
+  PT(EggData) egg_data = new EggData;
+  converter.set_egg_data(egg_data);
+
+  if (!converter.convert_file(Filename("a.test"))) {
+    nout << num_threads << " threads: conversion failed\n";
+    return false;
+  }
+
+  int num_b = count_groups(egg_data, "b");
+  int num_c = count_groups(egg_data, "c");
+  if (num_b != 1 || num_c != 2) {
+    nout << num_threads << " threads: got " << num_b << " b and " << num_c
+         << " c, expected 1 b and 2 c\n";
+    return false;
+  }
+
+  nout << num_threads << " threads: ok\n";
+  return true;
+}
+
+/**
+ * Converts e.test, which references the nonexistent missing.test twice.  The
+ * conversion should fail, but missing.test should be tried only once.
+ */
+static bool
+run_failure_test(int num_threads) {
+  pandatool_num_threads.set_value(num_threads);
+  TestConverter::_attempts.clear();
+
+  TestConverter converter;
+  converter.set_merge_externals(true);
+  PT(EggData) egg_data = new EggData;
+  converter.set_egg_data(egg_data);
+
+  if (converter.convert_file(Filename("e.test"))) {
+    nout << num_threads << " threads: conversion of e unexpectedly succeeded\n";
+    return false;
+  }
+
+  int attempts = TestConverter::_attempts["missing"];
+  if (attempts != 1) {
+    nout << num_threads << " threads: tried missing " << attempts
+         << " times, expected 1\n";
+    return false;
+  }
+
+  nout << num_threads << " threads: failure ok\n";
+  return true;
+}
+
+int
+main(int argc, char *argv[]) {
+  init_libegg();
+
+  TestConverter::_files["a"].push_back(Filename("b.test"));
+  TestConverter::_files["a"].push_back(Filename("c.test"));
+  TestConverter::_files["b"].push_back(Filename("c.test"));
+  TestConverter::_files["c"];
+  TestConverter::_files["e"].push_back(Filename("missing.test"));
+  TestConverter::_files["e"].push_back(Filename("missing.test"));
+
+  bool success = true;
+  success = run_test(1) && success;
+  success = run_test(4) && success;
+  success = run_failure_test(1) && success;
+  success = run_failure_test(4) && success;
+  return success ? 0 : 1;
+}
@@ -12,13 +12,19 @@
  */
 
 #include "dxfFile.h"
-#include "string_utils.h"
 #include "virtualFileSystem.h"
 
 using std::istream;
 using std::ostream;
 using std::string;
 
+// The minimum number of bytes requested from the stream at a time.
+static const size_t dxf_buffer_size = 65536;
+
+// The sentinel that begins a binary DXF file, including its terminating NUL.
+static const char dxf_binary_sentinel[] = "AutoCAD Binary DXF\r\n\x1a";
+static const size_t dxf_binary_sentinel_length = sizeof(dxf_binary_sentinel);
+
 DXFFile::Color DXFFile::_colors[DXF_num_colors] = {
   { 1, 1, 1 },        // Color 0 is not used.
   { 1, 0, 0 },        // Color 1 = Red
@@ -289,6 +295,13 @@ DXFFile() {
   _layer = nullptr;
   reset_entity();
   _color_index = -1;
+  _binary = false;
+  _two_byte_codes = false;
+  _value = 0.0;
+  _num_entities = 0;
+  _buffer_pos = 0;
+  _buffer_end = 0;
+  _in_eof = true;
 }
 
 /**
@@ -308,7 +321,10 @@ DXFFile::
  */
 void DXFFile::
 process(Filename filename) {
-  filename.set_text();
+  // We open the file in binary mode, since it might be a binary DXF file.
+  // For an ASCII file, a trailing carriage return is stripped along with any
+  // other whitespace at the end of each line.
+  filename.set_binary();
 
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
   istream *in = vfs->open_read_file(filename, true);
@@ -333,6 +349,8 @@ process(istream *in, bool owns_in) {
   _in = in;
   _owns_in = owns_in;
   _state = ST_top;
+  _num_entities = 0;
+  start_reading();
 
   begin_file();
   while (_state != ST_done && _state != ST_error) {
@@ -471,6 +489,15 @@ get_color() const {
   return _colors[0];
 }
 
+/**
+ * Returns the number of entities that have been completely read from the
+ * file so far.  This is mainly useful for reporting progress.
+ */
+int DXFFile::
+get_num_entities() const {
+  return _num_entities;
+}
+
 
 /**
  * Assuming the current entity is a planar-based entity, for instance, a 2-d
@@ -532,40 +559,209 @@ compute_ocs() {
 }
 
 
+/**
+ * Returns the value of the current group, interpreted as a floating-point
+ * number.
+ */
+double DXFFile::
+get_double_value() const {
+  if (_binary) {
+    return _value;
+  }
+  return strtod(_string.c_str(), nullptr);
+}
+
+/**
+ * Returns the value of the current group, interpreted as an integer.
+ */
+int DXFFile::
+get_int_value() const {
+  if (_binary) {
+    return (int)_value;
+  }
+  return (int)strtol(_string.c_str(), nullptr, 10);
+}
+
 /**
  * Reads the next code, string pair from the DXF file.  This is the basic unit
  * of data in a DXF file.
  */
 bool DXFFile::
 get_group() {
-  istream &in = *_in;
+  bool okflag;
   do {
-    in >> _code;
-    if (!in) {
+    okflag = _binary ? get_binary_group() : get_text_group();
+    if (!okflag) {
       change_state(ST_error);
       return false;
     }
 
-    // Now skip past exactly one newline character and any number of other
-    // whitespace characters.
-    while (in && in.peek() != '\n') {
-      in.get();
+    // If we just read a comment, go back and get another one.
+  } while (_code == 999);
+
+  return true;
+}
+
+/**
+ * Reads the next code, string pair from an ASCII DXF file.  Each of these is
+ * stored on two lines; the lines are scanned directly within the read buffer,
+ * so that only the string value need be copied out.  Returns true on success,
+ * false on error or end of file.
+ */
+bool DXFFile::
+get_text_group() {
+  const char *begin, *end;
+
+  // Get the group code, skipping any blank lines before it.
+  do {
+    if (!get_line(begin, end, '\n')) {
+      return false;
     }
-    in.get();
-    while (in && isspace(in.peek()) && in.peek() != '\n') {
-      in.get();
+    while (begin < end && isspace((unsigned char)*begin)) {
+      ++begin;
     }
+  } while (begin == end);
 
-    std::getline(in, _string);
-    _string = trim_right(_string);
+  bool negative = false;
+  if (*begin == '-') {
+    negative = true;
+    ++begin;
+  }
+  if (begin == end || !isdigit((unsigned char)*begin)) {
+    return false;
+  }
+  int code = 0;
+  while (begin < end && isdigit((unsigned char)*begin)) {
+    code = code * 10 + (*begin - '0');
+    ++begin;
+  }
+  _code = negative ? -code : code;
 
-    if (!in) {
-      change_state(ST_error);
+  // Now get the value, without any leading or trailing whitespace.
+  if (!get_line(begin, end, '\n')) {
+    return false;
+  }
+  while (begin < end && isspace((unsigned char)*begin)) {
+    ++begin;
+  }
+  while (end > begin && isspace((unsigned char)end[-1])) {
+    --end;
+  }
+  _string.assign(begin, end - begin);
+  return true;
+}
+
+/**
+ * Reads the next code, value pair from a binary DXF file.  The type of the
+ * value is implied by the group code.  Returns true on success, false on
+ * error or end of file.
+ */
+bool DXFFile::
+get_binary_group() {
+  const unsigned char *data;
+
+  if (_two_byte_codes) {
+    data = get_bytes(2);
+    if (data == nullptr) {
+      return false;
+    }
+    _code = (int16_t)(data[0] | (data[1] << 8));
+  } else {
+    // Older files store the code in a single byte, with 255 indicating that
+    // a two-byte extended code follows.
+    data = get_bytes(1);
+    if (data == nullptr) {
       return false;
     }
+    _code = data[0];
+    if (_code == 255) {
+      data = get_bytes(2);
+      if (data == nullptr) {
+        return false;
+      }
+      _code = (int16_t)(data[0] | (data[1] << 8));
+    }
+  }
 
-    // If we just read a comment, go back and get another one.
-  } while (_code == 999);
+  int code = _code;
+  if ((code >= 10 && code <= 59) || (code >= 110 && code <= 149) ||
+      (code >= 210 && code <= 239) || (code >= 460 && code <= 469) ||
+      (code >= 1010 && code <= 1059)) {
+    // A double-precision floating-point value.
+    data = get_bytes(8);
+    if (data == nullptr) {
+      return false;
+    }
+    uint64_t bits = 0;
+    for (int i = 7; i >= 0; --i) {
+      bits = (bits << 8) | data[i];
+    }
+    memcpy(&_value, &bits, sizeof(_value));
+    _string.clear();
+
+  } else if ((code >= 60 && code <= 79) || (code >= 170 && code <= 179) ||
+             (code >= 270 && code <= 289) || (code >= 370 && code <= 389) ||
+             (code >= 400 && code <= 409) || (code >= 1060 && code <= 1070)) {
+    // A 16-bit integer.
+    data = get_bytes(2);
+    if (data == nullptr) {
+      return false;
+    }
+    _value = (int16_t)(data[0] | (data[1] << 8));
+    _string.clear();
+
+  } else if ((code >= 90 && code <= 99) || (code >= 420 && code <= 459) ||
+             code == 1071) {
+    // A 32-bit integer.
+    data = get_bytes(4);
+    if (data == nullptr) {
+      return false;
+    }
+    _value = (int32_t)((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                       ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+    _string.clear();
+
+  } else if (code >= 160 && code <= 169) {
+    // A 64-bit integer.
+    data = get_bytes(8);
+    if (data == nullptr) {
+      return false;
+    }
+    uint64_t bits = 0;
+    for (int i = 7; i >= 0; --i) {
+      bits = (bits << 8) | data[i];
+    }
+    _value = (double)(int64_t)bits;
+    _string.clear();
+
+  } else if (code >= 290 && code <= 299) {
+    // A boolean, stored in a single byte.
+    data = get_bytes(1);
+    if (data == nullptr) {
+      return false;
+    }
+    _value = data[0];
+    _string.clear();
+
+  } else if ((code >= 310 && code <= 319) || code == 1004) {
+    // A chunk of binary data, preceded by its length.  We don't use these,
+    // so we just skip over it.
+    data = get_bytes(1);
+    if (data == nullptr || get_bytes(data[0]) == nullptr) {
+      return false;
+    }
+    _value = 0.0;
+    _string.clear();
+
+  } else {
+    // Everything else is a NUL-terminated string.
+    const char *begin, *end;
+    if (!get_line(begin, end, '\0')) {
+      return false;
+    }
+    _value = 0.0;
+    _string.assign(begin, end - begin);
+  }
 
   return true;
 }
@@ -589,6 +785,7 @@ change_state(State new_state) {
     // last vertex (if we were scanning the vertices after an entity).
     done_entity();
     reset_entity();
+    ++_num_entities;
   }
   switch (new_state) {
   case ST_top:
@@ -714,8 +911,6 @@ state_top() {
  */
 void DXFFile::
 state_section() {
-  string tail;
-
   switch (_code) {
   case 0:
     if (_string == "ENDSEC") {
@@ -744,7 +939,7 @@ state_section() {
     break;
 
   case 62:  // Color.
-    _color_index = string_to_int(_string, tail);
+    _color_index = get_int_value();
     break;
 
   default:
@@ -758,8 +953,6 @@ state_section() {
  */
 void DXFFile::
 state_entity() {
-  string tail;
-
   switch (_code) {
   case 0:
     state_section();
@@ -770,75 +963,75 @@ state_entity() {
     break;
 
   case 10:
-    _p[0] = string_to_double(_string, tail);
+    _p[0] = get_double_value();
     break;
 
   case 11:
-    _q[0] = string_to_double(_string, tail);
+    _q[0] = get_double_value();
     break;
 
   case 12:
-    _r[0] = string_to_double(_string, tail);
+    _r[0] = get_double_value();
     break;
 
   case 13:
-    _s[0] = string_to_double(_string, tail);
+    _s[0] = get_double_value();
     break;
 
   case 20:
-    _p[1] = string_to_double(_string, tail);
+    _p[1] = get_double_value();
     break;
 
   case 21:
-    _q[1] = string_to_double(_string, tail);
+    _q[1] = get_double_value();
     break;
 
   case 22:
-    _r[1] = string_to_double(_string, tail);
+    _r[1] = get_double_value();
     break;
 
   case 23:
-    _s[1] = string_to_double(_string, tail);
+    _s[1] = get_double_value();
     break;
 
   case 30:
-    _p[2] = string_to_double(_string, tail);
+    _p[2] = get_double_value();
     break;
 
   case 31:
-    _q[2] = string_to_double(_string, tail);
+    _q[2] = get_double_value();
     break;
 
   case 32:
-    _r[2] = string_to_double(_string, tail);
+    _r[2] = get_double_value();
     break;
 
   case 33:
-    _s[2] = string_to_double(_string, tail);
+    _s[2] = get_double_value();
     break;
 
   case 62:  // Color.
-    _color_index = string_to_int(_string, tail);
+    _color_index = get_int_value();
     break;
 
   case 66:  // Vertices-follow.
-    _vertices_follow = (string_to_int(_string, tail) != 0);
+    _vertices_follow = (get_int_value() != 0);
     break;
 
   case 70:  // Polyline flags.
-    _flags = string_to_int(_string, tail);
+    _flags = get_int_value();
     break;
 
   case 210:
-    _z[0] = string_to_double(_string, tail);
+    _z[0] = get_double_value();
     break;
 
   case 220:
-    _z[1] = string_to_double(_string, tail);
+    _z[1] = get_double_value();
     break;
 
   case 230:
-    _z[2] = string_to_double(_string, tail);
+    _z[2] = get_double_value();
     break;
 
   default:
@@ -853,8 +1046,6 @@ state_entity() {
  */
 void DXFFile::
 state_verts() {
-  string tail;
-
   switch (_code) {
   case 0:
     state_section();
@@ -865,15 +1056,15 @@ state_verts() {
     break;
 
   case 10:
-    _p[0] = string_to_double(_string, tail);
+    _p[0] = get_double_value();
     break;
 
   case 20:
-    _p[1] = string_to_double(_string, tail);
+    _p[1] = get_double_value();
     break;
 
   case 30:
-    _p[2] = string_to_double(_string, tail);
+    _p[2] = get_double_value();
     break;
 
   default:
@@ -882,6 +1073,122 @@ state_verts() {
 }
 
 
+/**
+ * Resets the read buffer for a new input stream, and determines whether the
+ * stream contains an ASCII or a binary DXF file.
+ */
+void DXFFile::
+start_reading() {
+  _buffer.resize(dxf_buffer_size);
+  _buffer_pos = 0;
+  _buffer_end = 0;
+  _in_eof = false;
+  _binary = false;
+  _two_byte_codes = false;
+
+  while (_buffer_end < dxf_binary_sentinel_length + 2 && fill_buffer()) {
+  }
+
+  if (_buffer_end >= dxf_binary_sentinel_length &&
+      memcmp(&_buffer[0], dxf_binary_sentinel,
+             dxf_binary_sentinel_length) == 0) {
+    _binary = true;
+    _buffer_pos = dxf_binary_sentinel_length;
+
+    // The first group is always a 0 code, followed by "SECTION".  In newer
+    // files, the code is two bytes long, so the second byte is also 0.
+    _two_byte_codes = (_buffer_end >= _buffer_pos + 2 &&
+                       _buffer[_buffer_pos + 1] == '\0');
+  }
+}
+
+/**
+ * Reads more data from the stream into the buffer, first shifting any
+ * unconsumed bytes to the beginning of the buffer (and growing the buffer, if
+ * it is already full of unconsumed bytes).  Returns true if any more data was
+ * read, false if we have reached the end of the file.
+ */
+bool DXFFile::
+fill_buffer() {
+  if (_in_eof) {
+    return false;
+  }
+
+  size_t available = _buffer_end - _buffer_pos;
+  if (_buffer_pos != 0) {
+    if (available != 0) {
+      memmove(&_buffer[0], &_buffer[0] + _buffer_pos, available);
+    }
+    _buffer_pos = 0;
+    _buffer_end = available;
+  }
+  if (_buffer_end == _buffer.size()) {
+    _buffer.resize(_buffer.size() * 2);
+  }
+
+  _in->read(&_buffer[0] + _buffer_end, _buffer.size() - _buffer_end);
+  size_t count = (size_t)_in->gcount();
+  _buffer_end += count;
+  if (count == 0 || !(*_in)) {
+    _in_eof = true;
+  }
+  return (count != 0);
+}
+
+/**
+ * Returns the range of bytes up to the next occurrence of the indicated
+ * terminator character, and consumes them along with the terminator.  The
+ * range points into the read buffer, and remains valid only until the next
+ * read.  If the file ends without a terminator, the remainder of the file is
+ * returned.  Returns false if there are no more bytes in the file.
+ */
+bool DXFFile::
+get_line(const char *&begin, const char *&end, char terminator) {
+  size_t scanned = 0;
+  while (true) {
+    const char *start = &_buffer[0] + _buffer_pos;
+    size_t available = _buffer_end - _buffer_pos;
+    const char *found =
+      (const char *)memchr(start + scanned, terminator, available - scanned);
+    if (found != nullptr) {
+      begin = start;
+      end = found;
+      _buffer_pos += (found - start) + 1;
+      return true;
+    }
+    scanned = available;
+
+    if (!fill_buffer()) {
+      // There is no terminator before the end of the file.
+      if (_buffer_pos == _buffer_end) {
+        return false;
+      }
+      begin = &_buffer[0] + _buffer_pos;
+      end = &_buffer[0] + _buffer_end;
+      _buffer_pos = _buffer_end;
+      return true;
+    }
+  }
+}
+
+/**
+ * Consumes the indicated number of bytes, and returns a pointer to them
+ * within the read buffer.  Returns NULL if the file ends first.
+ */
+const unsigned char *DXFFile::
+get_bytes(size_t length) {
+  while (_buffer_end - _buffer_pos < length) {
+    if (!fill_buffer()) {
+      return nullptr;
+    }
+  }
+  const unsigned char *data =
+    (const unsigned char *)&_buffer[0] + _buffer_pos;
+  _buffer_pos += length;
+  return data;
+}
+
+
 ostream &operator << (ostream &out, const DXFFile::State &state) {
   switch (state) {
   case DXFFile::ST_top:
@@ -22,6 +22,7 @@
 
 #include "luse.h"
 #include "filename.h"
+#include "pvector.h"
 
 
 static const int DXF_max_line = 256;
@@ -31,6 +32,8 @@ static const int DXF_num_colors = 256;
  * A generic DXF-reading class.  This class can read a DXF file but doesn't
  * actually do anything with the data; it's intended to be inherited from and
  * the appropriate functions overridden (particularly DoneEntity()).
+ *
+ * Both ASCII and binary DXF files are supported.
  */
 class DXFFile : public MemoryBase {
 public:
@@ -111,6 +114,10 @@ public:
   // time done_entity() is called.
   const Color &get_color() const;
 
+  // get_num_entities() returns the number of entities that have been
+  // completely read from the file so far.
+  int get_num_entities() const;
+
   // Some entities are defined in world coordinates, in 3-d space; other
   // entities are inherently 2-d in nature and are defined in planar
   // coordinates and must be converted to 3-d space.  Call this function from
@@ -146,9 +153,22 @@ protected:
   int _code;
   std::string _string;
 
+  // For a binary DXF file, numeric values are stored here rather than in
+  // _string.  Use get_double_value() and get_int_value() to retrieve the
+  // value of the current group in either case.
+  bool _binary;
+  bool _two_byte_codes;
+  double _value;
+  int _num_entities;
+
+  double get_double_value() const;
+  int get_int_value() const;
+
   void compute_ocs();
 
   bool get_group();
+  bool get_text_group();
+  bool get_binary_group();
   void change_state(State new_state);
   void change_section(Section new_section);
   void change_layer(const std::string &layer_name);
@@ -159,6 +179,19 @@ protected:
   void state_section();
   void state_entity();
   void state_verts();
+
+private:
+  void start_reading();
+  bool fill_buffer();
+  bool get_line(const char *&begin, const char *&end, char terminator);
+  const unsigned char *get_bytes(size_t length);
+
+  // The bytes between _buffer_pos and _buffer_end have been read from the
+  // stream, but not yet consumed.
+  pvector<char> _buffer;
+  size_t _buffer_pos;
+  size_t _buffer_end;
+  bool _in_eof;
 };
 
 std::ostream &operator << (std::ostream &out, const DXFFile::State &state);
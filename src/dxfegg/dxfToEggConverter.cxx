@@ -72,6 +72,18 @@ supports_compressed() const {
   return true;
 }
 
+/**
+ * Returns true if this converter can directly convert the model type to
+ * internal Panda memory structures, given the indicated options, or false
+ * otherwise.  If this returns true, then convert_to_node() may be called to
+ * perform the conversion, which may be faster than calling convert_file() if
+ * the ultimate goal is a PandaNode anyway.
+ */
+bool DXFToEggConverter::
+supports_convert_to_node(const LoaderOptions &options) const {
+  return true;
+}
+
 /**
  * Handles the reading of the input file and converting it to egg.  Returns
  * true if successful, false otherwise.
@@ -88,11 +100,41 @@ convert_file(const Filename &filename) {
   return !had_error();
 }
 
+/**
+ * Reads the input file and directly produces a ready-to-render model file as
+ * a PandaNode.  Returns NULL on failure, or if it is not supported.  (This
+ * functionality is not supported by all converter types; see
+ * supports_convert_to_node()).
+ */
+PT(PandaNode) DXFToEggConverter::
+convert_to_node(const LoaderOptions &options, const Filename &filename) {
+  clear_error();
+
+  _root_node = new PandaNode("");
+  process(filename);
+
+  DXFLayerMap::iterator li;
+  for (li = _layers.begin(); li != _layers.end(); ++li) {
+    ((DXFToEggLayer *)(*li).second)->build_node();
+  }
+
+  PT(PandaNode) result = _root_node;
+  _root_node = nullptr;
+
+  if (had_error()) {
+    return nullptr;
+  }
+  return result;
+}
+
 /**
  *
  */
 DXFLayer *DXFToEggConverter::
 new_layer(const std::string &name) {
+  if (_root_node != nullptr) {
+    return new DXFToEggLayer(name, _root_node);
+  }
   return new DXFToEggLayer(name, get_egg_data());
 }
 
@@ -18,6 +18,7 @@
 
 #include "somethingToEggConverter.h"
 #include "dxfFile.h"
+#include "pandaNode.h"
 
 /**
  * This class supervises the construction of an EggData structure from a DXF
@@ -34,8 +35,10 @@ public:
   virtual std::string get_name() const;
   virtual std::string get_extension() const;
   virtual bool supports_compressed() const;
+  virtual bool supports_convert_to_node(const LoaderOptions &options) const;
 
   virtual bool convert_file(const Filename &filename);
+  virtual PT(PandaNode) convert_to_node(const LoaderOptions &options, const Filename &filename);
 
 protected:
   virtual DXFLayer *new_layer(const std::string &name);
@@ -43,6 +46,9 @@ protected:
   virtual void error();
 
   bool _error;
+
+  // Filled when creating a PandaNode directly.
+  PT(PandaNode) _root_node;
 };
 
 #endif
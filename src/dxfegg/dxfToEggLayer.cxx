@@ -20,6 +20,7 @@
 #include "eggLine.h"
 #include "eggVertex.h"
 #include "eggVertexPool.h"
+#include "colorAttrib.h"
 
 
 /**
@@ -33,6 +34,20 @@ DXFToEggLayer(const std::string &name, EggGroupNode *parent) : DXFLayer(name) {
   _group->add_child(_vpool);
 }
 
+/**
+ * This flavor of the constructor is used when converting directly to a
+ * PandaNode; the layer's geometry is built into a GeomNode of the same name,
+ * parented to the indicated node.
+ */
+DXFToEggLayer::
+DXFToEggLayer(const std::string &name, PandaNode *parent) : DXFLayer(name) {
+  _geom_node = new GeomNode(name);
+  parent->add_child(_geom_node);
+
+  // DXF files are always Z-up, as in convert_file().
+  _builder.set_coordinate_system(CS_zup_right);
+}
+
 
 /**
  * Given that done_entity() has just been called and that the current entity
@@ -41,6 +56,17 @@ DXFToEggLayer(const std::string &name, EggGroupNode *parent) : DXFLayer(name) {
  */
 void DXFToEggLayer::
 add_polygon(const DXFToEggConverter *entity) {
+  if (_geom_node != nullptr) {
+    pvector<NodeGeomBuilder::Vertex> vertices;
+    get_node_vertices(entity, vertices);
+    if (vertices.empty()) {
+      return;
+    }
+    _builder.add_polygon(RenderState::make(ColorAttrib::make_vertex()),
+                         &vertices[0], (int)vertices.size());
+    return;
+  }
+
   EggPolygon *poly = new EggPolygon;
   _group->add_child(poly);
 
@@ -70,6 +96,17 @@ add_polygon(const DXFToEggConverter *entity) {
  */
 void DXFToEggLayer::
 add_line(const DXFToEggConverter *entity) {
+  if (_geom_node != nullptr) {
+    pvector<NodeGeomBuilder::Vertex> vertices;
+    get_node_vertices(entity, vertices);
+    if (vertices.empty()) {
+      return;
+    }
+    _builder.add_line(RenderState::make(ColorAttrib::make_vertex()),
+                      &vertices[0], (int)vertices.size());
+    return;
+  }
+
   EggLine *line = new EggLine;
   _group->add_child(line);
 
@@ -97,3 +134,41 @@ add_vertex(const DXFVertex &vert) {
 
   return _vpool->create_unique_vertex(egg_vert);
 }
+
+/**
+ * Converts the geometry accumulated for this layer into Geoms on its
+ * GeomNode.  This is only meaningful when converting directly to a PandaNode.
+ */
+void DXFToEggLayer::
+build_node() {
+  if (_geom_node != nullptr) {
+    _builder.build(_geom_node);
+  }
+}
+
+/**
+ * Fills the vector with the vertices of the current entity, in the form
+ * expected by the NodeGeomBuilder.  Consecutive repeated vertices are
+ * collapsed, as EggPrimitive::cleanup() would do; this is how a 3DFace
+ * represents a triangle.
+ */
+void DXFToEggLayer::
+get_node_vertices(const DXFToEggConverter *entity,
+                  pvector<NodeGeomBuilder::Vertex> &vertices) const {
+  const DXFFile::Color &color = entity->get_color();
+  LColor lcolor(color.r, color.g, color.b, 1.0);
+
+  vertices.reserve(entity->_verts.size());
+  DXFVertices::const_iterator vi;
+  for (vi = entity->_verts.begin(); vi != entity->_verts.end(); ++vi) {
+    if (!vertices.empty() && vertices.back()._pos == (*vi)._p) {
+      continue;
+    }
+    NodeGeomBuilder::Vertex vertex((*vi)._p);
+    vertex.set_color(lcolor);
+    vertices.push_back(vertex);
+  }
+  while (vertices.size() > 1 && vertices.back()._pos == vertices.front()._pos) {
+    vertices.pop_back();
+  }
+}
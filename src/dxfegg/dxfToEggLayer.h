@@ -20,6 +20,8 @@
 #include "eggVertexPool.h"
 #include "eggGroup.h"
 #include "pointerTo.h"
+#include "nodeGeomBuilder.h"
+#include "geomNode.h"
 
 class EggGroupNode;
 class EggVertex;
@@ -35,13 +37,23 @@ class DXFToEggConverter;
 class DXFToEggLayer : public DXFLayer {
 public:
   DXFToEggLayer(const std::string &name, EggGroupNode *parent);
+  DXFToEggLayer(const std::string &name, PandaNode *parent);
 
   void add_polygon(const DXFToEggConverter *entity);
   void add_line(const DXFToEggConverter *entity);
   EggVertex *add_vertex(const DXFVertex &vertex);
+  void build_node();
 
   PT(EggVertexPool) _vpool;
   PT(EggGroup) _group;
+
+  // These are used instead when converting directly to a PandaNode.
+  PT(GeomNode) _geom_node;
+  NodeGeomBuilder _builder;
+
+private:
+  void get_node_vertices(const DXFToEggConverter *entity,
+                         pvector<NodeGeomBuilder::Vertex> &vertices) const;
 };
 
 
@@ -14,6 +14,7 @@
 #include "dxfToEgg.h"
 
 #include "dxfToEggConverter.h"
+#include "trueClock.h"
 
 /**
  *
@@ -56,11 +57,23 @@ run() {
 
   apply_parameters(converter);
 
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
   if (!converter.convert_file(_input_filename)) {
     nout << "Errors in conversion.\n";
     exit(1);
   }
 
+  double elapsed = clock->get_short_time() - start;
+  int num_entities = converter.get_num_entities();
+  nout << "Converted " << num_entities << " entities in " << elapsed
+       << " seconds";
+  if (elapsed > 0.0) {
+    nout << " (" << (int)(num_entities / elapsed) << " entities per second)";
+  }
+  nout << "\n";
+
   write_egg_file();
   nout << "\n";
 }
@@ -3,7 +3,7 @@
 #define USE_PACKAGES freetype
 
 #define LOCAL_LIBS \
-  palettizer eggbase progbase
+  palettizer eggbase progbase pandatoolbase
 
 #define OTHER_LIBS \
     egg:c pandaegg:m \
@@ -21,13 +21,26 @@
   #define TARGET egg-mkfont
 
   #defer SOURCES \
+    distanceFieldMaker.h \
     eggMakeFont.h \
     rangeDescription.h rangeDescription.I \
     rangeIterator.h rangeIterator.I
 
   #define COMPOSITE_SOURCES \
+    distanceFieldMaker.cxx \
     eggMakeFont.cxx \
     rangeDescription.cxx \
     rangeIterator.cxx
 
 #end bin_target
+
+#begin test_bin_target
+  #define TARGET test_distance_field
+  #define LOCAL_LIBS \
+    pandatoolbase
+
+  #define SOURCES \
+    distanceFieldMaker.cxx distanceFieldMaker.h \
+    test_distance_field.cxx
+
+#end test_bin_target
@@ -0,0 +1,175 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file distanceFieldMaker.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "distanceFieldMaker.h"
+#include "pnmImage.h"
+
+#include <math.h>
+#include <algorithm>
+
+/**
+ * Computes the signed distance field for the glyph rendered in the indicated
+ * coverage image, which should be oversample times the size of the desired
+ * field in each dimension.  A pixel is considered to be inside the glyph if
+ * its coverage is at least one half.
+ *
+ * On return, field contains one value per pixel of the reduced field, in
+ * rows from the top.  The values are 0.5 at the edge of the glyph, rising to
+ * 1.0 at radius pixels inside it and falling to 0.0 at radius pixels outside
+ * it.
+ */
+void DistanceFieldMaker::
+make_field(const PNMImage &coverage, int oversample, double radius,
+           pvector<float> &field) {
+  _x_size = coverage.get_x_size();
+  _y_size = coverage.get_y_size();
+  size_t num_pixels = (size_t)_x_size * (size_t)_y_size;
+
+  _inside.resize(num_pixels);
+  for (int y = 0; y < _y_size; ++y) {
+    unsigned char *inside = &_inside[(size_t)y * _x_size];
+    for (int x = 0; x < _x_size; ++x) {
+      inside[x] = (coverage.get_bright(x, y) >= 0.5f);
+    }
+  }
+
+  // Find the squared distance from each pixel to the nearest pixel inside the
+  // glyph, and to the nearest pixel outside it.
+  transform(true, _dist_in);
+  transform(false, _dist_out);
+
+  // Now average the signed distances over each block of oversample x
+  // oversample pixels, and scale them down to the size of the field.
+  int out_x_size = _x_size / oversample;
+  int out_y_size = _y_size / oversample;
+  field.resize((size_t)out_x_size * (size_t)out_y_size);
+
+  double scale = 1.0 / ((double)oversample * oversample * oversample);
+  for (int oy = 0; oy < out_y_size; ++oy) {
+    for (int ox = 0; ox < out_x_size; ++ox) {
+      double sum = 0.0;
+      for (int sy = 0; sy < oversample; ++sy) {
+        size_t i = (size_t)(oy * oversample + sy) * _x_size + ox * oversample;
+        for (int sx = 0; sx < oversample; ++sx, ++i) {
+          // The distances are measured between pixel centers, so the edge
+          // itself is half a pixel closer.
+          if (_inside[i]) {
+            sum += 0.5 - sqrt((double)_dist_out[i]);
+          } else {
+            sum += sqrt((double)_dist_in[i]) - 0.5;
+          }
+        }
+      }
+
+      double value = 0.5 - 0.5 * (sum * scale) / radius;
+      field[(size_t)oy * out_x_size + ox] =
+        (float)std::max(0.0, std::min(1.0, value));
+    }
+  }
+}
+
+/**
+ * Fills dist with the squared distance from each pixel to the nearest pixel
+ * that is inside the glyph (if to_inside is true) or outside it (if it is
+ * false).
+ */
+void DistanceFieldMaker::
+transform(bool to_inside, pvector<float> &dist) {
+  // This stands in for infinity, but remains well-behaved in arithmetic.
+  static const float far_away = 1.0e20f;
+
+  size_t num_pixels = _inside.size();
+  dist.resize(num_pixels);
+  for (size_t i = 0; i < num_pixels; ++i) {
+    dist[i] = ((_inside[i] != 0) == to_inside) ? 0.0f : far_away;
+  }
+
+  transform_rows(&dist[0], _y_size, _x_size);
+
+  _transposed.resize(num_pixels);
+  transpose(&dist[0], &_transposed[0], _x_size, _y_size);
+  transform_rows(&_transposed[0], _x_size, _y_size);
+  transpose(&_transposed[0], &dist[0], _y_size, _x_size);
+}
+
+/**
+ * Replaces each of the indicated rows of squared distances with its
+ * one-dimensional distance transform: the minimum over all q of (p - q)^2 +
+ * f(q), for each p.
+ */
+void DistanceFieldMaker::
+transform_rows(float *data, int num_rows, int row_size) {
+  _row.resize(row_size);
+  _v.resize(row_size);
+  _z.resize(row_size + 1);
+
+  for (int r = 0; r < num_rows; ++r) {
+    float *f = data + (size_t)r * row_size;
+    std::copy(f, f + row_size, _row.begin());
+
+    // Find the lower envelope of the parabolas rooted at each point.  _v
+    // holds the roots of the parabolas in the envelope, and _z the
+    // boundaries between them.
+    int k = 0;
+    _v[0] = 0;
+    _z[0] = -HUGE_VAL;
+    _z[1] = HUGE_VAL;
+    for (int q = 1; q < row_size; ++q) {
+      double fq = (double)_row[q] + (double)q * q;
+      double s;
+      while (true) {
+        int p = _v[k];
+        s = (fq - ((double)_row[p] + (double)p * p)) / (2.0 * (q - p));
+        if (s > _z[k]) {
+          break;
+        }
+        --k;
+      }
+      ++k;
+      _v[k] = q;
+      _z[k] = s;
+      _z[k + 1] = HUGE_VAL;
+    }
+
+    // Then read the distances off the envelope.
+    k = 0;
+    for (int q = 0; q < row_size; ++q) {
+      while (_z[k + 1] < q) {
+        ++k;
+      }
+      int p = _v[k];
+      f[q] = (float)((double)(q - p) * (q - p) + _row[p]);
+    }
+  }
+}
+
+/**
+ * Copies the y_size rows of x_size values in from into to, transposed so that
+ * it has x_size rows of y_size values.
+ */
+void DistanceFieldMaker::
+transpose(const float *from, float *to, int x_size, int y_size) {
+  // This is done in small tiles, to be kinder to the cache.
+  static const int tile = 16;
+  for (int y0 = 0; y0 < y_size; y0 += tile) {
+    int y1 = std::min(y0 + tile, y_size);
+    for (int x0 = 0; x0 < x_size; x0 += tile) {
+      int x1 = std::min(x0 + tile, x_size);
+      for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+          to[(size_t)x * y_size + y] = from[(size_t)y * x_size + x];
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,55 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file distanceFieldMaker.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef DISTANCEFIELDMAKER_H
+#define DISTANCEFIELDMAKER_H
+
+#include "pandatoolbase.h"
+#include "pvector.h"
+
+class PNMImage;
+
+/**
+ * Computes a signed distance field for a glyph from an oversampled rendering
+ * of it, using an exact Euclidean distance transform.
+ *
+ * The transform is the separable one of Felzenszwalb and Huttenlocher: each
+ * row, and then each column, is transformed independently by computing the
+ * lower envelope of a set of parabolas, which takes time linear in the number
+ * of pixels no matter how far the field extends.  The columns are transposed
+ * into rows first, so that both passes run over contiguous memory.
+ *
+ * Each thread should have its own DistanceFieldMaker, since it keeps its
+ * scratch buffers from one glyph to the next.
+ */
+class DistanceFieldMaker {
+public:
+  void make_field(const PNMImage &coverage, int oversample, double radius,
+                  pvector<float> &field);
+
+private:
+  void transform(bool to_inside, pvector<float> &dist);
+  void transform_rows(float *data, int num_rows, int row_size);
+  static void transpose(const float *from, float *to, int x_size, int y_size);
+
+  int _x_size, _y_size;
+  pvector<unsigned char> _inside;
+  pvector<float> _dist_in, _dist_out, _transposed;
+
+  // Scratch space for transform_rows().
+  pvector<float> _row;
+  pvector<int> _v;
+  pvector<double> _z;
+};
+
+#endif
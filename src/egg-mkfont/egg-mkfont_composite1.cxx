@@ -1,3 +1,4 @@
+#include "distanceFieldMaker.cxx"
 
 #include "eggMakeFont.cxx"
 #include "rangeDescription.cxx"
@@ -13,6 +13,7 @@
 
 #include "eggMakeFont.h"
 #include "rangeIterator.h"
+#include "distanceFieldMaker.h"
 #include "palettizer.h"
 #include "filenameUnifier.h"
 #include "eggFile.h"
@@ -27,10 +28,12 @@
 #include "eggTexture.h"
 #include "eggVertexPool.h"
 #include "eggVertex.h"
+#include "workerPool.h"
 #include "string_utils.h"
 #include "dcast.h"
 
 #include <ctype.h>
+#include <math.h>
 
 using std::string;
 
@@ -129,6 +132,16 @@ EggMakeFont() : EggWriter(true, false) {
      "results in crisp text even when the text is enlarged or zoomed in.",
      &EggMakeFont::dispatch_true, nullptr, &_generate_distance_field);
 
+  add_option
+    ("edt", "n", 0,
+     "Compute the signed distance field with an exact Euclidean distance "
+     "transform, from a rendering of each glyph at n times the final "
+     "resolution, rather than letting the font renderer estimate it.  "
+     "This implies -sdf, and overrides -sf.  The field is more accurate "
+     "near sharp corners and thin strokes, and is generally faster to "
+     "compute for large glyphs.  A value of 8 is a good choice.",
+     &EggMakeFont::dispatch_int, &_use_edt, &_edt_oversample);
+
   add_option
     ("pm", "n", 0,
      "The number of extra pixels around a single character in the "
@@ -210,6 +223,14 @@ EggMakeFont() : EggWriter(true, false) {
      "-nopal is not specified.",
      &EggMakeFont::dispatch_int_pair, nullptr, _palette_size);
 
+  add_option
+    ("j", "threads", 0,
+     "Render the glyphs using the indicated number of threads, each with "
+     "its own copy of the font.  The default is taken from the "
+     "pandatool-num-threads config variable.  The output is the same "
+     "regardless of the number of threads.",
+     &EggMakeFont::dispatch_int, nullptr, &_num_threads);
+
   add_option
     ("face", "index", 0,
      "Specify the face index of the particular face within the font file "
@@ -228,6 +249,9 @@ EggMakeFont() : EggWriter(true, false) {
   _palette_size[0] = _palette_size[1] = 512;
   _face_index = 0;
   _generate_distance_field = false;
+  _use_edt = false;
+  _edt_oversample = 8;
+  _num_threads = 0;
 
   _text_maker = nullptr;
   _vpool = nullptr;
@@ -268,6 +292,22 @@ run() {
     exit(1);
   }
 
+  if (_use_edt) {
+    if (_edt_oversample < 1) {
+      nout << "Invalid oversample factor for -edt: " << _edt_oversample << "\n";
+      exit(1);
+    }
+    _generate_distance_field = true;
+
+    // The glyphs are oversampled by -edt instead.
+    if (_got_scale_factor && _scale_factor != 1.0) {
+      nout << "Ignoring -sf " << _scale_factor
+           << ", since -edt is in effect.\n";
+    }
+    _scale_factor = 1.0;
+    _got_scale_factor = true;
+  }
+
   if (_got_interior) {
     _no_native_aa = true;
   }
@@ -458,7 +498,9 @@ run() {
       _poly_margin -= 0.5;
     }
 
-    _text_maker->set_distance_field_radius(4);
+    if (!_use_edt) {
+      _text_maker->set_distance_field_radius(4);
+    }
   }
 
   // Also create an egg group indicating the font's design size and poly
@@ -470,12 +512,31 @@ run() {
   ds_group->add_child(point);
   point->add_vertex(vtx);
 
-  // Finally, add the characters, one at a time.
+  if (_use_edt) {
+    // The glyphs are rendered oversized, and reduced to their final size
+    // when the distance field is computed.
+    _text_maker->set_pixels_per_unit(_pixels_per_unit * _edt_oversample);
+    _text_maker->set_scale_factor(1.0);
+  }
+
+  // Finally, add the characters.  The glyphs are rendered in parallel, but
+  // they are added to the egg file in order, so that the output doesn't
+  // depend on the number of threads.
+  RenderedGlyphs glyphs;
   RangeIterator ri(_range);
   do {
-    add_character(ri.get_code());
+    glyphs.push_back(RenderedGlyph());
+    glyphs.back()._character = ri.get_code();
   } while (ri.next());
 
+  render_glyphs(glyphs);
+
+  RenderedGlyphs::const_iterator gi;
+  for (gi = glyphs.begin(); gi != glyphs.end(); ++gi) {
+    add_character(*gi);
+  }
+  _trefs.clear();
+
   // If there are extra glyphs, pick them up.
   if (!_extra_filenames.empty()) {
     vector_string::const_iterator si;
@@ -512,6 +573,12 @@ run() {
     }
     // pal->report_pi();
   }
+
+  pvector<PNMTextMaker *>::iterator mi;
+  for (mi = _thread_text_makers.begin(); mi != _thread_text_makers.end(); ++mi) {
+    delete (*mi);
+  }
+  _thread_text_makers.clear();
 }
 
 /**
@@ -535,17 +602,241 @@ make_vertex(const LPoint2d &xy) {
 }
 
 /**
- * Generates the indicated character and adds it to the font description.
+ * Creates another PNMTextMaker with the same font and settings as
+ * _text_maker, for use by another thread.  Returns NULL if the font cannot
+ * be loaded again.
+ */
+PNMTextMaker *EggMakeFont::
+make_text_maker() const {
+  PNMTextMaker *text_maker = new PNMTextMaker(_input_font_filename, _face_index);
+  if (!text_maker->is_valid()) {
+    delete text_maker;
+    return nullptr;
+  }
+
+  text_maker->set_point_size(_point_size);
+  text_maker->set_native_antialias(!_no_native_aa);
+  text_maker->set_interior_flag(_got_interior);
+  text_maker->set_pixels_per_unit(_text_maker->get_pixels_per_unit());
+  text_maker->set_scale_factor(_text_maker->get_scale_factor());
+  if (_generate_distance_field && !_use_edt) {
+    text_maker->set_distance_field_radius(4);
+  }
+  return text_maker;
+}
+
+/**
+ * Renders the glyph and texture image for each of the indicated characters.
+ * The characters are divided among several threads, each of which has its
+ * own PNMTextMaker, and hence its own FreeType face, since a face may not be
+ * used by more than one thread at once.
  */
 void EggMakeFont::
-add_character(int code) {
-  PNMTextGlyph *glyph = _text_maker->get_glyph(code);
+render_glyphs(RenderedGlyphs &glyphs) {
+  WorkerPool pool(_num_threads);
+
+  pvector<PNMTextMaker *> text_makers;
+  text_makers.push_back(_text_maker);
+  int num_threads = std::min(pool.get_num_threads(), (int)glyphs.size());
+  for (int i = 1; i < num_threads; ++i) {
+    PNMTextMaker *text_maker = make_text_maker();
+    if (text_maker == nullptr) {
+      break;
+    }
+    _thread_text_makers.push_back(text_maker);
+    text_makers.push_back(text_maker);
+  }
+
+  // The characters are interleaved among the threads, rather than divided
+  // into contiguous blocks, since neighboring characters tend to be of
+  // similar complexity.
+  size_t num_jobs = text_makers.size();
+  pvector<DistanceFieldMaker> field_makers(num_jobs);
+  pool.run((int)num_jobs, [&](int n) {
+    for (size_t i = n; i < glyphs.size(); i += num_jobs) {
+      render_glyph(text_makers[n], field_makers[n], glyphs[i]);
+    }
+  });
+}
+
+/**
+ * Gets the glyph for the indicated character from the indicated
+ * PNMTextMaker, and renders its texture image.
+ */
+void EggMakeFont::
+render_glyph(PNMTextMaker *text_maker, DistanceFieldMaker &field_maker,
+             RenderedGlyph &rendered) const {
+  rendered._glyph = text_maker->get_glyph(rendered._character);
+  rendered._hash = 0;
+  rendered._left = rendered._top = 0;
+  rendered._width = rendered._height = 0;
+  rendered._advance = 0.0;
+
+  PNMTextGlyph *glyph = rendered._glyph;
   if (glyph == nullptr) {
-    nout << "No definition in font for character " << code << ".\n";
     return;
   }
 
-  make_geom(glyph, code);
+  if (_use_edt) {
+    rendered._advance = glyph->get_advance() / _edt_oversample;
+    if (glyph->get_width() != 0 && glyph->get_height() != 0) {
+      render_distance_field(field_maker, rendered);
+      rendered._hash = hash_image(rendered._image);
+    }
+    return;
+  }
+
+  rendered._left = glyph->get_left();
+  rendered._top = glyph->get_top();
+  rendered._width = glyph->get_width();
+  rendered._height = glyph->get_height();
+  rendered._advance = glyph->get_advance();
+  if (rendered._width == 0 || rendered._height == 0) {
+    return;
+  }
+
+  PNMImage &image = rendered._image;
+  image.clear(glyph->get_width() + _tex_margin * 2,
+              glyph->get_height() + _tex_margin * 2, _num_channels);
+  image.fill(_bg[0], _bg[1], _bg[2]);
+  if (image.has_alpha()) {
+    image.alpha_fill(_bg[3]);
+  }
+  if (_got_interior) {
+    glyph->place(image, -glyph->get_left() + _tex_margin,
+                 glyph->get_top() + _tex_margin, _fg, _interior);
+  } else {
+    glyph->place(image, -glyph->get_left() + _tex_margin,
+                 glyph->get_top() + _tex_margin, _fg);
+  }
+
+  rendered._hash = hash_image(image);
+}
+
+/**
+ * Renders the texture image for the indicated glyph, which has been rendered
+ * at _edt_oversample times the final resolution, as a signed distance field.
+ * Also fills in the placement of the image, which is extended by the radius
+ * of the field on all sides.
+ */
+void EggMakeFont::
+render_distance_field(DistanceFieldMaker &field_maker,
+                      RenderedGlyph &rendered) const {
+  static const int radius = 4;
+  int ss = _edt_oversample;
+
+  // Find the bounds of the glyph in final pixels, rounded outward so that
+  // each final pixel covers a whole block of oversampled pixels.
+  PNMTextGlyph *glyph = rendered._glyph;
+  int hi_left = glyph->get_left();
+  int hi_top = glyph->get_top();
+  int left = (int)floor((double)hi_left / ss) - radius;
+  int right = (int)ceil((double)(hi_left + glyph->get_width()) / ss) + radius;
+  int top = (int)ceil((double)hi_top / ss) + radius;
+  int bottom = (int)floor((double)(hi_top - glyph->get_height()) / ss) - radius;
+
+  rendered._left = left;
+  rendered._top = top;
+  rendered._width = right - left;
+  rendered._height = top - bottom;
+
+  PNMImage coverage(rendered._width * ss, rendered._height * ss, 1);
+  glyph->place(coverage, -left * ss, top * ss, LColor(1.0, 1.0, 1.0, 1.0));
+
+  pvector<float> field;
+  field_maker.make_field(coverage, ss, radius, field);
+
+  PNMImage &image = rendered._image;
+  image.clear(rendered._width + _tex_margin * 2,
+              rendered._height + _tex_margin * 2, _num_channels);
+  image.fill(_bg[0], _bg[1], _bg[2]);
+  if (image.has_alpha()) {
+    image.alpha_fill(_bg[3]);
+  }
+
+  LColor delta = _fg - _bg;
+  for (int y = 0; y < rendered._height; ++y) {
+    const float *row = &field[(size_t)y * rendered._width];
+    for (int x = 0; x < rendered._width; ++x) {
+      LColor color = _bg + delta * row[x];
+      image.set_xel(x + _tex_margin, y + _tex_margin,
+                    color[0], color[1], color[2]);
+      if (image.has_alpha()) {
+        image.set_alpha(x + _tex_margin, y + _tex_margin, color[3]);
+      }
+    }
+  }
+}
+
+/**
+ * Returns a hash of the size and pixel values of the indicated image.
+ */
+size_t EggMakeFont::
+hash_image(const PNMImage &image) {
+  // This is the 32-bit FNV-1a hash.
+  uint32_t hash = 2166136261u;
+  hash = (hash ^ (uint32_t)image.get_x_size()) * 16777619u;
+  hash = (hash ^ (uint32_t)image.get_y_size()) * 16777619u;
+
+  int x_size = image.get_x_size();
+  int y_size = image.get_y_size();
+  bool has_alpha = image.has_alpha();
+  for (int y = 0; y < y_size; ++y) {
+    for (int x = 0; x < x_size; ++x) {
+      const xel &pixel = image.get_xel_val(x, y);
+      hash = (hash ^ (uint32_t)PPM_GETR(pixel)) * 16777619u;
+      hash = (hash ^ (uint32_t)PPM_GETG(pixel)) * 16777619u;
+      hash = (hash ^ (uint32_t)PPM_GETB(pixel)) * 16777619u;
+      if (has_alpha) {
+        hash = (hash ^ (uint32_t)image.get_alpha_val(x, y)) * 16777619u;
+      }
+    }
+  }
+  return hash;
+}
+
+/**
+ * Returns true if the two images have the same size and the same pixel
+ * values.
+ */
+bool EggMakeFont::
+same_image(const PNMImage &a, const PNMImage &b) {
+  if (a.get_x_size() != b.get_x_size() ||
+      a.get_y_size() != b.get_y_size() ||
+      a.get_num_channels() != b.get_num_channels()) {
+    return false;
+  }
+
+  int x_size = a.get_x_size();
+  int y_size = a.get_y_size();
+  bool has_alpha = a.has_alpha();
+  for (int y = 0; y < y_size; ++y) {
+    for (int x = 0; x < x_size; ++x) {
+      const xel &pa = a.get_xel_val(x, y);
+      const xel &pb = b.get_xel_val(x, y);
+      if (!PPM_EQUAL(pa, pb)) {
+        return false;
+      }
+      if (has_alpha && a.get_alpha_val(x, y) != b.get_alpha_val(x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Adds the indicated character, rendered earlier by render_glyphs(), to the
+ * font description.
+ */
+void EggMakeFont::
+add_character(const RenderedGlyph &rendered) {
+  if (rendered._glyph == nullptr) {
+    nout << "No definition in font for character " << rendered._character << ".\n";
+    return;
+  }
+
+  make_geom(rendered);
 }
 
 
@@ -553,17 +844,19 @@ add_character(int code) {
  * Creates the actual geometry for the glyph.
  */
 void EggMakeFont::
-make_geom(PNMTextGlyph *glyph, int character) {
+make_geom(const RenderedGlyph &rendered) {
+  int character = rendered._character;
+
   // Create an egg group to hold the polygon.
   string group_name = format_string(character);
   EggGroup *group = new EggGroup(group_name);
   _group->add_child(group);
 
-  if (glyph->get_width() != 0 && glyph->get_height() != 0) {
-    int bitmap_top = glyph->get_top();
-    int bitmap_left = glyph->get_left();
-    double tex_x_size = glyph->get_width();
-    double tex_y_size = glyph->get_height();
+  if (rendered._width != 0 && rendered._height != 0) {
+    int bitmap_top = rendered._top;
+    int bitmap_left = rendered._left;
+    double tex_x_size = rendered._width;
+    double tex_y_size = rendered._height;
 
     double poly_margin = _poly_margin;
     double x_origin = _tex_margin;
@@ -599,7 +892,7 @@ make_geom(PNMTextGlyph *glyph, int character) {
 
     EggPolygon *poly = new EggPolygon();
     group->add_child(poly);
-    poly->set_texture(get_tref(glyph, character));
+    poly->set_texture(get_tref(rendered));
 
     poly->add_vertex(v1);
     poly->add_vertex(v2);
@@ -609,7 +902,7 @@ make_geom(PNMTextGlyph *glyph, int character) {
 
   // Now create a single point where the origin of the next character will be.
 
-  EggVertex *v0 = make_vertex(LPoint2d(glyph->get_advance() / _pixels_per_unit + _render_margin, 0.0));
+  EggVertex *v0 = make_vertex(LPoint2d(rendered._advance / _pixels_per_unit + _render_margin, 0.0));
   EggPoint *point = new EggPoint;
   group->add_child(point);
   point->add_vertex(v0);
@@ -617,43 +910,35 @@ make_geom(PNMTextGlyph *glyph, int character) {
 
 /**
  * Returns the egg texture reference for a particular glyph, creating it if it
- * has not already been created.
+ * has not already been created.  Characters whose glyphs render to the same
+ * image share the same texture.
  */
 EggTexture *EggMakeFont::
-get_tref(PNMTextGlyph *glyph, int character) {
-  TRefs::iterator ti = _trefs.find(glyph);
-  if (ti != _trefs.end()) {
-    return (*ti).second;
+get_tref(const RenderedGlyph &rendered) {
+  TRefList &trefs = _trefs[rendered._hash];
+  TRefList::const_iterator ti;
+  for (ti = trefs.begin(); ti != trefs.end(); ++ti) {
+    if (same_image((*ti).first->_image, rendered._image)) {
+      return (*ti).second;
+    }
   }
 
-  EggTexture *tref = make_tref(glyph, character);
-  _trefs[glyph] = tref;
+  EggTexture *tref = make_tref(rendered);
+  trefs.push_back(TRefList::value_type(&rendered, tref));
   return tref;
 }
 
 /**
- * Generates a texture image for the indicated glyph, and returns its egg
- * reference.
+ * Records the texture image rendered for the indicated glyph, and returns its
+ * egg reference.
  */
 EggTexture *EggMakeFont::
-make_tref(PNMTextGlyph *glyph, int character) {
+make_tref(const RenderedGlyph &rendered) {
   char buffer[1024];
-  sprintf(buffer, _output_glyph_pattern.c_str(), character);
+  sprintf(buffer, _output_glyph_pattern.c_str(), rendered._character);
 
   Filename texture_filename = buffer;
-  PNMImage image(glyph->get_width() + _tex_margin * 2,
-                 glyph->get_height() + _tex_margin * 2, _num_channels);
-  image.fill(_bg[0], _bg[1], _bg[2]);
-  if (image.has_alpha()) {
-    image.alpha_fill(_bg[3]);
-  }
-  if (_got_interior) {
-    glyph->place(image, -glyph->get_left() + _tex_margin,
-                 glyph->get_top() + _tex_margin, _fg, _interior);
-  } else {
-    glyph->place(image, -glyph->get_left() + _tex_margin,
-                 glyph->get_top() + _tex_margin, _fg);
-  }
+  const PNMImage &image = rendered._image;
 
   // We don't write the image to disk immediately, since it might just get
   // palettized.  But we do record it in a TextureImage object within the
@@ -19,6 +19,7 @@
 
 #include "eggWriter.h"
 #include "eggTexture.h"
+#include "pnmImage.h"
 #include "pmap.h"
 #include "pvector.h"
 #include "vector_string.h"
@@ -28,6 +29,7 @@ class PNMTextGlyph;
 class EggVertexPool;
 class EggGroup;
 class TextureImage;
+class DistanceFieldMaker;
 
 /**
  * This program uses FreeType to generate an egg file and a series of texture
@@ -49,10 +51,35 @@ private:
   static bool dispatch_range(const std::string &, const std::string &arg, void *var);
   EggVertex *make_vertex(const LPoint2d &xy);
 
-  void add_character(int code);
-  void make_geom(PNMTextGlyph *glyph, int character);
-  EggTexture *get_tref(PNMTextGlyph *glyph, int character);
-  EggTexture *make_tref(PNMTextGlyph *glyph, int character);
+  // One of these is filled in for each character in _range by
+  // render_glyphs().
+  class RenderedGlyph {
+  public:
+    int _character;
+    PNMTextGlyph *_glyph;
+    PNMImage _image;
+    size_t _hash;
+
+    // The placement of _image relative to the glyph origin, and the advance
+    // to the next character, all in pixels of the generated texture.
+    int _left, _top, _width, _height;
+    double _advance;
+  };
+  typedef pvector<RenderedGlyph> RenderedGlyphs;
+
+  PNMTextMaker *make_text_maker() const;
+  void render_glyphs(RenderedGlyphs &glyphs);
+  void render_glyph(PNMTextMaker *text_maker, DistanceFieldMaker &field_maker,
+                    RenderedGlyph &rendered) const;
+  void render_distance_field(DistanceFieldMaker &field_maker,
+                             RenderedGlyph &rendered) const;
+  static size_t hash_image(const PNMImage &image);
+  static bool same_image(const PNMImage &a, const PNMImage &b);
+
+  void add_character(const RenderedGlyph &rendered);
+  void make_geom(const RenderedGlyph &rendered);
+  EggTexture *get_tref(const RenderedGlyph &rendered);
+  EggTexture *make_tref(const RenderedGlyph &rendered);
   void add_extra_glyphs(const Filename &extra_filename);
   void r_add_extra_glyphs(EggGroupNode *egg_group);
   static bool is_numeric(const std::string &str);
@@ -75,6 +102,9 @@ private:
   bool _no_palettize;
   int _palette_size[2];
   bool _generate_distance_field;
+  bool _use_edt;
+  int _edt_oversample;
+  int _num_threads;
 
   double _palettize_scale_factor;
   Filename _input_font_filename;
@@ -83,13 +113,17 @@ private:
   std::string _output_palette_pattern;
 
   PNMTextMaker *_text_maker;
+  pvector<PNMTextMaker *> _thread_text_makers;
 
   EggTexture::Format _format;
   int _num_channels;
   EggVertexPool *_vpool;
   EggGroup *_group;
 
-  typedef pmap<PNMTextGlyph *, EggTexture *> TRefs;
+  // The textures generated so far, indexed by the hash of their image, so
+  // that characters with identical glyphs can share the same texture.
+  typedef pvector<std::pair<const RenderedGlyph *, EggTexture *> > TRefList;
+  typedef pmap<size_t, TRefList> TRefs;
   TRefs _trefs;
 
   typedef pvector<TextureImage *> Textures;
@@ -0,0 +1,168 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_distance_field.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "distanceFieldMaker.h"
+#include "pnmImage.h"
+#include "clockObject.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Computes the same field as DistanceFieldMaker::make_field(), by searching
+ * every pixel of the coverage image for the nearest one on the other side of
+ * the edge.
+ */
+static void
+make_brute_field(const PNMImage &coverage, int oversample, double radius,
+                 pvector<float> &field) {
+  int x_size = coverage.get_x_size();
+  int y_size = coverage.get_y_size();
+
+  pvector<double> signed_dist((size_t)x_size * y_size);
+  for (int y = 0; y < y_size; ++y) {
+    for (int x = 0; x < x_size; ++x) {
+      bool inside = (coverage.get_bright(x, y) >= 0.5f);
+      double best = 1.0e20;
+      for (int yy = 0; yy < y_size; ++yy) {
+        for (int xx = 0; xx < x_size; ++xx) {
+          if ((coverage.get_bright(xx, yy) >= 0.5f) != inside) {
+            double dx = x - xx;
+            double dy = y - yy;
+            best = std::min(best, dx * dx + dy * dy);
+          }
+        }
+      }
+      signed_dist[(size_t)y * x_size + x] =
+        inside ? 0.5 - sqrt(best) : sqrt(best) - 0.5;
+    }
+  }
+
+  int out_x_size = x_size / oversample;
+  int out_y_size = y_size / oversample;
+  field.resize((size_t)out_x_size * out_y_size);
+  for (int oy = 0; oy < out_y_size; ++oy) {
+    for (int ox = 0; ox < out_x_size; ++ox) {
+      double sum = 0.0;
+      for (int sy = 0; sy < oversample; ++sy) {
+        for (int sx = 0; sx < oversample; ++sx) {
+          sum += signed_dist[(size_t)(oy * oversample + sy) * x_size +
+                             ox * oversample + sx];
+        }
+      }
+      double value = 0.5 - 0.5 * (sum / (oversample * oversample)) /
+        (radius * oversample);
+      field[(size_t)oy * out_x_size + ox] =
+        (float)std::max(0.0, std::min(1.0, value));
+    }
+  }
+}
+
+/**
+ * Compares DistanceFieldMaker against the brute-force field on a number of
+ * random images, of random sizes and densities.  The same maker is reused
+ * from one image to the next, as it is by egg-mkfont.  Returns true if they
+ * agree.
+ */
+static bool
+compare_random_images(int oversample, double radius) {
+  DistanceFieldMaker maker;
+  double max_error = 0.0;
+  for (int trial = 0; trial < 30; ++trial) {
+    int x_size = oversample * (1 + rand() % 20);
+    int y_size = oversample * (1 + rand() % 20);
+    int density = 2 + rand() % 10;
+
+    PNMImage coverage(x_size, y_size, 1);
+    for (int y = 0; y < y_size; ++y) {
+      for (int x = 0; x < x_size; ++x) {
+        coverage.set_gray(x, y, (rand() % density == 0) ? 1.0f : 0.0f);
+      }
+    }
+    if (trial == 0) {
+      // An empty image, with nothing inside.
+      coverage.fill(0.0f);
+    } else if (trial == 1) {
+      // A full one, with nothing outside.
+      coverage.fill(1.0f);
+    }
+
+    pvector<float> field, brute_field;
+    maker.make_field(coverage, oversample, radius, field);
+    make_brute_field(coverage, oversample, radius, brute_field);
+
+    if (field.size() != brute_field.size()) {
+      printf("Got %d values, expected %d\n", (int)field.size(),
+             (int)brute_field.size());
+      return false;
+    }
+    for (size_t i = 0; i < field.size(); ++i) {
+      max_error = std::max(max_error, (double)fabs(field[i] - brute_field[i]));
+    }
+  }
+
+  printf("oversample %d, radius %g: max error %g\n", oversample, radius,
+         max_error);
+  return max_error < 1.0e-5;
+}
+
+/**
+ * Reports how quickly DistanceFieldMaker computes the field of a disc at the
+ * size of a large glyph.
+ */
+static void
+time_disc(int size, int oversample) {
+  int hi_size = size * oversample;
+  double center = hi_size * 0.5;
+  double disc_radius = hi_size * 0.3;
+
+  PNMImage coverage(hi_size, hi_size, 1);
+  for (int y = 0; y < hi_size; ++y) {
+    for (int x = 0; x < hi_size; ++x) {
+      double dist = hypot(x + 0.5 - center, y + 0.5 - center);
+      coverage.set_gray(x, y, (dist < disc_radius) ? 1.0f : 0.0f);
+    }
+  }
+
+  DistanceFieldMaker maker;
+  pvector<float> field;
+  ClockObject *clock = ClockObject::get_global_clock();
+  static const int num_reps = 10;
+  double start = clock->get_real_time();
+  for (int i = 0; i < num_reps; ++i) {
+    maker.make_field(coverage, oversample, 4.0, field);
+  }
+  double elapsed = (clock->get_real_time() - start) / num_reps;
+
+  printf("%d x %d glyph at oversample %d: %g ms, %g Mpixels/s\n",
+         size, size, oversample, elapsed * 1000.0,
+         (double)hi_size * hi_size / elapsed / 1.0e6);
+}
+
+int
+main(int argc, char *argv[]) {
+  srand(1);
+
+  bool success = true;
+  success = compare_random_images(1, 1000.0) && success;
+  success = compare_random_images(1, 4.0) && success;
+  success = compare_random_images(2, 4.0) && success;
+  success = compare_random_images(3, 2.5) && success;
+
+  time_disc(64, 8);
+
+  printf(success ? "ok\n" : "FAILED\n");
+  return success ? 0 : 1;
+}
@@ -1,7 +1,7 @@
 #begin bin_target
   #define TARGET egg-qtess
   #define LOCAL_LIBS \
-    eggbase progbase
+    eggbase progbase pandatoolbase
   #define OTHER_LIBS \
     egg2pg:c egg:c pandaegg:m \
     chan:c char:c downloader:c event:c \
@@ -22,6 +22,7 @@
      config_egg_qtess.h \
      eggQtess.h \
      isoPlacer.I isoPlacer.h \
+     nurbsRowEvaluator.I nurbsRowEvaluator.h \
      qtessGlobals.h \
      qtessInputEntry.I qtessInputEntry.h \
      qtessInputFile.I qtessInputFile.h \
@@ -32,6 +33,7 @@
      config_egg_qtess.cxx \
      eggQtess.cxx \
      isoPlacer.cxx \
+     nurbsRowEvaluator.cxx \
      qtessGlobals.cxx \
      qtessInputEntry.cxx \
      qtessInputFile.cxx \
@@ -39,3 +41,28 @@
      subdivSegment.cxx
 
 #end bin_target
+
+#begin test_bin_target
+  #define TARGET test_row_evaluator
+  #define LOCAL_LIBS \
+    pandatoolbase
+  #define OTHER_LIBS \
+    egg2pg:c egg:c pandaegg:m \
+    chan:c char:c downloader:c event:c \
+    tform:c grutil:c text:c dgraph:c display:c gsgbase:c \
+    collide:c gobj:c cull:c device:c \
+    parametrics:c pgraph:c pgraphnodes:c pipeline:c pstatclient:c chan:c \
+    pnmimagetypes:c pnmimage:c mathutil:c linmath:c putil:c \
+    movies:c \
+    $[if $[HAVE_FREETYPE],pnmtext:c] \
+    $[if $[HAVE_NET],net:c] $[if $[WANT_NATIVE_NET],nativenet:c] \
+    $[if $[HAVE_AUDIO],audio:c] \
+    panda:m \
+    pandabase:c express:c pandaexpress:m \
+    interrogatedb dtoolutil:c dtoolbase:c prc  dtool:m
+
+  #define SOURCES \
+     nurbsRowEvaluator.cxx nurbsRowEvaluator.I nurbsRowEvaluator.h \
+     test_row_evaluator.cxx
+
+#end test_bin_target
@@ -1,6 +1,7 @@
 #include "config_egg_qtess.cxx"
 #include "eggQtess.cxx"
 #include "isoPlacer.cxx"
+#include "nurbsRowEvaluator.cxx"
 #include "qtessGlobals.cxx"
 #include "qtessInputEntry.cxx"
 #include "qtessInputFile.cxx"
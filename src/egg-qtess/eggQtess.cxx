@@ -13,6 +13,7 @@
 
 #include "eggQtess.h"
 #include "qtessGlobals.h"
+#include "workerPool.h"
 #include "dcast.h"
 
 /**
@@ -100,6 +101,12 @@ EggQtess() {
      "for output.",
      &EggQtess::dispatch_none, &_qtess_output);
 
+  add_option
+    ("j", "threads", 0,
+     "Tesselate the surfaces using the indicated number of threads.  The "
+     "default is taken from the pandatool-num-threads config variable.",
+     &EggQtess::dispatch_int, nullptr, &_num_threads);
+
   add_option
     ("H", "", 0,
      "Describe the format of the parameter file specified with -f.",
@@ -108,6 +115,7 @@ EggQtess() {
   _uniform_per_isoparam = 0.0;
   _uniform_per_surface = 0;
   _total_tris = 0;
+  _num_threads = 0;
 }
 
 /**
@@ -138,7 +146,9 @@ run() {
     read_qtess = true;
   }
 
-  find_surfaces(_data);
+  EggSurfaces egg_surfaces;
+  find_surfaces(_data, egg_surfaces);
+  make_surfaces(egg_surfaces);
 
   QtessInputEntry &default_entry = _qtess_file.get_default_entry();
   if (!read_qtess || default_entry.get_num_surfaces() == 0) {
@@ -192,9 +202,22 @@ run() {
 
     int tris = 0;
 
+    // A surface may copy its tesselation from another, so the matches must
+    // all be resolved, in order, before any of the surfaces are tesselated.
     Surfaces::const_iterator si;
     for (si = _surfaces.begin(); si != _surfaces.end(); ++si) {
-      tris += (*si)->tesselate();
+      (*si)->apply_match();
+    }
+
+    // Then each surface can be tesselated independently of the others.
+    WorkerPool pool(_num_threads);
+    pool.run((int)_surfaces.size(), [&](int i) {
+      _surfaces[i]->build_tesselation();
+    });
+
+    // Attaching the results to the egg file must be done one at a time.
+    for (si = _surfaces.begin(); si != _surfaces.end(); ++si) {
+      tris += (*si)->finish_tesselation();
     }
 
     std::cerr << tris << " tris generated.\n";
@@ -309,22 +332,49 @@ describe_qtess_format() {
  * Recursively walks the egg graph, collecting all the NURBS surfaces found.
  */
 void EggQtess::
-find_surfaces(EggNode *egg_node) {
+find_surfaces(EggNode *egg_node, EggSurfaces &egg_surfaces) {
   if (egg_node->is_of_type(EggNurbsSurface::get_class_type())) {
-    PT(QtessSurface) surface =
-      new QtessSurface(DCAST(EggNurbsSurface, egg_node));
-    if (surface->is_valid()) {
-      _surfaces.push_back(surface);
-      QtessInputEntry::Type match_type = _qtess_file.match(surface);
-      nassertv(match_type != QtessInputEntry::T_undefined);
-    }
+    egg_surfaces.push_back(DCAST(EggNurbsSurface, egg_node));
   }
 
   if (egg_node->is_of_type(EggGroupNode::get_class_type())) {
     EggGroupNode *egg_group = DCAST(EggGroupNode, egg_node);
     EggGroupNode::const_iterator ci;
     for (ci = egg_group->begin(); ci != egg_group->end(); ++ci) {
-      find_surfaces(*ci);
+      find_surfaces(*ci, egg_surfaces);
+    }
+  }
+}
+
+/**
+ * Creates a QtessSurface for each of the NURBS surfaces found by
+ * find_surfaces(), and matches each one against the parameter file.  The
+ * surfaces are evaluated, and their curvature scores computed if they will be
+ * needed, in parallel; but they are matched in the order in which they appear
+ * in the egg file.
+ */
+void EggQtess::
+make_surfaces(const EggSurfaces &egg_surfaces) {
+  int num_surfaces = (int)egg_surfaces.size();
+  Surfaces surfaces(num_surfaces);
+
+  bool needs_scores = _qtess_file.needs_scores();
+
+  WorkerPool pool(_num_threads);
+  pool.run(num_surfaces, [&](int i) {
+    surfaces[i] = new QtessSurface(egg_surfaces[i]);
+    if (needs_scores) {
+      surfaces[i]->compute_scores();
+    }
+  });
+
+  Surfaces::const_iterator si;
+  for (si = surfaces.begin(); si != surfaces.end(); ++si) {
+    QtessSurface *surface = (*si);
+    if (surface->is_valid()) {
+      _surfaces.push_back(surface);
+      QtessInputEntry::Type match_type = _qtess_file.match(surface);
+      nassertv(match_type != QtessInputEntry::T_undefined);
     }
   }
 }
@@ -36,7 +36,9 @@ protected:
 
 private:
   void describe_qtess_format();
-  void find_surfaces(EggNode *egg_node);
+  typedef pvector<EggNurbsSurface *> EggSurfaces;
+  void find_surfaces(EggNode *egg_node, EggSurfaces &egg_surfaces);
+  void make_surfaces(const EggSurfaces &egg_surfaces);
 
   Filename _qtess_filename;
   double _uniform_per_isoparam;
@@ -44,6 +46,7 @@ private:
   int _total_tris;
   bool _qtess_output;
   bool _describe_qtess;
+  int _num_threads;
 
   QtessInputFile _qtess_file;
 
@@ -14,20 +14,36 @@
 #include "isoPlacer.h"
 #include "qtessSurface.h"
 #include "subdivSegment.h"
-#include "nurbsSurfaceResult.h"
+#include "nurbsRowEvaluator.h"
 #include "pvector.h"
 
 
 /**
- *
+ * Samples the surface and integrates the resulting scores with the indicated
+ * ratio.  This is the same as sample_scores() followed by integrate().
  */
 void IsoPlacer::
 get_scores(int subdiv, int across, double ratio,
-           NurbsSurfaceResult *surf, bool s) {
+           NurbsSurfaceEvaluator *nurbs, bool s) {
+  sample_scores(subdiv, across, nurbs, s);
+  integrate(ratio);
+}
+
+/**
+ * Tallies up the curvature and stretch of the surface at subdiv points along
+ * one dimension, across the other dimension.  This is by far the most
+ * expensive part of placing the isoparams, but it does not depend on the
+ * ratio, so the tables it fills in may be integrated again with a different
+ * ratio without resampling the surface.
+ */
+void IsoPlacer::
+sample_scores(int subdiv, int across, NurbsSurfaceEvaluator *nurbs, bool s) {
   _maxi = subdiv - 1;
+  _across = across;
 
   _cscore.clear();
   _sscore.clear();
+  _cint.clear();
 
   _cscore.reserve(_maxi);
   _sscore.reserve(_maxi);
@@ -39,26 +55,29 @@ get_scores(int subdiv, int across, double ratio,
     _sscore.push_back(0.0);
   }
 
+  // Each pass across the surface samples the same points along it, so we
+  // evaluate a whole row at a time.
+  vector_double samples;
+  samples.reserve(_maxi + 1);
+  for (i = -1; i < _maxi; i++) {
+    samples.push_back((double)(i+1) / (double)(_maxi+1));
+  }
+  NurbsRowEvaluator row_eval(nurbs, s);
+  row_eval.set_samples(samples);
+  pvector<LPoint3> points(_maxi + 1);
+
   int a;
   for (a = 0; a <= across; a++) {
     double v = (double)a / (double)across;
+    row_eval.eval_row(v, &points[0]);
 
     LVecBase3 p1, p2, p3, pnext;
     LVecBase3 v1, v2;
-    if (s) {
-      surf->eval_point(0.0, v, p3);
-    } else {
-      surf->eval_point(v, 0.0, p3);
-    }
+    p3 = points[0];
     int num_points = 1;
 
     for (i = -1; i < _maxi; i++) {
-      double u = (double)(i+1) / (double)(_maxi+1);
-      if (s) {
-        surf->eval_point(u, v, pnext);
-      } else {
-        surf->eval_point(v, u, pnext);
-      }
+      pnext = points[i+1];
 
       // We'll ignore consecutive equal points.  They don't contribute to
       // curvature or size.
@@ -87,13 +106,22 @@ get_scores(int subdiv, int across, double ratio,
       }
     }
   }
+}
 
-  // Now integrate.
+/**
+ * Integrates the scores most recently computed by sample_scores(), weighting
+ * the stretch scores by the indicated ratio, to produce the table used by
+ * get_total_score() and place().
+ */
+void IsoPlacer::
+integrate(double ratio) {
+  _ratio = ratio;
   _cint.clear();
   _cint.reserve(_maxi + 1);
 
+  int i;
   double net = 0.0;
-  double ad = (double)(across+1);
+  double ad = (double)(_across+1);
   _cint.push_back(0.0);
   for (i = 0; i < _maxi; i++) {
     net += _cscore[i]/ad + ratio * _sscore[i]/ad;
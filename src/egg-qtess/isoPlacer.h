@@ -18,7 +18,7 @@
 #include "pvector.h"
 #include "vector_double.h"
 
-class NurbsSurfaceResult;
+class NurbsSurfaceEvaluator;
 
 /**
  * Contains the logic used to place isoparams where they'll do the most good
@@ -29,13 +29,19 @@ public:
   INLINE IsoPlacer();
 
   void get_scores(int subdiv, int across, double ratio,
-                  NurbsSurfaceResult *surf, bool s);
+                  NurbsSurfaceEvaluator *nurbs, bool s);
+  void sample_scores(int subdiv, int across,
+                     NurbsSurfaceEvaluator *nurbs, bool s);
+  void integrate(double ratio);
+  INLINE bool is_integrated(double ratio) const;
   void place(int count, pvector<double> &iso_points);
 
   INLINE double get_total_score() const;
 
   vector_double _cscore, _sscore, _cint;
   int _maxi;
+  int _across;
+  double _ratio;
 };
 
 #include "isoPlacer.I"
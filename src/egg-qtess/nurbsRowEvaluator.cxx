@@ -0,0 +1,311 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file nurbsRowEvaluator.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "nurbsRowEvaluator.h"
+
+#include <algorithm>
+
+/**
+ * Copies the control vertices and knots out of the indicated surface.  If
+ * along_u is true, the samples will vary in U, and each row will be at a
+ * particular value of V; otherwise, the samples vary in V, and each row is at
+ * a particular value of U.
+ */
+NurbsRowEvaluator::
+NurbsRowEvaluator(NurbsSurfaceEvaluator *nurbs, bool along_u) :
+  _along_u(along_u)
+{
+  int num_u = nurbs->get_num_u_vertices();
+  int num_v = nurbs->get_num_v_vertices();
+
+  vector_double u_knots, v_knots;
+  int num_u_knots = nurbs->get_num_u_knots();
+  u_knots.reserve(num_u_knots);
+  for (int i = 0; i < num_u_knots; ++i) {
+    u_knots.push_back(nurbs->get_u_knot(i));
+  }
+  int num_v_knots = nurbs->get_num_v_knots();
+  v_knots.reserve(num_v_knots);
+  for (int i = 0; i < num_v_knots; ++i) {
+    v_knots.push_back(nurbs->get_v_knot(i));
+  }
+
+  if (_along_u) {
+    _along_degree = nurbs->get_u_order() - 1;
+    _across_degree = nurbs->get_v_order() - 1;
+    _num_along = num_u;
+    _num_across = num_v;
+    _along_knots.swap(u_knots);
+    _across_knots.swap(v_knots);
+  } else {
+    _along_degree = nurbs->get_v_order() - 1;
+    _across_degree = nurbs->get_u_order() - 1;
+    _num_along = num_v;
+    _num_across = num_u;
+    _along_knots.swap(v_knots);
+    _across_knots.swap(u_knots);
+  }
+
+  for (int c = 0; c < 4; ++c) {
+    _cvs[c].resize(_num_along * _num_across);
+    _q[c].resize(_num_along);
+    _dq[c].resize(_num_along);
+  }
+  for (int ai = 0; ai < _num_across; ++ai) {
+    for (int li = 0; li < _num_along; ++li) {
+      const LVecBase4 &cv = _along_u ?
+        nurbs->get_vertex(li, ai) : nurbs->get_vertex(ai, li);
+      int k = ai * _num_along + li;
+      for (int c = 0; c < 4; ++c) {
+        _cvs[c][k] = cv[c];
+      }
+    }
+  }
+
+  _row_basis.resize(_across_degree + 1);
+  _row_dbasis.resize(_across_degree + 1);
+}
+
+/**
+ * Specifies the parameter values along the row at which eval_row() should
+ * evaluate the surface, and precomputes the basis functions there.
+ */
+void NurbsRowEvaluator::
+set_samples(const vector_double &samples) {
+  _samples = samples;
+
+  int n = (int)_samples.size();
+  int p = _along_degree;
+
+  _first.resize(n);
+  _basis.resize((p + 1) * n);
+  _dbasis.resize((p + 1) * n);
+
+  vector_double basis(p + 1), dbasis(p + 1);
+  for (int j = 0; j < n; ++j) {
+    int span = find_span(_along_knots, _num_along, p, _samples[j]);
+    compute_basis(_along_knots, span, p, _samples[j], &basis[0], &dbasis[0]);
+    _first[j] = span - p;
+    for (int a = 0; a <= p; ++a) {
+      _basis[a * n + j] = basis[a];
+      _dbasis[a * n + j] = dbasis[a];
+    }
+  }
+
+  for (int c = 0; c < 4; ++c) {
+    _h[c].resize(n);
+    _dh_along[c].resize(n);
+    _dh_across[c].resize(n);
+  }
+}
+
+/**
+ * Evaluates the surface at each of the samples along the row at parameter t
+ * across it.  Each of the non-NULL arrays is filled in with
+ * get_num_samples() entries: the points on the surface, the (unnormalized)
+ * surface normals, and the (u, v) parameters of the points.
+ */
+void NurbsRowEvaluator::
+eval_row(double t, LPoint3 *points, LVector3 *normals, LTexCoordd *uvs) {
+  int n = (int)_samples.size();
+  bool want_normals = (normals != nullptr);
+
+  // First, collapse the control vertices across the row into a single
+  // curve's worth of control vertices along it, along with their derivatives
+  // across the row.
+  int across_degree = _across_degree;
+  int span = find_span(_across_knots, _num_across, across_degree, t);
+  compute_basis(_across_knots, span, across_degree, t,
+                &_row_basis[0], &_row_dbasis[0]);
+  int first_row = span - across_degree;
+
+  for (int c = 0; c < 4; ++c) {
+    double *qc = &_q[c][0];
+    double *dqc = &_dq[c][0];
+    std::fill(qc, qc + _num_along, 0.0);
+    std::fill(dqc, dqc + _num_along, 0.0);
+
+    for (int b = 0; b <= across_degree; ++b) {
+      const double *cv = &_cvs[c][(first_row + b) * _num_along];
+      double nb = _row_basis[b];
+      double db = _row_dbasis[b];
+      for (int i = 0; i < _num_along; ++i) {
+        qc[i] += nb * cv[i];
+        dqc[i] += db * cv[i];
+      }
+    }
+  }
+
+  // Then evaluate that curve, still in homogeneous space, at all of the
+  // samples.
+  int along_degree = _along_degree;
+  for (int c = 0; c < 4; ++c) {
+    const double *qc = &_q[c][0];
+    const double *dqc = &_dq[c][0];
+    const int *first = &_first[0];
+    double *h = &_h[c][0];
+    double *dha = &_dh_along[c][0];
+    double *dhc = &_dh_across[c][0];
+    std::fill(h, h + n, 0.0);
+
+    if (want_normals) {
+      std::fill(dha, dha + n, 0.0);
+      std::fill(dhc, dhc + n, 0.0);
+      for (int a = 0; a <= along_degree; ++a) {
+        const double *basis = &_basis[a * n];
+        const double *dbasis = &_dbasis[a * n];
+        for (int j = 0; j < n; ++j) {
+          int i = first[j] + a;
+          h[j] += basis[j] * qc[i];
+          dha[j] += dbasis[j] * qc[i];
+          dhc[j] += basis[j] * dqc[i];
+        }
+      }
+    } else {
+      for (int a = 0; a <= along_degree; ++a) {
+        const double *basis = &_basis[a * n];
+        for (int j = 0; j < n; ++j) {
+          h[j] += basis[j] * qc[first[j] + a];
+        }
+      }
+    }
+  }
+
+  // Finally, project the results back out of homogeneous space.
+  for (int j = 0; j < n; ++j) {
+    double inv_w = 1.0 / _h[3][j];
+    LPoint3d point(_h[0][j] * inv_w, _h[1][j] * inv_w, _h[2][j] * inv_w);
+    if (points != nullptr) {
+      points[j] = LCAST(PN_stdfloat, point);
+    }
+
+    if (want_normals) {
+      // The derivative of x / w is (x' - (x / w) w') / w.
+      LVector3d along((_dh_along[0][j] - point[0] * _dh_along[3][j]) * inv_w,
+                      (_dh_along[1][j] - point[1] * _dh_along[3][j]) * inv_w,
+                      (_dh_along[2][j] - point[2] * _dh_along[3][j]) * inv_w);
+      LVector3d across((_dh_across[0][j] - point[0] * _dh_across[3][j]) * inv_w,
+                       (_dh_across[1][j] - point[1] * _dh_across[3][j]) * inv_w,
+                       (_dh_across[2][j] - point[2] * _dh_across[3][j]) * inv_w);
+      LVector3d normal = _along_u ? along.cross(across) : across.cross(along);
+      normals[j] = LCAST(PN_stdfloat, normal);
+    }
+
+    if (uvs != nullptr) {
+      if (_along_u) {
+        uvs[j].set(_samples[j], t);
+      } else {
+        uvs[j].set(t, _samples[j]);
+      }
+    }
+  }
+}
+
+/**
+ * Returns the index of the knot span that contains the parameter t: that is,
+ * the span such that knots[span] <= t < knots[span + 1].  Parameters outside
+ * the valid range of the curve are clamped to the first or last span.
+ */
+int NurbsRowEvaluator::
+find_span(const vector_double &knots, int num_cvs, int degree, double t) {
+  int lo = degree;
+  int hi = num_cvs - 1;
+
+  if (t >= knots[num_cvs]) {
+    // Skip any empty spans at the end.
+    while (hi > lo && knots[hi] == knots[hi + 1]) {
+      --hi;
+    }
+    return hi;
+  }
+
+  if (t <= knots[lo]) {
+    // Skip any empty spans at the beginning.
+    while (lo < hi && knots[lo] == knots[lo + 1]) {
+      ++lo;
+    }
+    return lo;
+  }
+
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (knots[mid] <= t) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+/**
+ * Computes the values of the degree + 1 basis functions that are nonzero
+ * within the indicated span at parameter t, using the Cox-de Boor
+ * recurrence.
+ */
+void NurbsRowEvaluator::
+compute_basis(const vector_double &knots, int span, int degree, double t,
+              double *basis) {
+  vector_double left(degree + 1), right(degree + 1);
+
+  basis[0] = 1.0;
+  for (int j = 1; j <= degree; ++j) {
+    left[j] = t - knots[span + 1 - j];
+    right[j] = knots[span + j] - t;
+    double saved = 0.0;
+    for (int r = 0; r < j; ++r) {
+      double denom = right[r + 1] + left[j - r];
+      double temp = (denom != 0.0) ? basis[r] / denom : 0.0;
+      basis[r] = saved + right[r + 1] * temp;
+      saved = left[j - r] * temp;
+    }
+    basis[j] = saved;
+  }
+}
+
+/**
+ * Computes the values of the nonzero basis functions as above, and also
+ * their first derivatives with respect to t.
+ */
+void NurbsRowEvaluator::
+compute_basis(const vector_double &knots, int span, int degree, double t,
+              double *basis, double *dbasis) {
+  if (degree == 0) {
+    basis[0] = 1.0;
+    dbasis[0] = 0.0;
+    return;
+  }
+
+  // The derivative of each basis function is a weighted difference of two
+  // basis functions of the next lower degree.
+  compute_basis(knots, span, degree - 1, t, basis);
+  for (int a = 0; a <= degree; ++a) {
+    int i = span - degree + a;
+    double d = 0.0;
+    if (a > 0) {
+      double denom = knots[i + degree] - knots[i];
+      if (denom != 0.0) {
+        d += basis[a - 1] / denom;
+      }
+    }
+    if (a < degree) {
+      double denom = knots[i + degree + 1] - knots[i + 1];
+      if (denom != 0.0) {
+        d -= basis[a] / denom;
+      }
+    }
+    dbasis[a] = degree * d;
+  }
+
+  compute_basis(knots, span, degree, t, basis);
+}
@@ -0,0 +1,81 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file nurbsRowEvaluator.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef NURBSROWEVALUATOR_H
+#define NURBSROWEVALUATOR_H
+
+#include "pandatoolbase.h"
+#include "nurbsSurfaceEvaluator.h"
+#include "luse.h"
+#include "vector_double.h"
+#include "vector_int.h"
+
+/**
+ * Evaluates a NURBS surface at the same set of sample points along each of a
+ * number of isoparametric rows, for instance to tesselate it into a grid.
+ *
+ * Where NurbsSurfaceResult finds the segment and evaluates the basis
+ * matrices anew for every point, this computes the basis functions for the
+ * samples along the row just once, in set_samples().  Each call to
+ * eval_row() then collapses the control vertices across the row into a
+ * single curve, and evaluates that curve at all of the samples together.
+ * The inner loops run over plain contiguous arrays, one per component, so
+ * that the compiler can vectorize them.
+ */
+class NurbsRowEvaluator {
+public:
+  NurbsRowEvaluator(NurbsSurfaceEvaluator *nurbs, bool along_u);
+
+  void set_samples(const vector_double &samples);
+  INLINE int get_num_samples() const;
+
+  void eval_row(double t, LPoint3 *points, LVector3 *normals = nullptr,
+                LTexCoordd *uvs = nullptr);
+
+private:
+  static int find_span(const vector_double &knots, int num_cvs, int degree,
+                       double t);
+  static void compute_basis(const vector_double &knots, int span, int degree,
+                            double t, double *basis);
+  static void compute_basis(const vector_double &knots, int span, int degree,
+                            double t, double *basis, double *dbasis);
+
+  // If _along_u is true, the samples vary in U, and each row is at a
+  // particular value of V; otherwise, the other way around.
+  bool _along_u;
+
+  int _along_degree, _across_degree;
+  int _num_along, _num_across;
+  vector_double _along_knots, _across_knots;
+
+  // The homogeneous control vertices, one array for each component, with the
+  // vertices along a row adjacent to each other.
+  vector_double _cvs[4];
+
+  // For each sample: the first control vertex along the row that it depends
+  // on, and the values and derivatives of the degree + 1 nonzero basis
+  // functions there.  The basis functions are stored one after the other,
+  // each for all of the samples.
+  vector_double _samples;
+  vector_int _first;
+  vector_double _basis, _dbasis;
+
+  // Scratch space for eval_row().
+  vector_double _row_basis, _row_dbasis;
+  vector_double _q[4], _dq[4];
+  vector_double _h[4], _dh_along[4], _dh_across[4];
+};
+
+#include "nurbsRowEvaluator.I"
+
+#endif
@@ -291,19 +291,18 @@ match(QtessSurface *surface) {
  * that will be produced.
  */
 int QtessInputEntry::
-count_tris(double tri_factor, int attempts) {
+count_tris() {
   int total_tris = 0;
-  bool aim_for_tris = false;
 
   if (_type == T_num_tris && _num_patches > 0.0) {
     // If we wanted to aim for a particular number of triangles for the group,
     // choose a per-isoparam setting that will approximately achieve this.
+    double pi = solve_num_tris();
     if (_auto_distribute) {
-      set_per_score(sqrt(0.5 * (double)_num_tris / _num_patches / tri_factor));
+      set_per_score(pi);
     } else {
-      set_per_isoparam(sqrt(0.5 * (double)_num_tris / _num_patches / tri_factor));
+      set_per_isoparam(pi);
     }
-    aim_for_tris = true;
   }
 
   Surfaces::iterator si;
@@ -339,14 +338,64 @@ count_tris(double tri_factor, int attempts) {
     total_tris += surface->count_tris();
   }
 
-  if (aim_for_tris && attempts < 10 &&
-      (double)total_tris / (double)_num_tris > 1.1) {
-    // We'd like to get within 10% of the requested number of triangles, if
-    // possible.  Keep trying until we do, or until we just need to give up.
-    set_num_tris(_num_tris);
-    return count_tris(tri_factor * total_tris / _num_tris, attempts + 1);
+  return total_tris;
+}
+
+/**
+ * Chooses the per-isoparam (or per-score) tesselation that comes closest to
+ * _num_tris triangles over all of the matched surfaces.  The surfaces are
+ * not actually tesselated while searching; each trial only asks the surfaces
+ * how many triangles they would produce, which costs almost nothing once
+ * their scores have been computed.
+ */
+double QtessInputEntry::
+solve_num_tris() {
+  // Start with the obvious estimate: two triangles per quad, and pi x pi
+  // quads per patch.
+  double pi = sqrt(0.5 * (double)_num_tris / _num_patches);
+
+  // We'd like to get within 10% of the requested number of triangles.  The
+  // estimate may overshoot, though, because of the minimum tesselation of
+  // each surface, and rounding.
+  if ((double)count_tris_per_isoparam(pi) <= (double)_num_tris * 1.1) {
+    return pi;
+  }
+
+  // The number of triangles never decreases as pi increases, so we can
+  // simply bisect for the largest pi that doesn't exceed the request.
+  double lo = 0.0;
+  double hi = pi;
+  for (int i = 0; i < 50; ++i) {
+    double mid = (lo + hi) * 0.5;
+    if (count_tris_per_isoparam(mid) <= _num_tris) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (qtess_cat.is_debug()) {
+    qtess_cat.debug()
+      << "Reduced " << pi << " per isoparam to " << lo << " to achieve "
+      << count_tris_per_isoparam(lo) << " of " << _num_tris << " tris.\n";
   }
+  return lo;
+}
+
+/**
+ * Returns the total number of triangles the matched surfaces would produce
+ * if they were tesselated with the indicated per-isoparam (or per-score)
+ * value.
+ */
+int QtessInputEntry::
+count_tris_per_isoparam(double pi) {
+  int total_tris = 0;
 
+  Surfaces::iterator si;
+  for (si = _surfaces.begin(); si != _surfaces.end(); ++si) {
+    total_tris += (*si)->count_tris_per_isoparam(pi, _auto_distribute,
+                                                _auto_place, _curvature_ratio);
+  }
   return total_tris;
 }
 
@@ -56,7 +56,7 @@ public:
 
   Type match(QtessSurface *surface);
   INLINE int get_num_surfaces() const;
-  int count_tris(double tri_factor = 1.0, int attempts = 0);
+  int count_tris();
 
   static void output_extra(std::ostream &out, const pvector<double> &iso, char axis);
   void output(std::ostream &out) const;
@@ -68,6 +68,9 @@ public:
   QtessSurface *_constrain_u, *_constrain_v;
 
 private:
+  double solve_num_tris();
+  int count_tris_per_isoparam(double pi);
+
   typedef pvector<GlobPattern> NodeNames;
   NodeNames _node_names;
 
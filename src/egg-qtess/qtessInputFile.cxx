@@ -12,6 +12,7 @@
  */
 
 #include "qtessInputFile.h"
+#include "qtessGlobals.h"
 #include "config_egg_qtess.h"
 #include "string_utils.h"
 
@@ -304,6 +305,26 @@ count_tris() {
   return total_tris;
 }
 
+/**
+ * Returns true if any of the entries (including the default entry, whether
+ * or not it has been created yet) may need to know the curvature scores of
+ * the surfaces it matches.
+ */
+bool QtessInputFile::
+needs_scores() const {
+  if (QtessGlobals::_auto_place || QtessGlobals::_auto_distribute) {
+    return true;
+  }
+
+  Entries::const_iterator ei;
+  for (ei = _entries.begin(); ei != _entries.end(); ++ei) {
+    if ((*ei)._auto_place || (*ei)._auto_distribute) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  *
  */
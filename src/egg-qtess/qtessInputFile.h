@@ -37,6 +37,7 @@ public:
 
   QtessInputEntry::Type match(QtessSurface *surface);
   int count_tris();
+  bool needs_scores() const;
 
   void write(std::ostream &out, int indent_level = 0) const;
 
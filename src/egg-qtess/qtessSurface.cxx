@@ -20,6 +20,7 @@
 #include "eggVertex.h"
 #include "eggComment.h"
 #include "egg_parametrics.h"
+#include "nurbsRowEvaluator.h"
 #include "pset.h"
 #include "pmap.h"
 
@@ -44,6 +45,7 @@ QtessSurface(EggNurbsSurface *egg_surface) :
   _match_u = _match_v = nullptr;
   _tess_u = _tess_v = 0;
   _got_scores = false;
+  _tesselation_tris = 0;
 
   // If the surface is closed in either dimension, the mininum tesselation in
   // that dimension is by default 3, so we don't ribbonize the surface.
@@ -80,12 +82,34 @@ QtessSurface(EggNurbsSurface *egg_surface) :
   }
 }
 
+/**
+ * Samples the curvature and stretch of the surface in both dimensions, if
+ * this has not already been done.  This is the expensive part of
+ * get_score(); it touches nothing outside of this surface, so it may be
+ * called for several surfaces at once from different threads.
+ */
+void QtessSurface::
+compute_scores() {
+  if (_nurbs != nullptr && !_got_scores) {
+    _u_placer.sample_scores(_nurbs->get_num_u_segments() * 100,
+                            _nurbs->get_num_v_segments() * 2,
+                            _nurbs, true);
+    _v_placer.sample_scores(_nurbs->get_num_v_segments() * 100,
+                            _nurbs->get_num_u_segments() * 2,
+                            _nurbs, false);
+    _got_scores = true;
+  }
+}
+
 /**
  * Computes the curvature/stretch score for the surface, if it has not been
  * already computed, and returns the net surface score.  This is used both for
  * automatically distributing isoparams among the surfaces by curvature, as
  * well as for automatically placing the isoparams within each surface by
  * curvature.
+ *
+ * The surface is only sampled the first time this is called; subsequent
+ * calls, even with a different ratio, reuse the same sampled scores.
  */
 double QtessSurface::
 get_score(double ratio) {
@@ -93,14 +117,12 @@ get_score(double ratio) {
     return 0.0;
   }
 
-  if (!_got_scores) {
-    _u_placer.get_scores(_nurbs->get_num_u_segments() * 100,
-                         _nurbs->get_num_v_segments() * 2,
-                         ratio, _nurbs_result, true);
-    _v_placer.get_scores(_nurbs->get_num_v_segments() * 100,
-                         _nurbs->get_num_u_segments() * 2,
-                         ratio, _nurbs_result, false);
-    _got_scores = true;
+  compute_scores();
+  if (!_u_placer.is_integrated(ratio)) {
+    _u_placer.integrate(ratio);
+  }
+  if (!_v_placer.is_integrated(ratio)) {
+    _v_placer.integrate(ratio);
   }
 
   return _u_placer.get_total_score() * _v_placer.get_total_score() * _importance2;
@@ -114,10 +136,39 @@ get_score(double ratio) {
 int QtessSurface::
 tesselate() {
   apply_match();
-  int tris = 0;
+  build_tesselation();
+  return finish_tesselation();
+}
+
+/**
+ * Generates the polygons for the tesselation computed earlier, without yet
+ * attaching them to the egg file.  This touches nothing outside of this
+ * surface, so it may be called for several surfaces at once from different
+ * threads, as long as apply_match() has already been called for all of them.
+ */
+void QtessSurface::
+build_tesselation() {
+  _joint_refs.clear();
+  _tesselation = do_uniform_tesselate(_tesselation_tris, _joint_refs);
+}
+
+/**
+ * Completes the work begun by build_tesselation(): assigns the new vertices
+ * to their joints, and replaces the surface's node in the tree with the new
+ * group.  Returns the number of triangles generated.
+ */
+int QtessSurface::
+finish_tesselation() {
+  int tris = _tesselation_tris;
 
-  PT(EggGroup) group = do_uniform_tesselate(tris);
-  PT(EggNode) new_node = group.p();
+  JointRefs::const_iterator jri;
+  for (jri = _joint_refs.begin(); jri != _joint_refs.end(); ++jri) {
+    (*jri)._joint->ref_vertex((*jri)._vertex, (*jri)._membership);
+  }
+  _joint_refs.clear();
+
+  PT(EggNode) new_node = _tesselation.p();
+  _tesselation.clear();
   if (new_node == nullptr) {
     new_node = new EggComment(_egg_surface->get_name(),
                               "Omitted NURBS surface.");
@@ -197,17 +248,12 @@ tesselate_specific(const pvector<double> &u_list,
  */
 void QtessSurface::
 tesselate_per_isoparam(double pi, bool autoplace, double ratio) {
-  if (_num_u == 0 || _num_v == 0) {
+  int u, v;
+  if (!get_per_isoparam_uv(pi, false, autoplace, ratio, u, v)) {
     omit();
 
   } else {
-    _tess_u = max(_min_u, (int)floor(_num_u * _importance * pi + 0.5));
-    _tess_v = max(_min_v, (int)floor(_num_v * _importance * pi + 0.5));
-    _iso_u.clear();
-    _iso_v.clear();
-    if (autoplace) {
-      tesselate_auto(_tess_u, _tess_v, ratio);
-    }
+    tesselate_uv(u, v, autoplace, ratio);
   }
 }
 
@@ -218,17 +264,12 @@ tesselate_per_isoparam(double pi, bool autoplace, double ratio) {
  */
 void QtessSurface::
 tesselate_per_score(double pi, bool autoplace, double ratio) {
-  if (get_score(ratio) <= 0.0) {
+  int u, v;
+  if (!get_per_isoparam_uv(pi, true, autoplace, ratio, u, v)) {
     omit();
 
   } else {
-    _tess_u = max(_min_u, (int)floor(_u_placer.get_total_score() * _importance * pi + 0.5));
-    _tess_v = max(_min_v, (int)floor(_v_placer.get_total_score() * _importance * pi + 0.5));
-    _iso_u.clear();
-    _iso_v.clear();
-    if (autoplace) {
-      tesselate_auto(_tess_u, _tess_v, ratio);
-    }
+    tesselate_uv(u, v, autoplace, ratio);
   }
 }
 
@@ -249,6 +290,51 @@ tesselate_auto(int u, int v, double ratio) {
   }
 }
 
+/**
+ * Returns the number of triangles that tesselate_per_isoparam() (or
+ * tesselate_per_score(), if per_score is true) would produce with the
+ * indicated parameters, without actually placing any isoparams.  Once the
+ * scores have been computed, this is just a bit of arithmetic, so it may be
+ * called many times in search of a particular number of triangles.
+ */
+int QtessSurface::
+count_tris_per_isoparam(double pi, bool per_score, bool autoplace,
+                        double ratio) {
+  int u, v;
+  if (!get_per_isoparam_uv(pi, per_score, autoplace, ratio, u, v)) {
+    return 0;
+  }
+  return u * v * 2;
+}
+
+/**
+ * Computes the number of quads in each dimension that
+ * tesselate_per_isoparam() or tesselate_per_score() should use.  Returns
+ * false if the surface should be omitted instead.
+ */
+bool QtessSurface::
+get_per_isoparam_uv(double pi, bool per_score, bool autoplace, double ratio,
+                    int &u, int &v) {
+  if (per_score) {
+    if (get_score(ratio) <= 0.0) {
+      return false;
+    }
+    u = max(_min_u, (int)floor(_u_placer.get_total_score() * _importance * pi + 0.5));
+    v = max(_min_v, (int)floor(_v_placer.get_total_score() * _importance * pi + 0.5));
+
+  } else {
+    if (_num_u == 0 || _num_v == 0) {
+      return false;
+    }
+    u = max(_min_u, (int)floor(_num_u * _importance * pi + 0.5));
+    v = max(_min_v, (int)floor(_num_v * _importance * pi + 0.5));
+  }
+
+  // tesselate_auto() will omit the surface if it has no score to place the
+  // isoparams by.
+  return !autoplace || get_score(ratio) > 0.0;
+}
+
 /**
  * Records the joint membership and morph offsets of each control vertex in
  * the extra-dimensional space of the NURBS, so that we can extract this data
@@ -352,7 +438,7 @@ apply_match() {
  * earlier call to omit(), teseselate_uv(), or tesselate_per_isoparam().
  */
 PT(EggGroup) QtessSurface::
-do_uniform_tesselate(int &tris) const {
+do_uniform_tesselate(int &tris, JointRefs &joint_refs) const {
   tris = 0;
 
   if (_tess_u == 0 || _tess_v == 0) {
@@ -400,20 +486,37 @@ do_uniform_tesselate(int &tris) const {
   typedef pmap<LVertexd, NVertexGroup> NVertexCollection;
   NVertexCollection n_collection;
 
+  // The vertices are evaluated one row at a time, all at the same values of
+  // u.
+  vector_double u_samples;
+  u_samples.reserve(num_u);
+  for (ui = 0; ui < num_u; ui++) {
+    if (_iso_u.empty()) {
+      u = (double)ui / (double)(num_u-1);
+    } else {
+      u = _iso_u[ui] / _iso_u.back();
+    }
+    u_samples.push_back(u);
+  }
+
+  NurbsRowEvaluator row_eval(_nurbs, true);
+  row_eval.set_samples(u_samples);
+  pvector<LPoint3> points(num_u);
+  pvector<LVector3> normals(num_u);
+  pvector<LTexCoordd> uvs(num_u);
+
   for (vi = 0; vi < num_v; vi++) {
     if (_iso_v.empty()) {
       v = (double)vi / (double)(num_v-1);
     } else {
       v = _iso_v[vi] / _iso_v.back();
     }
-    for (ui = 0; ui < num_u; ui++) {
-      if (_iso_u.empty()) {
-        u = (double)ui / (double)(num_u-1);
-      } else {
-        u = _iso_u[ui] / _iso_u.back();
-      }
+    row_eval.eval_row(v, &points[0], &normals[0], &uvs[0]);
 
-      PT(EggVertex) egg_vertex = evaluate_vertex(u, v);
+    for (ui = 0; ui < num_u; ui++) {
+      PT(EggVertex) egg_vertex =
+        evaluate_vertex(u_samples[ui], v, points[ui], normals[ui], uvs[ui],
+                        joint_refs);
       vpool->add_vertex(egg_vertex);
       new_verts.push_back(egg_vertex);
       n_collection[egg_vertex->get_pos3()].insert(egg_vertex);
@@ -494,18 +597,19 @@ do_uniform_tesselate(int &tris) const {
 }
 
 /**
- * Evaluates the surface at the given u, v position and sets the vertex to the
- * appropriate values.  Also sets the joint membership of the vertex.
+ * Creates a vertex at the given u, v position on the surface, given the
+ * point, normal and uv already computed there by a NurbsRowEvaluator, and
+ * evaluates the remaining extended attributes.  The joint membership of the
+ * vertex is not assigned here, since the joints are shared with other
+ * surfaces; it is added to joint_refs instead, to be assigned by
+ * finish_tesselation().
  */
 PT(EggVertex) QtessSurface::
-evaluate_vertex(double u, double v) const {
+evaluate_vertex(double u, double v, const LPoint3 &point,
+                LVector3 normal, const LTexCoordd &uv,
+                JointRefs &joint_refs) const {
   PT(EggVertex) egg_vertex = new EggVertex;
 
-  LVertex point;
-  LNormal normal;
-  _nurbs_result->eval_point(u, v, point);
-  _nurbs_result->eval_normal(u, v, normal);
-
   // If the normal is too short, don't consider it--it's probably inaccurate
   // due to numerical limitations.  We'll recompute it later based on the
   // polygon normals.
@@ -516,7 +620,7 @@ evaluate_vertex(double u, double v) const {
   }
 
   egg_vertex->set_pos(LCAST(double, point));
-  egg_vertex->set_uv(LVecBase2d(u, v));
+  egg_vertex->set_uv(uv);
 
   // The color is stored, by convention, in slots 0-4 of the surface.
   if (_has_vertex_color) {
@@ -533,7 +637,11 @@ evaluate_vertex(double u, double v) const {
 
     double membership = _nurbs_result->eval_extended_point(u, v, d);
     if (membership > 0.0) {
-      joint->ref_vertex(egg_vertex, membership);
+      JointRef ref;
+      ref._vertex = egg_vertex;
+      ref._joint = joint;
+      ref._membership = membership;
+      joint_refs.push_back(ref);
     }
   }
 
@@ -45,9 +45,13 @@ public:
   INLINE double count_patches() const;
   INLINE int count_tris() const;
 
+  void compute_scores();
   double get_score(double ratio);
 
   int tesselate();
+  void apply_match();
+  void build_tesselation();
+  int finish_tesselation();
   int write_qtess_parameter(std::ostream &out);
   void omit();
   void tesselate_uv(int u, int v, bool autoplace, double ratio);
@@ -56,16 +60,29 @@ public:
   void tesselate_per_isoparam(double pi, bool autoplace, double ratio);
   void tesselate_per_score(double pi, bool autoplace, double ratio);
   void tesselate_auto(int u, int v, double ratio);
+  int count_tris_per_isoparam(double pi, bool per_score, bool autoplace,
+                              double ratio);
 
 private:
+  class JointRef {
+  public:
+    PT(EggVertex) _vertex;
+    EggGroup *_joint;
+    double _membership;
+  };
+  typedef pvector<JointRef> JointRefs;
+
   void record_vertex_extras();
   INLINE int get_joint_membership_index(EggGroup *joint);
   INLINE int get_dxyz_index(const std::string &morph_name);
   INLINE int get_drgba_index(const std::string &morph_name);
 
-  void apply_match();
-  PT(EggGroup) do_uniform_tesselate(int &tris) const;
-  PT(EggVertex) evaluate_vertex(double u, double v) const;
+  bool get_per_isoparam_uv(double pi, bool per_score, bool autoplace,
+                           double ratio, int &u, int &v);
+  PT(EggGroup) do_uniform_tesselate(int &tris, JointRefs &joint_refs) const;
+  PT(EggVertex) evaluate_vertex(double u, double v, const LPoint3 &point,
+                                LVector3 normal, const LTexCoordd &uv,
+                                JointRefs &joint_refs) const;
 
   PT(EggNurbsSurface) _egg_surface;
   PT(NurbsSurfaceEvaluator) _nurbs;
@@ -105,6 +122,13 @@ private:
 
   IsoPlacer _u_placer, _v_placer;
   bool _got_scores;
+
+  // The polygons generated by build_tesselation(), and the joint memberships
+  // of their vertices, waiting to be attached to the egg file by
+  // finish_tesselation().
+  PT(EggGroup) _tesselation;
+  JointRefs _joint_refs;
+  int _tesselation_tris;
 };
 
 #include "qtessSurface.I"
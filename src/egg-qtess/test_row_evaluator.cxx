@@ -0,0 +1,197 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_row_evaluator.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "nurbsRowEvaluator.h"
+#include "nurbsSurfaceEvaluator.h"
+#include "nurbsSurfaceResult.h"
+#include "clockObject.h"
+#include "pvector.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Returns a random number between lo and hi.
+ */
+static double
+random_between(double lo, double hi) {
+  return lo + (hi - lo) * ((double)rand() / RAND_MAX);
+}
+
+/**
+ * Makes a rational surface of the indicated orders and numbers of vertices,
+ * with random vertices and weights, and uneven knots, including a doubled
+ * one in U if the order allows it without breaking the surface.
+ */
+static PT(NurbsSurfaceEvaluator)
+make_surface(int u_order, int v_order, int num_u, int num_v) {
+  PT(NurbsSurfaceEvaluator) nurbs = new NurbsSurfaceEvaluator;
+  nurbs->set_u_order(u_order);
+  nurbs->set_v_order(v_order);
+  nurbs->reset(num_u, num_v);
+
+  for (int ui = 0; ui < num_u; ++ui) {
+    for (int vi = 0; vi < num_v; ++vi) {
+      LVecBase3 vertex(ui + random_between(-0.4, 0.4),
+                       vi + random_between(-0.4, 0.4),
+                       random_between(-2.0, 2.0));
+      nurbs->set_vertex(ui, vi, vertex, random_between(0.5, 2.0));
+    }
+  }
+
+  // Clamped knots, with random spacing inside.
+  int num_u_knots = num_u + u_order;
+  double knot = 0.0;
+  for (int i = 0; i < num_u_knots; ++i) {
+    if (i >= u_order && i <= num_u && (i != u_order + 1 || u_order < 3)) {
+      knot += random_between(0.5, 2.0);
+    }
+    nurbs->set_u_knot(i, knot);
+  }
+  int num_v_knots = num_v + v_order;
+  knot = 0.0;
+  for (int i = 0; i < num_v_knots; ++i) {
+    if (i >= v_order && i <= num_v) {
+      knot += random_between(0.5, 2.0);
+    }
+    nurbs->set_v_knot(i, knot);
+  }
+
+  nurbs->normalize_u_knots();
+  nurbs->normalize_v_knots();
+  return nurbs;
+}
+
+/**
+ * Compares NurbsRowEvaluator against NurbsSurfaceResult on a grid of
+ * num_samples by num_rows points of the surface.  Returns true if they agree.
+ */
+static bool
+compare(NurbsSurfaceEvaluator *nurbs, bool along_u, int num_samples,
+        int num_rows) {
+  PT(NurbsSurfaceResult) result = nurbs->evaluate();
+
+  vector_double samples;
+  for (int j = 0; j < num_samples; ++j) {
+    samples.push_back((double)j / (double)(num_samples - 1));
+  }
+  NurbsRowEvaluator row_eval(nurbs, along_u);
+  row_eval.set_samples(samples);
+
+  pvector<LPoint3> points(num_samples);
+  pvector<LVector3> normals(num_samples);
+  pvector<LTexCoordd> uvs(num_samples);
+
+  double max_point_error = 0.0;
+  double max_normal_error = 0.0;
+  for (int r = 0; r < num_rows; ++r) {
+    double t = (double)r / (double)(num_rows - 1);
+    row_eval.eval_row(t, &points[0], &normals[0], &uvs[0]);
+
+    for (int j = 0; j < num_samples; ++j) {
+      double u = along_u ? samples[j] : t;
+      double v = along_u ? t : samples[j];
+      if (!uvs[j].almost_equal(LTexCoordd(u, v))) {
+        printf("Wrong uv at (%g, %g)\n", u, v);
+        return false;
+      }
+
+      LVecBase3 point, normal;
+      result->eval_point(u, v, point);
+      result->eval_normal(u, v, normal);
+      max_point_error = std::max(max_point_error,
+                                 (double)(points[j] - point).length());
+
+      // The normals need only agree in direction; neither is normalized.
+      LVector3 n1 = normals[j];
+      LVector3 n2 = normal;
+      if (n1.normalize() && n2.normalize()) {
+        max_normal_error = std::max(max_normal_error, 1.0 - n1.dot(n2));
+      }
+    }
+  }
+
+  printf("  along %s: max point error %g, max normal error %g\n",
+         along_u ? "u" : "v", max_point_error, max_normal_error);
+  return max_point_error < 1.0e-3 && max_normal_error < 1.0e-3;
+}
+
+/**
+ * Reports the number of points and normals per second that each method
+ * evaluates on a num_samples by num_rows grid.
+ */
+static void
+time_methods(NurbsSurfaceEvaluator *nurbs, int num_samples, int num_rows) {
+  PT(NurbsSurfaceResult) result = nurbs->evaluate();
+  ClockObject *clock = ClockObject::get_global_clock();
+
+  vector_double samples;
+  for (int j = 0; j < num_samples; ++j) {
+    samples.push_back((double)j / (double)(num_samples - 1));
+  }
+
+  double start = clock->get_real_time();
+  NurbsRowEvaluator row_eval(nurbs, true);
+  row_eval.set_samples(samples);
+  pvector<LPoint3> points(num_samples);
+  pvector<LVector3> normals(num_samples);
+  for (int r = 0; r < num_rows; ++r) {
+    row_eval.eval_row((double)r / (double)(num_rows - 1),
+                      &points[0], &normals[0]);
+  }
+  double row_time = clock->get_real_time() - start;
+
+  start = clock->get_real_time();
+  LVecBase3 point, normal;
+  for (int r = 0; r < num_rows; ++r) {
+    double v = (double)r / (double)(num_rows - 1);
+    for (int j = 0; j < num_samples; ++j) {
+      result->eval_point(samples[j], v, point);
+      result->eval_normal(samples[j], v, normal);
+    }
+  }
+  double point_time = clock->get_real_time() - start;
+
+  double num_points = (double)num_samples * num_rows;
+  printf("%g points: eval_row %g/s, eval_point/eval_normal %g/s\n",
+         num_points, num_points / row_time, num_points / point_time);
+}
+
+int
+main(int argc, char *argv[]) {
+  srand(1);
+
+  static const int shapes[][4] = {
+    // u_order, v_order, num_u, num_v
+    { 4, 4, 4, 4 },
+    { 4, 3, 9, 7 },
+    { 2, 4, 5, 11 },
+    { 3, 2, 12, 3 },
+  };
+
+  bool success = true;
+  for (const int *shape : shapes) {
+    printf("order %d x %d, %d x %d vertices:\n",
+           shape[0], shape[1], shape[2], shape[3]);
+    PT(NurbsSurfaceEvaluator) nurbs =
+      make_surface(shape[0], shape[1], shape[2], shape[3]);
+    success = compare(nurbs, true, 37, 23) && success;
+    success = compare(nurbs, false, 37, 23) && success;
+  }
+
+  time_methods(make_surface(4, 4, 20, 20), 500, 500);
+
+  printf(success ? "ok\n" : "FAILED\n");
+  return success ? 0 : 1;
+}
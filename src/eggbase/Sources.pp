@@ -1,7 +1,7 @@
 #begin ss_lib_target
   #define TARGET eggbase
   #define LOCAL_LIBS \
-    progbase converter
+    progbase converter pandatoolbase
   #define OTHER_LIBS \
     pipeline:c event:c pstatclient:c panda:m \
     pandabase:c pnmimage:c mathutil:c linmath:c putil:c express:c \
@@ -16,7 +16,7 @@
      eggMultiBase.h eggMultiFilter.h \
      eggReader.h eggSingleBase.h \
      eggToSomething.h eggWriter.h \
-     somethingToEgg.h
+     somethingToEgg.h textureCopyQueue.h
 
   #define COMPOSITE_SOURCES \
      eggBase.cxx eggConverter.cxx eggFilter.cxx \
@@ -24,12 +24,14 @@
      eggMultiBase.cxx \
      eggMultiFilter.cxx eggReader.cxx eggSingleBase.cxx \
      eggToSomething.cxx \
-     eggWriter.cxx somethingToEgg.cxx
+     eggWriter.cxx somethingToEgg.cxx \
+     textureCopyQueue.cxx
 
   #define INSTALL_HEADERS \
     eggBase.h eggConverter.h eggFilter.h \
     eggMakeSomething.h \
     eggMultiBase.h eggMultiFilter.h \
-    eggReader.h eggSingleBase.h eggToSomething.h eggWriter.h somethingToEgg.h
+    eggReader.h eggSingleBase.h eggToSomething.h eggWriter.h somethingToEgg.h \
+    textureCopyQueue.h
 
 #end ss_lib_target
@@ -53,51 +53,91 @@ post_process_egg_files() {
     return;
   }
 
+  report_post_process(_eggs[0]->get_coordinate_system());
+
   Eggs::iterator ei;
+  for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
+    post_process_egg_file(*ei);
+  }
+}
+
+/**
+ * Tells the user about the processing post_process_egg_file() will perform.
+ * The coordinate system is that of the egg files, for describing the
+ * transform.
+ */
+void EggMultiBase::
+report_post_process(CoordinateSystem cs) {
   if (_got_transform) {
     nout << "Applying transform matrix:\n";
     _transform.write(nout, 2);
     LVecBase3d scale, hpr, translate;
-    if (decompose_matrix(_transform, scale, hpr, translate,
-                         _eggs[0]->get_coordinate_system())) {
+    if (decompose_matrix(_transform, scale, hpr, translate, cs)) {
       nout << "(scale " << scale << ", hpr " << hpr << ", translate "
            << translate << ")\n";
     }
-    for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-      (*ei)->transform(_transform);
-    }
   }
 
   if (_make_points) {
     nout << "Making points\n";
-    for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-      (*ei)->make_point_primitives();
-    }
   }
 
   switch (_normals_mode) {
   case NM_strip:
     nout << "Stripping normals.\n";
-    for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-      (*ei)->strip_normals();
-      (*ei)->remove_unused_vertices(true);
-    }
     break;
 
   case NM_polygon:
     nout << "Recomputing polygon normals.\n";
-    for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-      (*ei)->recompute_polygon_normals();
-      (*ei)->remove_unused_vertices(true);
-    }
     break;
 
   case NM_vertex:
     nout << "Recomputing vertex normals.\n";
-    for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-      (*ei)->recompute_vertex_normals(_normals_threshold);
-      (*ei)->remove_unused_vertices(true);
+    break;
+
+  case NM_preserve:
+    break;
+  }
+
+  if (!_got_tbnall) {
+    for (vector_string::const_iterator si = _tbn_names.begin();
+         si != _tbn_names.end();
+         ++si) {
+      nout << "Computing tangent and binormal for \"" << GlobPattern(*si)
+           << "\"\n";
     }
+  }
+}
+
+/**
+ * Performs the processing of post_process_egg_files() on just one egg file.
+ * This doesn't write anything to nout, so it may be called for different egg
+ * files from different threads.
+ */
+void EggMultiBase::
+post_process_egg_file(EggData *data) {
+  if (_got_transform) {
+    data->transform(_transform);
+  }
+
+  if (_make_points) {
+    data->make_point_primitives();
+  }
+
+  switch (_normals_mode) {
+  case NM_strip:
+    data->strip_normals();
+    data->remove_unused_vertices(true);
+    break;
+
+  case NM_polygon:
+    data->recompute_polygon_normals();
+    data->remove_unused_vertices(true);
+    break;
+
+  case NM_vertex:
+    data->recompute_vertex_normals(_normals_threshold);
+    data->remove_unused_vertices(true);
     break;
 
   case NM_preserve:
@@ -106,34 +146,25 @@ post_process_egg_files() {
   }
 
   if (_got_tbnall) {
-    for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-      if ((*ei)->recompute_tangent_binormal(GlobPattern("*"))) {
-        (*ei)->remove_unused_vertices(true);
-      }
+    if (data->recompute_tangent_binormal(GlobPattern("*"))) {
+      data->remove_unused_vertices(true);
     }
   } else {
     if (_got_tbnauto) {
-      for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-        if ((*ei)->recompute_tangent_binormal_auto()) {
-          (*ei)->remove_unused_vertices(true);
-        }
+      if (data->recompute_tangent_binormal_auto()) {
+        data->remove_unused_vertices(true);
       }
     }
 
     for (vector_string::const_iterator si = _tbn_names.begin();
          si != _tbn_names.end();
          ++si) {
-      GlobPattern uv_name(*si);
-      nout << "Computing tangent and binormal for \"" << uv_name << "\"\n";
-      for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-        (*ei)->recompute_tangent_binormal(uv_name);
-        (*ei)->remove_unused_vertices(true);
-      }
+      data->recompute_tangent_binormal(GlobPattern(*si));
+      data->remove_unused_vertices(true);
     }
   }
 }
 
-
 /**
  * Allocates and returns a new EggData structure that represents the indicated
  * egg file.  If the egg file cannot be read for some reason, returns NULL.
@@ -35,6 +35,8 @@ public:
   EggMultiBase();
 
   void post_process_egg_files();
+  void report_post_process(CoordinateSystem cs);
+  void post_process_egg_file(EggData *data);
 
 protected:
   virtual PT(EggData) read_egg(const Filename &filename);
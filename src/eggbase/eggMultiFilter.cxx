@@ -15,6 +15,13 @@
 
 #include "pnotify.h"
 #include "eggData.h"
+#include "workerPool.h"
+#include "trueClock.h"
+#include "pmutex.h"
+#include "mutexHolder.h"
+
+#include <sstream>
+#include <iomanip>
 
 /**
  *
@@ -62,6 +69,9 @@ EggMultiFilter(bool allow_empty) : _allow_empty(allow_empty) {
   // option that will prevent the program from generating output.  This
   // removes some checks for an output specification in handle_args.
   _read_only = false;
+
+  _independent_eggs = false;
+  _num_threads = 0;
 }
 
 
@@ -134,7 +144,17 @@ handle_args(ProgramBase::Args &args) {
 
   Args::const_iterator ai;
   for (ai = args.begin(); ai != args.end(); ++ai) {
-    PT(EggData) data = read_egg(Filename::from_os_specific(*ai));
+    _egg_filenames.push_back(Filename::from_os_specific(*ai));
+  }
+
+  if (_independent_eggs) {
+    // The egg files will be read one at a time by process_eggs().
+    return true;
+  }
+
+  Filenames::const_iterator fi;
+  for (fi = _egg_filenames.begin(); fi != _egg_filenames.end(); ++fi) {
+    PT(EggData) data = read_egg(*fi);
     if (data == nullptr) {
       // Rather than returning false, we simply exit here, so the ProgramBase
       // won't try to tell the user how to run the program just because we got
@@ -172,7 +192,7 @@ post_command_line() {
 Filename EggMultiFilter::
 get_output_filename(const Filename &source_filename) const {
   if (_got_output_filename) {
-    nassertr(!_inplace && !_got_output_dirname && _eggs.size() == 1, Filename());
+    nassertr(!_inplace && !_got_output_dirname && _egg_filenames.size() == 1, Filename());
     return _output_filename;
 
   } else if (_got_output_dirname) {
@@ -208,3 +228,137 @@ write_eggs() {
     }
   }
 }
+
+/**
+ * Derived programs whose processing of each egg file is independent of the
+ * others may call this in their constructor.  Such a program overrides
+ * process_egg() and calls process_eggs() instead of write_eggs(); the egg
+ * files are then not read up front into _eggs, but each is read, processed
+ * and written in turn by one of several threads, so that only as many egg
+ * files are in memory at once as there are threads.
+ */
+void EggMultiFilter::
+add_threads_option() {
+  add_option
+    ("j", "threads", 0,
+     "Process the indicated number of egg files at once, each in its own "
+     "thread.  The default is taken from the pandatool-num-threads config "
+     "variable.  The output is the same regardless of the number of "
+     "threads.",
+     &EggMultiFilter::dispatch_int, nullptr, &_num_threads);
+
+  _independent_eggs = true;
+}
+
+/**
+ * Called by process_eggs() to perform the program's own processing of one egg
+ * file, after it has been read and before the standard post-processing.  This
+ * may be called for different egg files from different threads at once, and
+ * any messages should be written to out rather than to nout.
+ */
+void EggMultiFilter::
+process_egg(EggData *, std::ostream &) {
+}
+
+/**
+ * The counterpart of write_eggs() for programs that call
+ * add_threads_option(): reads, processes and writes each of the egg files
+ * named on the command line, several at a time, and then reports the time
+ * spent on each.  If any egg file can't be read or written, the program exits
+ * with an error after the others have been written.
+ */
+void EggMultiFilter::
+process_eggs() {
+  nassertv(!_read_only && _independent_eggs);
+  int num_eggs = (int)_egg_filenames.size();
+  if (num_eggs == 0) {
+    return;
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  // The first egg file establishes the coordinate system of the rest, unless
+  // the user specified one, so it is read before the others start.
+  PT(EggData) first_data = read_egg(_egg_filenames[0]);
+  double first_read = clock->get_short_time() - start;
+  if (first_data == nullptr) {
+    exit(1);
+  }
+  report_post_process(_coordinate_system);
+
+  pvector<FileTiming> timings(num_eggs);
+  Mutex lock;
+
+  WorkerPool pool(_num_threads);
+  pool.run(num_eggs, [&](int i) {
+    FileTiming &timing = timings[i];
+    std::ostringstream out;
+
+    double read_start = clock->get_short_time();
+    PT(EggData) data;
+    if (i == 0) {
+      data = std::move(first_data);
+      timing._read = first_read;
+    } else {
+      data = read_egg(_egg_filenames[i]);
+      timing._read = clock->get_short_time() - read_start;
+    }
+    timing._process = 0.0;
+    timing._write = 0.0;
+
+    if (data == nullptr) {
+      out << "Unable to read " << _egg_filenames[i] << "\n";
+      timing._ok = false;
+
+    } else {
+      double process_start = clock->get_short_time();
+      data->set_coordinate_system(_coordinate_system);
+      append_command_comment(data);
+      process_egg(data, out);
+      post_process_egg_file(data);
+
+      double write_start = clock->get_short_time();
+      timing._process = write_start - process_start;
+
+      Filename filename = get_output_filename(data->get_egg_filename());
+      out << "Writing " << filename << "\n";
+      filename.make_dir();
+      timing._ok = data->write_egg(filename);
+      if (!timing._ok) {
+        out << "Unable to write " << filename << "\n";
+      }
+      timing._write = clock->get_short_time() - write_start;
+    }
+
+    MutexHolder holder(lock);
+    nout << out.str();
+  });
+
+  double elapsed = clock->get_short_time() - start;
+
+  std::ostringstream summary;
+  summary << std::fixed << std::setprecision(3)
+          << "\n  read     process  write    egg file\n";
+  int num_failed = 0;
+  for (int i = 0; i < num_eggs; ++i) {
+    const FileTiming &timing = timings[i];
+    summary << "  " << std::setw(8) << std::left << timing._read
+            << " " << std::setw(8) << timing._process
+            << " " << std::setw(8) << timing._write
+            << " " << _egg_filenames[i];
+    if (!timing._ok) {
+      summary << " (failed)";
+      ++num_failed;
+    }
+    summary << "\n";
+  }
+  summary << "Processed " << num_eggs << " egg files in " << elapsed
+          << " s with " << pool.get_num_threads() << " threads.\n";
+  nout << summary.str();
+
+  if (num_failed != 0) {
+    nout << num_failed << " egg files failed.\n";
+    exit(1);
+  }
+}
@@ -34,6 +34,10 @@ protected:
   Filename get_output_filename(const Filename &source_filename) const;
   virtual void write_eggs();
 
+  void add_threads_option();
+  virtual void process_egg(EggData *data, std::ostream &out);
+  void process_eggs();
+
 protected:
   bool _allow_empty;
   bool _got_output_filename;
@@ -46,6 +50,21 @@ protected:
   bool _got_input_filename;
 
   bool _read_only;
+
+  bool _independent_eggs;
+  int _num_threads;
+
+  typedef pvector<Filename> Filenames;
+  Filenames _egg_filenames;
+
+private:
+  class FileTiming {
+  public:
+    bool _ok;
+    double _read;
+    double _process;
+    double _write;
+  };
 };
 
 #endif
@@ -12,8 +12,8 @@
  */
 
 #include "eggReader.h"
+#include "textureCopyQueue.h"
 
-#include "pnmImage.h"
 #include "config_putil.h"
 #include "eggTextureCollection.h"
 #include "eggGroup.h"
@@ -71,8 +71,12 @@ add_texture_options() {
   add_option
     ("td", "dirname", 40,
      "Copy textures to the indicated directory.  The copy is performed "
-     "only if the destination file does not exist or is older than the "
-     "source file.",
+     "only if the destination file does not exist, or the contents of the "
+     "source file or the destination file have changed since it was last "
+     "copied.  The contents of the copies are recorded in the file named "
+     "by pandatool-texture-copy-cache; if that is empty, or the "
+     "destination was not copied by this program, the copy is performed "
+     "if the source file is newer than the destination file instead.",
      &EggReader::dispatch_filename, &_got_tex_dirname, &_tex_dirname);
 
   add_option
@@ -245,11 +249,13 @@ do_reader_options() {
 
 /**
  * Renames and copies the textures referenced in the egg file, if so specified
- * by the -td and -te options.  Returns true if all textures are copied
- * successfully, false if any one of them failed.
+ * by the -td and -te options.  The copies are made by the TextureCopyQueue,
+ * several at a time.  Returns true if all textures are copied successfully,
+ * false if any one of them failed.
  */
 bool EggReader::
 copy_textures() {
+  TextureCopyQueue *queue = TextureCopyQueue::get_global_ptr();
   bool success = true;
   EggTextureCollection textures;
   textures.find_used_textures(_data);
@@ -277,28 +283,14 @@ copy_textures() {
 
     if (orig_filename != new_filename) {
       tex->set_filename(new_filename);
-
-      // The new filename is different; does it need copying?
-      int compare =
-        orig_filename.compare_timestamps(new_filename, true, true);
-      if (compare > 0) {
-        // Yes, it does.  Copy it!
-        nout << "Reading " << orig_filename << "\n";
-        PNMImage image;
-        if (!image.read(orig_filename)) {
-          nout << "  unable to read!\n";
-          success = false;
-        } else {
-          nout << "Writing " << new_filename << "\n";
-          if (!image.write(new_filename, _tex_type)) {
-            nout << "  unable to write!\n";
-            success = false;
-          }
-        }
-      }
+      queue->add_copy(orig_filename, new_filename, _tex_type);
     }
   }
 
+  if (!queue->flush()) {
+    success = false;
+  }
+
   return success;
 }
 
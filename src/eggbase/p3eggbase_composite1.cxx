@@ -10,4 +10,5 @@
 #include "eggSingleBase.cxx"
 #include "eggToSomething.cxx"
 #include "somethingToEgg.cxx"
+#include "textureCopyQueue.cxx"
 
@@ -0,0 +1,391 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file textureCopyQueue.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "textureCopyQueue.h"
+#include "config_pandatoolbase.h"
+#include "workerPool.h"
+#include "mutexHolder.h"
+#include "pnmImage.h"
+#include "pnmFileType.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "virtualFileSystem.h"
+
+#include <sstream>
+
+TextureCopyQueue *TextureCopyQueue::_global_ptr = nullptr;
+
+/**
+ *
+ */
+TextureCopyQueue::
+TextureCopyQueue() :
+  _cache_read(false)
+{
+}
+
+/**
+ * Returns the one TextureCopyQueue for the process.
+ */
+TextureCopyQueue *TextureCopyQueue::
+get_global_ptr() {
+  if (_global_ptr == nullptr) {
+    _global_ptr = new TextureCopyQueue;
+  }
+  return _global_ptr;
+}
+
+/**
+ * Requests that the indicated source image be copied to the indicated
+ * destination, converting it to the indicated type, or to the type implied
+ * by the destination's extension if type is NULL.  The copy is made by the
+ * next call to flush(), unless the same destination has been requested
+ * before.
+ */
+void TextureCopyQueue::
+add_copy(const Filename &source, const Filename &dest, PNMFileType *type) {
+  std::string key = dest.get_fullpath();
+  _requested.push_back(key);
+
+  Copies::iterator ci = _copies.find(key);
+  if (ci != _copies.end()) {
+    const Copy &copy = (*ci).second;
+    if (copy._source != source) {
+      nout << "Both " << copy._source << " and " << source
+           << " would be copied to " << dest << "; using "
+           << copy._source << ".\n";
+    }
+    return;
+  }
+
+  Copy copy;
+  copy._source = source;
+  copy._dest = dest;
+  copy._type = type;
+  copy._state = CS_queued;
+  _copies[key] = copy;
+  _queue.push_back(key);
+}
+
+/**
+ * Makes all of the copies requested by add_copy() since the last call to
+ * flush().  Returns true if all of them, including any that had already been
+ * made before, were successful, or false if any failed.
+ */
+bool TextureCopyQueue::
+flush() {
+  pvector<std::string> queue, requested;
+  queue.swap(_queue);
+  requested.swap(_requested);
+
+  if (!queue.empty()) {
+    WorkerPool::prepare_image_threads();
+
+    pvector<const Copy *> copies;
+    copies.reserve(queue.size());
+    for (const std::string &key : queue) {
+      copies.push_back(&_copies[key]);
+    }
+
+    pvector<std::string> messages(copies.size());
+    pvector<bool> results(copies.size());
+
+    WorkerPool pool;
+    pool.run((int)copies.size(), [&](int i) {
+      std::ostringstream out;
+      results[i] = perform_copy(*copies[i], out);
+      messages[i] = out.str();
+    });
+
+    for (size_t i = 0; i < queue.size(); ++i) {
+      nout << messages[i];
+      _copies[queue[i]]._state = results[i] ? CS_done : CS_failed;
+    }
+
+    if (!_changed_records.empty()) {
+      write_cache();
+    }
+  }
+
+  bool success = true;
+  for (const std::string &key : requested) {
+    if (_copies[key]._state != CS_done) {
+      success = false;
+    }
+  }
+  return success;
+}
+
+/**
+ * Makes one copy, unless its destination is already up to date.  This is
+ * called from several threads at once.  Returns true on success.
+ */
+bool TextureCopyQueue::
+perform_copy(const Copy &copy, std::ostream &out) {
+  if (!use_cache()) {
+    if (copy._source.compare_timestamps(copy._dest, true, true) <= 0) {
+      return true;
+    }
+    return convert_image(copy, out);
+  }
+
+  Record record;
+  record._source = get_record_key(copy._source);
+  record._type = get_type_name(copy._type);
+  if (!hash_file(copy._source, record._source_hash)) {
+    out << "Unable to read " << copy._source << "\n";
+    return false;
+  }
+
+  std::string key = get_record_key(copy._dest);
+  bool up_to_date = false;
+  bool got_dest_hash = false;
+  {
+    MutexHolder holder(_cache_lock);
+    const Records &records = get_records();
+    Records::const_iterator ri = records.find(key);
+    if (ri != records.end()) {
+      const Record &old_record = (*ri).second;
+      if (old_record._source == record._source &&
+          old_record._type == record._type &&
+          old_record._source_hash == record._source_hash) {
+        record._dest_hash = old_record._dest_hash;
+        got_dest_hash = true;
+        up_to_date = true;
+      }
+    } else {
+      // We have never copied this texture before; fall back to the
+      // timestamps.
+      up_to_date =
+        (copy._source.compare_timestamps(copy._dest, true, true) <= 0);
+    }
+  }
+
+  if (up_to_date) {
+    // Make sure the destination hasn't been changed since.
+    HashVal dest_hash;
+    if (hash_file(copy._dest, dest_hash) &&
+        (!got_dest_hash || dest_hash == record._dest_hash)) {
+      if (!got_dest_hash) {
+        // Remember it for next time.
+        record._dest_hash = dest_hash;
+        MutexHolder holder(_cache_lock);
+        set_record(key, &record);
+      }
+      return true;
+    }
+  }
+
+  if (!convert_image(copy, out)) {
+    return false;
+  }
+
+  bool hashed = hash_file(copy._dest, record._dest_hash);
+  MutexHolder holder(_cache_lock);
+  set_record(key, hashed ? &record : nullptr);
+  return true;
+}
+
+/**
+ * Reads the source image of the copy and writes it to the destination.
+ * Returns true on success.
+ */
+bool TextureCopyQueue::
+convert_image(const Copy &copy, std::ostream &out) {
+  out << "Reading " << copy._source << "\n";
+  PNMImage image;
+  if (!image.read(copy._source)) {
+    out << "  unable to read!\n";
+    return false;
+  }
+
+  out << "Writing " << copy._dest << "\n";
+  if (!image.write(copy._dest, copy._type)) {
+    out << "  unable to write!\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Returns true if the copies are checked against the cache file named by
+ * pandatool-texture-copy-cache, or false if only the timestamps are
+ * compared.
+ */
+bool TextureCopyQueue::
+use_cache() {
+#ifdef HAVE_OPENSSL
+  return !pandatool_texture_copy_cache.get_value().empty();
+#else
+  // There is no way to hash the images.
+  return false;
+#endif  // HAVE_OPENSSL
+}
+
+/**
+ * Computes the hash of the contents of the indicated file.  Returns true on
+ * success, false if the file can't be read.
+ */
+bool TextureCopyQueue::
+hash_file(const Filename &filename, HashVal &hash) {
+#ifdef HAVE_OPENSSL
+  return hash.hash_file(filename);
+#else
+  return false;
+#endif  // HAVE_OPENSSL
+}
+
+/**
+ * Returns the absolute name of the indicated file, which identifies a copy
+ * to that destination, or from that source, in the cache.
+ */
+std::string TextureCopyQueue::
+get_record_key(const Filename &dest) {
+  Filename key = dest;
+  key.make_absolute();
+  key.standardize();
+  return key.get_fullpath();
+}
+
+/**
+ * Returns the records of the copies made by previous runs, reading the cache
+ * file first if necessary.  _cache_lock must be held.
+ */
+TextureCopyQueue::Records &TextureCopyQueue::
+get_records() {
+  if (!_cache_read) {
+    _cache_read = true;
+    read_records(pandatool_texture_copy_cache, _records);
+  }
+  return _records;
+}
+
+/**
+ * Replaces the record of the copy identified by key, or removes it if record
+ * is NULL, and marks it to be written out by the next flush().  _cache_lock
+ * must be held.
+ */
+void TextureCopyQueue::
+set_record(const std::string &key, const Record *record) {
+  Records &records = get_records();
+  if (record != nullptr) {
+    records[key] = *record;
+  } else {
+    records.erase(key);
+  }
+  _changed_records.insert(key);
+}
+
+/**
+ * Writes the records changed since the last flush() to the cache file.
+ *
+ * Other processes may be copying textures at the same time, so the file is
+ * read again first and only the changed records are replaced, and the result
+ * is written to a temporary file that is then renamed into place.
+ */
+void TextureCopyQueue::
+write_cache() {
+  Filename filename = pandatool_texture_copy_cache;
+  Records records;
+  read_records(filename, records);
+  for (const std::string &key : _changed_records) {
+    Records::const_iterator ri = _records.find(key);
+    if (ri != _records.end()) {
+      records[key] = (*ri).second;
+    } else {
+      records.erase(key);
+    }
+  }
+  _changed_records.clear();
+
+  Datagram dg;
+  dg.append_data("texc", 4);
+  dg.add_uint32(3);
+  dg.add_uint32(records.size());
+
+  for (Records::const_iterator ri = records.begin();
+       ri != records.end();
+       ++ri) {
+    const Record &record = (*ri).second;
+    dg.add_string((*ri).first);
+    dg.add_string(record._source);
+    dg.add_string(record._type);
+    record._source_hash.write_datagram(dg);
+    record._dest_hash.write_datagram(dg);
+  }
+
+  filename.set_binary();
+  filename.make_dir();
+  Filename temp = Filename::temporary(filename.get_dirname(),
+                                      filename.get_basename() + ".");
+  temp.set_binary();
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  if (!vfs->write_file(temp, (const unsigned char *)dg.get_data(),
+                       dg.get_length(), false) ||
+      !temp.rename_to(filename)) {
+    nout << "Couldn't write " << filename << "\n";
+    temp.unlink();
+  }
+}
+
+/**
+ * Reads the records of the copies made by previous runs from the indicated
+ * cache file into records.  Returns true if the file was read, false if it
+ * doesn't exist or can't be understood.
+ */
+bool TextureCopyQueue::
+read_records(const Filename &filename, Records &records) {
+  if (filename.empty()) {
+    return false;
+  }
+  Filename binary_filename = filename;
+  binary_filename.set_binary();
+
+  VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
+  vector_uchar data;
+  if (!vfs->exists(binary_filename) ||
+      !vfs->read_file(binary_filename, data, true)) {
+    return false;
+  }
+
+  Datagram dg(data);
+  DatagramIterator di(dg);
+  if (di.get_remaining_size() < 12 || di.get_fixed_string(4) != "texc" ||
+      di.get_uint32() != 3) {
+    nout << "Ignoring " << filename << " in an unknown format.\n";
+    return false;
+  }
+
+  uint32_t num_records = di.get_uint32();
+  for (uint32_t i = 0; i < num_records; ++i) {
+    std::string key = di.get_string();
+    Record &record = records[key];
+    record._source = di.get_string();
+    record._type = di.get_string();
+    record._source_hash.read_datagram(di);
+    record._dest_hash.read_datagram(di);
+  }
+  return true;
+}
+
+/**
+ * Returns the name of the indicated image type for the cache records, or the
+ * empty string if the type is taken from the extension.
+ */
+std::string TextureCopyQueue::
+get_type_name(PNMFileType *type) {
+  if (type == nullptr) {
+    return std::string();
+  }
+  return type->get_name();
+}
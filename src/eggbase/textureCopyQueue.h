@@ -0,0 +1,109 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file textureCopyQueue.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef TEXTURECOPYQUEUE_H
+#define TEXTURECOPYQUEUE_H
+
+#include "pandatoolbase.h"
+
+#include "filename.h"
+#include "hashVal.h"
+#include "pmutex.h"
+#include "pmap.h"
+#include "pset.h"
+#include "pvector.h"
+
+class PNMFileType;
+
+/**
+ * Copies and converts texture images on behalf of the -td and -te options of
+ * EggReader, for the whole process.
+ *
+ * Copies are queued with add_copy(), and performed by flush(), several at a
+ * time according to pandatool-num-threads.  A copy to a destination that
+ * has already been queued or made is not repeated, no matter how many egg
+ * textures reference it.
+ *
+ * A copy is also skipped if its destination is up to date.  The file named
+ * by pandatool-texture-copy-cache, which is shared by every destination
+ * directory, records a content hash of the source image and of the converted
+ * image for each copy made.  A destination is up to date if neither hash has
+ * changed, regardless of the timestamps.  When there is no record of a
+ * destination, or the cache is disabled, it is up to date if it is newer
+ * than its source.
+ *
+ * add_copy() and flush() should be called from only one thread at a time;
+ * the copies themselves are made in parallel.
+ */
+class TextureCopyQueue {
+private:
+  TextureCopyQueue();
+
+public:
+  static TextureCopyQueue *get_global_ptr();
+
+  void add_copy(const Filename &source, const Filename &dest,
+                PNMFileType *type);
+  bool flush();
+
+private:
+  enum CopyState {
+    CS_queued,
+    CS_done,
+    CS_failed,
+  };
+
+  class Copy {
+  public:
+    Filename _source;
+    Filename _dest;
+    PNMFileType *_type;
+    CopyState _state;
+  };
+  typedef pmap<std::string, Copy> Copies;
+
+  class Record {
+  public:
+    std::string _source;
+    std::string _type;
+    HashVal _source_hash;
+    HashVal _dest_hash;
+  };
+  typedef pmap<std::string, Record> Records;
+
+
+  bool perform_copy(const Copy &copy, std::ostream &out);
+  static bool convert_image(const Copy &copy, std::ostream &out);
+  static bool use_cache();
+  static bool hash_file(const Filename &filename, HashVal &hash);
+  static std::string get_record_key(const Filename &dest);
+  Records &get_records();
+  void set_record(const std::string &key, const Record *record);
+  void write_cache();
+  static bool read_records(const Filename &filename, Records &records);
+  static std::string get_type_name(PNMFileType *type);
+
+  Copies _copies;
+  pvector<std::string> _queue;
+  pvector<std::string> _requested;
+
+  // This is shared by the threads making the copies.
+  Mutex _cache_lock;
+  bool _cache_read;
+  Records _records;
+  pset<std::string> _changed_records;
+
+  static TextureCopyQueue *_global_ptr;
+};
+
+#endif
@@ -1,5 +1,5 @@
 #define LOCAL_LIBS \
-  converter eggbase progbase
+  converter eggbase progbase pandatoolbase
 #define OTHER_LIBS \
   egg:c pandaegg:m \
   event:c pipeline:c pstatclient:c downloader:c net:c nativenet:c \
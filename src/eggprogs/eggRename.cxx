@@ -27,6 +27,8 @@ EggRename() {
     ("strip_prefix", "name", 0,
      "strips out the prefix that is put on all nodes, by maya ext. ref",
      &EggRename::dispatch_vector_string, nullptr, &_strip_prefix);
+
+  add_threads_option();
 }
 
 /**
@@ -36,17 +38,21 @@ void EggRename::
 run() {
   if (!_strip_prefix.empty()) {
     nout << "Stripping prefix from nodes.\n";
-    int num_renamed = 0;
-    int num_egg_files = 0;
-    Eggs::iterator ei;
-    for (ei = _eggs.begin(); ei != _eggs.end(); ++ei) {
-      num_renamed += (*ei)->rename_nodes(_strip_prefix, true);
-      ++num_egg_files;
-    }
-    nout << "  (" << num_renamed << " renamed.)\n";
   }
 
-  write_eggs();
+  process_eggs();
+}
+
+/**
+ * Renames the nodes of one egg file.
+ */
+void EggRename::
+process_egg(EggData *data, std::ostream &out) {
+  if (!_strip_prefix.empty()) {
+    int num_renamed = data->rename_nodes(_strip_prefix, true);
+    out << "  (" << num_renamed << " renamed in "
+        << data->get_egg_filename().get_basename() << ".)\n";
+  }
 }
 
 
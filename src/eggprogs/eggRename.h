@@ -28,6 +28,10 @@ public:
 
   void run();
 
+protected:
+  virtual void process_egg(EggData *data, std::ostream &out);
+
+public:
   vector_string _strip_prefix;
 };
 
@@ -22,6 +22,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <algorithm>
 
 TypeHandle FltHeader::_type_handle;
 
@@ -477,9 +478,7 @@ get_vertex(int n) const {
 void FltHeader::
 clear_vertices() {
   _vertices.clear();
-  _unique_vertices.clear();
-  _vertices_by_offset.clear();
-  _offsets_by_vertex.clear();
+  _vertex_offsets.clear();
   _vertex_lookups_stale = false;
 }
 
@@ -489,12 +488,16 @@ clear_vertices() {
  */
 void FltHeader::
 add_vertex(FltVertex *vertex) {
-  bool inserted = _unique_vertices.insert(vertex).second;
-  if (inserted) {
-    _vertices.push_back(vertex);
+  int index = vertex->_palette_index;
+  if (index >= 0 && index < (int)_vertices.size() &&
+      _vertices[index] == vertex) {
+    // It's already in the palette.
+    return;
   }
+
+  vertex->_palette_index = (int)_vertices.size();
+  _vertices.push_back(vertex);
   _vertex_lookups_stale = true;
-  nassertv(_unique_vertices.size() == _vertices.size());
 }
 
 /**
@@ -508,13 +511,29 @@ get_vertex_by_offset(int offset) {
     update_vertex_lookups();
   }
 
-  VerticesByOffset::const_iterator vi;
-  vi = _vertices_by_offset.find(offset);
-  if (vi == _vertices_by_offset.end()) {
+  int num_vertices = (int)_vertex_offsets.size();
+  if (num_vertices > 1) {
+    // The vertex records in a palette are usually all the same size, in which
+    // case we can compute the index directly.
+    int first = _vertex_offsets[0];
+    int stride = _vertex_offsets[1] - first;
+    if (offset >= first && stride > 0 && (offset - first) % stride == 0) {
+      int index = (offset - first) / stride;
+      if (index < num_vertices && _vertex_offsets[index] == offset) {
+        return _vertices[index];
+      }
+    }
+  }
+
+  // Otherwise, look it up with a binary search.
+  VertexOffsets::const_iterator oi;
+  oi = std::lower_bound(_vertex_offsets.begin(), _vertex_offsets.end(),
+                        offset);
+  if (oi == _vertex_offsets.end() || (*oi) != offset) {
     nout << "No vertex with offset " << offset << "\n";
     return nullptr;
   }
-  return (*vi).second;
+  return _vertices[oi - _vertex_offsets.begin()];
 }
 
 /**
@@ -528,13 +547,13 @@ get_offset_by_vertex(FltVertex *vertex) {
     update_vertex_lookups();
   }
 
-  OffsetsByVertex::const_iterator vi;
-  vi = _offsets_by_vertex.find(vertex);
-  if (vi == _offsets_by_vertex.end()) {
+  int index = vertex->_palette_index;
+  if (index < 0 || index >= (int)_vertices.size() ||
+      _vertices[index] != vertex) {
     nout << "Vertex does not appear in palette.\n";
     return 0;
   }
-  return (*vi).second;
+  return _vertex_offsets[index];
 }
 
 /**
@@ -1028,12 +1047,13 @@ update_vertex_lookups() {
   // We start with the length of the vertex palette record itself.
   int offset = 8;
 
-  Vertices::const_iterator vi;
-  for (vi = _vertices.begin(); vi != _vertices.end(); ++vi) {
-    FltVertex *vertex = (*vi);
+  size_t num_vertices = _vertices.size();
+  _vertex_offsets.resize(num_vertices);
+  for (size_t i = 0; i < num_vertices; ++i) {
+    FltVertex *vertex = _vertices[i];
 
-    _offsets_by_vertex[vertex] = offset;
-    _vertices_by_offset[offset] = vertex;
+    vertex->_palette_index = (int)i;
+    _vertex_offsets[i] = offset;
     offset += vertex->get_record_length();
   }
 
@@ -1309,10 +1329,9 @@ extract_vertex(FltRecordReader &reader) {
   if (!vertex->extract_record(reader)) {
     return false;
   }
+  vertex->_palette_index = (int)_vertices.size();
   _vertices.push_back(vertex);
-  _unique_vertices.insert(vertex);
-  _offsets_by_vertex[vertex] = _current_vertex_offset;
-  _vertices_by_offset[_current_vertex_offset] = vertex;
+  _vertex_offsets.push_back(_current_vertex_offset);
   _current_vertex_offset += reader.get_record_length();
 
   // _vertex_lookups_stale remains false.
@@ -241,16 +241,15 @@ private:
   // Support for the vertex palette.
   int update_vertex_lookups();
 
+  // The byte offset of each vertex is stored in _vertex_offsets, at the same
+  // index as the vertex in _vertices, and so is in ascending order.  Each
+  // vertex also records its own index, so no map is needed in either
+  // direction.
   typedef pvector<PT(FltVertex)> Vertices;
-  typedef pset<FltVertex *> UniqueVertices;
-
-  typedef pmap<int, FltVertex *> VerticesByOffset;
-  typedef pmap<FltVertex *, int> OffsetsByVertex;
+  typedef pvector<int> VertexOffsets;
 
   Vertices _vertices;
-  UniqueVertices _unique_vertices;
-  VerticesByOffset _vertices_by_offset;
-  OffsetsByVertex _offsets_by_vertex;
+  VertexOffsets _vertex_offsets;
 
   bool _vertex_lookups_stale;
 
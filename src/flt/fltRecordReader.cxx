@@ -27,7 +27,6 @@ FltRecordReader(std::istream &in) :
 {
   _opcode = FO_none;
   _record_length = 0;
-  _iterator = nullptr;
   _state = S_begin;
   _next_error = FE_ok;
   _next_opcode = FO_none;
@@ -42,8 +41,6 @@ FltRecordReader(std::istream &in) :
  */
 FltRecordReader::
 ~FltRecordReader() {
-  delete _iterator;
-  _iterator = nullptr;
 }
 
 /**
@@ -60,8 +57,8 @@ get_opcode() const {
  */
 DatagramIterator &FltRecordReader::
 get_iterator() {
-  nassertr(_state == S_normal, *_iterator);
-  return *_iterator;
+  nassertr(_state == S_normal, _iterator);
+  return _iterator;
 }
 
 /**
@@ -74,7 +71,7 @@ get_datagram() {
   static Datagram bogus_datagram;
   nassertr(_state == S_normal, bogus_datagram);
 #endif
-  return _iterator->get_datagram();
+  return _datagram;
 }
 
 /**
@@ -99,10 +96,6 @@ advance(bool ok_eof) {
     assert(!flt_error_abort);
     return FE_read_error;
   }
-  if (_iterator != nullptr) {
-    delete _iterator;
-    _iterator = nullptr;
-  }
 
   if (_next_error == FE_end_of_file) {
     _state = S_eof;
@@ -127,17 +120,17 @@ advance(bool ok_eof) {
       << " of length " << _record_length << "\n";
   }
 
-  // And now read the full record based on the length.
-  int length = _next_record_length - header_size;
-  if (length > 0) {
-    vector_uchar data((size_t)length);
-    _in.read((char *)&data[0], length);
-    _datagram = Datagram(std::move(data));
-  } else {
-    _datagram = Datagram();
+  // If some record from before is still holding a reference to our buffer
+  // (for instance, an FltUnsupportedRecord keeps its datagram), we must
+  // start a new buffer rather than overwriting it.  Otherwise, the buffer
+  // shared only with our own _datagram may be reused.
+  if (_buffer.is_null() || _buffer.get_ref_count() > 2) {
+    _buffer = PTA_uchar::empty_array(0);
   }
+  _buffer.v().clear();
 
-  if (_in.fail()) {
+  // And now read the full record based on the length.
+  if (!read_data((size_t)(_next_record_length - header_size))) {
     if (_in.eof()) {
       _state = S_eof;
       assert(!flt_error_abort);
@@ -159,16 +152,8 @@ advance(bool ok_eof) {
 
     // Read the continuation and tack it on.
     _record_length += _next_record_length;
-    length = _next_record_length - header_size;
 
-    if (length > 0) {
-      char *buffer = new char[length];
-      _in.read(buffer, length);
-      _datagram.append_data(buffer, length);
-      delete[] buffer;
-    }
-
-    if (_in.fail()) {
+    if (!read_data((size_t)(_next_record_length - header_size))) {
       if (_in.eof()) {
         _state = S_eof;
         assert(!flt_error_abort);
@@ -183,8 +168,9 @@ advance(bool ok_eof) {
     read_next_header();
   }
 
-  // Finally, create a new iterator to read this record.
-  _iterator = new DatagramIterator(_datagram);
+  // Finally, reset the iterator to read this record.
+  _datagram.set_array(_buffer);
+  _iterator.assign(_datagram);
   _state = S_normal;
 
   return FE_ok;
@@ -229,14 +215,31 @@ read_next_header() {
     return;
   }
 
-  // Now extract out the opcode and length.
-  Datagram dg(bytes, header_size);
-  DatagramIterator dgi(dg);
-  _next_opcode = (FltOpcode)dgi.get_be_int16();
-  _next_record_length = dgi.get_be_uint16();
+  // Now extract out the opcode and length, both big-endian.
+  const unsigned char *ubytes = (const unsigned char *)bytes;
+  _next_opcode = (FltOpcode)(int16_t)((ubytes[0] << 8) | ubytes[1]);
+  _next_record_length = (ubytes[2] << 8) | ubytes[3];
 
   if (_next_record_length < header_size) {
     _next_error = FE_invalid_record;
     return;
   }
 }
+
+/**
+ * Reads the indicated number of bytes from the file, and appends them to the
+ * end of the current record's buffer.  Returns true on success, false if the
+ * read failed.
+ */
+bool FltRecordReader::
+read_data(size_t length) {
+  if (length == 0) {
+    return true;
+  }
+
+  pvector<unsigned char> &data = _buffer.v();
+  size_t start = data.size();
+  data.resize(start + length);
+  _in.read((char *)&data[start], length);
+  return !_in.fail();
+}
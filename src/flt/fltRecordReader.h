@@ -21,11 +21,15 @@
 
 #include "datagram.h"
 #include "datagramIterator.h"
+#include "pta_uchar.h"
 
 /**
  * This class turns an istream into a sequence of FltRecords by reading a
  * sequence of Datagrams and extracting the opcode from each one.  It
  * remembers where it is in the file and what the current record is.
+ *
+ * The same buffer is reused to hold each record in turn, so that reading a
+ * large file doesn't allocate a new buffer for each of its many records.
  */
 class FltRecordReader {
 public:
@@ -44,12 +48,14 @@ public:
 
 private:
   void read_next_header();
+  bool read_data(size_t length);
 
   std::istream &_in;
+  PTA_uchar _buffer;
   Datagram _datagram;
   FltOpcode _opcode;
   int _record_length;
-  DatagramIterator *_iterator;
+  DatagramIterator _iterator;
 
   FltError _next_error;
   FltOpcode _next_opcode;
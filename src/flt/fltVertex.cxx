@@ -32,6 +32,8 @@ FltVertex(FltHeader *header) : FltRecord(header) {
 
   _has_normal = false;
   _has_uv = false;
+
+  _palette_index = -1;
 }
 
 /**
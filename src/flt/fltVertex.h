@@ -81,6 +81,10 @@ public:
   }
 
 private:
+  // The index of this vertex within its header's vertex palette, or -1 if it
+  // has not been added to the palette.
+  int _palette_index;
+
   static TypeHandle _type_handle;
 
   friend class FltHeader;
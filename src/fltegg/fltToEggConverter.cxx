@@ -34,6 +34,16 @@
 #include "eggVertexPool.h"
 #include "eggExternalReference.h"
 #include "string_utils.h"
+#include "geomNode.h"
+#include "renderState.h"
+#include "colorAttrib.h"
+#include "textureAttrib.h"
+#include "textureStage.h"
+#include "samplerState.h"
+#include "transparencyAttrib.h"
+#include "cullFaceAttrib.h"
+#include "transformState.h"
+#include "texturePool.h"
 
 using std::string;
 
@@ -99,6 +109,18 @@ supports_compressed() const {
   return true;
 }
 
+/**
+ * Returns true if this converter can directly convert the model type to
+ * internal Panda memory structures, given the indicated options, or false
+ * otherwise.  If this returns true, then convert_to_node() may be called to
+ * perform the conversion, which may be faster than calling convert_file() if
+ * the ultimate goal is a PandaNode anyway.
+ */
+bool FltToEggConverter::
+supports_convert_to_node(const LoaderOptions &options) const {
+  return true;
+}
+
 /**
  * Handles the reading of the input file and converting it to egg.  Returns
  * true if successful, false otherwise.
@@ -125,6 +147,51 @@ convert_file(const Filename &filename) {
   return convert_flt(header);
 }
 
+/**
+ * Reads the input file and directly produces a ready-to-render model file as
+ * a PandaNode.  Returns NULL on failure, or if it is not supported.  (This
+ * functionality is not supported by all converter types; see
+ * supports_convert_to_node()).
+ *
+ * Only the common subset of OpenFlight is handled this way: if the file
+ * contains external references, decals, billboards, light points, sequence
+ * animations, or embedded <egg> syntax in its comments, this returns NULL,
+ * and the file should be loaded via convert_file() instead.
+ */
+PT(PandaNode) FltToEggConverter::
+convert_to_node(const LoaderOptions &options, const Filename &filename) {
+  PT(FltHeader) header = new FltHeader(_path_replace);
+
+  nout << "Reading " << filename << "\n";
+  FltError result = header->read_flt(filename);
+  if (result != FE_ok) {
+    nout << "Unable to read: " << result << "\n";
+    return nullptr;
+  }
+
+  header->check_version();
+
+  _flt_units = header->get_units();
+
+  if (!can_convert_to_node(header)) {
+    return nullptr;
+  }
+
+  clear_error();
+  _flt_header = header;
+
+  PT(PandaNode) root = new PandaNode("");
+  convert_node_level(_flt_header, root, nullptr);
+
+  _flt_header.clear();
+  _node_textures.clear();
+
+  if (had_error()) {
+    return nullptr;
+  }
+  return root;
+}
+
 /**
  * This may be called after convert_file() has been called and returned true,
  * indicating a successful conversion.  It will return the distance units
@@ -157,6 +224,13 @@ convert_flt(const FltHeader *flt_header) {
   // be adjusted to match the particular polygon they're assigned to (for
   // instance, to apply a transparency or something).
 
+  if (_merge_externals) {
+    // Convert all of the referenced files up front, in parallel.
+    pvector<Filename> ref_filenames;
+    collect_ext_refs(_flt_header, ref_filenames);
+    prefetch_external_references(ref_filenames);
+  }
+
   FltToEggLevelState state(this);
   state._egg_parent = _egg_data;
   convert_record(_flt_header, state);
@@ -387,6 +461,28 @@ convert_ext_ref(const FltExternalReference *flt_ext, FltToEggLevelState &state)
   handle_external_reference(egg_parent, flt_ext->get_ref_filename());
 }
 
+/**
+ * Appends the filename of each external reference at or below the indicated
+ * record to ref_filenames.
+ */
+void FltToEggConverter::
+collect_ext_refs(const FltRecord *flt_record, pvector<Filename> &ref_filenames) {
+  if (flt_record->is_of_type(FltExternalReference::get_class_type())) {
+    const FltExternalReference *flt_ext = DCAST(FltExternalReference, flt_record);
+    ref_filenames.push_back(flt_ext->get_ref_filename());
+  }
+
+  int num_children = flt_record->get_num_children();
+  for (int i = 0; i < num_children; i++) {
+    collect_ext_refs(flt_record->get_child(i), ref_filenames);
+  }
+
+  int num_subfaces = flt_record->get_num_subfaces();
+  for (int i = 0; i < num_subfaces; i++) {
+    collect_ext_refs(flt_record->get_subface(i), ref_filenames);
+  }
+}
+
 /**
  * Applies the state indicated in the FltGeometry record to the indicated
  * EggPrimitive and all of its indicated vertices, and then officially adds
@@ -837,3 +933,420 @@ make_egg_texture(const FltTexture *flt_texture) {
   parse_comment(flt_texture, egg_texture);
   return egg_texture;
 }
+
+/**
+ * Returns true if the indicated record and all of its children can be
+ * handled by convert_to_node(), or false if the file must be converted via
+ * the egg path instead.
+ */
+bool FltToEggConverter::
+can_convert_to_node(const FltRecord *flt_record) const {
+  if (flt_record->get_num_subfaces() != 0 ||
+      flt_record->is_of_type(FltExternalReference::get_class_type()) ||
+      has_egg_comment(flt_record)) {
+    return false;
+  }
+
+  if (flt_record->is_of_type(FltGroup::get_class_type())) {
+    const FltGroup *flt_group = DCAST(FltGroup, flt_record);
+    if ((flt_group->_flags & FltGroup::F_forward_animation) != 0) {
+      return false;
+    }
+  }
+
+  if (flt_record->is_of_type(FltFace::get_class_type())) {
+    const FltFace *flt_face = DCAST(FltFace, flt_record);
+    switch (flt_face->_draw_type) {
+    case FltGeometry::DT_omni_light:
+    case FltGeometry::DT_uni_light:
+    case FltGeometry::DT_bi_light:
+      return false;
+
+    default:
+      break;
+    }
+
+    if (flt_face->_billboard_type == FltGeometry::BT_axial ||
+        flt_face->_billboard_type == FltGeometry::BT_point) {
+      return false;
+    }
+
+    if (flt_face->has_transform() &&
+        !flt_face->get_transform().almost_equal(LMatrix4d::ident_mat())) {
+      // This would need a synthetic group.
+      return false;
+    }
+
+    if (flt_face->has_texture()) {
+      const FltTexture *flt_texture = flt_face->get_texture();
+      if (flt_texture->_env_type == FltTexture::ET_decal ||
+          has_egg_comment(flt_texture)) {
+        return false;
+      }
+    }
+  }
+
+  int num_children = flt_record->get_num_children();
+  for (int i = 0; i < num_children; i++) {
+    if (!can_convert_to_node(flt_record->get_child(i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns true if the record's comment contains "<egg>", which only the egg
+ * path knows how to interpret.
+ */
+bool FltToEggConverter::
+has_egg_comment(const FltRecord *flt_record) const {
+  const string &comment = flt_record->get_comment();
+  if (comment.length() < 5) {
+    return false;
+  }
+
+  static const string egg_str = "<egg>";
+  for (size_t p = 0; p + 5 <= comment.length(); ++p) {
+    if (cmp_nocase(comment.substr(p, 5), egg_str) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Converts all of the children of the indicated record into the indicated
+ * node.  Faces immediately below the record are collected into a single
+ * GeomNode.  This is the equivalent of convert_record() for
+ * convert_to_node().
+ */
+void FltToEggConverter::
+convert_node_level(const FltRecord *flt_record, PandaNode *node,
+                   const FltObject *flt_object) {
+  NodeLevel level;
+  level._node = node;
+  level._flt_object = flt_object;
+  level._builder.set_coordinate_system(CS_zup_right);
+
+  convert_node_children(flt_record, level);
+
+  if (!level._builder.is_empty()) {
+    PT(GeomNode) geom_node = new GeomNode(node->get_name());
+    level._builder.build(geom_node);
+    node->add_child(geom_node);
+  }
+}
+
+/**
+ * Converts the children of the record into the current level.
+ */
+void FltToEggConverter::
+convert_node_children(const FltRecord *flt_record, NodeLevel &level) {
+  int num_children = flt_record->get_num_children();
+
+  for (int i = 0; i < num_children; i++) {
+    const FltRecord *child = flt_record->get_child(i);
+    dispatch_node_record(child, level);
+  }
+}
+
+/**
+ * Determines what kind of record this is and converts it into the current
+ * level.  This is the equivalent of dispatch_record() for convert_to_node().
+ */
+void FltToEggConverter::
+dispatch_node_record(const FltRecord *flt_record, NodeLevel &level) {
+  if (flt_record->is_of_type(FltLOD::get_class_type())) {
+    convert_node_lod(DCAST(FltLOD, flt_record), level);
+
+  } else if (flt_record->is_of_type(FltFace::get_class_type())) {
+    convert_node_face(DCAST(FltFace, flt_record), level);
+
+  } else if (flt_record->is_of_type(FltBead::get_class_type())) {
+    // Groups, objects, and any other beads we don't know about simply
+    // become a PandaNode.
+    const FltBead *flt_bead = DCAST(FltBead, flt_record);
+    if (!flt_bead->is_of_type(FltGroup::get_class_type()) &&
+        !flt_bead->is_of_type(FltObject::get_class_type())) {
+      nout << "Don't know how to convert beads of type "
+           << flt_bead->get_type() << "\n";
+    }
+
+    PT(PandaNode) node = make_bead_node(flt_bead);
+    level._node->add_child(node);
+
+    const FltObject *flt_object = level._flt_object;
+    if (flt_bead->is_of_type(FltObject::get_class_type())) {
+      flt_object = DCAST(FltObject, flt_bead);
+    }
+    convert_node_level(flt_bead, node, flt_object);
+
+  } else {
+    convert_node_children(flt_record, level);
+  }
+}
+
+/**
+ * Converts the LOD bead and all of its children.  Sibling LOD beads that
+ * share a common center become the children of the same LODNode, as the
+ * EggBinner would arrange them.
+ */
+void FltToEggConverter::
+convert_node_lod(const FltLOD *flt_lod, NodeLevel &level) {
+  LPoint3d center(flt_lod->_center_x, flt_lod->_center_y, flt_lod->_center_z);
+
+  LODNode *lod_node;
+  NodeLevel::LODNodes::const_iterator li = level._lod_nodes.find(center);
+  if (li != level._lod_nodes.end()) {
+    lod_node = (*li).second;
+  } else {
+    PT(LODNode) new_node = LODNode::make_default_lod(flt_lod->get_id());
+    new_node->set_center(LCAST(PN_stdfloat, center));
+    level._node->add_child(new_node);
+    level._lod_nodes.insert(NodeLevel::LODNodes::value_type(center, new_node));
+    lod_node = new_node;
+  }
+
+  PT(PandaNode) node = make_bead_node(flt_lod);
+  lod_node->add_child(node);
+  lod_node->add_switch(flt_lod->_switch_in, flt_lod->_switch_out);
+
+  convert_node_level(flt_lod, node, level._flt_object);
+}
+
+/**
+ * Converts the face into the current level's NodeGeomBuilder, applying the
+ * same color, texture, and lighting rules as setup_geometry().
+ */
+void FltToEggConverter::
+convert_node_face(const FltFace *flt_face, NodeLevel &level) {
+  const FltVertexList *vlist = nullptr;
+  int num_children = flt_face->get_num_children();
+  for (int i = 0; i < num_children && vlist == nullptr; i++) {
+    const FltRecord *child = flt_face->get_child(i);
+    if (child->is_of_type(FltVertexList::get_class_type())) {
+      vlist = DCAST(FltVertexList, child);
+    }
+  }
+
+  if (vlist == nullptr || vlist->get_num_vertices() == 0) {
+    return;
+  }
+
+  bool use_vertex_color = true;
+  bool keep_normals = true;
+  switch (flt_face->_light_mode) {
+  case FltGeometry::LM_face_no_normal:
+    use_vertex_color = false;
+    keep_normals = false;
+    break;
+
+  case FltGeometry::LM_vertex_no_normal:
+    use_vertex_color = true;
+    keep_normals = false;
+    break;
+
+  case FltGeometry::LM_face_with_normal:
+    use_vertex_color = false;
+    keep_normals = true;
+    break;
+
+  case FltGeometry::LM_vertex_with_normal:
+    use_vertex_color = true;
+    keep_normals = true;
+    break;
+  }
+
+  LColor face_color = flt_face->get_color();
+
+  if (level._flt_object != nullptr) {
+    PN_stdfloat alpha = 1.0 - (level._flt_object->_transparency / 65535.0);
+    face_color[3] *= alpha;
+  }
+
+  CPT(RenderState) state = RenderState::make(ColorAttrib::make_vertex());
+  bool has_alpha = (face_color[3] != 1.0f);
+
+  if (flt_face->has_texture()) {
+    CPT(RenderAttrib) tex_attrib = make_node_texture(flt_face->get_texture());
+    if (tex_attrib != nullptr) {
+      state = state->add_attrib(tex_attrib);
+      Texture *tex = DCAST(TextureAttrib, tex_attrib)->get_texture();
+      has_alpha = has_alpha || Texture::has_alpha(tex->get_format());
+    }
+
+    if (flt_face->_texwhite) {
+      use_vertex_color = false;
+    }
+  }
+
+  if (has_alpha) {
+    state = state->add_attrib(TransparencyAttrib::make(TransparencyAttrib::M_alpha));
+  }
+
+  if (flt_face->_draw_type == FltGeometry::DT_solid_no_cull) {
+    state = state->add_attrib(CullFaceAttrib::make(CullFaceAttrib::M_cull_none));
+  }
+
+  int num_vertices = vlist->get_num_vertices();
+  pvector<NodeGeomBuilder::Vertex> vertices;
+  vertices.reserve(num_vertices);
+  for (int i = 0; i < num_vertices; i++) {
+    const FltVertex *flt_vertex = vlist->get_vertex(i);
+    NodeGeomBuilder::Vertex vertex(flt_vertex->_pos);
+
+    if (keep_normals && flt_vertex->_has_normal) {
+      vertex.set_normal(LCAST(double, flt_vertex->_normal));
+    }
+    if (flt_vertex->_has_uv) {
+      vertex.set_uv(LCAST(double, flt_vertex->_uv));
+    }
+
+    if (!use_vertex_color) {
+      vertex.set_color(face_color);
+
+    } else if (flt_vertex->has_color()) {
+      LColor vertex_color = flt_vertex->get_color();
+      vertex_color[3] = face_color[3];
+      vertex.set_color(vertex_color);
+
+    } else if (flt_face->has_color()) {
+      vertex.set_color(face_color);
+    }
+
+    vertices.push_back(vertex);
+  }
+
+  level._builder.add_polygon(state, &vertices[0], num_vertices);
+}
+
+/**
+ * Creates a PandaNode to represent the indicated bead, with its name and
+ * transform.
+ */
+PT(PandaNode) FltToEggConverter::
+make_bead_node(const FltBead *flt_bead) {
+  string name;
+  if (flt_bead->is_of_type(FltBeadID::get_class_type())) {
+    name = DCAST(FltBeadID, flt_bead)->get_id();
+  }
+
+  PT(PandaNode) node = new PandaNode(name);
+  if (flt_bead->has_transform()) {
+    node->set_transform(TransformState::make_mat
+                        (LCAST(PN_stdfloat, flt_bead->get_transform())));
+  }
+
+  return node;
+}
+
+/**
+ * Returns a TextureAttrib that applies the indicated FltTexture, or the one
+ * previously made for the same FltTexture.  The filter and wrap modes that
+ * make_egg_texture() would have applied are stored in the attrib's
+ * SamplerState, leaving the shared Texture from the TexturePool untouched.
+ * Returns NULL if the texture cannot be loaded.
+ */
+CPT(RenderAttrib) FltToEggConverter::
+make_node_texture(const FltTexture *flt_texture) {
+  NodeTextures::const_iterator ti;
+  ti = _node_textures.find(flt_texture);
+  if (ti != _node_textures.end()) {
+    return (*ti).second;
+  }
+
+  PT(Texture) tex = TexturePool::load_texture(flt_texture->get_texture_filename());
+  if (tex == nullptr) {
+    _node_textures.insert(NodeTextures::value_type(flt_texture, nullptr));
+    nout << "Unable to load " << flt_texture->get_texture_filename() << "\n";
+    _error = true;
+    return nullptr;
+  }
+
+  SamplerState sampler = tex->get_default_sampler();
+
+  switch (flt_texture->_min_filter) {
+  case FltTexture::MN_point:
+    sampler.set_minfilter(SamplerState::FT_nearest);
+    break;
+
+  case FltTexture::MN_bilinear:
+    sampler.set_minfilter(SamplerState::FT_linear);
+    break;
+
+  case FltTexture::MN_mipmap_point:
+    sampler.set_minfilter(SamplerState::FT_nearest_mipmap_nearest);
+    break;
+
+  case FltTexture::MN_mipmap_linear:
+    sampler.set_minfilter(SamplerState::FT_nearest_mipmap_linear);
+    break;
+
+  case FltTexture::MN_mipmap_bilinear:
+    sampler.set_minfilter(SamplerState::FT_linear_mipmap_nearest);
+    break;
+
+  case FltTexture::MN_mipmap_trilinear:
+  case FltTexture::MN_OB_mipmap:
+    sampler.set_minfilter(SamplerState::FT_linear_mipmap_linear);
+    break;
+
+  default:
+    // Not supported.
+    break;
+  }
+
+  switch (flt_texture->_mag_filter) {
+  case FltTexture::MG_point:
+    sampler.set_magfilter(SamplerState::FT_nearest);
+    break;
+
+  case FltTexture::MG_bilinear:
+    sampler.set_magfilter(SamplerState::FT_linear);
+    break;
+
+  default:
+    // Not supported.
+    break;
+  }
+
+  // The per-axis modes override the general one, as they do in egg.
+  switch (flt_texture->_repeat) {
+  case FltTexture::RT_repeat:
+    sampler.set_wrap_u(SamplerState::WM_repeat);
+    sampler.set_wrap_v(SamplerState::WM_repeat);
+    break;
+
+  case FltTexture::RT_clamp:
+    sampler.set_wrap_u(SamplerState::WM_clamp);
+    sampler.set_wrap_v(SamplerState::WM_clamp);
+    break;
+  }
+
+  switch (flt_texture->_repeat_u) {
+  case FltTexture::RT_repeat:
+    sampler.set_wrap_u(SamplerState::WM_repeat);
+    break;
+
+  case FltTexture::RT_clamp:
+    sampler.set_wrap_u(SamplerState::WM_clamp);
+    break;
+  }
+
+  switch (flt_texture->_repeat_v) {
+  case FltTexture::RT_repeat:
+    sampler.set_wrap_v(SamplerState::WM_repeat);
+    break;
+
+  case FltTexture::RT_clamp:
+    sampler.set_wrap_v(SamplerState::WM_clamp);
+    break;
+  }
+
+  CPT(RenderAttrib) attrib = DCAST(TextureAttrib, TextureAttrib::make())->
+    add_on_stage(TextureStage::get_default(), tex, sampler);
+  _node_textures.insert(NodeTextures::value_type(flt_texture, attrib));
+  return attrib;
+}
@@ -26,6 +26,11 @@
 #include "pt_EggVertex.h"
 #include "pointerTo.h"
 #include "distanceUnit.h"
+#include "nodeGeomBuilder.h"
+#include "pandaNode.h"
+#include "lodNode.h"
+#include "texture.h"
+#include "renderAttrib.h"
 
 class FltRecord;
 class FltLOD;
@@ -57,8 +62,10 @@ public:
   virtual std::string get_name() const;
   virtual std::string get_extension() const;
   virtual bool supports_compressed() const;
+  virtual bool supports_convert_to_node(const LoaderOptions &options) const;
 
   virtual bool convert_file(const Filename &filename);
+  virtual PT(PandaNode) convert_to_node(const LoaderOptions &options, const Filename &filename);
   virtual DistanceUnit get_input_units();
   bool convert_flt(const FltHeader *flt_header);
 
@@ -81,6 +88,8 @@ private:
   void convert_bead(const FltBead *flt_bead, FltToEggLevelState &state);
   void convert_face(const FltFace *flt_face, FltToEggLevelState &state);
   void convert_ext_ref(const FltExternalReference *flt_ext, FltToEggLevelState &state);
+  void collect_ext_refs(const FltRecord *flt_record,
+                        pvector<Filename> &ref_filenames);
 
   void setup_geometry(const FltGeometry *flt_geom, FltToEggLevelState &state,
                       EggPrimitive *egg_prim, EggVertexPool *egg_vpool,
@@ -97,6 +106,30 @@ private:
   PT_EggVertex make_egg_vertex(const FltVertex *flt_vertex);
   PT_EggTexture make_egg_texture(const FltTexture *flt_texture);
 
+  // The following are used by convert_to_node() in lieu of the above.
+  // Everything directly under one bead is collected into a NodeLevel, which
+  // accumulates its faces and its LOD siblings.
+  class NodeLevel {
+  public:
+    PandaNode *_node;
+    const FltObject *_flt_object;
+    NodeGeomBuilder _builder;
+
+    typedef pmap<LPoint3d, PT(LODNode) > LODNodes;
+    LODNodes _lod_nodes;
+  };
+
+  bool can_convert_to_node(const FltRecord *flt_record) const;
+  bool has_egg_comment(const FltRecord *flt_record) const;
+  void convert_node_level(const FltRecord *flt_record, PandaNode *node,
+                          const FltObject *flt_object);
+  void convert_node_children(const FltRecord *flt_record, NodeLevel &level);
+  void dispatch_node_record(const FltRecord *flt_record, NodeLevel &level);
+  void convert_node_lod(const FltLOD *flt_lod, NodeLevel &level);
+  void convert_node_face(const FltFace *flt_face, NodeLevel &level);
+  PT(PandaNode) make_bead_node(const FltBead *flt_bead);
+  CPT(RenderAttrib) make_node_texture(const FltTexture *flt_texture);
+
   CPT(FltHeader) _flt_header;
   DistanceUnit _flt_units;
 
@@ -104,6 +137,9 @@ private:
 
   typedef pmap<const FltTexture *, PT(EggTexture) > Textures;
   Textures _textures;
+
+  typedef pmap<const FltTexture *, CPT(RenderAttrib) > NodeTextures;
+  NodeTextures _node_textures;
 };
 
 #include "fltToEggConverter.I"
@@ -92,6 +92,10 @@ run() {
     _input_units = converter.get_input_units();
   }
 
+  if (converter.get_external_cache() != nullptr) {
+    converter.get_external_cache()->write(nout);
+  }
+
   write_egg_file();
   nout << "\n";
 }
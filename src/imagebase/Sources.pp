@@ -1,7 +1,7 @@
 #begin ss_lib_target
   #define TARGET imagebase
   #define LOCAL_LIBS \
-    progbase
+    progbase pandatoolbase
 
   #define OTHER_LIBS \
     pipeline:c event:c pstatclient:c panda:m \
@@ -13,13 +13,15 @@
 
   #define SOURCES \
     imageReader.h imageWriter.I imageWriter.h \
-    imageBase.h imageFilter.h
+    imageBase.h imageFilter.h imageResampler.I imageResampler.h
 
   #define COMPOSITE_SOURCES \
     imageBase.cxx imageFilter.cxx \
-    imageReader.cxx imageWriter.cxx
+    imageReader.cxx imageResampler.cxx imageWriter.cxx
 
   #define INSTALL_HEADERS \
-    imageBase.h imageFilter.h imageReader.h imageWriter.I imageWriter.h
+    imageBase.h imageFilter.h imageReader.h \
+    imageResampler.I imageResampler.h \
+    imageWriter.I imageWriter.h
 
 #end ss_lib_target
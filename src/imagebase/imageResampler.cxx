@@ -0,0 +1,232 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file imageResampler.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "imageResampler.h"
+#include "workerPool.h"
+#include "pnmImage.h"
+
+#include <math.h>
+#include <algorithm>
+
+// The number of output rows in each band.
+static const int band_rows = 32;
+
+/**
+ *
+ */
+ImageResampler::
+ImageResampler() {
+  _gaussian = false;
+  _radius = 1.0;
+  _num_threads = 0;
+}
+
+/**
+ * Fills dest, which should already have been initialized to the desired
+ * size, with a resized copy of source.  The two images should have the same
+ * number of channels and the same maxval.
+ */
+void ImageResampler::
+resample(PNMImage &dest, const PNMImage &source) const {
+  nassertv(dest.get_num_channels() == source.get_num_channels());
+  nassertv(dest.get_maxval() == source.get_maxval());
+
+  int x_size = dest.get_x_size();
+  int y_size = dest.get_y_size();
+  if (x_size == 0 || y_size == 0 ||
+      source.get_x_size() == 0 || source.get_y_size() == 0) {
+    return;
+  }
+
+  Axis x_axis, y_axis;
+  make_axis(x_axis, source.get_x_size(), x_size);
+  make_axis(y_axis, source.get_y_size(), y_size);
+
+  int num_bands = (y_size + band_rows - 1) / band_rows;
+  WorkerPool pool(_num_threads);
+  pool.run(num_bands, [&](int band) {
+    int y_begin = band * band_rows;
+    int y_end = std::min(y_begin + band_rows, y_size);
+    resample_band(dest, source, x_axis, y_axis, y_begin, y_end);
+  });
+}
+
+/**
+ * Computes the filter taps along one axis.
+ */
+void ImageResampler::
+make_axis(Axis &axis, int source_size, int dest_size) const {
+  axis._start.clear();
+  axis._index.clear();
+  axis._weight.clear();
+  axis._start.reserve(dest_size + 1);
+
+  if (_gaussian) {
+    make_gaussian_axis(axis, source_size, dest_size);
+  } else {
+    make_box_axis(axis, source_size, dest_size);
+  }
+  axis._start.push_back((int)axis._index.size());
+
+  // Normalize the weights of each output pixel to sum to 1.
+  for (int i = 0; i < dest_size; ++i) {
+    float sum = 0.0f;
+    for (int t = axis._start[i]; t < axis._start[i + 1]; ++t) {
+      sum += axis._weight[t];
+    }
+    if (sum > 0.0f) {
+      for (int t = axis._start[i]; t < axis._start[i + 1]; ++t) {
+        axis._weight[t] /= sum;
+      }
+    }
+  }
+}
+
+/**
+ * Computes the taps of the box filter: the area of each input pixel covered
+ * by the output pixel when shrinking, or linear interpolation when
+ * enlarging.
+ */
+void ImageResampler::
+make_box_axis(Axis &axis, int source_size, int dest_size) const {
+  double scale = (double)source_size / (double)dest_size;
+
+  for (int i = 0; i < dest_size; ++i) {
+    axis._start.push_back((int)axis._index.size());
+
+    if (dest_size < source_size) {
+      double a = i * scale;
+      double b = (i + 1) * scale;
+      int first = (int)floor(a);
+      int last = std::min((int)ceil(b), source_size);
+      for (int j = first; j < last; ++j) {
+        double coverage = std::min(b, (double)(j + 1)) - std::max(a, (double)j);
+        if (coverage > 0.0) {
+          axis._index.push_back(j);
+          axis._weight.push_back((float)coverage);
+        }
+      }
+
+    } else {
+      double center = (i + 0.5) * scale - 0.5;
+      int j = (int)floor(center);
+      double frac = center - j;
+      axis._index.push_back(std::max(j, 0));
+      axis._weight.push_back((float)(1.0 - frac));
+      axis._index.push_back(std::min(j + 1, source_size - 1));
+      axis._weight.push_back((float)frac);
+    }
+  }
+}
+
+/**
+ * Computes the taps of the Gaussian filter.  The radius is measured in output
+ * pixels, or in input pixels if that is larger, and spans two standard
+ * deviations.  Input pixels beyond the edges repeat the edge pixels.
+ */
+void ImageResampler::
+make_gaussian_axis(Axis &axis, int source_size, int dest_size) const {
+  double scale = (double)source_size / (double)dest_size;
+  double radius = _radius * std::max(scale, 1.0);
+  double sigma = std::max(radius * 0.5, 1.0e-6);
+  double k = -0.5 / (sigma * sigma);
+
+  for (int i = 0; i < dest_size; ++i) {
+    axis._start.push_back((int)axis._index.size());
+
+    double center = (i + 0.5) * scale - 0.5;
+    int first = (int)ceil(center - radius);
+    int last = (int)floor(center + radius);
+    if (first > last) {
+      // The filter is narrower than a pixel; take the nearest one.
+      first = last = (int)floor(center + 0.5);
+    }
+
+    for (int j = first; j <= last; ++j) {
+      double d = j - center;
+      axis._index.push_back(std::max(0, std::min(j, source_size - 1)));
+      axis._weight.push_back((float)exp(k * d * d));
+    }
+  }
+}
+
+/**
+ * Fills in rows y_begin through y_end - 1 of dest.
+ */
+void ImageResampler::
+resample_band(PNMImage &dest, const PNMImage &source,
+              const Axis &x_axis, const Axis &y_axis,
+              int y_begin, int y_end) const {
+  int num_channels = source.get_num_channels();
+  int source_x_size = source.get_x_size();
+  int x_size = dest.get_x_size();
+  int row_size = x_size * num_channels;
+
+  // Find the input rows this band needs.
+  int y0 = source.get_y_size();
+  int y1 = -1;
+  for (int t = y_axis._start[y_begin]; t < y_axis._start[y_end]; ++t) {
+    y0 = std::min(y0, y_axis._index[t]);
+    y1 = std::max(y1, y_axis._index[t]);
+  }
+  if (y1 < y0) {
+    return;
+  }
+
+  // Filter each of them along x.
+  pvector<float> source_row(source_x_size * num_channels);
+  pvector<float> rows((size_t)(y1 - y0 + 1) * row_size);
+  for (int sy = y0; sy <= y1; ++sy) {
+    for (int sx = 0; sx < source_x_size; ++sx) {
+      for (int c = 0; c < num_channels; ++c) {
+        source_row[sx * num_channels + c] = (float)source.get_channel_val(sx, sy, c);
+      }
+    }
+
+    float *row = &rows[(size_t)(sy - y0) * row_size];
+    for (int x = 0; x < x_size; ++x) {
+      float *out = row + x * num_channels;
+      for (int c = 0; c < num_channels; ++c) {
+        out[c] = 0.0f;
+      }
+      for (int t = x_axis._start[x]; t < x_axis._start[x + 1]; ++t) {
+        const float *in = &source_row[x_axis._index[t] * num_channels];
+        float w = x_axis._weight[t];
+        for (int c = 0; c < num_channels; ++c) {
+          out[c] += w * in[c];
+        }
+      }
+    }
+  }
+
+  // And then filter those rows along y, into the band.
+  float maxval = (float)source.get_maxval();
+  pvector<float> out_row(row_size);
+  for (int y = y_begin; y < y_end; ++y) {
+    std::fill(out_row.begin(), out_row.end(), 0.0f);
+    for (int t = y_axis._start[y]; t < y_axis._start[y + 1]; ++t) {
+      const float *in = &rows[(size_t)(y_axis._index[t] - y0) * row_size];
+      float w = y_axis._weight[t];
+      for (int i = 0; i < row_size; ++i) {
+        out_row[i] += w * in[i];
+      }
+    }
+
+    for (int x = 0; x < x_size; ++x) {
+      for (int c = 0; c < num_channels; ++c) {
+        float value = std::max(0.0f, std::min(out_row[x * num_channels + c], maxval));
+        dest.set_channel_val(x, y, c, (xelval)(value + 0.5f));
+      }
+    }
+  }
+}
@@ -0,0 +1,73 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file imageResampler.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef IMAGERESAMPLER_H
+#define IMAGERESAMPLER_H
+
+#include "pandatoolbase.h"
+#include "pvector.h"
+
+class PNMImage;
+
+/**
+ * Resizes an image with a separable filter, using several threads.
+ *
+ * The filter is applied first along each row, and then along each column.
+ * The output image is divided into bands of rows, and each thread filters
+ * one band at a time: it filters just the input rows that the band needs
+ * along x into a buffer of its own, and then filters the buffer along y into
+ * the band.  Thus the memory needed is proportional to the width of the
+ * image, not its area, and the output doesn't depend on the number of
+ * threads.
+ *
+ * The filter operates on the stored channel values, just as
+ * PNMImage::quick_filter_from() and gaussian_filter_from() do, but its
+ * output is not identical to theirs; image-resize only uses it with -r.
+ */
+class ImageResampler {
+public:
+  ImageResampler();
+
+  INLINE void set_box_filter();
+  INLINE void set_gaussian_filter(double radius);
+  INLINE void set_num_threads(int num_threads);
+
+  void resample(PNMImage &dest, const PNMImage &source) const;
+
+private:
+  // The taps of the filter along one axis: output pixel i is the weighted
+  // sum of the input pixels _index[_start[i]] through _index[_start[i + 1] -
+  // 1].
+  class Axis {
+  public:
+    pvector<int> _start;
+    pvector<int> _index;
+    pvector<float> _weight;
+  };
+
+  void make_axis(Axis &axis, int source_size, int dest_size) const;
+  void make_box_axis(Axis &axis, int source_size, int dest_size) const;
+  void make_gaussian_axis(Axis &axis, int source_size, int dest_size) const;
+
+  void resample_band(PNMImage &dest, const PNMImage &source,
+                     const Axis &x_axis, const Axis &y_axis,
+                     int y_begin, int y_end) const;
+
+  bool _gaussian;
+  double _radius;
+  int _num_threads;
+};
+
+#include "imageResampler.I"
+
+#endif
@@ -2,5 +2,6 @@
 #include "imageBase.cxx"
 #include "imageFilter.cxx"
 #include "imageReader.cxx"
+#include "imageResampler.cxx"
 #include "imageWriter.cxx"
 
@@ -1,5 +1,5 @@
 #define LOCAL_LIBS \
-  imagebase progbase
+  imagebase progbase pandatoolbase
 
 #define OTHER_LIBS \
     pipeline:c event:c pstatclient:c grutil:c \
@@ -61,6 +61,8 @@ private:
 
   bool _use_gaussian_filter;
   double _filter_radius;
+  bool _use_resampler;
+  int _num_threads;
 };
 
 #include "imageResize.I"
@@ -14,7 +14,12 @@
 #include "imageTransformColors.h"
 #include "string_utils.h"
 #include "pnmImage.h"
+#include "workerPool.h"
+#include "pmutex.h"
+#include "mutexHolder.h"
 #include <math.h>
+#include <sstream>
+#include <algorithm>
 
 using std::max;
 using std::min;
@@ -99,7 +104,17 @@ ImageTransformColors() {
      "input image files are lost.",
      &ImageTransformColors::dispatch_none, &_inplace);
 
+  add_option
+    ("j", "threads", 0,
+     "Process the images using the indicated number of threads.  If there "
+     "are several images, they are processed at the same time, one per "
+     "thread; a single image is divided among the threads.  The default is "
+     "taken from the pandatool-num-threads config variable.  The output is "
+     "the same regardless of the number of threads.",
+     &ImageTransformColors::dispatch_int, nullptr, &_num_threads);
+
   _mat = LMatrix4d::ident_mat();
+  _num_threads = 0;
 }
 
 /**
@@ -110,23 +125,33 @@ run() {
   _mat.write(nout, 0);
   nout << "\n";
 
-  Filenames::iterator fi;
-  for (fi = _filenames.begin(); fi != _filenames.end(); ++fi) {
-    const Filename &source_filename = (*fi);
-    nout << source_filename << "\n";
+  WorkerPool::prepare_image_threads();
+
+  WorkerPool pool(_filenames.size() > 1 ? _num_threads : 1);
+  int image_threads = (pool.get_num_threads() > 1) ? 1 : _num_threads;
+
+  Mutex lock;
+  pool.run((int)_filenames.size(), [&](int i) {
+    const Filename &source_filename = _filenames[i];
+    std::ostringstream out;
+    out << source_filename << "\n";
+
     PNMImage image;
     if (!image.read(source_filename)) {
-      nout << "Couldn't read " << source_filename << "; ignoring.\n";
-      continue;
-    }
+      out << "Couldn't read " << source_filename << "; ignoring.\n";
 
-    process_image(image);
+    } else {
+      process_image(image, image_threads);
 
-    Filename output_filename = get_output_filename(source_filename);
-    if (!image.write(output_filename)) {
-      nout << "Couldn't write " << output_filename << "; ignoring.\n";
+      Filename output_filename = get_output_filename(source_filename);
+      if (!image.write(output_filename)) {
+        out << "Couldn't write " << output_filename << "; ignoring.\n";
+      }
     }
-  }
+
+    MutexHolder holder(lock);
+    nout << out.str();
+  });
 }
 
 /**
@@ -450,25 +475,83 @@ rgb2hls(const LRGBColord &rgb) {
 }
 
 /**
- * Processes a single image in-place.
+ * Processes a single image in-place, using the indicated number of threads.
  */
 void ImageTransformColors::
-process_image(PNMImage &image) {
-  if (_hls) {
-    for (int yi = 0; yi < image.get_y_size(); ++yi) {
-      for (int xi = 0; xi < image.get_x_size(); ++xi) {
-        LRGBColord rgb = LCAST(double, image.get_xel(xi, yi));
-        rgb = hls2rgb(_mat.xform_point(rgb2hls(rgb)));
-        image.set_xel(xi, yi, LCAST(float, rgb));
+process_image(PNMImage &image, int num_threads) const {
+  // Each component is converted to floating point according to its value
+  // alone, so we do that with a table.  The table is built with the same
+  // from_val() that get_xel() uses, so the results are exactly the same.
+  int maxval = image.get_maxval();
+  pvector<LRGBColord> table(maxval + 1);
+  for (int v = 0; v <= maxval; ++v) {
+    xel col;
+    PPM_ASSIGN(col, v, v, v);
+    table[v] = LCAST(double, image.from_val(col));
+  }
+
+  static const int band_rows = 64;
+  int y_size = image.get_y_size();
+  int num_bands = (y_size + band_rows - 1) / band_rows;
+
+  WorkerPool pool(num_threads);
+  pool.run(num_bands, [&](int band) {
+    int y_begin = band * band_rows;
+    process_band(image, table, y_begin, std::min(y_begin + band_rows, y_size));
+  });
+}
+
+/**
+ * Processes rows y_begin through y_end - 1 of the image.  The arithmetic for
+ * each pixel is exactly that of get_xel(), the transform, and set_xel().
+ */
+void ImageTransformColors::
+process_band(PNMImage &image, const pvector<LRGBColord> &table,
+             int y_begin, int y_end) const {
+  // The result depends only on the color of the pixel, and most images have
+  // many pixels of the same color, so we remember the last result for each
+  // of a number of colors.
+  static const int cache_size = 4096;
+  class CacheEntry {
+  public:
+    xel _in;
+    xel _out;
+    bool _valid;
+  };
+  pvector<CacheEntry> cache(cache_size);
+  for (CacheEntry &entry : cache) {
+    entry._valid = false;
+  }
+
+  int x_size = image.get_x_size();
+  xel *array = image.get_array();
+  for (int yi = y_begin; yi < y_end; ++yi) {
+    xel *row = array + (size_t)yi * x_size;
+    for (int xi = 0; xi < x_size; ++xi) {
+      xel &col = row[xi];
+      uint32_t hash = ((uint32_t)PPM_GETR(col) * 0x9e3779b1u) ^
+        ((uint32_t)PPM_GETG(col) * 0x85ebca6bu) ^
+        ((uint32_t)PPM_GETB(col) * 0xc2b2ae35u);
+      CacheEntry &entry = cache[(hash >> 16) & (cache_size - 1)];
+      if (entry._valid && PPM_GETR(entry._in) == PPM_GETR(col) &&
+          PPM_GETG(entry._in) == PPM_GETG(col) &&
+          PPM_GETB(entry._in) == PPM_GETB(col)) {
+        col = entry._out;
+        continue;
       }
-    }
-  } else {
-    for (int yi = 0; yi < image.get_y_size(); ++yi) {
-      for (int xi = 0; xi < image.get_x_size(); ++xi) {
-        LRGBColord rgb = LCAST(double, image.get_xel(xi, yi));
+
+      LRGBColord rgb(table[PPM_GETR(col)][0], table[PPM_GETG(col)][1],
+                     table[PPM_GETB(col)][2]);
+      if (_hls) {
+        rgb = hls2rgb(_mat.xform_point(rgb2hls(rgb)));
+      } else {
         rgb = _mat.xform_point(rgb);
-        image.set_xel(xi, yi, LCAST(float, rgb));
       }
+
+      entry._in = col;
+      entry._out = image.to_val(LCAST(float, rgb));
+      entry._valid = true;
+      col = entry._out;
     }
   }
 }
@@ -42,11 +42,14 @@ protected:
   virtual bool handle_args(Args &args);
   Filename get_output_filename(const Filename &source_filename) const;
 
-  void process_image(PNMImage &image);
+  void process_image(PNMImage &image, int num_threads) const;
+  void process_band(PNMImage &image, const pvector<LRGBColord> &table,
+                    int y_begin, int y_end) const;
 
 private:
   bool _hls;
   LMatrix4d _mat;
+  int _num_threads;
 
   bool _got_output_filename;
   Filename _output_filename;
@@ -19,6 +19,9 @@
 
 TypeHandle IffInputFile::_type_handle;
 
+// The minimum number of bytes requested from the stream at a time.
+static const size_t iff_buffer_size = 65536;
+
 /**
  *
  */
@@ -29,6 +32,8 @@ IffInputFile() {
   _eof = true;
   _unexpected_eof = false;
   _bytes_read = 0;
+  _buffer_start = 0;
+  _buffer_end = 0;
 }
 
 /**
@@ -78,6 +83,8 @@ set_input(std::istream *input, bool owns_istream) {
   _eof = false;
   _unexpected_eof = false;
   _bytes_read = 0;
+  _buffer_start = 0;
+  _buffer_end = 0;
 }
 
 /**
@@ -85,12 +92,11 @@ set_input(std::istream *input, bool owns_istream) {
  */
 int8_t IffInputFile::
 get_int8() {
-  Datagram dg;
-  if (!read_bytes(dg, 1)) {
+  const unsigned char *data = get_view(1);
+  if (data == nullptr) {
     return 0;
   }
-  DatagramIterator dgi(dg);
-  return dgi.get_int8();
+  return (int8_t)data[0];
 }
 
 /**
@@ -98,12 +104,11 @@ get_int8() {
  */
 uint8_t IffInputFile::
 get_uint8() {
-  Datagram dg;
-  if (!read_bytes(dg, 1)) {
+  const unsigned char *data = get_view(1);
+  if (data == nullptr) {
     return 0;
   }
-  DatagramIterator dgi(dg);
-  return dgi.get_int8();
+  return data[0];
 }
 
 /**
@@ -111,12 +116,11 @@ get_uint8() {
  */
 int16_t IffInputFile::
 get_be_int16() {
-  Datagram dg;
-  if (!read_bytes(dg, 2)) {
+  const unsigned char *data = get_view(2);
+  if (data == nullptr) {
     return 0;
   }
-  DatagramIterator dgi(dg);
-  return dgi.get_be_int16();
+  return (int16_t)decode_be_uint16(data);
 }
 
 /**
@@ -124,12 +128,11 @@ get_be_int16() {
  */
 int32_t IffInputFile::
 get_be_int32() {
-  Datagram dg;
-  if (!read_bytes(dg, 4)) {
+  const unsigned char *data = get_view(4);
+  if (data == nullptr) {
     return 0;
   }
-  DatagramIterator dgi(dg);
-  return dgi.get_be_int32();
+  return (int32_t)decode_be_uint32(data);
 }
 
 /**
@@ -137,12 +140,11 @@ get_be_int32() {
  */
 uint16_t IffInputFile::
 get_be_uint16() {
-  Datagram dg;
-  if (!read_bytes(dg, 2)) {
+  const unsigned char *data = get_view(2);
+  if (data == nullptr) {
     return 0;
   }
-  DatagramIterator dgi(dg);
-  return dgi.get_be_uint16();
+  return decode_be_uint16(data);
 }
 
 /**
@@ -150,12 +152,11 @@ get_be_uint16() {
  */
 uint32_t IffInputFile::
 get_be_uint32() {
-  Datagram dg;
-  if (!read_bytes(dg, 4)) {
+  const unsigned char *data = get_view(4);
+  if (data == nullptr) {
     return 0;
   }
-  DatagramIterator dgi(dg);
-  return dgi.get_be_uint32();
+  return decode_be_uint32(data);
 }
 
 /**
@@ -163,12 +164,11 @@ get_be_uint32() {
  */
 PN_stdfloat IffInputFile::
 get_be_float32() {
-  Datagram dg;
-  if (!read_bytes(dg, 4)) {
+  const unsigned char *data = get_view(4);
+  if (data == nullptr) {
     return 0;
   }
-  DatagramIterator dgi(dg);
-  return dgi.get_be_float32();
+  return decode_be_float32(data);
 }
 
 /**
@@ -194,12 +194,11 @@ get_string() {
  */
 IffId IffInputFile::
 get_id() {
-  Datagram dg;
-  if (!read_bytes(dg, 4)) {
+  const unsigned char *data = get_view(4);
+  if (data == nullptr) {
     return IffId();
   }
-  const char *id = (const char *)dg.get_data();
-  return IffId(id);
+  return IffId((const char *)data);
 }
 
 /**
@@ -307,14 +306,12 @@ get_subchunk(IffChunk *context) {
  */
 bool IffInputFile::
 read_byte(char &byte) {
-  if (is_eof()) {
+  const unsigned char *data = get_view(1);
+  if (data == nullptr) {
     return false;
   }
-
-  _input->get(byte);
-  _bytes_read++;
-  _eof = _input->eof() || _input->fail();
-  return !is_eof();
+  byte = (char)data[0];
+  return true;
 }
 
 /**
@@ -323,40 +320,118 @@ read_byte(char &byte) {
  */
 bool IffInputFile::
 read_bytes(Datagram &datagram, int length) {
-  if (is_eof()) {
+  const unsigned char *data = get_view(length);
+  if (data == nullptr) {
     return false;
   }
-
-  char *buffer = new char[length];
-  _input->read(buffer, length);
-  _eof = (_input->gcount() != length);
-  if (is_eof()) {
-    return false;
-  }
-
-  _bytes_read += length;
-  datagram = Datagram(buffer, length);
-  delete[] buffer;
+  datagram = Datagram(data, length);
   return true;
 }
 
 /**
  * Reads a series of bytes, but does not store them.  Returns true if
  * successful, false otherwise.
+ *
+ * If the underlying stream supports seeking, the bytes are skipped over
+ * without being read at all.
  */
 bool IffInputFile::
 skip_bytes(int length) {
   if (is_eof()) {
     return false;
   }
+  if (length <= 0) {
+    return true;
+  }
 
-  char byte;
-  while (length > 0 && !is_eof()) {
-    read_byte(byte);
-    length--;
+  // First, consume whatever is already in the buffer.
+  size_t remaining = (size_t)length;
+  size_t buffered = std::min(remaining, _buffer_end - _buffer_start);
+  _buffer_start += buffered;
+  _bytes_read += buffered;
+  remaining -= buffered;
+  if (remaining == 0) {
+    return true;
   }
 
-  return !is_eof();
+  // The buffer is now empty.  Try to seek past the rest.
+  _buffer_start = 0;
+  _buffer_end = 0;
+  std::streampos pos = _input->tellg();
+  if (pos != std::streampos(-1)) {
+    _input->seekg(remaining, std::ios::cur);
+    if (!_input->fail()) {
+      // Make sure we didn't seek past the end of the file; we must be able to
+      // read the byte just before our new position.
+      _input->seekg(-1, std::ios::cur);
+      if (!_input->fail() && _input->get() != EOF) {
+        _bytes_read += remaining;
+        return true;
+      }
+    }
+    _input->clear();
+    _input->seekg(pos);
+  }
+
+  // The stream doesn't support seeking; read and discard the bytes instead.
+  _input->clear();
+  while (remaining > 0) {
+    size_t count = std::min(remaining, iff_buffer_size);
+    if (get_view(count) == nullptr) {
+      return false;
+    }
+    remaining -= count;
+  }
+
+  return true;
+}
+
+/**
+ * Reads the indicated number of bytes, and returns a pointer to them.  The
+ * pointer points into an internal buffer, and remains valid only until the
+ * next read operation on the file.  Returns NULL, and sets the eof flag, if
+ * the bytes could not all be read.
+ */
+const unsigned char *IffInputFile::
+get_view(size_t length) {
+  if (is_eof()) {
+    return nullptr;
+  }
+  if (length == 0) {
+    static const unsigned char empty = 0;
+    return &empty;
+  }
+
+  if (_buffer_end - _buffer_start < length) {
+    if (!fill_buffer(length)) {
+      _eof = true;
+      return nullptr;
+    }
+  }
+
+  const unsigned char *data = &_buffer[0] + _buffer_start;
+  _buffer_start += length;
+  _bytes_read += length;
+  return data;
+}
+
+/**
+ * Decodes a series of 32-bit big-endian floating-point numbers, such as
+ * returned by get_view(), into the indicated array.
+ */
+void IffInputFile::
+decode_be_float32_array(const unsigned char *data, PN_stdfloat *values,
+                        size_t count) {
+  // This is deliberately written as a simple loop without any dependencies
+  // between iterations, so that the compiler may vectorize it.
+  for (size_t i = 0; i < count; ++i) {
+    const unsigned char *p = data + i * 4;
+    uint32_t bits = (((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                     ((uint32_t)p[2] << 8) | (uint32_t)p[3]);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    values[i] = value;
+  }
 }
 
 /**
@@ -367,3 +442,45 @@ IffChunk *IffInputFile::
 make_new_chunk(IffId) {
   return new IffGenericChunk;
 }
+
+/**
+ * Reads more data from the stream, until at least the indicated number of
+ * unconsumed bytes are available in the buffer.  Returns true if successful,
+ * false if the end of the file is reached first.
+ */
+bool IffInputFile::
+fill_buffer(size_t length) {
+  // Shift the unconsumed bytes to the beginning of the buffer.
+  size_t available = _buffer_end - _buffer_start;
+  if (_buffer_start != 0) {
+    if (available != 0) {
+      memmove(&_buffer[0], &_buffer[0] + _buffer_start, available);
+    }
+    _buffer_start = 0;
+    _buffer_end = available;
+  }
+
+  size_t want = std::max(length, iff_buffer_size);
+  if (_buffer.size() < want) {
+    _buffer.resize(want);
+  }
+
+  while (_buffer_end < length) {
+    _input->read((char *)&_buffer[0] + _buffer_end,
+                 _buffer.size() - _buffer_end);
+    size_t count = (size_t)_input->gcount();
+    _buffer_end += count;
+    if (count == 0 || _input->eof() || _input->fail()) {
+      break;
+    }
+  }
+
+  // A short read at the end of the file leaves the stream in a failed state,
+  // which would prevent a later seek; clear it, since we keep track of the
+  // eof condition ourselves.
+  if (_input->eof()) {
+    _input->clear();
+  }
+
+  return _buffer_end >= length;
+}
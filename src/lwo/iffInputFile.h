@@ -21,11 +21,17 @@
 
 #include "typedObject.h"
 #include "pointerTo.h"
+#include "pvector.h"
 
 class Datagram;
 
 /**
  * A wrapper around an istream used for reading an IFF file.
+ *
+ * The file is read through an internal buffer, so that the many small reads
+ * made while parsing a chunk don't each go to the stream.  get_view() returns
+ * a pointer directly into this buffer, which allows a chunk reader to decode
+ * a large block of data (e.g.  the points of a PNTS chunk) in one pass.
  */
 class IffInputFile : public TypedObject {
 public:
@@ -62,6 +68,13 @@ public:
   bool read_byte(char &byte);
   bool read_bytes(Datagram &datagram, int length);
   bool skip_bytes(int length);
+  const unsigned char *get_view(size_t length);
+
+  INLINE static uint16_t decode_be_uint16(const unsigned char *data);
+  INLINE static uint32_t decode_be_uint32(const unsigned char *data);
+  INLINE static PN_stdfloat decode_be_float32(const unsigned char *data);
+  static void decode_be_float32_array(const unsigned char *data,
+                                      PN_stdfloat *values, size_t count);
 
 protected:
   virtual IffChunk *make_new_chunk(IffId id);
@@ -73,6 +86,15 @@ protected:
   bool _unexpected_eof;
   size_t _bytes_read;
 
+private:
+  bool fill_buffer(size_t length);
+
+  // The bytes between _buffer_start and _buffer_end have been read from the
+  // stream, but not yet consumed.
+  pvector<unsigned char> _buffer;
+  size_t _buffer_start;
+  size_t _buffer_end;
+
 public:
   virtual TypeHandle get_type() const {
     return get_class_type();
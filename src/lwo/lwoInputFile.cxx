@@ -71,6 +71,24 @@ get_vec3() {
   return result;
 }
 
+/**
+ * Reads all of the remaining bytes of the current chunk, up to the indicated
+ * stop_at position, and returns a pointer to them, suitable for decoding in
+ * memory.  length is filled in with the number of bytes.  The pointer remains
+ * valid only until the next read operation on the file.  Returns NULL on
+ * error.
+ */
+const unsigned char *LwoInputFile::
+get_chunk_view(size_t stop_at, size_t &length) {
+  size_t bytes_read = get_bytes_read();
+  if (stop_at < bytes_read) {
+    length = 0;
+    return nullptr;
+  }
+  length = stop_at - bytes_read;
+  return get_view(length);
+}
+
 /**
  * Reads a Lightwave platform-neutral filename and converts it to a Panda
  * platform-neutral filename.
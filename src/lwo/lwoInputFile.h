@@ -33,6 +33,9 @@ public:
 
   int get_vx();
   LVecBase3 get_vec3();
+  const unsigned char *get_chunk_view(size_t stop_at, size_t &length);
+  INLINE static bool decode_vx(const unsigned char *&data,
+                               const unsigned char *end, int &index);
   Filename get_filename();
 
 protected:
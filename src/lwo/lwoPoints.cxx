@@ -46,9 +46,25 @@ bool LwoPoints::
 read_iff(IffInputFile *in, size_t stop_at) {
   LwoInputFile *lin = DCAST(LwoInputFile, in);
 
-  while (lin->get_bytes_read() < stop_at && !lin->is_eof()) {
-    LPoint3 point = lin->get_vec3();
-    _points.push_back(point);
+  // Decode all of the points in one pass, rather than one float at a time.
+  size_t num_points = 0;
+  if (stop_at > lin->get_bytes_read()) {
+    num_points = (stop_at - lin->get_bytes_read()) / 12;
+  }
+  const unsigned char *data = lin->get_view(num_points * 12);
+  if (data == nullptr) {
+    return false;
+  }
+
+  pvector<PN_stdfloat> values(num_points * 3);
+  if (!values.empty()) {
+    IffInputFile::decode_be_float32_array(data, &values[0], values.size());
+  }
+
+  _points.reserve(_points.size() + num_points);
+  for (size_t i = 0; i < num_points; ++i) {
+    _points.push_back(LPoint3(values[i * 3], values[i * 3 + 1],
+                              values[i * 3 + 2]));
   }
 
   return (lin->get_bytes_read() == stop_at);
@@ -52,16 +52,32 @@ read_iff(IffInputFile *in, size_t stop_at) {
 
     _polygon_type = lin->get_id();
 
-    while (lin->get_bytes_read() < stop_at && !lin->is_eof()) {
-      int nf = lin->get_be_uint16();
+    // Read the rest of the chunk at once, and decode it in memory.
+    size_t length;
+    const unsigned char *data = lin->get_chunk_view(stop_at, length);
+    if (data == nullptr) {
+      return false;
+    }
+    const unsigned char *end = data + length;
+
+    while (data < end) {
+      if (end - data < 2) {
+        return false;
+      }
+      int nf = IffInputFile::decode_be_uint16(data);
+      data += 2;
       int num_vertices = nf & PF_numverts_mask;
 
       PT(Polygon) poly = new Polygon;
       poly->_flags = nf & ~PF_numverts_mask;
       poly->_surface_index = -1;
+      poly->_vertices.reserve(num_vertices);
 
       for (int i = 0; i < num_vertices; i++) {
-        int vindex = lin->get_vx();
+        int vindex;
+        if (!LwoInputFile::decode_vx(data, end, vindex)) {
+          return false;
+        }
         poly->_vertices.push_back(vindex);
       }
 
@@ -58,13 +58,27 @@ read_iff(IffInputFile *in, size_t stop_at) {
   _dimension = lin->get_be_uint16();
   _name = lin->get_string();
 
-  while (lin->get_bytes_read() < stop_at && !lin->is_eof()) {
-    int index = lin->get_vx();
+  // Read the rest of the chunk at once, and decode it in memory.
+  size_t length;
+  const unsigned char *data = lin->get_chunk_view(stop_at, length);
+  if (data == nullptr) {
+    return false;
+  }
+  const unsigned char *end = data + length;
+  size_t value_size = (size_t)_dimension * 4;
+
+  while (data < end) {
+    int index;
+    if (!LwoInputFile::decode_vx(data, end, index) ||
+        (size_t)(end - data) < value_size) {
+      return false;
+    }
 
-    PTA_stdfloat value;
-    for (int i = 0; i < _dimension; i++) {
-      value.push_back(lin->get_be_float32());
+    PTA_stdfloat value = PTA_stdfloat::empty_array(_dimension);
+    if (_dimension != 0) {
+      IffInputFile::decode_be_float32_array(data, &value[0], _dimension);
     }
+    data += value_size;
 
     bool inserted = _vmap.insert(VMap::value_type(index, value)).second;
     if (!inserted) {
@@ -72,7 +86,7 @@ read_iff(IffInputFile *in, size_t stop_at) {
     }
   }
 
-  return (lin->get_bytes_read() == stop_at);
+  return true;
 }
 
 /**
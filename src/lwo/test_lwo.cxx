@@ -14,6 +14,8 @@
 #include "lwoInputFile.h"
 #include "lwoChunk.h"
 #include "config_lwo.h"
+#include "trueClock.h"
+#include "pvector.h"
 
 int
 main(int argc, char *argv[]) {
@@ -29,14 +31,38 @@ main(int argc, char *argv[]) {
     exit(1);
   }
 
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  // Parse the whole file before writing any of it, so that the time measured
+  // is that of the reader alone.
+  pvector<PT(IffChunk) > chunks;
   PT(IffChunk) chunk = in.get_chunk();
   while (chunk != nullptr) {
+    chunks.push_back(chunk);
+    chunk = in.get_chunk();
+  }
+
+  double parse_elapsed = clock->get_short_time() - start;
+  start = clock->get_short_time();
+
+  for (IffChunk *chunk : chunks) {
     nout << "Got chunk type " << chunk->get_type() << ":\n";
     chunk->write(nout, 2);
-    chunk = in.get_chunk();
   }
 
+  double write_elapsed = clock->get_short_time() - start;
   nout << "EOF = " << in.is_eof() << "\n";
 
+  // Report the parse throughput, which is useful when profiling the reader.
+  size_t bytes_read = in.get_bytes_read();
+  nout << "Parsed " << bytes_read << " bytes in " << parse_elapsed
+       << " seconds";
+  if (parse_elapsed > 0.0) {
+    nout << " (" << (bytes_read / parse_elapsed) / (1024.0 * 1024.0)
+         << " MB/s)";
+  }
+  nout << "; wrote the chunks in " << write_elapsed << " seconds\n";
+
   return (0);
 }
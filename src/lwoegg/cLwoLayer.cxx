@@ -15,6 +15,7 @@
 #include "lwoToEggConverter.h"
 
 #include "eggData.h"
+#include "transformState.h"
 
 
 /**
@@ -50,3 +51,43 @@ connect_egg() {
 
   _converter->get_egg_data()->add_child(_egg_group.p());
 }
+
+/**
+ * Creates the GeomNode associated with this Lightwave layer, when converting
+ * directly to a PandaNode.  The geometry is filled in later by connect_node().
+ */
+void CLwoLayer::
+make_node() {
+  _geom_node = new GeomNode(_layer->_name);
+
+  if (_layer->_pivot != LPoint3::zero()) {
+    // If we have a nonzero pivot point, that's a translation transform.  It
+    // must be converted to Panda's coordinate system, as the vertices will
+    // be.
+    LMatrix4 cs_mat = LMatrix4::convert_mat(CS_yup_left, CS_default);
+    LPoint3 translate = cs_mat.xform_point(_layer->_pivot);
+    _geom_node->set_transform(TransformState::make_pos(translate));
+  }
+}
+
+/**
+ * Builds the accumulated polygons into the GeomNode, and parents it to its
+ * parent layer or to the converter's root node.
+ */
+void CLwoLayer::
+connect_node() {
+  _builder.build(_geom_node);
+
+  if (_layer->_parent != -1) {
+    const CLwoLayer *parent = _converter->get_layer(_layer->_parent);
+    if (parent != nullptr) {
+      parent->_geom_node->add_child(_geom_node);
+      return;
+    }
+
+    nout << "No layer found with number " << _layer->_parent
+         << "; cannot parent layer " << _layer->_number << " properly.\n";
+  }
+
+  _converter->get_root_node()->add_child(_geom_node);
+}
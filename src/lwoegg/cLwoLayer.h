@@ -19,6 +19,8 @@
 #include "lwoLayer.h"
 #include "eggGroup.h"
 #include "pointerTo.h"
+#include "geomNode.h"
+#include "nodeGeomBuilder.h"
 
 class LwoToEggConverter;
 
@@ -34,9 +36,16 @@ public:
   void make_egg();
   void connect_egg();
 
+  void make_node();
+  void connect_node();
+
   LwoToEggConverter *_converter;
   CPT(LwoLayer) _layer;
   PT(EggGroup) _egg_group;
+
+  // These are used instead when converting directly to a PandaNode.
+  PT(GeomNode) _geom_node;
+  NodeGeomBuilder _builder;
 };
 
 #include "cLwoLayer.I"
@@ -24,6 +24,7 @@
 #include "eggPolygon.h"
 #include "eggPoint.h"
 #include "deg_2_rad.h"
+#include "nodeGeomBuilder.h"
 
 using std::string;
 
@@ -190,6 +191,25 @@ connect_egg() {
 }
 
 
+/**
+ * Adds the polygons to the NodeGeomBuilder of the associated layer, when
+ * converting directly to a PandaNode.  This is the equivalent of make_egg()
+ * and connect_egg().
+ */
+void CLwoPolygons::
+make_node() {
+  if (_polygons->_polygon_type == IffId("PTCH")) {
+    nout << "Treating subdivision patches as ordinary polygons.\n";
+    make_node_faces();
+
+  } else if (_polygons->_polygon_type == IffId("FACE")) {
+    make_node_faces();
+
+  } else {
+    nout << "Ignoring geometry type " << _polygons->_polygon_type << ".\n";
+  }
+}
+
 /**
  * Generates "face" polygons, i.e.  actual polygons.
  */
@@ -282,3 +302,92 @@ make_faces() {
     _egg_group->recompute_polygon_normals(cs);
   }
 }
+
+/**
+ * The PandaNode equivalent of make_faces().  Single-vertex polygons (points)
+ * are not supported by this path, and are ignored.
+ */
+void CLwoPolygons::
+make_node_faces() {
+  PN_stdfloat smooth_angle = -1.0;
+
+  const LwoPoints *points = _points->_points;
+  int num_points = points->get_num_points();
+
+  // We can't know the smoothing angle until we have seen all of the
+  // surfaces, so we hold the polygons here before passing them on to the
+  // builder.
+  class NodePolygon {
+  public:
+    CPT(RenderState) _state;
+    size_t _first_vertex;
+    size_t _num_vertices;
+  };
+  pvector<NodePolygon> node_polygons;
+  pvector<NodeGeomBuilder::Vertex> all_vertices;
+  pvector<NodeGeomBuilder::Vertex> vertices;
+
+  int num_polygons = _polygons->get_num_polygons();
+  node_polygons.reserve(num_polygons);
+  for (int pindex = 0; pindex < num_polygons; pindex++) {
+    LwoPolygons::Polygon *poly = _polygons->get_polygon(pindex);
+    CLwoSurface *surface = get_surface(pindex);
+
+    int num_vertices = poly->_vertices.size();
+    if (num_vertices < 3) {
+      continue;
+    }
+
+    bool is_valid = true;
+    vertices.clear();
+
+    // As in make_faces(), we reverse the vertex ordering to compensate for
+    // Lightwave's clockwise ordering convention.
+    for (int vi = num_vertices; vi > 0; vi--) {
+      int vindex = poly->_vertices[vi % num_vertices];
+      if (vindex < 0 || vindex >= num_points) {
+        nout << "Invalid vertex index " << vindex << " in polygon.\n";
+        is_valid = false;
+      } else {
+        NodeGeomBuilder::Vertex vertex(LCAST(double, points->get_point(vindex)));
+
+        if (surface != nullptr && surface->has_named_uvs()) {
+          string uv_name = surface->get_uv_name();
+          LPoint2 uv;
+          if (get_uv(uv_name, pindex, vindex, uv) ||
+              _points->get_uv(uv_name, vindex, uv)) {
+            vertex.set_uv(LCAST(double, uv));
+          }
+        }
+
+        vertices.push_back(vertex);
+      }
+    }
+
+    if (is_valid) {
+      CPT(RenderState) state = RenderState::make_empty();
+      if (surface != nullptr) {
+        surface->apply_node_properties(state, vertices, smooth_angle);
+      }
+
+      NodePolygon node_poly;
+      node_poly._state = state;
+      node_poly._first_vertex = all_vertices.size();
+      node_poly._num_vertices = vertices.size();
+      node_polygons.push_back(node_poly);
+      all_vertices.insert(all_vertices.end(), vertices.begin(), vertices.end());
+    }
+  }
+
+  double smooth_degrees = 0.0;
+  if (smooth_angle > 0.0) {
+    smooth_degrees = rad_2_deg(smooth_angle);
+  }
+
+  NodeGeomBuilder &builder = _points->_layer->_builder;
+  pvector<NodePolygon>::const_iterator pi;
+  for (pi = node_polygons.begin(); pi != node_polygons.end(); ++pi) {
+    builder.add_polygon((*pi)._state, &all_vertices[(*pi)._first_vertex],
+                        (int)(*pi)._num_vertices, smooth_degrees);
+  }
+}
@@ -47,6 +47,7 @@ public:
 
   void make_egg();
   void connect_egg();
+  void make_node();
 
   LwoToEggConverter *_converter;
   CPT(LwoPolygons) _polygons;
@@ -66,6 +67,7 @@ public:
 
 private:
   void make_faces();
+  void make_node_faces();
 };
 
 #include "cLwoPolygons.I"
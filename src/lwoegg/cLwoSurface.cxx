@@ -25,6 +25,14 @@
 #include "string_utils.h"
 #include "mathNumbers.h"
 #include "dcast.h"
+#include "texturePool.h"
+#include "textureAttrib.h"
+#include "material.h"
+#include "materialPool.h"
+#include "materialAttrib.h"
+#include "colorAttrib.h"
+#include "cullFaceAttrib.h"
+#include "transparencyAttrib.h"
 
 
 /**
@@ -39,6 +47,7 @@ CLwoSurface(LwoToEggConverter *converter, const LwoSurface *surface) :
   _rgb.set(1.0, 1.0, 1.0);
   _checked_material = false;
   _checked_texture = false;
+  _made_node_state = false;
   _map_uvs = nullptr;
   _block = nullptr;
 
@@ -192,6 +201,37 @@ apply_properties(EggPrimitive *egg_prim, vector_PT_EggVertex &egg_vertices,
   }
 }
 
+/**
+ * The PandaNode equivalent of apply_properties(): composes the render state
+ * described by the surface onto the indicated state, and generates UV's for
+ * the vertices if needed.
+ */
+void CLwoSurface::
+apply_node_properties(CPT(RenderState) &state,
+                      pvector<NodeGeomBuilder::Vertex> &vertices,
+                      PN_stdfloat &smooth_angle) {
+  if (!_surface->_source.empty()) {
+    // This surface is derived from another surface; apply that one first.
+    CLwoSurface *parent = _converter->get_surface(_surface->_source);
+    if (parent != nullptr && parent != this) {
+      parent->apply_node_properties(state, vertices, smooth_angle);
+    }
+  }
+
+  if (!_made_node_state) {
+    make_node_state();
+  }
+  state = state->compose(_node_state);
+
+  if (_egg_texture != nullptr) {
+    generate_uvs(vertices);
+  }
+
+  if ((_flags & F_smooth_angle) != 0) {
+    smooth_angle = std::max(smooth_angle, _smooth_angle);
+  }
+}
+
 /**
  * Checks whether the surface demands a texture or not.  Returns true if so,
  * false otherwise.
@@ -361,6 +401,80 @@ generate_uvs(vector_PT_EggVertex &egg_vertices) {
   }
 }
 
+/**
+ * The PandaNode equivalent of the above.
+ */
+void CLwoSurface::
+generate_uvs(pvector<NodeGeomBuilder::Vertex> &vertices) {
+  if (_map_uvs == nullptr || vertices.empty()) {
+    return;
+  }
+
+  LPoint3d centroid(0.0, 0.0, 0.0);
+
+  pvector<NodeGeomBuilder::Vertex>::iterator vi;
+  for (vi = vertices.begin(); vi != vertices.end(); ++vi) {
+    centroid += (*vi)._pos;
+  }
+
+  centroid /= (double)vertices.size();
+  centroid = centroid * _block->_inv_transform;
+
+  for (vi = vertices.begin(); vi != vertices.end(); ++vi) {
+    LPoint3d pos = (*vi)._pos * _block->_inv_transform;
+    (*vi).set_uv((this->*_map_uvs)(pos, centroid));
+  }
+}
+
+/**
+ * Computes the RenderState that corresponds to the color, texture, and
+ * material that apply_properties() would have assigned to an egg primitive.
+ */
+void CLwoSurface::
+make_node_state() {
+  _made_node_state = true;
+
+  bool has_texture = check_texture();
+  bool has_material = check_material();
+
+  CPT(RenderState) state = RenderState::make(ColorAttrib::make_flat(_diffuse_color));
+  bool has_alpha = (_diffuse_color[3] < 1.0f);
+
+  if (has_material) {
+    PT(Material) material = new Material(_egg_material->get_name());
+    if (_egg_material->has_emit()) {
+      material->set_emission(_egg_material->get_emit());
+    }
+    if (_egg_material->has_spec()) {
+      material->set_specular(_egg_material->get_spec());
+    }
+    if (_egg_material->has_shininess()) {
+      material->set_shininess(_egg_material->get_shininess());
+    }
+    state = state->add_attrib(MaterialAttrib::make(MaterialPool::get_material(material)));
+  }
+
+  if (has_texture) {
+    Texture *tex = TexturePool::load_texture(_egg_texture->get_filename());
+    if (tex != nullptr) {
+      state = state->add_attrib(TextureAttrib::make(tex));
+      if (Texture::has_alpha(tex->get_format())) {
+        has_alpha = true;
+      }
+    }
+  }
+
+  if (has_alpha) {
+    state = state->add_attrib(TransparencyAttrib::make(TransparencyAttrib::M_alpha));
+  }
+
+  if ((_flags & F_backface) != 0 && _backface) {
+    state = state->add_attrib(CullFaceAttrib::make(CullFaceAttrib::M_cull_none));
+  }
+
+  _node_state = state;
+}
+
 /**
  * Computes a UV based on the given point in space, using a planar projection.
  */
@@ -25,6 +25,8 @@
 #include "pt_EggTexture.h"
 #include "pt_EggMaterial.h"
 #include "vector_PT_EggVertex.h"
+#include "nodeGeomBuilder.h"
+#include "renderState.h"
 
 #include "pmap.h"
 
@@ -46,6 +48,9 @@ public:
   void apply_properties(EggPrimitive *egg_prim,
                         vector_PT_EggVertex &egg_vertices,
                         PN_stdfloat &smooth_angle);
+  void apply_node_properties(CPT(RenderState) &state,
+                             pvector<NodeGeomBuilder::Vertex> &vertices,
+                             PN_stdfloat &smooth_angle);
   bool check_texture();
   bool check_material();
 
@@ -92,8 +97,13 @@ public:
 
   CLwoSurfaceBlock *_block;
 
+  bool _made_node_state;
+  CPT(RenderState) _node_state;
+
 private:
   void generate_uvs(vector_PT_EggVertex &egg_vertices);
+  void generate_uvs(pvector<NodeGeomBuilder::Vertex> &vertices);
+  void make_node_state();
 
   LPoint2d map_planar(const LPoint3d &pos, const LPoint3d &centroid) const;
   LPoint2d map_spherical(const LPoint3d &pos, const LPoint3d &centroid) const;
@@ -101,34 +101,54 @@ supports_compressed() const {
  */
 bool LwoToEggConverter::
 convert_file(const Filename &filename) {
-  LwoInputFile in;
-
-  nout << "Reading " << filename << "\n";
-  if (!in.open_read(filename)) {
-    nout << "Unable to open " << filename << "\n";
+  PT(LwoHeader) header = read_lwo(filename);
+  if (header == nullptr) {
     return false;
   }
 
-  PT(IffChunk) chunk = in.get_chunk();
-  if (chunk == nullptr) {
-    nout << "Unable to read " << filename << "\n";
-    return false;
-  }
+  return convert_lwo(header);
+}
 
-  if (!chunk->is_of_type(LwoHeader::get_class_type())) {
-    nout << "File " << filename << " is not a Lightwave Object file.\n";
-    return false;
-  }
+/**
+ * Returns true if this converter can directly convert the model type to
+ * internal Panda memory structures, given the indicated options, or false
+ * otherwise.  If this returns true, then convert_to_node() may be called to
+ * perform the conversion, which may be faster than calling convert_file() if
+ * the ultimate goal is a PandaNode anyway.
+ */
+bool LwoToEggConverter::
+supports_convert_to_node(const LoaderOptions &options) const {
+  return true;
+}
 
-  LwoHeader *header = DCAST(LwoHeader, chunk);
-  if (!header->is_valid()) {
-    nout << "File " << filename
-         << " is not recognized as a Lightwave Object file.  "
-         << "Perhaps the version is too recent.\n";
-    return false;
+/**
+ * Reads the input file and directly produces a ready-to-render model file as
+ * a PandaNode.  Returns NULL on failure, or if it is not supported.  (This
+ * functionality is not supported by all converter types; see
+ * supports_convert_to_node()).
+ */
+PT(PandaNode) LwoToEggConverter::
+convert_to_node(const LoaderOptions &options, const Filename &filename) {
+  PT(LwoHeader) header = read_lwo(filename);
+  if (header == nullptr) {
+    return nullptr;
   }
 
-  return convert_lwo(header);
+  _error = false;
+  _lwo_header = header;
+  _root_node = new PandaNode("");
+
+  collect_lwo();
+  make_node();
+
+  PT(PandaNode) result = _root_node;
+  _root_node = nullptr;
+  cleanup();
+
+  if (had_error()) {
+    return nullptr;
+  }
+  return result;
 }
 
 /**
@@ -191,6 +211,42 @@ get_surface(const std::string &name) const {
   return nullptr;
 }
 
+/**
+ * Opens and reads the indicated Lightwave file, and returns its header chunk,
+ * or NULL if the file could not be read.
+ */
+PT(LwoHeader) LwoToEggConverter::
+read_lwo(const Filename &filename) {
+  LwoInputFile in;
+
+  nout << "Reading " << filename << "\n";
+  if (!in.open_read(filename)) {
+    nout << "Unable to open " << filename << "\n";
+    return nullptr;
+  }
+
+  PT(IffChunk) chunk = in.get_chunk();
+  if (chunk == nullptr) {
+    nout << "Unable to read " << filename << "\n";
+    return nullptr;
+  }
+
+  if (!chunk->is_of_type(LwoHeader::get_class_type())) {
+    nout << "File " << filename << " is not a Lightwave Object file.\n";
+    return nullptr;
+  }
+
+  LwoHeader *header = DCAST(LwoHeader, chunk);
+  if (!header->is_valid()) {
+    nout << "File " << filename
+         << " is not recognized as a Lightwave Object file.  "
+         << "Perhaps the version is too recent.\n";
+    return nullptr;
+  }
+
+  return header;
+}
+
 /**
  * Frees all the internal data structures after we're done converting, and
  * resets the converter to its initial state.
@@ -399,6 +455,43 @@ connect_egg() {
   }
 }
 
+/**
+ * Creates the GeomNodes for all of the layers and adds the polygons to them,
+ * when converting directly to a PandaNode.  This takes the place of
+ * make_egg() and connect_egg().
+ */
+void LwoToEggConverter::
+make_node() {
+  if (_generic_layer != nullptr) {
+    _generic_layer->make_node();
+  }
+
+  Layers::iterator li;
+  for (li = _layers.begin(); li != _layers.end(); ++li) {
+    CLwoLayer *layer = (*li);
+    if (layer != nullptr) {
+      layer->make_node();
+    }
+  }
+
+  Polygons::iterator gi;
+  for (gi = _polygons.begin(); gi != _polygons.end(); ++gi) {
+    CLwoPolygons *polygons = (*gi);
+    polygons->make_node();
+  }
+
+  if (_generic_layer != nullptr) {
+    _generic_layer->connect_node();
+  }
+
+  for (li = _layers.begin(); li != _layers.end(); ++li) {
+    CLwoLayer *layer = (*li);
+    if (layer != nullptr) {
+      layer->connect_node();
+    }
+  }
+}
+
 /**
  * Ensures that there is space in the _layers array to store an element at
  * position number.
@@ -19,6 +19,7 @@
 #include "somethingToEggConverter.h"
 #include "lwoHeader.h"
 #include "pointerTo.h"
+#include "pandaNode.h"
 
 #include "pvector.h"
 #include "pmap.h"
@@ -49,20 +50,25 @@ public:
   virtual bool convert_file(const Filename &filename);
   bool convert_lwo(const LwoHeader *lwo_header);
   virtual bool supports_compressed() const;
+  virtual bool supports_convert_to_node(const LoaderOptions &options) const;
+  virtual PT(PandaNode) convert_to_node(const LoaderOptions &options, const Filename &filename);
 
   CLwoLayer *get_layer(int number) const;
   CLwoClip *get_clip(int number) const;
 
   CLwoSurface *get_surface(const std::string &name) const;
+  INLINE PandaNode *get_root_node() const;
 
   bool _make_materials;
 
 private:
+  PT(LwoHeader) read_lwo(const Filename &filename);
   void cleanup();
 
   void collect_lwo();
   void make_egg();
   void connect_egg();
+  void make_node();
 
   void slot_layer(int number);
   void slot_clip(int number);
@@ -70,6 +76,9 @@ private:
 
   CPT(LwoHeader) _lwo_header;
 
+  // Filled when creating a PandaNode directly.
+  PT(PandaNode) _root_node;
+
   CLwoLayer *_generic_layer;
   typedef pvector<CLwoLayer *> Layers;
   Layers _layers;
@@ -135,6 +135,15 @@ convert_to_node(const LoaderOptions &options, const Filename &filename) {
 
   _current_vertex_data->close_geom(this);
   delete _current_vertex_data;
+  _current_vertex_data = nullptr;
+
+  if (objegg_cat.is_debug()) {
+    objegg_cat.debug()
+      << "Synthesized normal table: ";
+    _unique_synth_vn_table.write_stats(objegg_cat.debug(false));
+    objegg_cat.debug(false)
+      << "\n";
+  }
 
   if (had_error()) {
     return nullptr;
@@ -801,9 +810,8 @@ generate_points() {
  */
 int ObjToEggConverter::
 add_synth_normal(const LVecBase3d &normal) {
-  std::pair<UniqueVec3Table::iterator, bool> result = _unique_synth_vn_table.insert(UniqueVec3Table::value_type(normal, _unique_synth_vn_table.size()));
-  UniqueVec3Table::iterator ni = result.first;
-  int index = (*ni).second;
+  std::pair<int, bool> result = _unique_synth_vn_table.insert(normal, (int)_synth_vn_table.size());
+  int index = result.first;
 
   if (result.second) {
     // If the normal was added to the table, it's a unique normal, and now we
@@ -896,9 +904,9 @@ VertexData(PandaNode *parent, const string &name) :
  * returns an equivalent vertex already present.
  */
 int ObjToEggConverter::VertexData::
-add_vertex(const ObjToEggConverter *converter, const VertexEntry &entry) {
-  std::pair<UniqueVertexEntries::iterator, bool> result;
-  UniqueVertexEntries::iterator ni;
+add_vertex(ObjToEggConverter *converter, const VertexEntry &entry) {
+  UniqueVertexEntries &unique_entries = converter->_unique_entries;
+  UniqueVertexPositions &unique_positions = converter->_unique_positions;
   int index;
 
   if (entry._vni != 0 || entry._synth_vni != 0) {
@@ -907,14 +915,14 @@ add_vertex(const ObjToEggConverter *converter, const VertexEntry &entry) {
     VertexEntry no_normal(entry);
     no_normal._vni = 0;
     no_normal._synth_vni = 0;
-    ni = _unique_entries.find(no_normal);
-    if (ni != _unique_entries.end()) {
+    index = unique_entries.find(no_normal);
+    if (index >= 0) {
       // We did have such a vertex!  In this case, repurpose this vertex,
-      // resetting it to contain this normal.
-      index = (*ni).second;
-      _unique_entries.erase(ni);
-      result = _unique_entries.insert(UniqueVertexEntries::value_type(entry, index));
-      nassertr(result.second, index);
+      // resetting it to contain this normal.  It remains the only vertex at
+      // this position, so _unique_positions needn't change.
+      unique_entries.remove(no_normal);
+      bool inserted = unique_entries.insert(entry, index).second;
+      nassertr(inserted, index);
       nassertr(_entries[index] == no_normal, index);
       _entries[index]._vni = entry._vni;
       _entries[index]._synth_vni = entry._synth_vni;
@@ -923,25 +931,32 @@ add_vertex(const ObjToEggConverter *converter, const VertexEntry &entry) {
   } else if (entry._vni == 0 && entry._synth_vni == 0) {
     // If we are storing a vertex *without* any normal, see if we have already
     // stored a vertex with a normal first.
-    ni = _unique_entries.lower_bound(entry);
-    if (ni != _unique_entries.end() && (*ni).first.matches_except_normal(entry)) {
+    index = unique_positions.find(entry);
+    if (index >= 0) {
       // We had such a vertex, so use it.
-      index = (*ni).second;
       return index;
     }
   }
 
   // We didn't already have a vertex we could repurpose, so try to add exactly
   // the desired vertex.
-  result = _unique_entries.insert(UniqueVertexEntries::value_type(entry, _entries.size()));
-  ni = result.first;
-  index = (*ni).second;
+  std::pair<int, bool> result = unique_entries.insert(entry, (int)_entries.size());
+  index = result.first;
 
   if (result.second) {
     // If the vertex was added to the table, it's a unique vertex, and now we
     // have to add it to the vertex data too.
     _entries.push_back(entry);
 
+    // Also record it by position.  If there are several vertices at this
+    // position, we keep the one with the lowest normal index, to match the
+    // ordering of VertexEntry::operator <.
+    std::pair<int, bool> pos_result = unique_positions.insert(entry, index);
+    if (!pos_result.second && entry < _entries[pos_result.first]) {
+      unique_positions.remove(entry);
+      unique_positions.insert(entry, index);
+    }
+
     if (converter->_v4_given) {
       _v4_given = true;
     }
@@ -972,7 +987,7 @@ add_vertex(const ObjToEggConverter *converter, const VertexEntry &entry) {
  * assigned to the last vertex.
  */
 void ObjToEggConverter::VertexData::
-add_triangle(const ObjToEggConverter *converter, const VertexEntry &v0,
+add_triangle(ObjToEggConverter *converter, const VertexEntry &v0,
              const VertexEntry &v1, const VertexEntry &v2,
              int synth_vni) {
   int v0i, v1i, v2i;
@@ -997,7 +1012,7 @@ add_triangle(const ObjToEggConverter *converter, const VertexEntry &v0,
  * for new geoms.
  */
 void ObjToEggConverter::VertexData::
-close_geom(const ObjToEggConverter *converter) {
+close_geom(ObjToEggConverter *converter) {
   if (_prim->get_num_vertices() != 0) {
     // Create a new format that includes only the columns we actually used.
     PT(GeomVertexArrayFormat) aformat = new GeomVertexArrayFormat;
@@ -1100,7 +1115,24 @@ close_geom(const ObjToEggConverter *converter) {
     _geom_node->add_geom(geom, state);
   }
 
+  if (objegg_cat.is_debug() && !_entries.empty()) {
+    objegg_cat.debug()
+      << "Closed geom " << _name << " with " << _entries.size()
+      << " vertices; vertex table: ";
+    converter->_unique_entries.write_stats(objegg_cat.debug(false));
+    objegg_cat.debug(false)
+      << "; position table: ";
+    converter->_unique_positions.write_stats(objegg_cat.debug(false));
+    objegg_cat.debug(false)
+      << "\n";
+  }
+
   _prim = new GeomTriangles(GeomEnums::UH_static);
   _entries.clear();
-  _unique_entries.clear();
+
+  // Reset the lookup tables for the next Geom, keeping their storage.
+  converter->_unique_entries.clear();
+  converter->_unique_entries.reset_stats();
+  converter->_unique_positions.clear();
+  converter->_unique_positions.reset_stats();
 }
@@ -26,6 +26,7 @@
 #include "pandaNode.h"
 #include "pvector.h"
 #include "epvector.h"
+#include "indexHashTable.h"
 
 /**
  * Convert an Obj file to egg data.
@@ -76,7 +77,16 @@ protected:
   typedef epvector<LVecBase4d> Vec4Table;
   typedef epvector<LVecBase3d> Vec3Table;
   typedef epvector<LVecBase2d> Vec2Table;
-  typedef pmap<LVecBase3d, int> UniqueVec3Table;
+
+  class Vec3Compare {
+  public:
+    INLINE static size_t get_hash(const LVecBase3d &key);
+    INLINE static bool is_equal(const LVecBase3d &a, const LVecBase3d &b);
+
+  private:
+    INLINE static LVecBase3d quantize(const LVecBase3d &v);
+  };
+  typedef IndexHashTable<LVecBase3d, Vec3Compare> UniqueVec3Table;
 
   Vec4Table _v_table;
   Vec3Table _vn_table, _rgb_table;
@@ -100,13 +110,16 @@ protected:
 
   class VertexEntry {
   public:
-    VertexEntry();
+    INLINE VertexEntry();
     VertexEntry(const ObjToEggConverter *converter, const std::string &obj_vertex);
 
     INLINE bool operator < (const VertexEntry &other) const;
     INLINE bool operator == (const VertexEntry &other) const;
     INLINE bool matches_except_normal(const VertexEntry &other) const;
 
+    INLINE size_t get_hash() const;
+    INLINE size_t get_hash_except_normal() const;
+
     // The 1-based vertex, texcoord, and normal index numbers appearing in the
     // obj file for this vertex.  0 if the index number is not given.
     int _vi, _vti, _vni;
@@ -114,18 +127,35 @@ protected:
     // The 1-based index number to the synthesized normal, if needed.
     int _synth_vni;
   };
-  typedef pmap<VertexEntry, int> UniqueVertexEntries;
+
+  // Compares VertexEntries by all of their indices.
+  class VertexEntryCompare {
+  public:
+    INLINE static size_t get_hash(const VertexEntry &key);
+    INLINE static bool is_equal(const VertexEntry &a, const VertexEntry &b);
+  };
+
+  // Compares VertexEntries by their vertex and texcoord indices only, so we
+  // can find a vertex that has any normal at all.
+  class VertexEntryExceptNormalCompare {
+  public:
+    INLINE static size_t get_hash(const VertexEntry &key);
+    INLINE static bool is_equal(const VertexEntry &a, const VertexEntry &b);
+  };
+
+  typedef IndexHashTable<VertexEntry, VertexEntryCompare> UniqueVertexEntries;
+  typedef IndexHashTable<VertexEntry, VertexEntryExceptNormalCompare> UniqueVertexPositions;
   typedef pvector<VertexEntry> VertexEntries;
 
   class VertexData {
   public:
     VertexData(PandaNode *parent, const std::string &name);
 
-    int add_vertex(const ObjToEggConverter *converter, const VertexEntry &entry);
-    void add_triangle(const ObjToEggConverter *converter, const VertexEntry &v0,
+    int add_vertex(ObjToEggConverter *converter, const VertexEntry &entry);
+    void add_triangle(ObjToEggConverter *converter, const VertexEntry &v0,
                       const VertexEntry &v1, const VertexEntry &v2,
                       int synth_vni);
-    void close_geom(const ObjToEggConverter *converter);
+    void close_geom(ObjToEggConverter *converter);
 
     PT(PandaNode) _parent;
     std::string _name;
@@ -133,7 +163,6 @@ protected:
 
     PT(GeomPrimitive) _prim;
     VertexEntries _entries;
-    UniqueVertexEntries _unique_entries;
 
     bool _v4_given, _vt3_given;
     bool _vt_given, _rgb_given, _vn_given;
@@ -141,6 +170,12 @@ protected:
 
   VertexData *_current_vertex_data;
 
+  // These index the vertices of _current_vertex_data.  They are kept here
+  // rather than in the VertexData, so that their storage is reused from one
+  // Geom and group to the next.
+  UniqueVertexEntries _unique_entries;
+  UniqueVertexPositions _unique_positions;
+
   friend class VertexData;
 };
 
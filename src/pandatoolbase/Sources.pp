@@ -18,16 +18,22 @@
     animationConvert.cxx animationConvert.h \
     config_pandatoolbase.cxx config_pandatoolbase.h \
     distanceUnit.cxx distanceUnit.h \
+    jsonOutput.cxx jsonOutput.h \
+    mappedFile.cxx mappedFile.I mappedFile.h \
     pandatoolbase.cxx pandatoolbase.h pandatoolsymbols.h \
     pathReplace.cxx pathReplace.I pathReplace.h \
-    pathStore.cxx pathStore.h
+    pathStore.cxx pathStore.h \
+    workerPool.I workerPool.cxx workerPool.h
 
   #define INSTALL_HEADERS \
     animationConvert.h \
     config_pandatoolbase.h \
     distanceUnit.h \
+    jsonOutput.h \
+    mappedFile.I mappedFile.h \
     pandatoolbase.h pandatoolsymbols.h \
     pathReplace.I pathReplace.h \
-    pathStore.h
+    pathStore.h \
+    workerPool.I workerPool.h
 
 #end ss_lib_target
@@ -15,6 +15,22 @@
 
 NotifyCategoryDef(pandatoolbase, "");
 
+ConfigVariableInt pandatool_num_threads
+("pandatool-num-threads", 0,
+ PRC_DESC("The number of threads the converters and tools may use to process "
+          "independent files or pieces of a file in parallel.  Set this to 0 "
+          "to use one thread per CPU, or 1 to disable threading."));
+
+ConfigVariableFilename pandatool_texture_copy_cache
+("pandatool-texture-copy-cache", "$USER_APPDATA/Panda3D/texture-copies.dat",
+ PRC_DESC("The file in which -td and -te record the content of each texture "
+          "they copy, so that a texture is copied again only if its source "
+          "has really changed, regardless of the timestamps.  One file "
+          "serves every destination directory.  Set this to the empty "
+          "string to compare only the timestamps of the files instead, "
+          "which is also what happens if Panda was built without "
+          "OpenSSL."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
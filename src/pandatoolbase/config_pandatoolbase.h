@@ -17,9 +17,14 @@
 #include "pandatoolbase.h"
 
 #include "notifyCategoryProxy.h"
+#include "configVariableInt.h"
+#include "configVariableFilename.h"
 
 NotifyCategoryDeclNoExport(pandatoolbase);
 
+extern ConfigVariableInt pandatool_num_threads;
+extern ConfigVariableFilename pandatool_texture_copy_cache;
+
 extern void init_libpandatoolbase();
 
 #endif
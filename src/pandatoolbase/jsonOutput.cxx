@@ -0,0 +1,60 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jsonOutput.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "jsonOutput.h"
+
+#include <stdio.h>
+
+/**
+ * Writes the indicated string to the stream as a quoted JSON string, with
+ * quotes, backslashes and control characters escaped.  Other bytes are
+ * written as they are, so the string should already be UTF-8.
+ */
+void
+write_json_string(std::ostream &out, const std::string &str) {
+  out << '"';
+  for (std::string::const_iterator si = str.begin(); si != str.end(); ++si) {
+    unsigned char ch = (unsigned char)(*si);
+    switch (ch) {
+    case '"':
+      out << "\\\"";
+      break;
+
+    case '\\':
+      out << "\\\\";
+      break;
+
+    case '\n':
+      out << "\\n";
+      break;
+
+    case '\r':
+      out << "\\r";
+      break;
+
+    case '\t':
+      out << "\\t";
+      break;
+
+    default:
+      if (ch < 0x20) {
+        char buffer[8];
+        sprintf(buffer, "\\u%04x", ch);
+        out << buffer;
+      } else {
+        out << (char)ch;
+      }
+    }
+  }
+  out << '"';
+}
@@ -0,0 +1,25 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file jsonOutput.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef JSONOUTPUT_H
+#define JSONOUTPUT_H
+
+#include "pandatoolbase.h"
+
+#include <string>
+
+// These help the tools that write machine-readable reports.
+
+void write_json_string(std::ostream &out, const std::string &str);
+
+#endif
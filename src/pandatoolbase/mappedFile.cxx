@@ -0,0 +1,113 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedFile.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Maps the indicated file, which must be a nonempty file on disk, into
+ * memory.  Returns true on success, or false if the file can't be mapped.
+ */
+bool MappedFile::
+open(const Filename &filename) {
+  close();
+
+#ifdef _WIN32
+  std::wstring os_specific = filename.to_os_specific_w();
+  HANDLE file = CreateFileW(os_specific.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 ||
+      (ULONGLONG)size.QuadPart > (ULONGLONG)(SIZE_MAX)) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return false;
+  }
+
+  // The view keeps the mapping alive after we close our handle to it.
+  void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (data == nullptr) {
+    return false;
+  }
+
+  _data = (const char *)data;
+  _size = (size_t)size.QuadPart;
+
+#else
+  std::string os_specific = filename.to_os_specific();
+  int fd = ::open(os_specific.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  size_t size = (size_t)st.st_size;
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  // The file will be read from beginning to end.
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  _data = (const char *)data;
+  _size = size;
+#endif
+
+  return true;
+}
+
+/**
+ * Unmaps the file, if any.  Pointers previously returned by get_data() are
+ * no longer valid.
+ */
+void MappedFile::
+close() {
+  if (_data != nullptr) {
+#ifdef _WIN32
+    UnmapViewOfFile((LPCVOID)_data);
+#else
+    munmap((void *)_data, _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+  }
+}
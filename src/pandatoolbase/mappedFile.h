@@ -0,0 +1,52 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file mappedFile.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "pandatoolbase.h"
+
+#include "filename.h"
+
+/**
+ * A read-only view of a file on disk that has been mapped into memory, so
+ * that a very large input file may be scanned, perhaps by several threads at
+ * once, without first being copied into a buffer.
+ *
+ * Only plain files on the local disk can be mapped.  If open() fails, the
+ * caller should read the file through the virtual file system instead, which
+ * also handles multifiles and compressed files.
+ */
+class MappedFile {
+public:
+  INLINE MappedFile();
+  INLINE ~MappedFile();
+
+  MappedFile(const MappedFile &copy) = delete;
+  MappedFile &operator = (const MappedFile &copy) = delete;
+
+  bool open(const Filename &filename);
+  void close();
+
+  INLINE bool is_open() const;
+  INLINE const char *get_data() const;
+  INLINE size_t get_size() const;
+
+private:
+  const char *_data;
+  size_t _size;
+};
+
+#include "mappedFile.I"
+
+#endif
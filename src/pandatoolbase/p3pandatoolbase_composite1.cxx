@@ -3,4 +3,7 @@
 #include "pathReplace.cxx"
 #include "animationConvert.cxx"
 #include "distanceUnit.cxx"
+#include "jsonOutput.cxx"
+#include "mappedFile.cxx"
 #include "pandatoolbase.cxx"
+#include "workerPool.cxx"
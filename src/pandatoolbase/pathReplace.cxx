@@ -16,6 +16,7 @@
 #include "config_pandatoolbase.h"
 #include "indent.h"
 #include "virtualFileSystem.h"
+#include "lightMutexHolder.h"
 
 /**
  *
@@ -45,6 +46,7 @@ PathReplace::
 Filename PathReplace::
 match_path(const Filename &orig_filename,
            const DSearchPath &additional_path) {
+  LightMutexHolder holder(_lock);
   Filename match;
   bool got_match = false;
 
@@ -151,6 +153,7 @@ store_path(const Filename &orig_filename) {
     return orig_filename;
   }
 
+  LightMutexHolder holder(_lock);
   if (_path_directory.is_local()) {
     _path_directory.make_absolute();
   }
@@ -199,6 +202,7 @@ full_convert_path(const Filename &orig_filename,
                   const DSearchPath &additional_path,
                   Filename &resolved_path,
                   Filename &output_path) {
+  LightMutexHolder holder(_lock);
   if (_path_directory.is_local()) {
     _path_directory.make_absolute();
   }
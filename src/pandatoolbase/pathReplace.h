@@ -22,6 +22,7 @@
 #include "dSearchPath.h"
 #include "pvector.h"
 #include "pmap.h"
+#include "lightMutex.h"
 
 /**
  * This encapsulates the user's command-line request to replace existing,
@@ -117,6 +118,10 @@ private:
 
   bool _error_flag;
 
+  // A PathReplace is shared between a converter and its copies, which may be
+  // converting external references on different threads.
+  LightMutex _lock;
+
   typedef pmap<Filename, Filename> Copied;
   Copied _orig_to_target;
   Copied _target_to_orig;
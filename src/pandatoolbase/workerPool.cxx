@@ -0,0 +1,142 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file workerPool.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "workerPool.h"
+#include "config_pandatoolbase.h"
+#include "mutexHolder.h"
+#include "string_utils.h"
+#include "pnmFileTypeRegistry.h"
+
+#include <thread>
+
+/**
+ * Creates a pool that uses up to num_threads threads.  If num_threads is 0
+ * or less, the value of pandatool-num-threads is used instead.
+ */
+WorkerPool::
+WorkerPool(int num_threads) :
+  _job(nullptr),
+  _num_jobs(0),
+  _next_job(0)
+{
+  if (num_threads <= 0) {
+    num_threads = get_default_num_threads();
+  }
+  if (!Thread::is_true_threads()) {
+    num_threads = 1;
+  }
+  _num_threads = num_threads;
+}
+
+/**
+ * Runs job(n) for each n in the range [0, num_jobs), and returns when they
+ * have all completed.
+ */
+void WorkerPool::
+run(int num_jobs, const JobFunc &job) {
+  if (num_jobs <= 0) {
+    return;
+  }
+
+  int num_threads = std::min(_num_threads, num_jobs);
+  if (num_threads <= 1) {
+    for (int n = 0; n < num_jobs; ++n) {
+      job(n);
+    }
+    return;
+  }
+
+  _job = &job;
+  _num_jobs = num_jobs;
+  _next_job = 0;
+
+  pvector<PT(WorkerThread) > threads;
+  threads.reserve(num_threads - 1);
+  for (int i = 1; i < num_threads; ++i) {
+    PT(WorkerThread) thread = new WorkerThread(this, i);
+    if (thread->start(TP_normal, true)) {
+      threads.push_back(thread);
+    }
+  }
+
+  // The calling thread does its share of the work too.
+  run_jobs();
+
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->join();
+  }
+
+  _job = nullptr;
+  _num_jobs = 0;
+}
+
+/**
+ * Returns the number of threads a WorkerPool uses when none is specified: the
+ * value of pandatool-num-threads, or the number of CPUs if that is 0.
+ */
+int WorkerPool::
+get_default_num_threads() {
+  int num_threads = pandatool_num_threads;
+  if (num_threads <= 0) {
+    num_threads = (int)std::thread::hardware_concurrency();
+  }
+  return std::max(num_threads, 1);
+}
+
+/**
+ * Pulls jobs off the queue and runs them until there are none left.
+ */
+void WorkerPool::
+run_jobs() {
+  while (true) {
+    int n;
+    {
+      MutexHolder holder(_lock);
+      if (_next_job >= _num_jobs) {
+        return;
+      }
+      n = _next_job++;
+    }
+    (*_job)(n);
+  }
+}
+
+/**
+ *
+ */
+WorkerPool::WorkerThread::
+WorkerThread(WorkerPool *pool, int n) :
+  Thread("worker-" + format_string(n), "worker"),
+  _pool(pool)
+{
+}
+
+/**
+ *
+ */
+void WorkerPool::WorkerThread::
+thread_main() {
+  _pool->run_jobs();
+}
+
+/**
+ * Should be called before starting a pool whose jobs read or write images,
+ * through PNMImage, PfmFile or the TexturePool.  The PNMFileTypeRegistry
+ * sorts its types the first time it looks one up by extension, which is not
+ * safe to do from several threads at once; this forces that to happen now,
+ * in the calling thread.
+ */
+void WorkerPool::
+prepare_image_threads() {
+  PNMFileTypeRegistry::get_global_ptr()->get_type_from_extension("");
+}
@@ -0,0 +1,74 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file workerPool.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include "pandatoolbase.h"
+
+#include "thread.h"
+#include "pmutex.h"
+#include "pvector.h"
+
+#include <functional>
+
+/**
+ * A simple fork-join pool for running a number of independent jobs across
+ * several threads, for the benefit of the various tools that process many
+ * files or many independent pieces of one file.
+ *
+ * run() calls the job function once for each job index, from the calling
+ * thread and from up to get_num_threads() - 1 additional threads, and
+ * returns when all of the jobs have finished.  The order in which the jobs
+ * run is not defined, so each job must write its results into its own slot.
+ *
+ * If Panda was not compiled with true threads, or the pool is given only one
+ * thread, the jobs are simply run in order in the calling thread.
+ */
+class WorkerPool {
+public:
+  typedef std::function<void(int)> JobFunc;
+
+  explicit WorkerPool(int num_threads = 0);
+
+  INLINE int get_num_threads() const;
+
+  void run(int num_jobs, const JobFunc &job);
+
+  static int get_default_num_threads();
+  static void prepare_image_threads();
+
+private:
+  void run_jobs();
+
+  class WorkerThread : public Thread {
+  public:
+    WorkerThread(WorkerPool *pool, int n);
+    virtual void thread_main();
+
+  private:
+    WorkerPool *_pool;
+  };
+
+  int _num_threads;
+
+  // These are only valid within run().
+  Mutex _lock;
+  const JobFunc *_job;
+  int _num_jobs;
+  int _next_job;
+};
+
+#include "workerPool.I"
+
+#endif
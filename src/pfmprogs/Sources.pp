@@ -12,17 +12,18 @@
 
 #begin bin_target
   #define TARGET pfm-trans
-  #define LOCAL_LIBS progbase
+  #define LOCAL_LIBS progbase pandatoolbase
 
   #define SOURCES \
     config_pfmprogs.cxx config_pfmprogs.h \
+    pfmStreamTransform.cxx pfmStreamTransform.I pfmStreamTransform.h \
     pfmTrans.cxx pfmTrans.h
 
 #end bin_target
 
 #begin bin_target
   #define TARGET pfm-bba
-  #define LOCAL_LIBS progbase
+  #define LOCAL_LIBS progbase pandatoolbase
 
   #define SOURCES \
     config_pfmprogs.cxx config_pfmprogs.h \
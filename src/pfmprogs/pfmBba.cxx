@@ -14,6 +14,11 @@
 #include "pfmBba.h"
 #include "config_pfmprogs.h"
 #include "pfmFile.h"
+#include "workerPool.h"
+#include "pmutex.h"
+#include "mutexHolder.h"
+
+#include <sstream>
 
 /**
  *
@@ -30,10 +35,19 @@ PfmBba() {
      "Treats (0,0,0) in the pfm file as a special don't-touch value.",
      &PfmBba::dispatch_none, &_got_zero_special);
 
+  add_option
+    ("j", "threads", 0,
+     "Process the indicated number of pfm files at once, each in its own "
+     "thread.  The default is taken from the pandatool-num-threads config "
+     "variable.",
+     &PfmBba::dispatch_int, nullptr, &_num_threads);
+
   add_option
     ("o", "filename", 50,
      "Specify the filename to which the resulting bba file will be written.",
      &PfmBba::dispatch_filename, &_got_output_filename, &_output_filename);
+
+  _num_threads = 0;
 }
 
 
@@ -42,24 +56,41 @@ PfmBba() {
  */
 void PfmBba::
 run() {
-  Filenames::const_iterator fi;
-  for (fi = _input_filenames.begin(); fi != _input_filenames.end(); ++fi) {
+  WorkerPool::prepare_image_threads();
+
+  bool success = true;
+  Mutex lock;
+  WorkerPool pool(_num_threads);
+  pool.run((int)_input_filenames.size(), [&](int i) {
+    const Filename &input_filename = _input_filenames[i];
+    std::ostringstream out;
+
+    bool okflag;
     PfmFile file;
-    if (!file.read(*fi)) {
-      nout << "Cannot read " << *fi << "\n";
-      exit(1);
+    if (!file.read(input_filename)) {
+      out << "Cannot read " << input_filename << "\n";
+      okflag = false;
+    } else {
+      okflag = process_pfm(input_filename, file, out);
     }
-    if (!process_pfm(*fi, file)) {
-      exit(1);
+
+    MutexHolder holder(lock);
+    nout << out.str();
+    if (!okflag) {
+      success = false;
     }
+  });
+
+  if (!success) {
+    exit(1);
   }
 }
 
 /**
- * Handles a single pfm file.
+ * Handles a single pfm file.  Messages are written to out.
  */
 bool PfmBba::
-process_pfm(const Filename &input_filename, PfmFile &file) {
+process_pfm(const Filename &input_filename, PfmFile &file, std::ostream &out) {
   file.set_zero_special(_got_zero_special);
 
   Filename bba_filename;
@@ -75,9 +106,9 @@ process_pfm(const Filename &input_filename, PfmFile &file) {
     PT(BoundingHexahedron) bounds = file.compute_planar_bounds(LPoint2f(0.5, 0.5), pfm_bba_dist[0], pfm_bba_dist[1], false);
     nassertr(bounds != nullptr, false);
 
-    pofstream out;
-    if (!bba_filename.open_write(out)) {
-      std::cerr << "Unable to open " << bba_filename << "\n";
+    pofstream bba;
+    if (!bba_filename.open_write(bba)) {
+      out << "Unable to open " << bba_filename << "\n";
       return false;
     }
 
@@ -101,7 +132,7 @@ process_pfm(const Filename &input_filename, PfmFile &file) {
 
     for (int i = 0; i < 8; ++i) {
       const LPoint3 &p = points[i];
-      out << p[0] << "," << p[1] << "," << p[2] << "\n";
+      bba << p[0] << "," << p[1] << "," << p[2] << "\n";
     }
   }
 
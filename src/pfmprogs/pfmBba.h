@@ -31,7 +31,8 @@ public:
   PfmBba();
 
   void run();
-  bool process_pfm(const Filename &input_filename, PfmFile &file);
+  bool process_pfm(const Filename &input_filename, PfmFile &file,
+                   std::ostream &out);
 
 protected:
   virtual bool handle_args(Args &args);
@@ -41,6 +42,7 @@ private:
   Filenames _input_filenames;
 
   bool _got_zero_special;
+  int _num_threads;
   bool _got_output_filename;
   Filename _output_filename;
 };
@@ -0,0 +1,373 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pfmStreamTransform.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pfmStreamTransform.h"
+#include "string_utils.h"
+#include "pandaFileStream.h"
+
+#include <algorithm>
+#include <string.h>
+
+// The number of floats in each block of rows, in and out.
+static const size_t block_floats = 4 * 1024 * 1024;
+
+/**
+ *
+ */
+PfmStreamTransform::
+PfmStreamTransform() {
+  _zero_special = false;
+  _no_data_nan = 0;
+  _got_crop = false;
+  _crop[0] = _crop[1] = _crop[2] = _crop[3] = 0;
+  _autocrop = false;
+  _got_transform = false;
+  _transform = LMatrix4f::ident_mat();
+}
+
+/**
+ * Adds a flip, as performed by PfmFile::flip(), after the crop and any flips
+ * added previously.
+ */
+void PfmStreamTransform::
+add_flip(bool flip_x, bool flip_y, bool transpose) {
+  Flip flip;
+  flip._flip_x = flip_x;
+  flip._flip_y = flip_y;
+  flip._transpose = transpose;
+  _flips.push_back(flip);
+}
+
+/**
+ * Reads the input file, transforms it, and writes the output file.  Messages
+ * are written to out.  Returns R_unsupported without writing anything if
+ * the file or the operations can't be handled here.
+ */
+PfmStreamTransform::Result PfmStreamTransform::
+process(const Filename &input_filename, const Filename &output_filename,
+        std::ostream &out) const {
+  if (downcase(input_filename.get_extension()) != "pfm" ||
+      downcase(output_filename.get_extension()) != "pfm") {
+    return R_unsupported;
+  }
+
+  // The output is written while the input is still being read, so they must
+  // be different files.
+  Filename input_canon = input_filename;
+  Filename output_canon = output_filename;
+  input_canon.make_canonical();
+  output_canon.make_canonical();
+  if (input_canon == output_canon) {
+    return R_unsupported;
+  }
+
+  Filename input = Filename::binary_filename(input_filename);
+  pifstream in;
+  if (!input.open_read(in)) {
+    return R_unsupported;
+  }
+
+  Header header;
+  if (!read_header(in, header)) {
+    return R_unsupported;
+  }
+  int num_channels = header._num_channels;
+  if (num_channels != 1 && num_channels != 3) {
+    return R_unsupported;
+  }
+  if (_got_transform && num_channels != 3) {
+    return R_unsupported;
+  }
+  if (_no_data_nan > num_channels) {
+    return R_unsupported;
+  }
+
+  // Start with the crop.
+  bool got_crop = _got_crop;
+  int crop[4] = { _crop[0], _crop[1], _crop[2], _crop[3] };
+  if (_autocrop) {
+    got_crop = calc_autocrop(in, header, crop);
+  }
+
+  Mapping map;
+  map._x_size = header._x_size;
+  map._y_size = header._y_size;
+  map._x0 = 0;
+  map._xx = 1;
+  map._xy = 0;
+  map._y0 = 0;
+  map._yx = 0;
+  map._yy = 1;
+
+  if (got_crop) {
+    if (crop[0] < 0 || crop[2] < 0 || crop[0] > crop[1] || crop[2] > crop[3] ||
+        crop[1] > header._x_size || crop[3] > header._y_size) {
+      return R_unsupported;
+    }
+    map._x_size = crop[1] - crop[0];
+    map._y_size = crop[3] - crop[2];
+    map._x0 = crop[0];
+    map._y0 = crop[2];
+  }
+
+  // Then each flip.  Output point (nx, ny) comes from point (px, py) before
+  // the flip; we substitute that into the mapping so far.
+  for (const Flip &flip : _flips) {
+    int w = map._x_size;
+    int h = map._y_size;
+
+    // px = c0 + c1 * nx + c2 * ny, and py = d0 + d1 * nx + d2 * ny.
+    int c0, c1, c2, d0, d1, d2;
+    if (!flip._transpose) {
+      c0 = flip._flip_x ? w - 1 : 0;
+      c1 = flip._flip_x ? -1 : 1;
+      c2 = 0;
+      d0 = flip._flip_y ? h - 1 : 0;
+      d1 = 0;
+      d2 = flip._flip_y ? -1 : 1;
+    } else {
+      c0 = flip._flip_x ? w - 1 : 0;
+      c1 = 0;
+      c2 = flip._flip_x ? -1 : 1;
+      d0 = flip._flip_y ? h - 1 : 0;
+      d1 = flip._flip_y ? -1 : 1;
+      d2 = 0;
+      std::swap(map._x_size, map._y_size);
+    }
+
+    Mapping prev = map;
+    map._x0 = prev._x0 + prev._xx * c0 + prev._xy * d0;
+    map._xx = prev._xx * c1 + prev._xy * d1;
+    map._xy = prev._xx * c2 + prev._xy * d2;
+    map._y0 = prev._y0 + prev._yx * c0 + prev._yy * d0;
+    map._yx = prev._yx * c1 + prev._yy * d1;
+    map._yy = prev._yx * c2 + prev._yy * d2;
+  }
+
+  if (map._x_size == 0 || map._y_size == 0) {
+    return R_unsupported;
+  }
+
+  Filename output = Filename::binary_filename(output_filename);
+  pofstream out_file;
+  if (!output.open_write(out_file, true)) {
+    out << "Unable to write " << output << "\n";
+    return R_failed;
+  }
+
+  // The data is written in the native byte order, which the sign of the
+  // scale records.
+  static const uint16_t one = 1;
+  bool little_endian = (*(const unsigned char *)&one == 1);
+  out_file << ((num_channels == 1) ? "Pf" : "PF") << "\n"
+           << map._x_size << " " << map._y_size << "\n"
+           << (little_endian ? "-1" : "1") << "\n";
+
+  size_t row_floats = (size_t)map._x_size * num_channels;
+  int block_rows = (int)std::max(block_floats / row_floats, (size_t)1);
+
+  pvector<PN_float32> in_block, out_block;
+  for (int oy0 = 0; oy0 < map._y_size; oy0 += block_rows) {
+    int oy1 = std::min(oy0 + block_rows, map._y_size);
+
+    // Find the rectangle of the input that these rows come from.
+    int ox_corner[2] = { 0, map._x_size - 1 };
+    int oy_corner[2] = { oy0, oy1 - 1 };
+    int ix0 = header._x_size, ix1 = -1, iy0 = header._y_size, iy1 = -1;
+    for (int ox : ox_corner) {
+      for (int oy : oy_corner) {
+        int ix = map._x0 + map._xx * ox + map._xy * oy;
+        int iy = map._y0 + map._yx * ox + map._yy * oy;
+        ix0 = std::min(ix0, ix);
+        ix1 = std::max(ix1, ix);
+        iy0 = std::min(iy0, iy);
+        iy1 = std::max(iy1, iy);
+      }
+    }
+    int rect_width = ix1 - ix0 + 1;
+    in_block.resize((size_t)rect_width * (iy1 - iy0 + 1) * num_channels);
+    if (!read_rect(in, header, ix0, iy0, ix1 + 1, iy1 + 1, &in_block[0])) {
+      out << "Cannot read " << input_filename << "\n";
+      return R_failed;
+    }
+
+    // Rearrange the points into the output rows.
+    out_block.resize((size_t)(oy1 - oy0) * row_floats);
+    for (int oy = oy0; oy < oy1; ++oy) {
+      PN_float32 *dest = &out_block[(size_t)(oy - oy0) * row_floats];
+      int ix = map._x0 + map._xy * oy;
+      int iy = map._y0 + map._yy * oy;
+      if (map._xx == 1 && map._yx == 0) {
+        // The row is contiguous in the input.
+        memcpy(dest, &in_block[((size_t)(iy - iy0) * rect_width + (ix - ix0)) * num_channels],
+               row_floats * sizeof(PN_float32));
+        continue;
+      }
+      for (int ox = 0; ox < map._x_size; ++ox) {
+        const PN_float32 *source =
+          &in_block[((size_t)(iy - iy0) * rect_width + (ix - ix0)) * num_channels];
+        for (int ci = 0; ci < num_channels; ++ci) {
+          dest[ci] = source[ci];
+        }
+        dest += num_channels;
+        ix += map._xx;
+        iy += map._yx;
+      }
+    }
+
+    if (_got_transform) {
+      // This is the arithmetic of PfmFile::xform() for 3 channels.
+      PN_float32 *p = &out_block[0];
+      PN_float32 *end = p + out_block.size();
+      for (; p < end; p += 3) {
+        if (has_point(p, 3)) {
+          LPoint3f point(p[0], p[1], p[2]);
+          point = _transform.xform_point(point);
+          p[0] = point[0];
+          p[1] = point[1];
+          p[2] = point[2];
+        }
+      }
+    }
+
+    out_file.write((const char *)&out_block[0],
+                   out_block.size() * sizeof(PN_float32));
+    if (out_file.fail()) {
+      out << "Unable to write " << output << "\n";
+      return R_failed;
+    }
+  }
+
+  return R_ok;
+}
+
+/**
+ * Reads the header of a plain pfm file.  Returns true if it is one.
+ */
+bool PfmStreamTransform::
+read_header(std::istream &in, Header &header) {
+  std::string magic;
+  in >> magic;
+  if (magic == "PF") {
+    header._num_channels = 3;
+  } else if (magic == "Pf") {
+    header._num_channels = 1;
+  } else {
+    return false;
+  }
+
+  double scale;
+  in >> header._x_size >> header._y_size >> scale;
+  if (in.fail() || header._x_size <= 0 || header._y_size <= 0) {
+    return false;
+  }
+
+  // A single whitespace character separates the header from the data.
+  in.get();
+  header._data_start = in.tellg();
+  if (in.fail() || header._data_start < 0) {
+    return false;
+  }
+
+  // A negative scale means the data is little-endian.
+  static const uint16_t one = 1;
+  bool little_endian = (*(const unsigned char *)&one == 1);
+  header._swap = ((scale < 0.0) != little_endian);
+  return true;
+}
+
+/**
+ * Finds the smallest rectangle that includes all of the points of the input,
+ * as PfmFile::calc_autocrop() does.  Returns false if there are no points.
+ */
+bool PfmStreamTransform::
+calc_autocrop(std::istream &in, const Header &header, int crop[4]) const {
+  int num_channels = header._num_channels;
+  size_t row_floats = (size_t)header._x_size * num_channels;
+  int block_rows = (int)std::max(block_floats / row_floats, (size_t)1);
+
+  int x_begin = header._x_size, x_end = 0;
+  int y_begin = header._y_size, y_end = 0;
+
+  pvector<PN_float32> block;
+  for (int y0 = 0; y0 < header._y_size; y0 += block_rows) {
+    int y1 = std::min(y0 + block_rows, header._y_size);
+    block.resize((size_t)(y1 - y0) * row_floats);
+    if (!read_rect(in, header, 0, y0, header._x_size, y1, &block[0])) {
+      return false;
+    }
+
+    const PN_float32 *p = &block[0];
+    for (int yi = y0; yi < y1; ++yi) {
+      for (int xi = 0; xi < header._x_size; ++xi) {
+        if (has_point(p, num_channels)) {
+          x_begin = std::min(x_begin, xi);
+          x_end = std::max(x_end, xi + 1);
+          y_begin = std::min(y_begin, yi);
+          y_end = std::max(y_end, yi + 1);
+        }
+        p += num_channels;
+      }
+    }
+  }
+
+  if (x_begin >= x_end || y_begin >= y_end) {
+    return false;
+  }
+
+  crop[0] = x_begin;
+  crop[1] = x_end;
+  crop[2] = y_begin;
+  crop[3] = y_end;
+  return true;
+}
+
+/**
+ * Reads the points in columns x_begin to x_end - 1 of rows y_begin to y_end -
+ * 1 into buffer, in the native byte order.  Returns true on success.
+ */
+bool PfmStreamTransform::
+read_rect(std::istream &in, const Header &header,
+          int x_begin, int y_begin, int x_end, int y_end,
+          PN_float32 *buffer) {
+  int num_channels = header._num_channels;
+  size_t rect_floats = (size_t)(x_end - x_begin) * num_channels;
+  size_t rect_bytes = rect_floats * sizeof(PN_float32);
+
+  if (x_begin == 0 && x_end == header._x_size) {
+    // The rows are contiguous in the file.
+    in.seekg(header._data_start + (std::streamoff)y_begin * rect_bytes);
+    in.read((char *)buffer, rect_bytes * (y_end - y_begin));
+  } else {
+    for (int yi = y_begin; yi < y_end; ++yi) {
+      std::streamoff offset =
+        ((std::streamoff)yi * header._x_size + x_begin) * num_channels;
+      in.seekg(header._data_start + offset * (std::streamoff)sizeof(PN_float32));
+      in.read((char *)(buffer + (size_t)(yi - y_begin) * rect_floats), rect_bytes);
+    }
+  }
+  if (in.fail()) {
+    in.clear();
+    return false;
+  }
+
+  if (header._swap) {
+    size_t num_floats = rect_floats * (y_end - y_begin);
+    unsigned char *p = (unsigned char *)buffer;
+    for (size_t i = 0; i < num_floats; ++i, p += 4) {
+      std::swap(p[0], p[3]);
+      std::swap(p[1], p[2]);
+    }
+  }
+  return true;
+}
@@ -0,0 +1,106 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pfmStreamTransform.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef PFMSTREAMTRANSFORM_H
+#define PFMSTREAMTRANSFORM_H
+
+#include "pandatoolbase.h"
+#include "filename.h"
+#include "pvector.h"
+#include "luse.h"
+
+/**
+ * Applies the crop, flips and matrix transform of pfm-trans to a pfm file in
+ * a single pass, reading and writing a block of rows at a time, so that the
+ * whole grid is never held in memory.
+ *
+ * The operations are performed in the same order, and give exactly the same
+ * results, as PfmFile::apply_crop(), flip() and xform() performed one after
+ * the other: first the crop, then the flips in the order they were added,
+ * and then the transform.  Since the crop and flips merely rearrange the
+ * points, they are combined into a single mapping from each output point to
+ * its input point, and each block of output rows is filled from the
+ * rectangle of the input file that it maps to.
+ *
+ * Only plain 1- and 3-channel pfm files are handled, and the transform only
+ * for 3 channels.  For anything else, process() returns R_unsupported, and
+ * the caller should fall back to PfmFile.
+ */
+class PfmStreamTransform {
+public:
+  enum Result {
+    R_ok,
+    R_failed,
+    R_unsupported,
+  };
+
+  PfmStreamTransform();
+
+  INLINE void set_zero_special(bool zero_special);
+  INLINE void set_no_data_nan(int num_channels);
+  INLINE void set_crop(int x_begin, int x_end, int y_begin, int y_end);
+  INLINE void set_autocrop(bool autocrop);
+  void add_flip(bool flip_x, bool flip_y, bool transpose);
+  INLINE void set_transform(const LMatrix4f &transform);
+
+  Result process(const Filename &input_filename,
+                 const Filename &output_filename, std::ostream &out) const;
+
+private:
+  class Header {
+  public:
+    int _num_channels;
+    int _x_size;
+    int _y_size;
+    bool _swap;
+    std::streamoff _data_start;
+  };
+
+  // Maps each output point to the input point it comes from:
+  // ix = _x0 + _xx * ox + _xy * oy, and iy = _y0 + _yx * ox + _yy * oy.
+  class Mapping {
+  public:
+    int _x_size, _y_size;
+    int _x0, _xx, _xy;
+    int _y0, _yx, _yy;
+  };
+
+  class Flip {
+  public:
+    bool _flip_x;
+    bool _flip_y;
+    bool _transpose;
+  };
+  typedef pvector<Flip> Flips;
+
+  static bool read_header(std::istream &in, Header &header);
+  bool calc_autocrop(std::istream &in, const Header &header,
+                     int crop[4]) const;
+  static bool read_rect(std::istream &in, const Header &header,
+                        int x_begin, int y_begin, int x_end, int y_end,
+                        PN_float32 *buffer);
+  INLINE bool has_point(const PN_float32 *point, int num_channels) const;
+
+  bool _zero_special;
+  int _no_data_nan;
+  bool _got_crop;
+  int _crop[4];
+  bool _autocrop;
+  Flips _flips;
+  bool _got_transform;
+  LMatrix4f _transform;
+};
+
+#include "pfmStreamTransform.I"
+
+#endif
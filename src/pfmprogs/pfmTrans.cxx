@@ -20,6 +20,12 @@
 #include "pointerTo.h"
 #include "string_utils.h"
 #include "pandaFileStream.h"
+#include "pfmStreamTransform.h"
+#include "workerPool.h"
+#include "pmutex.h"
+#include "mutexHolder.h"
+
+#include <sstream>
 
 using std::string;
 
@@ -32,6 +38,7 @@ PfmTrans() {
   _got_transform = false;
   _transform = LMatrix4::ident_mat();
   _rotate = 0;
+  _num_threads = 0;
 
   add_transform_options();
 
@@ -86,6 +93,13 @@ PfmTrans() {
      "Flips the pfm file about the y axis.",
      &PfmTrans::dispatch_none, &_got_mirror_y);
 
+  add_option
+    ("j", "threads", 0,
+     "Process the indicated number of pfm files at once, each in its own "
+     "thread.  The default is taken from the pandatool-num-threads config "
+     "variable.  With -vis or -ls, the files are processed one at a time.",
+     &PfmTrans::dispatch_int, nullptr, &_num_threads);
+
   add_option
     ("o", "filename", 50,
      "Specify the filename to which the resulting pfm file will be written.  "
@@ -145,16 +159,57 @@ run() {
     _mesh_root = NodePath("mesh_root");
   }
 
-  Filenames::const_iterator fi;
-  for (fi = _input_filenames.begin(); fi != _input_filenames.end(); ++fi) {
-    PfmFile file;
-    if (!file.read(*fi)) {
-      nout << "Cannot read " << *fi << "\n";
-      exit(1);
+  // Unless the file must be resized, or visualized or listed, which need the
+  // whole grid, each file is streamed through a PfmStreamTransform, a block
+  // of rows at a time.  Files it can't handle are loaded into a PfmFile as
+  // before.
+  PfmStreamTransform stream;
+  bool can_stream = make_stream_transform(stream);
+
+  // The visualizations all go into one scene graph, and -ls writes just one
+  // file, so in those cases the files are processed one at a time.
+  int num_threads = _num_threads;
+  if (_got_vis_filename || _got_ls_filename) {
+    num_threads = 1;
+  }
+
+  WorkerPool::prepare_image_threads();
+
+  bool success = true;
+  Mutex lock;
+  WorkerPool pool(num_threads);
+  pool.run((int)_input_filenames.size(), [&](int i) {
+    const Filename &input_filename = _input_filenames[i];
+    std::ostringstream out;
+
+    PfmStreamTransform::Result result = PfmStreamTransform::R_unsupported;
+    if (can_stream) {
+      result = stream.process(input_filename,
+                              get_output_filename(input_filename), out);
     }
-    if (!process_pfm(*fi, file)) {
-      exit(1);
+
+    bool okflag;
+    if (result != PfmStreamTransform::R_unsupported) {
+      okflag = (result == PfmStreamTransform::R_ok);
+    } else {
+      PfmFile file;
+      if (!file.read(input_filename)) {
+        out << "Cannot read " << input_filename << "\n";
+        okflag = false;
+      } else {
+        okflag = process_pfm(input_filename, file);
+      }
     }
+
+    MutexHolder holder(lock);
+    nout << out.str();
+    if (!okflag) {
+      success = false;
+    }
+  });
+
+  if (!success) {
+    exit(1);
   }
 
   if (_got_vis_filename) {
@@ -176,12 +231,14 @@ process_pfm(const Filename &input_filename, PfmFile &file) {
   vizzer.set_vis_inverse(_got_vis_inverse);
   vizzer.set_vis_2d(_got_vis_2d);
 
+  bool got_crop = _got_crop;
+  int crop[4] = { _crop[0], _crop[1], _crop[2], _crop[3] };
   if (_got_autocrop) {
-    _got_crop = file.calc_autocrop(_crop[0], _crop[1], _crop[2], _crop[3]);
+    got_crop = file.calc_autocrop(crop[0], crop[1], crop[2], crop[3]);
   }
 
-  if (_got_crop) {
-    file.apply_crop(_crop[0], _crop[1], _crop[2], _crop[3]);
+  if (got_crop) {
+    file.apply_crop(crop[0], crop[1], crop[2], crop[3]);
   }
 
   if (_got_resize) {
@@ -265,13 +322,7 @@ process_pfm(const Filename &input_filename, PfmFile &file) {
     }
   }
 
-  Filename output_filename;
-  if (_got_output_filename) {
-    output_filename = _output_filename;
-  } else if (_got_output_dirname) {
-    output_filename = Filename(_output_dirname, input_filename.get_basename());
-  }
-
+  Filename output_filename = get_output_filename(input_filename);
   if (!output_filename.empty()) {
     return file.write(output_filename);
   }
@@ -279,6 +330,73 @@ process_pfm(const Filename &input_filename, PfmFile &file) {
   return true;
 }
 
+/**
+ * Sets up the indicated PfmStreamTransform to perform the same operations as
+ * process_pfm().  Returns false if process_pfm() must be used instead.
+ */
+bool PfmTrans::
+make_stream_transform(PfmStreamTransform &stream) const {
+  if (_got_resize || _got_vis_filename || _got_ls_filename ||
+      (!_got_output_filename && !_got_output_dirname)) {
+    return false;
+  }
+
+  if (_got_no_data_nan) {
+    stream.set_no_data_nan(_no_data_nan_num_channels);
+  } else if (_got_zero_special) {
+    stream.set_zero_special(true);
+  }
+
+  if (_got_crop) {
+    stream.set_crop(_crop[0], _crop[1], _crop[2], _crop[3]);
+  }
+  stream.set_autocrop(_got_autocrop);
+
+  int r = (_rotate / 90) % 4;
+  if (r < 0) {
+    r += 4;
+  }
+  switch (r) {
+  case 1:
+    stream.add_flip(true, false, true);
+    break;
+  case 2:
+    stream.add_flip(true, false, false);
+    stream.add_flip(false, true, false);
+    break;
+  case 3:
+    stream.add_flip(false, true, true);
+    break;
+  }
+
+  if (_got_mirror_x) {
+    stream.add_flip(true, false, false);
+  }
+  if (_got_mirror_y) {
+    stream.add_flip(false, true, false);
+  }
+
+  if (_got_transform) {
+    stream.set_transform(LCAST(PN_float32, _transform));
+  }
+
+  return true;
+}
+
+/**
+ * Returns the name of the file to write the processed input file to, or the
+ * empty string if it is not to be written.
+ */
+Filename PfmTrans::
+get_output_filename(const Filename &input_filename) const {
+  if (_got_output_filename) {
+    return _output_filename;
+  } else if (_got_output_dirname) {
+    return Filename(_output_dirname, input_filename.get_basename());
+  }
+  return Filename();
+}
+
 /**
  * Adds -TS, -TT, etc.  as valid options for this program.  If the user
  * specifies one of the options on the command line, the data will be
@@ -22,6 +22,7 @@
 #include "luse.h"
 
 class PfmFile;
+class PfmStreamTransform;
 
 /**
  * Operates on a pfm file.
@@ -32,6 +33,8 @@ public:
 
   void run();
   bool process_pfm(const Filename &input_filename, PfmFile &file);
+  bool make_stream_transform(PfmStreamTransform &stream) const;
+  Filename get_output_filename(const Filename &input_filename) const;
 
   void add_transform_options();
 
@@ -62,6 +65,7 @@ private:
   int _rotate;
   bool _got_mirror_x;
   bool _got_mirror_y;
+  int _num_threads;
 
   bool _got_output_filename;
   Filename _output_filename;
@@ -21,6 +21,7 @@
 #include "eggData.h"
 #include "loaderOptions.h"
 #include "bamCacheRecord.h"
+#include "transformState.h"
 
 TypeHandle LoaderFileTypePandatool::_type_handle;
 
@@ -164,6 +165,19 @@ load_file(const Filename &path, const LoaderOptions &options,
   if (ptloader_load_node && loader->supports_convert_to_node(options)) {
     result = loader->convert_to_node(options, path);
     if (!result.is_null()) {
+      DistanceUnit input_units = loader->get_input_units();
+      if (input_units != DU_invalid && ptloader_units != DU_invalid &&
+          input_units != ptloader_units) {
+        // As below, but the vertices are already built, so the scale goes on
+        // the root node instead.
+        ptloader_cat.info()
+          << "Converting from " << format_long_unit(input_units)
+          << " to " << format_long_unit(ptloader_units) << "\n";
+        double scale = convert_units(input_units, ptloader_units);
+        result->set_transform(TransformState::make_scale(scale)->compose(
+                                result->get_transform()));
+      }
+      delete loader;
       return result;
     }
   }
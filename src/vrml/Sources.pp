@@ -15,9 +15,28 @@
   #define SOURCES \
     parse_vrml.cxx parse_vrml.h \
     standard_nodes.cxx standard_nodes.h \
+    vrmlArena.cxx vrmlArena.h \
+    vrmlFastLexer.cxx vrmlFastLexer.h vrmlFastLexer.I \
     vrmlLexer.lxx \
     vrmlParser.yxx \
     vrmlNode.cxx vrmlNode.h \
     vrmlNodeType.cxx vrmlNodeType.h
 
 #end ss_lib_target
+
+#begin test_bin_target
+  #define TARGET test_vrml_lexers
+  #define LOCAL_LIBS \
+    vrml pandatoolbase
+  #define OTHER_LIBS \
+    mathutil:c linmath:c pipeline:c \
+    panda:m \
+    pandabase:c express:c pandaexpress:m \
+    interrogatedb dtoolutil:c dtoolbase:c prc  dtool:m
+
+  #define USE_PACKAGES zlib
+
+  #define SOURCES \
+    test_vrml_lexers.cxx
+
+#end test_bin_target
@@ -26,6 +26,7 @@
 #include "vrmlParserDefs.h"
 #include "vrmlNodeType.h"
 #include "vrmlNode.h"
+#include "vrmlArena.h"
 #include "standard_nodes.h"
 #include "zStream.h"
 #include "virtualFileSystem.h"
@@ -43,10 +44,12 @@ extern VrmlScene *parsed_scene;
 
 /**
  * Loads the set of standard VRML node definitions into the parser, if it has
- * not already been loaded.
+ * not already been loaded.  This is done only once per session; the standard
+ * node types, and the default values they reference, are kept for the life
+ * of the process.
  */
 static bool
-get_standard_nodes() {
+get_standard_nodes(bool use_flex) {
   static bool got_standard_nodes = false;
   static bool read_ok = true;
   if (got_standard_nodes) {
@@ -68,7 +71,12 @@ get_standard_nodes() {
   istringstream in(data);
 #endif  // HAVE_ZLIB
 
-  vrml_init_parser(in, "standardNodes.wrl");
+  // The default field values of the standard nodes are allocated from an
+  // arena that is never freed.
+  static VrmlArena *standard_arena = new VrmlArena;
+  VrmlArena::set_current(standard_arena);
+
+  vrml_init_parser(in, "standardNodes.wrl", use_flex);
   if (vrmlyyparse() != 0) {
     read_ok = false;
   }
@@ -81,9 +89,13 @@ get_standard_nodes() {
 /**
  * Reads the named VRML file and returns a corresponding VrmlScene, or NULL if
  * there is a parse error.
+ *
+ * The file is normally read with the hand-written VrmlFastLexer; if use_flex
+ * is true, the original flex scanner is used instead.  Both produce the same
+ * scene.
  */
 VrmlScene *
-parse_vrml(Filename filename) {
+parse_vrml(Filename filename, bool use_flex) {
   filename.set_text();
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
   istream *in = vfs->open_read_file(filename, true);
@@ -91,7 +103,7 @@ parse_vrml(Filename filename) {
     nout << "Cannot open " << filename << " for reading.\n";
     return nullptr;
   }
-  VrmlScene *result = parse_vrml(*in, filename);
+  VrmlScene *result = parse_vrml(*in, filename, use_flex);
   vfs->close_read_file(in);
   return result;
 }
@@ -101,8 +113,8 @@ parse_vrml(Filename filename) {
  * NULL if there is a parse error.
  */
 VrmlScene *
-parse_vrml(istream &in, const string &filename) {
-  if (!get_standard_nodes()) {
+parse_vrml(istream &in, const string &filename, bool use_flex) {
+  if (!get_standard_nodes(use_flex)) {
     std::cerr << "Internal error--unable to parse VRML.\n";
     return nullptr;
   }
@@ -110,13 +122,23 @@ parse_vrml(istream &in, const string &filename) {
   VrmlScene *scene = nullptr;
   VrmlNodeType::pushNameSpace();
 
-  vrml_init_parser(in, filename);
+  VrmlArena *arena = new VrmlArena;
+  VrmlArena::set_current(arena);
+
+  vrml_init_parser(in, filename, use_flex);
   if (vrmlyyparse() == 0) {
     scene = parsed_scene;
   }
   vrml_cleanup_parser();
 
   VrmlNodeType::popNameSpace();
+  VrmlArena::set_current(nullptr);
+
+  if (scene != nullptr) {
+    scene->set_arena(arena);
+  } else {
+    delete arena;
+  }
 
   return scene;
 }
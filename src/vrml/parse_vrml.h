@@ -17,7 +17,8 @@
 #include "vrmlNode.h"
 #include "filename.h"
 
-VrmlScene *parse_vrml(Filename filename);
-VrmlScene *parse_vrml(std::istream &in, const std::string &filename);
+VrmlScene *parse_vrml(Filename filename, bool use_flex = false);
+VrmlScene *parse_vrml(std::istream &in, const std::string &filename,
+                      bool use_flex = false);
 
 #endif
@@ -0,0 +1,154 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_vrml_lexers.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandatoolbase.h"
+#include "vrmlParserDefs.h"
+#include "vrmlNodeType.h"
+#include "vrmlArena.h"
+#include "standard_nodes.h"
+#include "zStream.h"
+#include "vector_string.h"
+#include "string_utils.h"
+
+#include <algorithm>
+#include <sstream>
+
+/**
+ * Returns the text of the standardNodes.wrl file compiled into the library.
+ */
+static std::string
+get_standard_nodes_text() {
+  std::string data((const char *)standard_nodes_data, standard_nodes_data_len);
+
+#ifdef HAVE_ZLIB
+  std::istringstream inz(data);
+  IDecompressStream in(&inz, false);
+  std::ostringstream out;
+  out << in.rdbuf();
+  return out.str();
+#else
+  return data;
+#endif  // HAVE_ZLIB
+}
+
+/**
+ * Parses the text with the indicated lexer, and describes each of the node
+ * types it declares, and the types and default values of their fields, one
+ * per line.  The node and field names are taken from a simple scan of the
+ * text.  Returns false if the text can't be parsed.
+ */
+static bool
+describe_nodes(const std::string &text, bool use_flex, std::string &result) {
+  VrmlNodeType::pushNameSpace();
+  VrmlArena *arena = new VrmlArena;
+  VrmlArena::set_current(arena);
+
+  std::istringstream in(text);
+  vrml_init_parser(in, "standardNodes.wrl", use_flex);
+  bool okflag = (vrmlyyparse() == 0);
+  vrml_cleanup_parser();
+
+  std::ostringstream out;
+  std::istringstream lines(text);
+  std::string line;
+  const VrmlNodeType *type = nullptr;
+  while (okflag && std::getline(lines, line)) {
+    vector_string words;
+    extract_words(line, words);
+    if (words.size() < 2 || words[0][0] == '#') {
+      continue;
+    }
+
+    if (words[0] == "PROTO") {
+      type = VrmlNodeType::find(words[1].c_str());
+      if (type == nullptr) {
+        nout << words[1] << " was not declared\n";
+        okflag = false;
+        break;
+      }
+      out << words[1] << "\n";
+      continue;
+    }
+
+    if (type == nullptr || words.size() < 3) {
+      continue;
+    }
+    const VrmlNodeType::NameTypeRec *rec = nullptr;
+    bool has_default = false;
+    if (words[0] == "eventIn") {
+      rec = type->hasEventIn(words[2].c_str());
+    } else if (words[0] == "eventOut") {
+      rec = type->hasEventOut(words[2].c_str());
+    } else if (words[0] == "field" || words[0] == "exposedField") {
+      rec = type->hasField(words[2].c_str());
+      has_default = true;
+    } else {
+      continue;
+    }
+    if (rec == nullptr) {
+      nout << type->getName() << "." << words[2] << " was not declared\n";
+      okflag = false;
+      break;
+    }
+
+    out << "  " << words[0] << " " << rec->type << " " << rec->name;
+    if (has_default) {
+      out << " ";
+      output_value(out, rec->dflt, rec->type);
+    }
+    out << "\n";
+  }
+
+  result = out.str();
+  VrmlNodeType::popNameSpace();
+  VrmlArena::set_current(nullptr);
+  delete arena;
+  return okflag;
+}
+
+/**
+ * Parses standardNodes.wrl with the flex scanner and with VrmlFastLexer, and
+ * checks that both produce the same node types with the same default values.
+ */
+int
+main(int argc, char *argv[]) {
+  std::string text = get_standard_nodes_text();
+
+  std::string flex_result, fast_result;
+  if (!describe_nodes(text, true, flex_result)) {
+    nout << "Unable to parse standardNodes.wrl with flex.\n";
+    return 1;
+  }
+  if (!describe_nodes(text, false, fast_result)) {
+    nout << "Unable to parse standardNodes.wrl with VrmlFastLexer.\n";
+    return 1;
+  }
+
+  if (flex_result != fast_result) {
+    // Report the first line that differs.
+    std::istringstream flex_in(flex_result), fast_in(fast_result);
+    std::string flex_line, fast_line;
+    while (std::getline(flex_in, flex_line) && std::getline(fast_in, fast_line) &&
+           flex_line == fast_line) {
+    }
+    nout << "The lexers disagree:\n"
+         << "  flex: " << flex_line << "\n"
+         << "  fast: " << fast_line << "\n";
+    return 1;
+  }
+
+  nout << "Both lexers agree on "
+       << std::count(fast_result.begin(), fast_result.end(), '\n')
+       << " lines of node declarations.\n";
+  return 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file vrmlArena.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "vrmlArena.h"
+#include "vrmlNode.h"
+#include "vrmlNodeType.h"
+
+#include <new>
+
+VrmlArena *VrmlArena::_current = nullptr;
+
+// The size of each block allocated by the arena.  Larger objects get a block
+// of their own.
+static const size_t vrml_arena_block_size = 65536;
+
+// Every allocation is aligned to this boundary.
+static const size_t vrml_arena_alignment = 16;
+
+/**
+ *
+ */
+VrmlArena::
+VrmlArena() :
+  _next(nullptr),
+  _remaining(0),
+  _num_bytes(0)
+{
+}
+
+/**
+ * Destroys all of the objects allocated from the arena, and frees its memory.
+ */
+VrmlArena::
+~VrmlArena() {
+  for (VrmlNode *node : _nodes) {
+    node->~VrmlNode();
+  }
+  for (MFArray *array : _arrays) {
+    array->~MFArray();
+  }
+  for (char *block : _blocks) {
+    delete[] block;
+  }
+  if (_current == this) {
+    _current = nullptr;
+  }
+}
+
+/**
+ * Allocates and returns a new VrmlNode of the indicated type.
+ */
+VrmlNode *VrmlArena::
+make_node(const VrmlNodeType *type) {
+  VrmlNode *node = new (allocate(sizeof(VrmlNode))) VrmlNode(type);
+  _nodes.push_back(node);
+  return node;
+}
+
+/**
+ * Allocates and returns a new, empty array for a multiple-valued field of the
+ * indicated type (e.g.  MFVEC3F).
+ */
+MFArray *VrmlArena::
+make_array(int type) {
+  MFArray *array = new (allocate(sizeof(MFArray))) MFArray(type);
+  _arrays.push_back(array);
+  return array;
+}
+
+/**
+ * Returns a NUL-terminated copy of the indicated string, allocated from the
+ * arena.
+ */
+char *VrmlArena::
+make_string(const char *str, size_t length) {
+  char *result = (char *)allocate(length + 1);
+  memcpy(result, str, length);
+  result[length] = '\0';
+  return result;
+}
+
+/**
+ * Returns a copy of the indicated NUL-terminated string, allocated from the
+ * arena.
+ */
+char *VrmlArena::
+make_string(const char *str) {
+  return make_string(str, strlen(str));
+}
+
+/**
+ * Returns the total number of bytes the arena has allocated from the system.
+ */
+size_t VrmlArena::
+get_num_bytes() const {
+  return _num_bytes;
+}
+
+/**
+ * Returns the arena from which the VRML lexer and parser are currently
+ * allocating.
+ */
+VrmlArena *VrmlArena::
+get_current() {
+  return _current;
+}
+
+/**
+ * Specifies the arena from which the VRML lexer and parser should allocate.
+ */
+void VrmlArena::
+set_current(VrmlArena *arena) {
+  _current = arena;
+}
+
+/**
+ * Returns a suitably-aligned pointer to the indicated number of bytes.
+ */
+void *VrmlArena::
+allocate(size_t size) {
+  size = (size + vrml_arena_alignment - 1) & ~(vrml_arena_alignment - 1);
+  if (size > _remaining) {
+    size_t block_size = std::max(size, vrml_arena_block_size);
+    char *block = new char[block_size + vrml_arena_alignment];
+    _blocks.push_back(block);
+    _num_bytes += block_size + vrml_arena_alignment;
+
+    // operator new[] doesn't promise our alignment, so adjust for it.
+    uintptr_t start = ((uintptr_t)block + vrml_arena_alignment - 1) &
+      ~(uintptr_t)(vrml_arena_alignment - 1);
+    _next = (char *)start;
+    _remaining = block_size;
+  }
+
+  void *result = _next;
+  _next += size;
+  _remaining -= size;
+  return result;
+}
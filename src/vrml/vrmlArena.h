@@ -0,0 +1,63 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file vrmlArena.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef VRMLARENA_H
+#define VRMLARENA_H
+
+#include "pandatoolbase.h"
+#include "pvector.h"
+
+class VrmlNode;
+class VrmlNodeType;
+class MFArray;
+
+/**
+ * Owns all of the nodes, multiple-valued field arrays and strings created
+ * while parsing a VRML file.  These are carved out of large blocks, rather
+ * than allocated one at a time, and are all freed together when the arena is
+ * destroyed along with the VrmlScene that owns it.
+ *
+ * While a file is being parsed, the lexer and parser allocate from the
+ * arena returned by get_current().
+ */
+class VrmlArena {
+public:
+  VrmlArena();
+  ~VrmlArena();
+
+  VrmlNode *make_node(const VrmlNodeType *type);
+  MFArray *make_array(int type);
+  char *make_string(const char *str, size_t length);
+  char *make_string(const char *str);
+
+  size_t get_num_bytes() const;
+
+  static VrmlArena *get_current();
+  static void set_current(VrmlArena *arena);
+
+private:
+  void *allocate(size_t size);
+
+  typedef pvector<char *> Blocks;
+  Blocks _blocks;
+  char *_next;
+  size_t _remaining;
+  size_t _num_bytes;
+
+  pvector<VrmlNode *> _nodes;
+  pvector<MFArray *> _arrays;
+
+  static VrmlArena *_current;
+};
+
+#endif
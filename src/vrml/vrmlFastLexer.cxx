@@ -0,0 +1,850 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file vrmlFastLexer.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "vrmlFastLexer.h"
+#include "vrmlLexerDefs.h"
+#include "vrmlNode.h"
+#include "vrmlArena.h"
+#include "vrmlParser.h"
+#include "pstrtod.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+using std::string;
+
+// This is defined in vrmlLexer.lxx; the parser sets it to the type of field
+// value it expects next.
+extern int expectToken;
+
+// The size of the block read from the input stream at a time.  The buffer
+// grows beyond this only if a single token is larger than half of it.
+static const size_t buffer_size = 65536;
+
+// The longest portion of a line that is reported with an error.
+static const size_t max_error_width = 1024;
+
+// The number of characters that must be in the buffer beyond the end of a
+// token, or beyond the start of a field value, for the scanning functions
+// below to decide what is there without running off the end of the buffer.
+static const ptrdiff_t max_lookahead = 8;
+
+static const struct {
+  const char *_name;
+  size_t _length;
+  int _token;
+} keywords[] = {
+  { "PROTO", 5, PROTO },
+  { "EXTERNPROTO", 11, EXTERNPROTO },
+  { "DEF", 3, DEF },
+  { "USE", 3, USE },
+  { "TO", 2, TO },
+  { "IS", 2, IS },
+  { "ROUTE", 5, ROUTE },
+  { "NULL", 4, SFN_NULL },
+  { "eventIn", 7, EVENTIN },
+  { "eventOut", 8, EVENTOUT },
+  { "field", 5, FIELD },
+  { "exposedField", 12, EXPOSEDFIELD },
+};
+static const int num_keywords = sizeof(keywords) / sizeof(keywords[0]);
+
+/**
+ * Returns true if the character may appear within an identifier; this
+ * corresponds to idRestChar in vrmlLexer.lxx.  The NUL that terminates the
+ * buffer is not an identifier character.
+ */
+static inline bool
+is_id_rest(unsigned char c) {
+  return c > 0x20 && c != 0x22 && c != 0x23 && c != 0x27 &&
+    c != 0x2b && c != 0x2c && c != 0x2e &&
+    (c < 0x5b || c > 0x5d) && c != 0x7b && c != 0x7d;
+}
+
+/**
+ * Returns true if the character may begin an identifier; this corresponds to
+ * idStartChar in vrmlLexer.lxx.  Note that identifiers beginning with a digit
+ * are also accepted, since Form-Z writes them.
+ */
+static inline bool
+is_id_start(unsigned char c) {
+  return is_id_rest(c) && c != 0x2d && (c < '0' || c > '9');
+}
+
+/**
+ *
+ */
+static inline bool
+is_digit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+/**
+ *
+ */
+static inline bool
+is_hex_digit(char c) {
+  return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/**
+ * Returns the end of the integer that begins at p, or NULL if there is no
+ * integer there.  This matches the {int} pattern of vrmlLexer.lxx: decimal,
+ * or hex with a leading 0x.
+ */
+static inline char *
+scan_int(char *p) {
+  if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+    p += 2;
+    while (is_hex_digit(*p)) {
+      ++p;
+    }
+    return p;
+  }
+
+  if (*p == '-') {
+    ++p;
+  }
+  char *digits = p;
+  while (is_digit(*p)) {
+    ++p;
+  }
+  return (p != digits) ? p : nullptr;
+}
+
+/**
+ * Returns the end of the floating-point number that begins at p, or NULL if
+ * there is no number there.  This matches the {float} pattern of
+ * vrmlLexer.lxx.
+ */
+static inline char *
+scan_float(char *p) {
+  if (*p == '-') {
+    ++p;
+  }
+  char *digits = p;
+  while (is_digit(*p)) {
+    ++p;
+  }
+  if (*p == '.' && is_digit(p[1])) {
+    p += 2;
+    while (is_digit(*p)) {
+      ++p;
+    }
+  } else if (p == digits) {
+    return nullptr;
+  }
+
+  if (*p == 'e' || *p == 'E') {
+    char *q = p + 1;
+    if (*q == '+' || *q == '-') {
+      ++q;
+    }
+    if (is_digit(*q)) {
+      p = q + 1;
+      while (is_digit(*p)) {
+        ++p;
+      }
+    }
+  }
+  return p;
+}
+
+/**
+ * Returns the end of the identifier that begins at p.
+ */
+static inline char *
+scan_word(char *p) {
+  while (is_id_rest(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+/**
+ *
+ */
+VrmlFastLexer::
+VrmlFastLexer(std::istream &in) :
+  _in(in),
+  _buffer(buffer_size + 1)
+{
+  _p = &_buffer[0];
+  _end = _p;
+  *_end = '\0';
+  _eof = false;
+
+  _line_number = 1;
+  _line_start = _p;
+}
+
+/**
+ * Returns the next token from the input, in the same way as the flex
+ * scanner's vrmlyylex(): multiple-valued fields other than MFNode are read
+ * completely, and returned to the parser as a single token.  Returns 0 at the
+ * end of the input.
+ */
+int VrmlFastLexer::
+get_token() {
+  if (expectToken == MFNODE || expectToken == SFNODE) {
+    // The parser reads the contents of SFNode and MFNode fields itself; the
+    // lexer just returns the marker token.
+    int token = expectToken;
+    expectToken = 0;
+    return token;
+  }
+
+  skip_space();
+  if (_p == _end) {
+    return 0;
+  }
+
+  if (expectToken != 0) {
+    return read_field_value(expectToken);
+  }
+  return read_node_token();
+}
+
+/**
+ * Returns the portion of the line currently being scanned that is reported
+ * with an error.
+ */
+string VrmlFastLexer::
+get_current_line() const {
+  if (_line_start == nullptr) {
+    // The start of the line has already been discarded from the buffer.
+    return _saved_line;
+  }
+
+  const char *line_end = _line_start;
+  while (line_end < _end && *line_end != '\n' &&
+         (size_t)(line_end - _line_start) < max_error_width) {
+    ++line_end;
+  }
+  return string(_line_start, line_end);
+}
+
+/**
+ * Reads a token in the normal state, in which nodes are being parsed: a
+ * keyword, an identifier, or a single punctuation character.
+ */
+int VrmlFastLexer::
+read_node_token() {
+  unsigned char c = *_p;
+  if (!is_id_start(c) && !is_digit(c)) {
+    return read_char();
+  }
+
+  char *end = scan_word(_p);
+  while (_end - end < max_lookahead && !_eof) {
+    fill();
+    end = scan_word(_p);
+  }
+
+  size_t length = end - _p;
+  for (int i = 0; i < num_keywords; ++i) {
+    if (keywords[i]._length == length &&
+        memcmp(keywords[i]._name, _p, length) == 0) {
+      _p = end;
+      return keywords[i]._token;
+    }
+  }
+
+  // The parser frees identifiers with free().
+  char *str = (char *)malloc(length + 1);
+  memcpy(str, _p, length);
+  str[length] = '\0';
+  vrmlyylval.string = str;
+  _p = end;
+  return IDENTIFIER;
+}
+
+/**
+ * Reads the value of a field of the indicated type, which the parser has
+ * told us to expect.
+ */
+int VrmlFastLexer::
+read_field_value(int type) {
+  if (_end - _p < max_lookahead && !_eof) {
+    fill();
+  }
+
+  // Any field may have an IS declaration instead of a value.
+  if (_p[0] == 'I' && _p[1] == 'S' && !is_id_rest(_p[2])) {
+    _p += 2;
+    expectToken = 0;
+    return IS;
+  }
+
+  switch (type) {
+  case SFBOOL:
+    if (strncmp(_p, "TRUE", 4) == 0) {
+      _p += 4;
+      expectToken = 0;
+      vrmlyylval.fv._sfbool = true;
+      return SFBOOL;
+
+    } else if (strncmp(_p, "FALSE", 5) == 0) {
+      _p += 5;
+      expectToken = 0;
+      vrmlyylval.fv._sfbool = false;
+      return SFBOOL;
+    }
+    break;
+
+  case SFINT32:
+    {
+      int value;
+      if (read_int(value)) {
+        expectToken = 0;
+        vrmlyylval.fv._sfint32 = value;
+        return SFINT32;
+      }
+    }
+    break;
+
+  case SFFLOAT:
+  case SFTIME:
+    if (read_float(vrmlyylval.fv._sffloat)) {
+      expectToken = 0;
+      return type;
+    }
+    break;
+
+  case SFVEC2F:
+    if (read_vec(vrmlyylval.fv._sfvec, 2)) {
+      expectToken = 0;
+      return type;
+    }
+    break;
+
+  case SFVEC3F:
+  case SFCOLOR:
+    if (read_vec(vrmlyylval.fv._sfvec, 3)) {
+      expectToken = 0;
+      return type;
+    }
+    break;
+
+  case SFROTATION:
+    if (read_vec(vrmlyylval.fv._sfvec, 4)) {
+      expectToken = 0;
+      return type;
+    }
+    break;
+
+  case SFSTRING:
+    expectToken = 0;
+    if (*_p == '"') {
+      ++_p;
+      if (!read_string()) {
+        return 0;
+      }
+      vrmlyylval.fv._sfstring = VrmlArena::get_current()->make_string
+        (_string.data(), _string.length());
+    } else {
+      skip_bad_string();
+      vrmlyyerror("String missing open-quote");
+      vrmlyylval.fv._sfstring = VrmlArena::get_current()->make_string("");
+    }
+    return SFSTRING;
+
+  case SFIMAGE:
+    return read_sf_image();
+
+  case MFCOLOR:
+  case MFFLOAT:
+  case MFINT32:
+  case MFROTATION:
+  case MFSTRING:
+  case MFVEC2F:
+  case MFVEC3F:
+    {
+      MFArray *array = VrmlArena::get_current()->make_array(type);
+      if (*_p == '[') {
+        ++_p;
+        return read_mf_list(type, array);
+
+      } else if (*_p == ']') {
+        ++_p;
+        vrmlyyerror("Unmatched ]");
+
+      } else if (!read_mf_element(type, array)) {
+        // No open bracket means a single value.
+        if (type != MFSTRING) {
+          break;
+        }
+        skip_bad_string();
+        vrmlyyerror("String missing open-quote");
+      }
+
+      expectToken = 0;
+      vrmlyylval.fv._mf = array;
+      return type;
+    }
+
+  default:
+    vrmlyyerror("ACK: Bad expectToken");
+    expectToken = 0;
+    return read_node_token();
+  }
+
+  return read_char();
+}
+
+/**
+ * Reads the values of a multiple-valued field, following the open bracket,
+ * up to and including the close bracket, and returns the field as a single
+ * token.
+ *
+ * This is the bulk path for numeric lists: each type has its own loop,
+ * which appends straight to the array.
+ */
+int VrmlFastLexer::
+read_mf_list(int type, MFArray *array) {
+  switch (type) {
+  case MFINT32:
+    {
+      int value;
+      for (;;) {
+        skip_space();
+        if (!read_int(value)) {
+          break;
+        }
+        array->add_int(value);
+      }
+    }
+    break;
+
+  case MFFLOAT:
+    {
+      double value;
+      for (;;) {
+        skip_space();
+        if (!read_float(value)) {
+          break;
+        }
+        array->add_float(value);
+      }
+    }
+    break;
+
+  case MFVEC2F:
+  case MFVEC3F:
+  case MFCOLOR:
+  case MFROTATION:
+    {
+      int num_components = array->get_stride();
+      double value[4];
+      for (;;) {
+        skip_space();
+        if (!read_vec(value, num_components)) {
+          break;
+        }
+        array->add_vec(value);
+      }
+    }
+    break;
+
+  case MFSTRING:
+    for (;;) {
+      skip_space();
+      if (*_p != '"') {
+        break;
+      }
+      ++_p;
+      if (!read_string()) {
+        return 0;
+      }
+      VrmlFieldValue v;
+      v._sfstring = VrmlArena::get_current()->make_string
+        (_string.data(), _string.length());
+      array->add_value(v);
+    }
+    break;
+  }
+
+  if (*_p == ']') {
+    ++_p;
+
+  } else if (type == MFSTRING && _p != _end && *_p != '[') {
+    skip_bad_string();
+    vrmlyyerror("String missing open-quote");
+
+  } else {
+    // Something other than a value in the list; the parser will report it.
+    return read_char();
+  }
+
+  expectToken = 0;
+  vrmlyylval.fv._mf = array;
+  return type;
+}
+
+/**
+ * Reads a single value of a multiple-valued field and appends it to the
+ * array.  Returns true on success, or false if there is not a value of the
+ * appropriate type next in the input.
+ */
+bool VrmlFastLexer::
+read_mf_element(int type, MFArray *array) {
+  switch (type) {
+  case MFINT32:
+    {
+      int value;
+      if (read_int(value)) {
+        array->add_int(value);
+        return true;
+      }
+    }
+    break;
+
+  case MFFLOAT:
+    {
+      double value;
+      if (read_float(value)) {
+        array->add_float(value);
+        return true;
+      }
+    }
+    break;
+
+  case MFVEC2F:
+  case MFVEC3F:
+  case MFCOLOR:
+  case MFROTATION:
+    {
+      double value[4];
+      if (read_vec(value, array->get_stride())) {
+        array->add_vec(value);
+        return true;
+      }
+    }
+    break;
+
+  case MFSTRING:
+    if (*_p == '"') {
+      ++_p;
+      if (read_string()) {
+        VrmlFieldValue v;
+        v._sfstring = VrmlArena::get_current()->make_string
+          (_string.data(), _string.length());
+        array->add_value(v);
+        return true;
+      }
+    }
+    break;
+  }
+
+  return false;
+}
+
+/**
+ * Reads an SFImage value: the width, height and number of components,
+ * followed by one integer per pixel.  As in the flex scanner, the pixels are
+ * skipped over, not stored.
+ */
+int VrmlFastLexer::
+read_sf_image() {
+  int width, height;
+  if (!read_int(width) || !skip_space() || !read_int(height)) {
+    return read_char();
+  }
+
+  int num_ints = 1 + width * height;
+  for (int i = 0; i < num_ints; ++i) {
+    int value;
+    skip_space();
+    if (!read_int(value)) {
+      return read_char();
+    }
+  }
+
+  expectToken = 0;
+  return SFIMAGE;
+}
+
+/**
+ * Consumes the next character and returns it as a token, as the flex
+ * scanner's catch-all rule does.  Returns 0 at the end of the input.
+ */
+int VrmlFastLexer::
+read_char() {
+  if (_p == _end) {
+    return 0;
+  }
+  return *_p++;
+}
+
+/**
+ * Skips over whitespace, commas, newlines and comments.  Returns true if
+ * anything was skipped, false if the next character is not whitespace.
+ * Either way, on return there is at least one character in the buffer, or
+ * the end of the input has been reached.
+ */
+bool VrmlFastLexer::
+skip_space() {
+  bool skipped = false;
+  for (;;) {
+    char c = *_p;
+    if (c == ' ' || c == ',' || c == '\t' || c == '\r') {
+      ++_p;
+
+    } else if (c == '\n') {
+      ++_p;
+      ++_line_number;
+      _line_start = _p;
+
+    } else if (c == '#') {
+      // A comment extends to the end of the line.
+      while (*_p != '\n') {
+        if (_p == _end) {
+          if (!fill()) {
+            return true;
+          }
+        } else {
+          ++_p;
+        }
+      }
+
+    } else if (_p == _end && !_eof) {
+      fill();
+      continue;
+
+    } else {
+      return skipped;
+    }
+    skipped = true;
+  }
+}
+
+/**
+ * Skips over the unquoted word that was found where a string was expected,
+ * so that the error can be reported once.
+ */
+void VrmlFastLexer::
+skip_bad_string() {
+  for (;;) {
+    char c = *_p;
+    if (c == ' ' || c == '"' || c == '\t' || c == '\r' || c == ',' ||
+        c == '\n' || c == '[' || c == ']') {
+      return;
+    }
+    if (_p == _end) {
+      if (!fill()) {
+        return;
+      }
+    } else {
+      ++_p;
+    }
+  }
+}
+
+/**
+ * Reads an integer, if there is one next in the input.  Returns true on
+ * success, or false if there is no integer there, in which case nothing is
+ * consumed.
+ */
+bool VrmlFastLexer::
+read_int(int &value) {
+  char *end = scan_int(_p);
+  while (_end - (end != nullptr ? end : _p) < max_lookahead && !_eof) {
+    // The number might continue past the end of the buffer.
+    fill();
+    end = scan_int(_p);
+  }
+  if (end == nullptr) {
+    return false;
+  }
+
+  // The common case, a short decimal number, is converted here; anything
+  // else goes through strtol(), as in the flex scanner, so that hex and
+  // octal numbers come out the same.
+  const char *p = _p;
+  bool negative = (*p == '-');
+  if (negative) {
+    ++p;
+  }
+  if ((*p != '0' || end - p == 1) && end - p <= 9) {
+    int result = 0;
+    while (p < end) {
+      result = result * 10 + (*p - '0');
+      ++p;
+    }
+    value = negative ? -result : result;
+
+  } else {
+    char save = *end;
+    *end = '\0';
+    value = (int)strtol(_p, nullptr, 0);
+    *end = save;
+  }
+
+  _p = end;
+  return true;
+}
+
+/**
+ * Reads a floating-point number, if there is one next in the input.  Returns
+ * true on success, or false if there is no number there, in which case
+ * nothing is consumed.
+ */
+bool VrmlFastLexer::
+read_float(double &value) {
+  char *end = scan_float(_p);
+  while (_end - (end != nullptr ? end : _p) < max_lookahead && !_eof) {
+    // The number might continue past the end of the buffer.
+    fill();
+    end = scan_float(_p);
+  }
+  if (end == nullptr) {
+    return false;
+  }
+
+  // Terminate the number where the {float} pattern ends, so that pstrtod()
+  // sees exactly what the flex scanner would have passed to it.
+  char save = *end;
+  *end = '\0';
+  value = pstrtod(_p, nullptr);
+  *end = save;
+
+  _p = end;
+  return true;
+}
+
+/**
+ * Reads the indicated number of floating-point numbers, which must be
+ * separated by whitespace.  Returns true on success, false if they are not
+ * all there.
+ */
+bool VrmlFastLexer::
+read_vec(double vec[], int num_components) {
+  if (!read_float(vec[0])) {
+    return false;
+  }
+  for (int i = 1; i < num_components; ++i) {
+    if (!skip_space() || !read_float(vec[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Reads a quoted string, following the open quote, up to and including the
+ * close quote, and stores it in _string.  Returns false if the input ends
+ * first.
+ *
+ * As in the flex scanner, a backslashed quote is stored as a quote, other
+ * backslashes are kept, and newlines within the string are dropped.
+ */
+bool VrmlFastLexer::
+read_string() {
+  _string.clear();
+  for (;;) {
+    const char *start = _p;
+    while (*_p != '"' && *_p != '\\' && *_p != '\n' && *_p != '\0') {
+      ++_p;
+    }
+    _string.append(start, _p - start);
+
+    switch (*_p) {
+    case '"':
+      ++_p;
+      return true;
+
+    case '\n':
+      ++_p;
+      ++_line_number;
+      _line_start = _p;
+      break;
+
+    case '\\':
+      if (_end - _p < 2 && !_eof) {
+        fill();
+      } else if (_p[1] == '"' || _p[1] == '\\') {
+        // A backslashed backslash is kept as it is, but it can't escape the
+        // character that follows it.
+        if (_p[1] == '\\') {
+          _string += '\\';
+        }
+        _string += _p[1];
+        _p += 2;
+      } else {
+        _string += '\\';
+        ++_p;
+      }
+      break;
+
+    default:
+      if (_p != _end) {
+        // A NUL character within the file.
+        ++_p;
+      } else if (!fill()) {
+        return false;
+      }
+    }
+  }
+}
+
+/**
+ * Reads the next block of the input stream into the buffer, keeping the
+ * characters that have not yet been scanned.  Returns true if anything was
+ * read, or false at the end of the input.
+ */
+bool VrmlFastLexer::
+fill() {
+  if (_eof) {
+    return false;
+  }
+
+  size_t keep = _end - _p;
+  size_t line_offset = 0;
+  if (_line_start != nullptr) {
+    if (_line_start < _p) {
+      // Save the start of the current line before it is discarded, in case
+      // we need to report an error on it.
+      _saved_line = get_current_line();
+      _line_start = nullptr;
+    } else {
+      line_offset = _line_start - _p;
+    }
+  }
+
+  size_t capacity = _buffer.size() - 1;
+  if (keep > capacity / 2) {
+    // A single token fills most of the buffer; make room for more.
+    pvector<char> new_buffer(capacity * 2 + 1);
+    memcpy(&new_buffer[0], _p, keep);
+    _buffer.swap(new_buffer);
+    capacity = _buffer.size() - 1;
+  } else if (keep != 0) {
+    memmove(&_buffer[0], _p, keep);
+  }
+
+  _p = &_buffer[0];
+  if (_line_start != nullptr) {
+    _line_start = _p + line_offset;
+  }
+
+  _in.read(_p + keep, capacity - keep);
+  size_t count = _in.gcount();
+  _end = _p + keep + count;
+  *_end = '\0';
+
+  if (count == 0) {
+    _eof = true;
+    return false;
+  }
+  return true;
+}
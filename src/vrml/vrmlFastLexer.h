@@ -0,0 +1,73 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file vrmlFastLexer.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef VRMLFASTLEXER_H
+#define VRMLFASTLEXER_H
+
+#include "pandatoolbase.h"
+#include "pvector.h"
+
+class MFArray;
+
+/**
+ * A hand-written lexer for VRML 2.0 files, which returns the same tokens to
+ * the parser as the flex scanner in vrmlLexer.lxx, and which is used in its
+ * place unless the flex scanner is specifically requested.
+ *
+ * It scans directly out of a large block read from the input stream, rather
+ * than matching one token at a time, and it reads an entire bracketed list
+ * of numbers in a single call, straight into the typed storage of the
+ * MFArray.  This is where most of the time goes in a large file.
+ */
+class VrmlFastLexer {
+public:
+  VrmlFastLexer(std::istream &in);
+
+  int get_token();
+
+  INLINE int get_line_number() const;
+  std::string get_current_line() const;
+
+private:
+  int read_node_token();
+  int read_field_value(int type);
+  int read_mf_list(int type, MFArray *array);
+  bool read_mf_element(int type, MFArray *array);
+  int read_sf_image();
+  int read_char();
+
+  bool skip_space();
+  void skip_bad_string();
+  bool read_int(int &value);
+  bool read_float(double &value);
+  bool read_vec(double vec[], int num_components);
+  bool read_string();
+
+  bool fill();
+
+  std::istream &_in;
+  pvector<char> _buffer;
+  char *_p;
+  char *_end;
+  bool _eof;
+
+  int _line_number;
+  const char *_line_start;
+  std::string _saved_line;
+
+  std::string _string;
+};
+
+#include "vrmlFastLexer.I"
+
+#endif
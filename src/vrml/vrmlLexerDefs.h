@@ -16,7 +16,9 @@
 
 #include "pandatoolbase.h"
 
-void vrml_init_lexer(std::istream &in, const std::string &filename);
+void vrml_init_lexer(std::istream &in, const std::string &filename,
+                     bool use_flex);
+void vrml_cleanup_lexer();
 int vrml_error_count();
 int vrml_warning_count();
 
@@ -12,6 +12,7 @@
  */
 
 #include "vrmlNode.h"
+#include "vrmlArena.h"
 #include "vrmlParser.h"
 
 #include "indent.h"
@@ -70,6 +71,22 @@ output(std::ostream &out, int indent) const {
   output_value(out, v, SFNODE, indent);
 }
 
+VrmlScene::
+VrmlScene() : _arena(nullptr) {
+}
+
+VrmlScene::
+~VrmlScene() {
+  delete _arena;
+}
+
+// Gives the scene ownership of the arena its nodes were allocated from.
+void VrmlScene::
+set_arena(VrmlArena *arena) {
+  delete _arena;
+  _arena = arena;
+}
+
 std::ostream &operator << (std::ostream &out, const VrmlScene &scene) {
   VrmlScene::const_iterator si;
   for (si = scene.begin(); si != scene.end(); ++si) {
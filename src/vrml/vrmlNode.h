@@ -63,7 +63,21 @@ inline std::ostream &operator << (std::ostream &out, const Declaration &dec) {
   return out;
 }
 
-typedef pvector<Declaration> VrmlScene;
+class VrmlArena;
+
+// The result of parsing a VRML file.  The scene owns the arena from which
+// all of its nodes were allocated, so deleting the scene frees everything.
+class VrmlScene : public pvector<Declaration> {
+public:
+  VrmlScene();
+  ~VrmlScene();
+
+  void set_arena(VrmlArena *arena);
+  VrmlArena *get_arena() const { return _arena; }
+
+private:
+  VrmlArena *_arena;
+};
 
 std::ostream &operator << (std::ostream &out, const VrmlScene &scene);
 
@@ -28,6 +28,100 @@ using std::ostream;
 //
 plist<VrmlNodeType*> VrmlNodeType::typeList;
 
+MFArray::
+MFArray(int type) :
+  _type(type),
+  _storage(S_values),
+  _stride(1)
+{
+  switch (type) {
+  case MFINT32:
+    _storage = S_ints;
+    break;
+
+  case MFFLOAT:
+    _storage = S_doubles;
+    break;
+
+  case MFVEC2F:
+    _storage = S_doubles;
+    _stride = 2;
+    break;
+
+  case MFVEC3F:
+  case MFCOLOR:
+    _storage = S_doubles;
+    _stride = 3;
+    break;
+
+  case MFROTATION:
+    _storage = S_doubles;
+    _stride = 4;
+    break;
+
+  default:
+    break;
+  }
+}
+
+size_t MFArray::
+size() const {
+  switch (_storage) {
+  case S_ints:
+    return _ints.size();
+
+  case S_doubles:
+    return _doubles.size() / _stride;
+
+  default:
+    return _values.size();
+  }
+}
+
+void MFArray::
+reserve(size_t num_elements) {
+  switch (_storage) {
+  case S_ints:
+    _ints.reserve(num_elements);
+    break;
+
+  case S_doubles:
+    _doubles.reserve(num_elements * _stride);
+    break;
+
+  default:
+    _values.reserve(num_elements);
+    break;
+  }
+}
+
+// Returns the nth element of the array as a VrmlFieldValue of the
+// corresponding single-valued type, regardless of how it is stored.
+VrmlFieldValue MFArray::
+get_element(size_t n) const {
+  VrmlFieldValue value;
+  switch (_storage) {
+  case S_ints:
+    value._sfint32 = _ints[n];
+    break;
+
+  case S_doubles:
+    if (_stride == 1) {
+      value._sffloat = _doubles[n];
+    } else {
+      for (int i = 0; i < _stride; ++i) {
+        value._sfvec[i] = _doubles[n * _stride + i];
+      }
+    }
+    break;
+
+  default:
+    value = _values[n];
+    break;
+  }
+  return value;
+}
+
 static ostream &
 output_array(ostream &out, const MFArray *mf,
              int type, int indent_level, int items_per_row) {
@@ -35,14 +129,14 @@ output_array(ostream &out, const MFArray *mf,
     out << "[ ]";
   } else {
     out << "[";
-    MFArray::const_iterator mi;
     int col = 0;
-    for (mi = mf->begin(); mi != mf->end(); ++mi) {
+    size_t num_elements = mf->size();
+    for (size_t n = 0; n < num_elements; ++n) {
       if (col == 0) {
         out << "\n";
         indent(out, indent_level + 2);
       }      
-      output_value(out, (*mi), type, indent_level + 2);
+      output_value(out, mf->get_element(n), type, indent_level + 2);
       if (++col >= items_per_row) {
         col = 0;
       } else {
@@ -22,6 +22,7 @@
 #include "pvector.h"
 
 class VrmlNode;
+class MFArray;
 
 struct SFNodeRef {
   VrmlNode *_p;
@@ -36,10 +37,59 @@ union VrmlFieldValue {
   char *_sfstring;
   double _sfvec[4];
   SFNodeRef _sfnode;
-  pvector<VrmlFieldValue> *_mf;
+  MFArray *_mf;
 };
 
-typedef pvector<VrmlFieldValue> MFArray;
+// The value of a multiple-valued field.  The numeric field types are stored
+// in one contiguous array each, rather than as a VrmlFieldValue per element:
+// MFInt32 as ints, and MFFloat, MFVec2f, MFVec3f, MFColor and MFRotation as
+// doubles, get_stride() to an element.  MFString and MFNode are stored as a
+// list of VrmlFieldValues.
+class MFArray {
+public:
+  MFArray(int type = 0);
+
+  int get_type() const { return _type; }
+  int get_stride() const { return _stride; }
+
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+  void reserve(size_t num_elements);
+
+  // For MFString and MFNode.
+  const VrmlFieldValue &get_value(size_t n) const { return _values[n]; }
+  VrmlFieldValue &modify_value(size_t n) { return _values[n]; }
+  void add_value(const VrmlFieldValue &value) { _values.push_back(value); }
+
+  // For MFInt32.
+  int get_int(size_t n) const { return _ints[n]; }
+  const int *get_ints() const { return _ints.empty() ? nullptr : &_ints[0]; }
+  void add_int(int value) { _ints.push_back(value); }
+
+  // For MFFloat, MFVec2f, MFVec3f, MFColor and MFRotation.
+  double get_float(size_t n) const { return _doubles[n]; }
+  const double *get_vec(size_t n) const { return &_doubles[n * _stride]; }
+  void add_float(double value) { _doubles.push_back(value); }
+  void add_vec(const double *vec) {
+    _doubles.insert(_doubles.end(), vec, vec + _stride);
+  }
+
+  VrmlFieldValue get_element(size_t n) const;
+
+private:
+  enum Storage {
+    S_values,
+    S_ints,
+    S_doubles,
+  };
+
+  int _type;
+  Storage _storage;
+  int _stride;
+  pvector<VrmlFieldValue> _values;
+  pvector<int> _ints;
+  pvector<double> _doubles;
+};
 
 
 std::ostream &output_value(std::ostream &out, const VrmlFieldValue &value, int type,
@@ -16,7 +16,8 @@
 
 #include "pandatoolbase.h"
 
-void vrml_init_parser(std::istream &in, const std::string &filename);
+void vrml_init_parser(std::istream &in, const std::string &filename,
+                      bool use_flex);
 void vrml_cleanup_parser();
 int vrmlyyparse();
 
@@ -13,11 +13,11 @@
   #define SOURCES \
     indexedFaceSet.cxx indexedFaceSet.h \
     vrmlAppearance.cxx vrmlAppearance.h \
-    vrmlToEggConverter.cxx vrmlToEggConverter.h
+    vrmlToEggConverter.cxx vrmlToEggConverter.h vrmlToEggConverter.I
 
   #define INSTALL_HEADERS \
     indexedFaceSet.h \
     vrmlAppearance.h \
-    vrmlToEggConverter.h
+    vrmlToEggConverter.h vrmlToEggConverter.I
 
 #end ss_lib_target
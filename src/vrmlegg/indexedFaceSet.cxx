@@ -21,6 +21,8 @@
 #include "eggVertex.h"
 #include "eggVertexPool.h"
 #include "eggPolygon.h"
+#include "nodeGeomBuilder.h"
+#include "cullFaceAttrib.h"
 
 using std::cerr;
 
@@ -59,6 +61,70 @@ convert_to_egg(EggGroup *group, const LMatrix4d &net_transform) {
   }
 }
 
+/**
+ * Adds the polygons to the indicated NodeGeomBuilder, for convert_to_node(),
+ * applying the same color and normal rules as convert_to_egg().  The
+ * vertices are left in the coordinate space of the Shape.
+ */
+void IndexedFaceSet::
+convert_to_node(NodeGeomBuilder &builder, const RenderState *state) {
+  bool ccw = _geometry->get_value("ccw")._sfbool;
+  bool solid = _geometry->get_value("solid")._sfbool;
+
+  CPT(RenderState) poly_state = state;
+  if (!solid) {
+    poly_state = state->add_attrib(CullFaceAttrib::make(CullFaceAttrib::M_cull_none));
+  }
+
+  // Any normals that the file doesn't give are computed by the builder,
+  // smoothed across the creaseAngle as in compute_normals().
+  double smooth_angle = 0.0;
+  if (_geometry->get_value("normal")._sfnode._p == nullptr) {
+    smooth_angle = rad_2_deg(_geometry->get_value("creaseAngle")._sffloat);
+  }
+
+  pvector<NodeGeomBuilder::Vertex> vertices;
+  for (size_t pi = 0; pi < _polys.size(); pi++) {
+    const VrmlPolygon &vpoly = _polys[pi];
+    int num_vertices = (int)vpoly._verts.size();
+    if (num_vertices < 3) {
+      continue;
+    }
+
+    bool has_color = vpoly._attrib.has_color();
+    LColor color = vpoly._attrib.get_color();
+    if (!has_color && _appearance._has_material) {
+      has_color = true;
+      color = _appearance._color;
+    }
+
+    vertices.clear();
+    for (int i = 0; i < num_vertices; i++) {
+      // If the vertices are clockwise, add 'em in reverse order.
+      const VrmlVertex &vv = vpoly._verts[ccw ? i : num_vertices - 1 - i];
+      NodeGeomBuilder::Vertex vertex(vv._pos);
+
+      if (vv._attrib.has_normal()) {
+        vertex.set_normal(vv._attrib.get_normal());
+      } else if (vpoly._attrib.has_normal()) {
+        vertex.set_normal(vpoly._attrib.get_normal());
+      }
+      if (vv._attrib.has_uv()) {
+        vertex.set_uv(vv._attrib.get_uv());
+      }
+      if (vv._attrib.has_color()) {
+        vertex.set_color(vv._attrib.get_color());
+      } else if (has_color) {
+        vertex.set_color(color);
+      }
+
+      vertices.push_back(vertex);
+    }
+
+    builder.add_polygon(poly_state, &vertices[0], num_vertices, smooth_angle);
+  }
+}
+
 
 /**
  *
@@ -69,9 +135,10 @@ get_coord_values() {
 
   if (coord != nullptr) {
     const MFArray *point = coord->get_value("point")._mf;
-    MFArray::const_iterator ci;
-    for (ci = point->begin(); ci != point->end(); ++ci) {
-      const double *p = (*ci)._sfvec;
+    size_t num_points = point->size();
+    _coord_values.reserve(num_points);
+    for (size_t i = 0; i < num_points; ++i) {
+      const double *p = point->get_vec(i);
       _coord_values.push_back(LVertexd(p[0], p[1], p[2]));
     }
   }
@@ -86,15 +153,16 @@ get_polys() {
   const MFArray *coordIndex = _geometry->get_value("coordIndex")._mf;
   VrmlPolygon poly;
 
-  MFArray::const_iterator ci;
-  for (ci = coordIndex->begin(); ci != coordIndex->end(); ++ci) {
-    if ((*ci)._sfint32 < 0) {
+  size_t num_indices = coordIndex->size();
+  for (size_t i = 0; i < num_indices; ++i) {
+    int index = coordIndex->get_int(i);
+    if (index < 0) {
       _polys.push_back(poly);
       poly._verts.clear();
     } else {
-      const LVertexd &p = _coord_values[(*ci)._sfint32];
+      const LVertexd &p = _coord_values[index];
       VrmlVertex vert;
-      vert._index = (*ci)._sfint32;
+      vert._index = index;
       vert._pos = p;
       poly._verts.push_back(vert);
     }
@@ -108,9 +176,9 @@ void IndexedFaceSet::
 get_vrml_colors(const VrmlNode *color_node, double transparency,
                 pvector<UnalignedLVecBase4> &color_list) {
   const MFArray *color = color_node->get_value("color")._mf;
-  MFArray::const_iterator ci;
-  for (ci = color->begin(); ci != color->end(); ++ci) {
-    const double *p = (*ci)._sfvec;
+  size_t num_colors = color->size();
+  for (size_t i = 0; i < num_colors; ++i) {
+    const double *p = color->get_vec(i);
     LColor color(p[0], p[1], p[2], 1.0 - transparency);
     color_list.push_back(color);
   }
@@ -124,9 +192,9 @@ void IndexedFaceSet::
 get_vrml_normals(const VrmlNode *normal_node,
                  pvector<LNormald> &normal_list) {
   const MFArray *point = normal_node->get_value("vector")._mf;
-  MFArray::const_iterator ci;
-  for (ci = point->begin(); ci != point->end(); ++ci) {
-    const double *p = (*ci)._sfvec;
+  size_t num_points = point->size();
+  for (size_t i = 0; i < num_points; ++i) {
+    const double *p = point->get_vec(i);
     LNormald normal(p[0], p[1], p[2]);
     normal_list.push_back(normal);
   }
@@ -140,9 +208,9 @@ void IndexedFaceSet::
 get_vrml_uvs(const VrmlNode *texCoord_node,
              pvector<LTexCoordd> &uv_list) {
   const MFArray *point = texCoord_node->get_value("point")._mf;
-  MFArray::const_iterator ci;
-  for (ci = point->begin(); ci != point->end(); ++ci) {
-    const double *p = (*ci)._sfvec;
+  size_t num_points = point->size();
+  for (size_t i = 0; i < num_points; ++i) {
+    const double *p = point->get_vec(i);
     LTexCoordd uv(p[0], p[1]);
     uv_list.push_back(uv);
   }
@@ -163,11 +231,12 @@ get_colors() {
     bool colorPerVertex = _geometry->get_value("colorPerVertex")._sfbool;
     MFArray *colorIndex = _geometry->get_value("colorIndex")._mf;
     if (colorPerVertex) {
-      MFArray::const_iterator ci;
+      size_t ci;
       size_t pi = 0;
       size_t pv = 0;
-      for (ci = colorIndex->begin(); ci != colorIndex->end(); ++ci) {
-        if ((*ci)._sfint32 < 0) {
+      for (ci = 0; ci < colorIndex->size(); ++ci) {
+        int index = colorIndex->get_int(ci);
+        if (index < 0) {
           // End of poly.
           if (pv != _polys[pi]._verts.size()) {
             cerr << "Color indices don't match up!\n";
@@ -180,7 +249,7 @@ get_colors() {
             cerr << "Color indices don't match up!\n";
             return false;
           }
-          _polys[pi]._verts[pv]._attrib.set_color(color_list[(*ci)._sfint32]);
+          _polys[pi]._verts[pv]._attrib.set_color(color_list[index]);
           pv++;
         }
       }
@@ -190,18 +259,19 @@ get_colors() {
       }
     } else {
       if (!colorIndex->empty()) {
-        MFArray::const_iterator ci;
+        size_t ci;
         size_t pi = 0;
         if (colorIndex->size() != _polys.size()) {
           cerr << "Wrong number of color indices!\n";
           return false;
         }
-        for (ci = colorIndex->begin(); ci != colorIndex->end(); ++ci) {
-          if ((*ci)._sfint32 < 0 || (*ci)._sfint32 >= (int)color_list.size()) {
+        for (ci = 0; ci < colorIndex->size(); ++ci) {
+          int index = colorIndex->get_int(ci);
+          if (index < 0 || index >= (int)color_list.size()) {
             cerr << "Invalid color index!\n";
             return false;
           }
-          _polys[pi]._attrib.set_color(color_list[(*ci)._sfint32]);
+          _polys[pi]._attrib.set_color(color_list[index]);
           pi++;
         }
       } else {
@@ -232,7 +302,7 @@ get_normals() {
 
     bool normalPerVertex = _geometry->get_value("normalPerVertex")._sfbool;
     MFArray *normalIndex = _geometry->get_value("normalIndex")._mf;
-    MFArray::const_iterator ci;
+    size_t ci;
 
     if (normalPerVertex &&
         normal_list.size() == _polys.size() &&
@@ -251,9 +321,7 @@ get_normals() {
         // normals, assume the VRML writer meant to imply a one-to-one
         // mapping.  This works around a broken formZ VRML file writer.
         for (size_t i = 0; i < normal_list.size(); i++) {
-          VrmlFieldValue fv;
-          fv._sfint32 = i;
-          (*normalIndex).push_back(fv);
+          normalIndex->add_int((int)i);
         }
       }
 
@@ -263,10 +331,8 @@ get_normals() {
       // exactly matches the number of vertices, and none of the indices is
       // -1.
       bool linear_list = (normalIndex->size() == _coord_values.size());
-      for (ci = normalIndex->begin();
-           ci != normalIndex->end() && linear_list;
-           ++ci) {
-        linear_list = ((*ci)._sfint32 >= 0);
+      for (ci = 0; ci < normalIndex->size() && linear_list; ++ci) {
+        linear_list = (normalIndex->get_int(ci) >= 0);
       }
 
       if (linear_list) {
@@ -275,8 +341,8 @@ get_normals() {
         // vertex.
         _per_vertex_normals.reserve(_coord_values.size());
 
-        for (ci = normalIndex->begin(); ci != normalIndex->end(); ++ci) {
-          size_t vi = (*ci)._sfint32;
+        for (ci = 0; ci < normalIndex->size(); ++ci) {
+          size_t vi = normalIndex->get_int(ci);
           nassertr(vi >= 0, false);
           if (vi >= normal_list.size()) {
             cerr << "Invalid normal index: " << vi << "\n";
@@ -292,11 +358,12 @@ get_normals() {
         // different normal values in differing polygons (meaning it's not
         // actually shared).
 
-        MFArray::const_iterator ci;
+        size_t ci;
         size_t pi = 0;
         size_t pv = 0;
-        for (ci = normalIndex->begin(); ci != normalIndex->end(); ++ci) {
-          if ((*ci)._sfint32 < 0) {
+        for (ci = 0; ci < normalIndex->size(); ++ci) {
+          int index = normalIndex->get_int(ci);
+          if (index < 0) {
             // End of poly.
             if (pv != _polys[pi]._verts.size()) {
               cerr << "Normal indices don't match up!\n";
@@ -309,7 +376,7 @@ get_normals() {
               cerr << "Normal indices don't match up!\n";
               return false;
             }
-            const LNormald &d = normal_list[(*ci)._sfint32];
+            const LNormald &d = normal_list[index];
             _polys[pi]._verts[pv]._attrib.set_normal(d);
             pv++;
           }
@@ -326,12 +393,13 @@ get_normals() {
           cerr << "Wrong number of normal indices!\n";
           return false;
         }
-        for (ci = normalIndex->begin(); ci != normalIndex->end(); ++ci) {
-          if ((*ci)._sfint32 < 0 || (*ci)._sfint32 >= (int)normal_list.size()) {
+        for (ci = 0; ci < normalIndex->size(); ++ci) {
+          int index = normalIndex->get_int(ci);
+          if (index < 0 || index >= (int)normal_list.size()) {
             cerr << "Invalid normal index!\n";
             return false;
           }
-          const LNormald &d = normal_list[(*ci)._sfint32];
+          const LNormald &d = normal_list[index];
           _polys[pi]._attrib.set_normal(d);
           pi++;
         }
@@ -383,16 +451,14 @@ get_uvs() {
     get_vrml_uvs(texCoord, uv_list);
 
     MFArray *texCoordIndex = _geometry->get_value("texCoordIndex")._mf;
-    MFArray::const_iterator ci;
+    size_t ci;
 
     if (texCoordIndex->empty()) {
       // If we have *no* texture coordinate index array, but we do have
       // texture coordinates, assume the VRML writer meant to imply a one-to-
       // one mapping.  This works around a broken formZ VRML file writer.
       for (size_t i = 0; i < uv_list.size(); i++) {
-        VrmlFieldValue fv;
-        fv._sfint32 = i;
-        (*texCoordIndex).push_back(fv);
+        texCoordIndex->add_int((int)i);
       }
     }
 
@@ -402,10 +468,8 @@ get_uvs() {
     // coordinate indices exactly matches the number of vertices, and none of
     // the indices is -1.
     bool linear_list = (texCoordIndex->size() == _coord_values.size());
-    for (ci = texCoordIndex->begin();
-         ci != texCoordIndex->end() && linear_list;
-         ++ci) {
-      linear_list = ((*ci)._sfint32 >= 0);
+    for (ci = 0; ci < texCoordIndex->size() && linear_list; ++ci) {
+      linear_list = (texCoordIndex->get_int(ci) >= 0);
     }
 
     if (linear_list) {
@@ -414,8 +478,8 @@ get_uvs() {
       // vertex.
       _per_vertex_uvs.reserve(_coord_values.size());
 
-      for (ci = texCoordIndex->begin(); ci != texCoordIndex->end(); ++ci) {
-        size_t vi = (*ci)._sfint32;
+      for (ci = 0; ci < texCoordIndex->size(); ++ci) {
+        size_t vi = texCoordIndex->get_int(ci);
         nassertr(vi >= 0, false);
         if (vi >= uv_list.size()) {
           cerr << "Invalid texCoord index: " << vi << "\n";
@@ -433,8 +497,9 @@ get_uvs() {
 
       size_t pi = 0;
       size_t pv = 0;
-      for (ci = texCoordIndex->begin(); ci != texCoordIndex->end(); ++ci) {
-        if ((*ci)._sfint32 < 0) {
+      for (ci = 0; ci < texCoordIndex->size(); ++ci) {
+        int index = texCoordIndex->get_int(ci);
+        if (index < 0) {
           // End of poly.
           if (pv != _polys[pi]._verts.size()) {
             cerr << "texCoord indices don't match up!\n";
@@ -447,7 +512,7 @@ get_uvs() {
             cerr << "texCoord indices don't match up!\n";
             return false;
           }
-          _polys[pi]._verts[pv]._attrib.set_uv(uv_list[(*ci)._sfint32]);
+          _polys[pi]._verts[pv]._attrib.set_uv(uv_list[index]);
           pv++;
         }
       }
@@ -21,6 +21,7 @@
 #include "eggPolygon.h"
 #include "eggVertex.h"
 #include "eggAttributes.h"
+#include "renderState.h"
 
 class VrmlNode;
 class EggData;
@@ -28,6 +29,7 @@ class EggGroup;
 class EggVertexPool;
 class VRMLAppearance;
 class LMatrix4d;
+class NodeGeomBuilder;
 
 /**
  * Decodes the vertices and faces in a VRML indexed face set, and creates the
@@ -38,6 +40,7 @@ public:
   IndexedFaceSet(const VrmlNode *geometry, const VRMLAppearance &appearance);
 
   void convert_to_egg(EggGroup *group, const LMatrix4d &net_transform);
+  void convert_to_node(NodeGeomBuilder &builder, const RenderState *state);
 
 private:
   void get_coord_values();
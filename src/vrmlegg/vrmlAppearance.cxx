@@ -13,6 +13,13 @@
 
 #include "vrmlAppearance.h"
 #include "vrmlNode.h"
+#include "somethingToEggConverter.h"
+#include "texturePool.h"
+#include "colorAttrib.h"
+#include "textureAttrib.h"
+#include "texMatrixAttrib.h"
+#include "transparencyAttrib.h"
+#include "transformState.h"
 #include "deg_2_rad.h"
 
 VRMLAppearance::
@@ -50,7 +57,7 @@ VRMLAppearance(const VrmlNode *appearance) {
       if (strcmp(texture->_type->getName(), "ImageTexture") == 0) {
         MFArray *url = texture->get_value("url")._mf;
         if (!url->empty()) {
-          const char *filename = (*url->begin())._sfstring;
+          const char *filename = url->get_value(0)._sfstring;
           _tex = new EggTexture("tref", filename);
 
           if (_has_tex_transform) {
@@ -65,3 +72,34 @@ VRMLAppearance(const VrmlNode *appearance) {
     }
   }
 }
+
+/**
+ * Returns the RenderState that corresponds to this appearance, for
+ * convert_to_node().  The color itself is applied per vertex.
+ */
+CPT(RenderState) VRMLAppearance::
+make_node_state(SomethingToEggConverter *converter) const {
+  CPT(RenderState) state = RenderState::make(ColorAttrib::make_vertex());
+  bool has_alpha = (_transparency != 0.0);
+
+  if (_tex != nullptr) {
+    Filename filename = converter->convert_model_path(_tex->get_filename());
+    Texture *tex = TexturePool::load_texture(filename);
+    if (tex != nullptr) {
+      state = state->add_attrib(TextureAttrib::make(tex));
+      if (Texture::has_alpha(tex->get_format())) {
+        has_alpha = true;
+      }
+      if (_tex->has_transform()) {
+        LMatrix3 mat = LCAST(PN_stdfloat, _tex->get_transform2d());
+        state = state->add_attrib(TexMatrixAttrib::make(TransformState::make_mat3(mat)));
+      }
+    }
+  }
+
+  if (has_alpha) {
+    state = state->add_attrib(TransparencyAttrib::make(TransparencyAttrib::M_alpha));
+  }
+
+  return state;
+}
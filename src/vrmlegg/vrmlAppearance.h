@@ -17,13 +17,17 @@
 #include "pandatoolbase.h"
 #include "eggTexture.h"
 #include "pt_EggTexture.h"
+#include "renderState.h"
 
 class VrmlNode;
+class SomethingToEggConverter;
 
 class VRMLAppearance {
 public:
   VRMLAppearance(const VrmlNode *vrmlAppearance);
 
+  CPT(RenderState) make_node_state(SomethingToEggConverter *converter) const;
+
   bool _has_material;
   LColor _color;
   double _transparency;
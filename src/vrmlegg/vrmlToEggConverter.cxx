@@ -20,6 +20,12 @@
 #include "eggGroupNode.h"
 #include "eggGroup.h"
 #include "eggData.h"
+#include "eggVertexPool.h"
+#include "externalReferenceCache.h"
+#include "nodeGeomBuilder.h"
+#include "transformState.h"
+#include "trueClock.h"
+#include "dcast.h"
 #include "deg_2_rad.h"
 
 /**
@@ -27,6 +33,7 @@
  */
 VRMLToEggConverter::
 VRMLToEggConverter() {
+  reset_instances();
 }
 
 /**
@@ -36,6 +43,7 @@ VRMLToEggConverter::
 VRMLToEggConverter(const VRMLToEggConverter &copy) :
   SomethingToEggConverter(copy)
 {
+  reset_instances();
 }
 
 /**
@@ -79,6 +87,18 @@ supports_compressed() const {
   return true;
 }
 
+/**
+ * Returns true if this converter can directly convert the model type to
+ * internal Panda memory structures, given the indicated options, or false
+ * otherwise.  If this returns true, then convert_to_node() may be called to
+ * perform the conversion, which may be faster than calling convert_file() if
+ * the ultimate goal is a PandaNode anyway.
+ */
+bool VRMLToEggConverter::
+supports_convert_to_node(const LoaderOptions &options) const {
+  return true;
+}
+
 /**
  * Handles the reading of the input file and converting it to egg.  Returns
  * true if successful, false otherwise.
@@ -86,6 +106,7 @@ supports_compressed() const {
 bool VRMLToEggConverter::
 convert_file(const Filename &filename) {
   clear_error();
+  reset_instances();
 
   VrmlScene *scene = parse_vrml(filename);
   if (scene == nullptr) {
@@ -111,9 +132,66 @@ convert_file(const Filename &filename) {
     vrml_node((*csi)._node, get_egg_data(), LMatrix4d::ident_mat());
   }
 
+  // This frees all of the VRML nodes at once.
+  delete scene;
+  _instances.clear();
+
   return !had_error();
 }
 
+/**
+ * Reads the input file and directly produces a ready-to-render model file as
+ * a PandaNode.  Returns NULL on failure, or if it is not supported.  (This
+ * functionality is not supported by all converter types; see
+ * supports_convert_to_node()).
+ *
+ * A node that is USEd more than once is converted only the first time; each
+ * USE reference parents that same PandaNode again, so that all of the
+ * instances share the same Geoms and GeomVertexDatas.
+ */
+PT(PandaNode) VRMLToEggConverter::
+convert_to_node(const LoaderOptions &options, const Filename &filename) {
+  clear_error();
+  reset_instances();
+
+  VrmlScene *scene = parse_vrml(filename);
+  if (scene == nullptr) {
+    return nullptr;
+  }
+
+  Nodes nodes;
+  VrmlScene::iterator si;
+  for (si = scene->begin(); si != scene->end(); ++si) {
+    get_all_defs((*si)._node, nodes);
+  }
+
+  PT(PandaNode) root = new PandaNode("");
+  VrmlScene::const_iterator csi;
+  for (csi = scene->begin(); csi != scene->end(); ++csi) {
+    node_vrml_node((*csi)._node, root);
+  }
+
+  delete scene;
+  _instances.clear();
+
+  if (had_error()) {
+    return nullptr;
+  }
+  return root;
+}
+
+/**
+ * Writes a summary of the USE references that were instanced during the last
+ * conversion, and the vertices and time that this saved.
+ */
+void VRMLToEggConverter::
+write_instances(std::ostream &out) const {
+  out << _num_instanced << " USE references instanced, sharing "
+      << _num_shared_vertices << " vertices (" << _instance_time
+      << " s instancing, in place of an estimated " << _saved_time
+      << " s converting)\n";
+}
+
 /**
  * Makes a first pass through the VRML hierarchy, identifying all nodes marked
  * with a DEF code, and also counting the times each one is referenced by USE.
@@ -168,9 +246,8 @@ get_all_defs(SFNodeRef &vrml, VRMLToEggConverter::Nodes &nodes) {
         get_all_defs((*fi)._value._sfnode, nodes);
       } else if ((*fi)._type->type == MFNODE) {
         MFArray *children = (*fi)._value._mf;
-        MFArray::iterator ci;
-        for (ci = children->begin(); ci != children->end(); ++ci) {
-          get_all_defs((*ci)._sfnode, nodes);
+        for (size_t ci = 0; ci < children->size(); ++ci) {
+          get_all_defs(children->modify_value(ci)._sfnode, nodes);
         }
       }
     }
@@ -219,21 +296,26 @@ vrml_grouping_node(const SFNodeRef &vrml, EggGroupNode *egg,
     name = vrml._name;
   }
 
-  /*
-    The following code fragment was used in the old DWD-style egg
-    library.  Currently, the Panda egg library doesn't support
-    instance references, so we deal with VRML instances by copying.
-
   if (vrml._type == SFNodeRef::T_use) {
-    // If this is an instancing reference, just add the reference and return;
-    // no need for further processing on the node.
-    Instances::const_iterator fi = _instances.find(node);
-    assert(fi != _instances.end());
-    EggInstance *inst = _data.CreateInstance(egg);
-    inst->AddGroupRef((*fi).second);
-    return;
+    // If the node has already been converted, this reference can share its
+    // vertices; we need only copy its groups and polygons.
+    Instances::const_iterator ii = _instances.find(node);
+    if (ii != _instances.end() && (*ii).second._group != nullptr) {
+      const Instance &inst = (*ii).second;
+      TrueClock *clock = TrueClock::get_global_ptr();
+      double start = clock->get_short_time();
+
+      PT(EggGroup) temp = new EggGroup;
+      if (ExternalReferenceCache::copy_node(inst._group, temp)) {
+        egg->steal_children(*temp);
+        ++_num_instanced;
+        _num_shared_vertices += inst._num_vertices;
+        _saved_time += inst._convert_time;
+        _instance_time += clock->get_short_time() - start;
+        return;
+      }
+    }
   }
-    */
 
   PT(EggGroup) group = new EggGroup(name);
   egg->add_child(group);
@@ -245,12 +327,21 @@ vrml_grouping_node(const SFNodeRef &vrml, EggGroupNode *egg,
     // make it an instance node.
     group->set_group_type(EggGroup::GT_instance);
     next_transform = LMatrix4d::ident_mat();
-
-    // And define the instance for future references.  _instances[node] =
-    // group;
   }
 
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  int first_vertex = _num_vertices;
+
   (this->*process_func)(node, group, next_transform);
+
+  if (node->_use_count > 0 && _instances.find(node) == _instances.end()) {
+    // And define the instance for future references.
+    Instance &inst = _instances[node];
+    inst._group = group;
+    inst._num_vertices = _num_vertices - first_vertex;
+    inst._convert_time = clock->get_short_time() - start;
+  }
 }
 
 
@@ -261,9 +352,8 @@ void VRMLToEggConverter::
 vrml_group(const VrmlNode *node, EggGroup *group,
            const LMatrix4d &net_transform) {
   const MFArray *children = node->get_value("children")._mf;
-  MFArray::const_iterator ci;
-  for (ci = children->begin(); ci != children->end(); ++ci) {
-    vrml_node((*ci)._sfnode, group, net_transform);
+  for (size_t ci = 0; ci < children->size(); ++ci) {
+    vrml_node(children->get_value(ci)._sfnode, group, net_transform);
   }
 }
 
@@ -273,6 +363,53 @@ vrml_group(const VrmlNode *node, EggGroup *group,
 void VRMLToEggConverter::
 vrml_transform(const VrmlNode *node, EggGroup *group,
                const LMatrix4d &net_transform) {
+  LMatrix4d local_transform;
+  if (get_transform(node, local_transform)) {
+    group->set_transform3d(local_transform);
+  }
+
+  LMatrix4d next_transform = local_transform * net_transform;
+
+  const MFArray *children = node->get_value("children")._mf;
+  for (size_t ci = 0; ci < children->size(); ++ci) {
+    vrml_node(children->get_value(ci)._sfnode, group, next_transform);
+  }
+}
+
+/**
+ * Creates an Egg group corresponding a VRML shape.  This will probably
+ * contain a vertex pool and a number of polygons.
+ */
+void VRMLToEggConverter::
+vrml_shape(const VrmlNode *node, EggGroup *group,
+           const LMatrix4d &net_transform) {
+  const VrmlNode *geometry = node->get_value("geometry")._sfnode._p;
+
+  if (geometry != nullptr) {
+    VRMLAppearance appearance(node->get_value("appearance")._sfnode._p);
+
+    if (strcmp(geometry->_type->getName(), "IndexedFaceSet") == 0) {
+      IndexedFaceSet ifs(geometry, appearance);
+      ifs.convert_to_egg(group, net_transform);
+
+      EggGroupNode::const_iterator ci;
+      for (ci = group->begin(); ci != group->end(); ++ci) {
+        if ((*ci)->is_of_type(EggVertexPool::get_class_type())) {
+          _num_vertices += (int)DCAST(EggVertexPool, *ci)->size();
+        }
+      }
+    } else {
+      std::cerr << "Ignoring " << geometry->_type->getName() << "\n";
+    }
+  }
+}
+
+/**
+ * Computes the local transform of the VRML Transform node.  Returns true if
+ * it is anything other than identity, false otherwise.
+ */
+bool VRMLToEggConverter::
+get_transform(const VrmlNode *node, LMatrix4d &local_transform) {
   const double *scale = node->get_value("scale")._sfvec;
   const double *rotation = node->get_value("rotation")._sfvec;
   const double *translation = node->get_value("translation")._sfvec;
@@ -280,7 +417,7 @@ vrml_transform(const VrmlNode *node, EggGroup *group,
   const double *center = node->get_value("center")._sfvec;
   const double *o = node->get_value("scaleOrientation")._sfvec;
 
-  LMatrix4d local_transform = LMatrix4d::ident_mat();
+  local_transform = LMatrix4d::ident_mat();
 
   bool any_transform = false;
 
@@ -347,34 +484,139 @@ vrml_transform(const VrmlNode *node, EggGroup *group,
       LMatrix4d::translate_mat(translation[0], translation[1], translation[2]);
   }
 
-  if (any_transform) {
-    group->set_transform3d(local_transform);
+  return any_transform;
+}
+
+/**
+ * Clears the record of converted instances, and the statistics reported by
+ * write_instances().
+ */
+void VRMLToEggConverter::
+reset_instances() {
+  _instances.clear();
+  _num_vertices = 0;
+  _num_instanced = 0;
+  _num_shared_vertices = 0;
+  _saved_time = 0.0;
+  _instance_time = 0.0;
+}
+
+/**
+ * Converts a single VRML node directly into a child of the indicated
+ * PandaNode.  This is the equivalent of vrml_node() and vrml_grouping_node()
+ * for convert_to_node().
+ */
+void VRMLToEggConverter::
+node_vrml_node(const SFNodeRef &vrml, PandaNode *parent) {
+  const VrmlNode *node = vrml._p;
+  if (node == nullptr) {
+    return;
   }
 
-  LMatrix4d next_transform = local_transform * net_transform;
+  const char *type_name = node->_type->getName();
+  bool is_transform = (strcmp(type_name, "Transform") == 0);
+  bool is_shape = (strcmp(type_name, "Shape") == 0);
+  if (!is_transform && !is_shape && strcmp(type_name, "Group") != 0) {
+    return;
+  }
+
+  if (node->_use_count > 0) {
+    Instances::const_iterator ii = _instances.find(node);
+    if (ii != _instances.end() && (*ii).second._node != nullptr) {
+      // This node has already been converted; simply parent it again.
+      const Instance &inst = (*ii).second;
+      parent->add_child(inst._node);
+      ++_num_instanced;
+      _num_shared_vertices += inst._num_vertices;
+      _saved_time += inst._convert_time;
+      return;
+    }
+  }
 
+  std::string name;
+  if (vrml._name != nullptr) {
+    name = vrml._name;
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  int first_vertex = _num_vertices;
+
+  PT(PandaNode) pnode;
+  if (is_shape) {
+    PT(GeomNode) geom_node = new GeomNode(name);
+    node_vrml_shape(node, geom_node);
+    pnode = geom_node;
+
+  } else {
+    pnode = new PandaNode(name);
+    if (is_transform) {
+      node_vrml_transform(node, pnode);
+    } else {
+      node_vrml_children(node, pnode);
+    }
+  }
+  parent->add_child(pnode);
+
+  if (node->_use_count > 0) {
+    Instance &inst = _instances[node];
+    inst._node = pnode;
+    inst._num_vertices = _num_vertices - first_vertex;
+    inst._convert_time = clock->get_short_time() - start;
+  }
+}
+
+/**
+ * Converts the children of a VRML Group or Transform node into the indicated
+ * PandaNode.
+ */
+void VRMLToEggConverter::
+node_vrml_children(const VrmlNode *node, PandaNode *pnode) {
   const MFArray *children = node->get_value("children")._mf;
-  MFArray::const_iterator ci;
-  for (ci = children->begin(); ci != children->end(); ++ci) {
-    vrml_node((*ci)._sfnode, group, next_transform);
+  for (size_t ci = 0; ci < children->size(); ++ci) {
+    node_vrml_node(children->get_value(ci)._sfnode, pnode);
   }
 }
 
 /**
- * Creates an Egg group corresponding a VRML shape.  This will probably
- * contain a vertex pool and a number of polygons.
+ * Applies the transform of the VRML Transform node to the indicated
+ * PandaNode, and converts its children.
  */
 void VRMLToEggConverter::
-vrml_shape(const VrmlNode *node, EggGroup *group,
-           const LMatrix4d &net_transform) {
+node_vrml_transform(const VrmlNode *node, PandaNode *pnode) {
+  LMatrix4d local_transform;
+  if (get_transform(node, local_transform)) {
+    // Convert the matrix into Panda's coordinate system.
+    LMatrix4 mat = LCAST(PN_stdfloat, local_transform);
+    LMatrix4 from_default = LMatrix4::convert_mat(CS_default, CS_yup_right);
+    LMatrix4 to_default = LMatrix4::convert_mat(CS_yup_right, CS_default);
+    pnode->set_transform(TransformState::make_mat(from_default * mat * to_default));
+  }
+
+  node_vrml_children(node, pnode);
+}
+
+/**
+ * Converts the geometry of a VRML Shape into the indicated GeomNode.  The
+ * vertices are left in the Shape's own coordinate space; the transforms are
+ * applied by the PandaNodes above it.
+ */
+void VRMLToEggConverter::
+node_vrml_shape(const VrmlNode *node, GeomNode *geom_node) {
   const VrmlNode *geometry = node->get_value("geometry")._sfnode._p;
 
   if (geometry != nullptr) {
     VRMLAppearance appearance(node->get_value("appearance")._sfnode._p);
 
     if (strcmp(geometry->_type->getName(), "IndexedFaceSet") == 0) {
+      NodeGeomBuilder builder(CS_yup_right);
       IndexedFaceSet ifs(geometry, appearance);
-      ifs.convert_to_egg(group, net_transform);
+      ifs.convert_to_node(builder, appearance.make_node_state(this));
+      builder.build(geom_node);
+
+      for (int i = 0; i < geom_node->get_num_geoms(); ++i) {
+        _num_vertices += geom_node->get_geom(i)->get_vertex_data()->get_num_rows();
+      }
     } else {
       std::cerr << "Ignoring " << geometry->_type->getName() << "\n";
     }
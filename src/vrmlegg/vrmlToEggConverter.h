@@ -17,12 +17,15 @@
 #include "pandatoolbase.h"
 
 #include "somethingToEggConverter.h"
+#include "eggGroup.h"
+#include "pandaNode.h"
+#include "geomNode.h"
+#include "pointerTo.h"
 #include "pmap.h"
 
 class VrmlNode;
 struct SFNodeRef;
 class EggGroupNode;
-class EggGroup;
 class LMatrix4d;
 
 /**
@@ -40,8 +43,13 @@ public:
   virtual std::string get_name() const;
   virtual std::string get_extension() const;
   virtual bool supports_compressed() const;
+  virtual bool supports_convert_to_node(const LoaderOptions &options) const;
 
   virtual bool convert_file(const Filename &filename);
+  virtual PT(PandaNode) convert_to_node(const LoaderOptions &options, const Filename &filename);
+
+  INLINE int get_num_instanced() const;
+  void write_instances(std::ostream &out) const;
 
 private:
   typedef pmap<std::string, VrmlNode *> Nodes;
@@ -61,6 +69,36 @@ private:
                       const LMatrix4d &net_transform);
   void vrml_shape(const VrmlNode *node, EggGroup *group,
                   const LMatrix4d &net_transform);
+
+  static bool get_transform(const VrmlNode *node, LMatrix4d &local_transform);
+  void reset_instances();
+
+  // The following are used by convert_to_node() in lieu of the above.
+  void node_vrml_node(const SFNodeRef &vrml, PandaNode *parent);
+  void node_vrml_children(const VrmlNode *node, PandaNode *pnode);
+  void node_vrml_transform(const VrmlNode *node, PandaNode *pnode);
+  void node_vrml_shape(const VrmlNode *node, GeomNode *geom_node);
+
+  // Each node that is USEd at least once is remembered here after it has
+  // been converted, so that the USE references can share its geometry
+  // instead of converting it again.
+  class Instance {
+  public:
+    PT(EggGroup) _group;
+    PT(PandaNode) _node;
+    int _num_vertices;
+    double _convert_time;
+  };
+  typedef pmap<const VrmlNode *, Instance> Instances;
+  Instances _instances;
+
+  int _num_vertices;
+  int _num_instanced;
+  int _num_shared_vertices;
+  double _saved_time;
+  double _instance_time;
 };
 
+#include "vrmlToEggConverter.I"
+
 #endif
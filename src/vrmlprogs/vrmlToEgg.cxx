@@ -59,6 +59,10 @@ run() {
     exit(1);
   }
 
+  if (converter.get_num_instanced() != 0) {
+    converter.write_instances(nout);
+  }
+
   write_egg_file();
   nout << "\n";
 }
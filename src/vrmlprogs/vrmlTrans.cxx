@@ -13,6 +13,9 @@
 
 #include "vrmlTrans.h"
 #include "parse_vrml.h"
+#include "trueClock.h"
+
+using std::string;
 
 /**
  *
@@ -42,6 +45,23 @@ VRMLTrans() :
      "If this option is omitted, the last parameter name is taken to be the "
      "name of the output file.",
      &VRMLTrans::dispatch_filename, &_got_output_filename, &_output_filename);
+
+  add_option
+    ("flex", "", 0,
+     "Read the file with the original flex-generated scanner, instead of "
+     "the hand-written lexer that is normally used.",
+     &VRMLTrans::dispatch_none, &_use_flex);
+
+  add_option
+    ("compare", "", 0,
+     "Read the file twice, once with each lexer, and report how long each "
+     "one took.  The program fails if the two resulting scenes are not "
+     "identical.  In this mode, floating-point numbers are written with "
+     "full precision.",
+     &VRMLTrans::dispatch_none, &_compare);
+
+  _use_flex = false;
+  _compare = false;
 }
 
 
@@ -52,13 +72,58 @@ void VRMLTrans::
 run() {
   nout << "Reading " << _input_filename << "\n";
 
-  VrmlScene *scene = parse_vrml(_input_filename);
-  if (scene == nullptr) {
+  string output;
+  if (_compare) {
+    // Read with the flex scanner first, so that it also reads the standard
+    // node definitions, just as it would if it were used alone.
+    string flex_output;
+    if (!read_scene(true, flex_output) || !read_scene(false, output)) {
+      nout << "Unable to read.\n";
+      exit(1);
+    }
+    if (output != flex_output) {
+      nout << "The two lexers produced different scenes.\n";
+      exit(1);
+    }
+    nout << "The two lexers produced identical scenes.\n";
+
+  } else if (!read_scene(_use_flex, output)) {
     nout << "Unable to read.\n";
     exit(1);
   }
 
-  get_output() << *scene << "\n";
+  get_output() << output << "\n";
+}
+
+
+/**
+ * Reads the input file with the indicated lexer, and fills result with the
+ * VRML text of the resulting scene.  Returns true on success.
+ */
+bool VRMLTrans::
+read_scene(bool use_flex, string &result) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+
+  VrmlScene *scene = parse_vrml(_input_filename, use_flex);
+  if (scene == nullptr) {
+    return false;
+  }
+
+  if (_compare) {
+    nout << "Read with the "
+         << (use_flex ? "flex scanner" : "hand-written lexer") << " in "
+         << clock->get_short_time() - start << " seconds.\n";
+  }
+
+  std::ostringstream strm;
+  if (_compare) {
+    strm.precision(17);
+  }
+  strm << *scene;
+  result = strm.str();
+  delete scene;
+  return true;
 }
 
 
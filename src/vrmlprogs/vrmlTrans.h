@@ -32,7 +32,12 @@ public:
 protected:
   virtual bool handle_args(Args &args);
 
+private:
+  bool read_scene(bool use_flex, std::string &result);
+
   Filename _input_filename;
+  bool _use_flex;
+  bool _compare;
 };
 
 #endif
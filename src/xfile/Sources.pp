@@ -18,8 +18,11 @@
      config_xfile.h \
      standard_templates.h \
      windowsGuid.h \
+     xBinaryDefs.h \
      xFile.I xFile.h \
      xFileArrayDef.I xFileArrayDef.h \
+     xFileBinaryReader.I xFileBinaryReader.h \
+     xFileBinaryWriter.I xFileBinaryWriter.h \
      xFileDataDef.I xFileDataDef.h \
      xFileDataNode.I xFileDataNode.h \
      xFileDataNodeReference.I xFileDataNodeReference.h \
@@ -41,6 +44,8 @@
      windowsGuid.cxx\
      xFile.cxx \
      xFileArrayDef.cxx \
+     xFileBinaryReader.cxx \
+     xFileBinaryWriter.cxx \
      xFileDataDef.cxx \
      xFileDataNode.cxx \
      xFileDataNodeReference.cxx \
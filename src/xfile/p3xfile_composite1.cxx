@@ -3,6 +3,8 @@
 #include "windowsGuid.cxx"
 #include "xFile.cxx"
 #include "xFileArrayDef.cxx"
+#include "xFileBinaryReader.cxx"
+#include "xFileBinaryWriter.cxx"
 #include "xFileDataDef.cxx"
 #include "xFileDataNode.cxx"
 #include "xFileDataNodeReference.cxx"
@@ -13,6 +13,8 @@
 
 #include "windowsGuid.h"
 #include "pnotify.h"
+#include "datagram.h"
+#include "datagramIterator.h"
 
 #include <stdio.h>  // for sscanf, sprintf
 
@@ -67,6 +69,48 @@ format_string() const {
   return string(buffer);
 }
 
+/**
+ * Appends the GUID to the datagram in the 16-byte little-endian layout used
+ * by binary .x files.
+ */
+void WindowsGuid::
+write_datagram(Datagram &dg) const {
+  dg.add_uint32((uint32_t)_data1);
+  dg.add_uint16(_data2);
+  dg.add_uint16(_data3);
+  dg.add_uint8(_b1);
+  dg.add_uint8(_b2);
+  dg.add_uint8(_b3);
+  dg.add_uint8(_b4);
+  dg.add_uint8(_b5);
+  dg.add_uint8(_b6);
+  dg.add_uint8(_b7);
+  dg.add_uint8(_b8);
+}
+
+/**
+ * Extracts a GUID written by write_datagram().  Returns true on success, or
+ * false if there are not enough bytes remaining in the datagram.
+ */
+bool WindowsGuid::
+read_datagram(DatagramIterator &scan) {
+  if (scan.get_remaining_size() < 16) {
+    return false;
+  }
+  _data1 = scan.get_uint32();
+  _data2 = scan.get_uint16();
+  _data3 = scan.get_uint16();
+  _b1 = scan.get_uint8();
+  _b2 = scan.get_uint8();
+  _b3 = scan.get_uint8();
+  _b4 = scan.get_uint8();
+  _b5 = scan.get_uint8();
+  _b6 = scan.get_uint8();
+  _b7 = scan.get_uint8();
+  _b8 = scan.get_uint8();
+  return true;
+}
+
 /**
  * Outputs a hex representation of the GUID.
  */
@@ -18,6 +18,9 @@
 
 #include <string.h>  // For memcpy, memcmp
 
+class Datagram;
+class DatagramIterator;
+
 /**
  * This is an implementation of the Windows GUID object, used everywhere as a
  * world-unique identifier for anything and everything.  In particular, it's
@@ -42,6 +45,9 @@ public:
   bool parse_string(const std::string &str);
   std::string format_string() const;
 
+  void write_datagram(Datagram &dg) const;
+  bool read_datagram(DatagramIterator &scan);
+
   void output(std::ostream &out) const;
 
 private:
@@ -0,0 +1,59 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file xBinaryDefs.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef XBINARYDEFS_H
+#define XBINARYDEFS_H
+
+#include "pandatoolbase.h"
+
+// The token values used by the binary .x file format.  Each token is stored
+// as a little-endian WORD; some of them are followed by additional data, as
+// noted.
+enum XBinaryToken {
+  // Record-bearing tokens.
+  XBT_name            = 1,   // DWORD count, count chars
+  XBT_string          = 2,   // DWORD count, count chars
+  XBT_integer         = 3,   // DWORD value
+  XBT_guid            = 5,   // DWORD, WORD, WORD, 8 BYTEs
+  XBT_integer_list    = 6,   // DWORD count, count DWORDs
+  XBT_float_list      = 7,   // DWORD count, count FLOATs or DOUBLEs
+
+  // Stand-alone tokens.
+  XBT_obrace          = 10,
+  XBT_cbrace          = 11,
+  XBT_oparen          = 12,
+  XBT_cparen          = 13,
+  XBT_obracket        = 14,
+  XBT_cbracket        = 15,
+  XBT_oangle          = 16,
+  XBT_cangle          = 17,
+  XBT_dot             = 18,
+  XBT_comma           = 19,
+  XBT_semicolon       = 20,
+  XBT_template        = 31,
+  XBT_word            = 40,
+  XBT_dword           = 41,
+  XBT_float           = 42,
+  XBT_double          = 43,
+  XBT_char            = 44,
+  XBT_uchar           = 45,
+  XBT_sword           = 46,
+  XBT_sdword          = 47,
+  XBT_void            = 48,
+  XBT_lpstr           = 49,
+  XBT_unicode         = 50,
+  XBT_cstring         = 51,
+  XBT_array           = 52,
+};
+
+#endif
@@ -16,17 +16,30 @@
 #include "xLexerDefs.h"
 #include "xFileTemplate.h"
 #include "xFileDataNodeTemplate.h"
+#include "xFileBinaryReader.h"
+#include "xFileBinaryWriter.h"
 #include "config_xfile.h"
 #include "standard_templates.h"
 #include "zStream.h"
 #include "virtualFileSystem.h"
 #include "dcast.h"
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 using std::istream;
 using std::istringstream;
 using std::ostream;
+using std::ostringstream;
 using std::string;
 
+#ifdef HAVE_ZLIB
+// MSZIP compresses the body of a tzip or bzip file in independent blocks of
+// at most this many bytes, each of which may refer back to the previous one.
+static const size_t mszip_block_size = 32768;
+#endif  // HAVE_ZLIB
+
 TypeHandle XFile::_type_handle;
 PT(XFile) XFile::_standard_templates;
 
@@ -38,6 +51,7 @@ XFile(bool keep_names) : XFileNode(this) {
   _major_version = 3;
   _minor_version = 2;
   _format_type = FT_text;
+  _compressed = false;
   _float_size = FS_64;
   _keep_names = keep_names;
 }
@@ -71,7 +85,9 @@ clear() {
  */
 bool XFile::
 read(Filename filename) {
-  filename.set_text();
+  // We read in binary mode, since the file might be binary; the lexer
+  // doesn't mind the carriage returns in a text file.
+  filename.set_binary();
   VirtualFileSystem *vfs = VirtualFileSystem::get_global_ptr();
   istream *in = vfs->open_read_file(filename, true);
   if (in == nullptr) {
@@ -100,24 +116,28 @@ read(istream &in, const string &filename) {
     return false;
   }
 
-  if (_format_type != FT_text) {
-    // Does anyone actually use the binary format?  It wouldn't be too hard to
-    // support it if there were any reason at all to do so.
-    xfile_cat.error()
-      << "Cannot read binary .x files at this time.\n";
-    return false;
-  }
-
   // We must call this first so the standard templates file will be parsed and
   // available by the time we need it--it's tricky to invoke the parser from
   // within another parser instance.
   get_standard_templates();
 
-  x_init_parser(in, filename, *this);
-  xyyparse();
-  x_cleanup_parser();
+  if (_compressed) {
+#ifdef HAVE_ZLIB
+    string body;
+    if (!decompress_mszip(in, body)) {
+      return false;
+    }
+    istringstream body_in(body);
+    return read_body(body_in, filename);
 
-  return (x_error_count() == 0);
+#else  // HAVE_ZLIB
+    xfile_cat.error()
+      << "Cannot read compressed .x files without zlib.\n";
+    return false;
+#endif  // HAVE_ZLIB
+  }
+
+  return read_body(in, filename);
 }
 
 /**
@@ -161,12 +181,27 @@ write(Filename filename) const {
  */
 bool XFile::
 write(ostream &out) const {
+#ifndef HAVE_ZLIB
+  if (_compressed) {
+    xfile_cat.error()
+      << "Cannot write compressed .x files without zlib.\n";
+    return false;
+  }
+#endif  // HAVE_ZLIB
+
   if (!write_header(out)) {
     return false;
   }
 
-  write_text(out, 0);
+#ifdef HAVE_ZLIB
+  if (_compressed) {
+    ostringstream body;
+    write_body(body);
+    return compress_mszip(out, body.str());
+  }
+#endif  // HAVE_ZLIB
 
+  write_body(out);
   return true;
 }
 
@@ -329,12 +364,19 @@ read_header(istream &in) {
 
   if (memcmp(format, "txt ", 4) == 0) {
     _format_type = FT_text;
+    _compressed = false;
 
   } else if (memcmp(format, "bin ", 4) == 0) {
     _format_type = FT_binary;
+    _compressed = false;
+
+  } else if (memcmp(format, "tzip", 4) == 0) {
+    _format_type = FT_text;
+    _compressed = true;
 
-  } else if (memcmp(format, "com ", 4) == 0) {
-    _format_type = FT_compressed;
+  } else if (memcmp(format, "bzip", 4) == 0) {
+    _format_type = FT_binary;
+    _compressed = true;
 
   } else {
     xfile_cat.error()
@@ -342,13 +384,6 @@ read_header(istream &in) {
     return false;
   }
 
-  if (_format_type == FT_compressed) {
-    // Read and ignore the compression type, since we don't support
-    // compression anyway.
-    char compression_type[4];
-    in.read(compression_type, 4);
-  }
-
   char float_size[4];
   if (!in.read(float_size, 4)) {
     xfile_cat.error()
@@ -392,15 +427,11 @@ write_header(ostream &out) const {
 
   switch (_format_type) {
   case FT_text:
-    out.write("txt ", 4);
+    out.write(_compressed ? "tzip" : "txt ", 4);
     break;
 
   case FT_binary:
-    out.write("bin ", 4);
-    break;
-
-  case FT_compressed:
-    out.write("cmp ", 4);
+    out.write(_compressed ? "bzip" : "bin ", 4);
     break;
 
   default:
@@ -409,11 +440,6 @@ write_header(ostream &out) const {
     return false;
   }
 
-  if (_format_type == FT_compressed) {
-    // Write a bogus compression type, just so we have a valid header.
-    out.write("xxx ", 4);
-  }
-
   switch (_float_size) {
   case FS_32:
     out.write("0032", 4);
@@ -429,7 +455,7 @@ write_header(ostream &out) const {
     return false;
   }
 
-  if (_format_type == FT_text) {
+  if (_format_type == FT_text && !_compressed) {
     // If it's a text format, we can now write a newline.
     out << "\n";
   }
@@ -437,6 +463,203 @@ write_header(ostream &out) const {
   return true;
 }
 
+/**
+ * Reads the (uncompressed) body of the file, following the header, in
+ * whichever format the header specified.  Returns true on success, false
+ * otherwise.
+ */
+bool XFile::
+read_body(istream &in, const string &filename) {
+  if (_format_type == FT_binary) {
+    XFileBinaryReader reader(this, _float_size);
+    return reader.read(in, filename);
+  }
+
+  x_init_parser(in, filename, *this);
+  xyyparse();
+  x_cleanup_parser();
+
+  return (x_error_count() == 0);
+}
+
+/**
+ * Writes the (uncompressed) body of the file, following the header, in
+ * whichever format was selected by set_format_type().
+ */
+void XFile::
+write_body(ostream &out) const {
+  if (_format_type == FT_binary) {
+    XFileBinaryWriter writer(_float_size);
+    writer.write_file(this);
+    const Datagram &dg = writer.get_datagram();
+    out.write((const char *)dg.get_data(), dg.get_length());
+
+  } else {
+    write_text(out, 0);
+  }
+}
+
+#ifdef HAVE_ZLIB
+/**
+ * Reads the MSZIP-compressed body of a tzip or bzip file, following the
+ * header, and stores the decompressed result in body.  Returns true on
+ * success, false on error.
+ */
+bool XFile::
+decompress_mszip(istream &in, string &body) {
+  // The body begins with the total size of the uncompressed file, including
+  // the 16-byte header.
+  unsigned char size_data[4];
+  if (!in.read((char *)size_data, 4)) {
+    xfile_cat.error()
+      << "Truncated file.\n";
+    return false;
+  }
+  size_t total_size = ((size_t)size_data[0] | ((size_t)size_data[1] << 8) |
+                       ((size_t)size_data[2] << 16) |
+                       ((size_t)size_data[3] << 24));
+  if (total_size > 16) {
+    body.reserve(total_size - 16);
+  }
+
+  // Then it is a sequence of blocks, each of which is a raw deflate stream
+  // preceded by its uncompressed and compressed sizes and the signature "CK".
+  // Each block uses the output of the previous one as a preset dictionary.
+  pvector<unsigned char> buffer;
+  while (true) {
+    unsigned char block_header[4];
+    in.read((char *)block_header, 4);
+    if (in.gcount() == 0) {
+      break;
+    }
+    if (in.gcount() != 4) {
+      xfile_cat.error()
+        << "Truncated compressed block.\n";
+      return false;
+    }
+
+    size_t uncompressed_size = block_header[0] | (block_header[1] << 8);
+    size_t compressed_size = block_header[2] | (block_header[3] << 8);
+    if (compressed_size < 2) {
+      xfile_cat.error()
+        << "Invalid compressed block.\n";
+      return false;
+    }
+
+    buffer.resize(compressed_size);
+    if (!in.read((char *)&buffer[0], compressed_size) ||
+        buffer[0] != 'C' || buffer[1] != 'K') {
+      xfile_cat.error()
+        << "Invalid compressed block.\n";
+      return false;
+    }
+
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, -MAX_WBITS) != Z_OK) {
+      xfile_cat.error()
+        << "Unable to initialize zlib.\n";
+      return false;
+    }
+
+    if (!body.empty()) {
+      size_t dict_size = std::min(body.size(), mszip_block_size);
+      inflateSetDictionary(&z, (const Bytef *)body.data() + body.size() - dict_size,
+                           (uInt)dict_size);
+    }
+
+    size_t start = body.size();
+    body.resize(start + uncompressed_size);
+
+    z.next_in = (Bytef *)&buffer[2];
+    z.avail_in = (uInt)(compressed_size - 2);
+    z.next_out = (Bytef *)&body[start];
+    z.avail_out = (uInt)uncompressed_size;
+    int result = inflate(&z, Z_FINISH);
+    inflateEnd(&z);
+
+    if (z.avail_out != 0 ||
+        (result != Z_STREAM_END && result != Z_OK && result != Z_BUF_ERROR)) {
+      xfile_cat.error()
+        << "Corrupt compressed block.\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Compresses the indicated body with MSZIP and writes it to the stream,
+ * following the header.  This is the inverse of decompress_mszip().  Returns
+ * true on success, false on error.
+ */
+bool XFile::
+compress_mszip(ostream &out, const string &body) {
+  size_t total_size = body.size() + 16;
+  unsigned char size_data[4] = {
+    (unsigned char)(total_size & 0xff),
+    (unsigned char)((total_size >> 8) & 0xff),
+    (unsigned char)((total_size >> 16) & 0xff),
+    (unsigned char)((total_size >> 24) & 0xff),
+  };
+  out.write((const char *)size_data, 4);
+
+  // A deflated block of 32K can only exceed the 64K limit of the size field
+  // if something has gone badly wrong.
+  pvector<unsigned char> buffer(0xffff);
+  buffer[0] = 'C';
+  buffer[1] = 'K';
+
+  size_t pos = 0;
+  while (pos < body.size()) {
+    size_t block_size = std::min(body.size() - pos, mszip_block_size);
+
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+      xfile_cat.error()
+        << "Unable to initialize zlib.\n";
+      return false;
+    }
+
+    if (pos != 0) {
+      size_t dict_size = std::min(pos, mszip_block_size);
+      deflateSetDictionary(&z, (const Bytef *)body.data() + pos - dict_size,
+                           (uInt)dict_size);
+    }
+
+    z.next_in = (Bytef *)body.data() + pos;
+    z.avail_in = (uInt)block_size;
+    z.next_out = (Bytef *)&buffer[2];
+    z.avail_out = (uInt)(buffer.size() - 2);
+    int result = deflate(&z, Z_FINISH);
+    size_t compressed_size = z.total_out + 2;
+    deflateEnd(&z);
+
+    if (result != Z_STREAM_END) {
+      xfile_cat.error()
+        << "Unable to compress block.\n";
+      return false;
+    }
+
+    unsigned char block_header[4] = {
+      (unsigned char)(block_size & 0xff),
+      (unsigned char)((block_size >> 8) & 0xff),
+      (unsigned char)(compressed_size & 0xff),
+      (unsigned char)((compressed_size >> 8) & 0xff),
+    };
+    out.write((const char *)block_header, 4);
+    out.write((const char *)&buffer[0], compressed_size);
+
+    pos += block_size;
+  }
+
+  return true;
+}
+#endif  // HAVE_ZLIB
+
 /**
  * Returns a global XFile object that contains the standard list of Direct3D
  * template definitions that may be assumed to be at the head of every file.
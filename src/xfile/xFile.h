@@ -56,21 +56,35 @@ public:
   enum FormatType {
     FT_text,
     FT_binary,
-    FT_compressed,
   };
   enum FloatSize {
     FS_32,
     FS_64,
   };
 
+  INLINE void set_format_type(FormatType format_type);
+  INLINE FormatType get_format_type() const;
+  INLINE void set_compressed(bool compressed);
+  INLINE bool get_compressed() const;
+  INLINE void set_float_size(FloatSize float_size);
+  INLINE FloatSize get_float_size() const;
+
 private:
   bool read_header(std::istream &in);
+  bool read_body(std::istream &in, const std::string &filename);
   bool write_header(std::ostream &out) const;
+  void write_body(std::ostream &out) const;
+
+#ifdef HAVE_ZLIB
+  static bool decompress_mszip(std::istream &in, std::string &body);
+  static bool compress_mszip(std::ostream &out, const std::string &body);
+#endif  // HAVE_ZLIB
 
   static const XFile *get_standard_templates();
 
   int _major_version, _minor_version;
   FormatType _format_type;
+  bool _compressed;
   FloatSize _float_size;
   bool _keep_names;
 
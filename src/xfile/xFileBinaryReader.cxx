@@ -0,0 +1,628 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file xFileBinaryReader.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "xFileBinaryReader.h"
+#include "xBinaryDefs.h"
+#include "xLexerDefs.h"
+#include "xFileTemplate.h"
+#include "xFileDataNodeTemplate.h"
+#include "xFileDataNodeReference.h"
+#include "config_xfile.h"
+#include "string_utils.h"
+
+#include <stdio.h>  // for sprintf
+
+using std::istream;
+using std::string;
+
+/**
+ *
+ */
+XFileBinaryReader::
+XFileBinaryReader(XFile *x_file, XFile::FloatSize float_size) :
+  _x_file(x_file),
+  _float_size(float_size),
+  _has_pushback(false)
+{
+}
+
+/**
+ * Reads the remainder of the indicated stream, which should be positioned
+ * just following the .x file header, as binary tokens.  The filename is used
+ * only for reporting errors.
+ *
+ * Returns true if the file is successfully read, false if there was an error
+ * (in which case the file might have been partially read).
+ */
+bool XFileBinaryReader::
+read(istream &in, const string &filename) {
+  // We share the lexer's error reporting, so that errors detected later by
+  // finalize_parse_data() are counted along with our own.
+  x_init_lexer(in, filename);
+
+  // Slurp the whole body into memory; binary .x files are generally small
+  // relative to their text equivalents, and this lets us decode the tokens
+  // straight out of the buffer.
+  string body;
+  static const size_t buffer_size = 4096;
+  char buffer[buffer_size];
+  in.read(buffer, buffer_size);
+  size_t count = in.gcount();
+  while (count != 0) {
+    body.append(buffer, count);
+    in.read(buffer, buffer_size);
+    count = in.gcount();
+  }
+
+  _data = Datagram(body.data(), body.size());
+  _scan = DatagramIterator(_data);
+  _has_pushback = false;
+
+  Token token;
+  while (get_token(token)) {
+    switch (token._type) {
+    case XBT_template:
+      if (!read_template()) {
+        return false;
+      }
+      break;
+
+    case XBT_name:
+      unget_token(token);
+      if (!read_object(_x_file)) {
+        return false;
+      }
+      break;
+
+    case XBT_cbrace:
+      // The 3dsMax converter writes an extra one; the text parser tolerates
+      // it, so we do too.
+      break;
+
+    default:
+      error("Unexpected token " + format_string(token._type) +
+            " at top level", token._offset);
+      return false;
+    }
+  }
+
+  return (x_error_count() == 0);
+}
+
+/**
+ * Reads the next token from the input.  Returns true on success, or false at
+ * the end of the input (or if the input is truncated, in which case an error
+ * is also reported).
+ */
+bool XFileBinaryReader::
+get_token(Token &token) {
+  if (_has_pushback) {
+    token = _pushback;
+    _has_pushback = false;
+    return true;
+  }
+
+  token._offset = _scan.get_current_index();
+  if (_scan.get_remaining_size() < 2) {
+    if (_scan.get_remaining_size() != 0) {
+      error("Truncated token", token._offset);
+    }
+    return false;
+  }
+
+  token._type = _scan.get_uint16();
+  switch (token._type) {
+  case XBT_name:
+  case XBT_string:
+    {
+      if (_scan.get_remaining_size() < 4) {
+        break;
+      }
+      size_t length = _scan.get_uint32();
+      if (_scan.get_remaining_size() < length) {
+        break;
+      }
+      token._str = _scan.get_fixed_string(length);
+    }
+    return true;
+
+  case XBT_integer:
+    if (_scan.get_remaining_size() < 4) {
+      break;
+    }
+    token._int = (int)_scan.get_uint32();
+    return true;
+
+  case XBT_guid:
+    if (!token._guid.read_datagram(_scan)) {
+      break;
+    }
+    return true;
+
+  case XBT_integer_list:
+    {
+      if (_scan.get_remaining_size() < 4) {
+        break;
+      }
+      size_t num_ints = _scan.get_uint32();
+      if (_scan.get_remaining_size() / 4 < num_ints) {
+        break;
+      }
+      token._int_list = PTA_int::empty_array(num_ints);
+      for (size_t i = 0; i < num_ints; ++i) {
+        token._int_list[i] = (int)_scan.get_uint32();
+      }
+    }
+    return true;
+
+  case XBT_float_list:
+    {
+      if (_scan.get_remaining_size() < 4) {
+        break;
+      }
+      size_t num_floats = _scan.get_uint32();
+      token._double_list = PTA_double::empty_array(num_floats);
+      if (_float_size == XFile::FS_32) {
+        if (_scan.get_remaining_size() / 4 < num_floats) {
+          break;
+        }
+        for (size_t i = 0; i < num_floats; ++i) {
+          token._double_list[i] = _scan.get_float32();
+        }
+      } else {
+        if (_scan.get_remaining_size() / 8 < num_floats) {
+          break;
+        }
+        for (size_t i = 0; i < num_floats; ++i) {
+          token._double_list[i] = _scan.get_float64();
+        }
+      }
+    }
+    return true;
+
+  default:
+    // All of the other tokens stand alone.
+    return true;
+  }
+
+  error("Truncated token", token._offset);
+  return false;
+}
+
+/**
+ * Reads the next token, and reports an error if it is not of the indicated
+ * type.  Returns true if the token matched, false otherwise.
+ */
+bool XFileBinaryReader::
+expect_token(int type, Token &token) {
+  if (!get_token(token)) {
+    error("Unexpected end of file", _scan.get_current_index());
+    return false;
+  }
+  if (token._type != type) {
+    error("Expected token " + format_string(type) + ", got " +
+          format_string(token._type), token._offset);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Reads a template definition, following the TEMPLATE token, and adds it to
+ * the file.
+ */
+bool XFileBinaryReader::
+read_template() {
+  Token name, token, guid;
+  if (!expect_token(XBT_name, name) ||
+      !expect_token(XBT_obrace, token) ||
+      !expect_token(XBT_guid, guid)) {
+    return false;
+  }
+
+  XFileTemplate *xtemplate = new XFileTemplate(_x_file, name._str, guid._guid);
+  _x_file->add_child(xtemplate);
+
+  while (get_token(token)) {
+    switch (token._type) {
+    case XBT_cbrace:
+      return true;
+
+    case XBT_obracket:
+      if (!read_template_options(xtemplate)) {
+        return false;
+      }
+      break;
+
+    default:
+      if (!read_template_member(xtemplate, token)) {
+        return false;
+      }
+    }
+  }
+
+  error("Unexpected end of file in template " + name._str,
+        _scan.get_current_index());
+  return false;
+}
+
+/**
+ * Reads a single member of a template definition, beginning with the
+ * indicated token, which has already been read.
+ */
+bool XFileBinaryReader::
+read_template_member(XFileTemplate *xtemplate, const Token &first) {
+  Token token = first;
+  bool is_array = false;
+  if (token._type == XBT_array) {
+    is_array = true;
+    if (!get_token(token)) {
+      error("Unexpected end of file", _scan.get_current_index());
+      return false;
+    }
+  }
+
+  XFileDataDef::Type type;
+  XFileTemplate *member_template = nullptr;
+  if (token._type == XBT_name) {
+    member_template = _x_file->find_template(token._str);
+    if (member_template == nullptr) {
+      error("Unknown template: " + token._str, token._offset);
+      return false;
+    }
+    type = XFileDataDef::T_template;
+
+  } else if (!get_primitive_type(token._type, type)) {
+    error("Unexpected token " + format_string(token._type) +
+          " in template", token._offset);
+    return false;
+  }
+
+  string name;
+  if (!read_optional_name(name)) {
+    return false;
+  }
+
+  XFileDataDef *data_def =
+    new XFileDataDef(_x_file, name, type, member_template);
+  xtemplate->add_child(data_def);
+
+  while (get_token(token)) {
+    if (token._type == XBT_semicolon) {
+      return true;
+    }
+    if (!is_array || token._type != XBT_obracket) {
+      error("Expected semicolon in template", token._offset);
+      return false;
+    }
+
+    if (!get_token(token)) {
+      break;
+    }
+    if (token._type == XBT_integer) {
+      data_def->add_array_def(XFileArrayDef(token._int));
+
+    } else if (token._type == XBT_name) {
+      XFileNode *size_def = xtemplate->find_child(token._str);
+      if (size_def == nullptr ||
+          !size_def->is_of_type(XFileDataDef::get_class_type())) {
+        error("Unknown identifier: " + token._str, token._offset);
+        return false;
+      }
+      data_def->add_array_def(XFileArrayDef(DCAST(XFileDataDef, size_def)));
+
+    } else {
+      error("Invalid array dimension", token._offset);
+      return false;
+    }
+
+    if (!expect_token(XBT_cbracket, token)) {
+      return false;
+    }
+  }
+
+  error("Unexpected end of file", _scan.get_current_index());
+  return false;
+}
+
+/**
+ * Reads the list of options, or the open ellipsis, following the OBRACKET
+ * token within a template definition.
+ */
+bool XFileBinaryReader::
+read_template_options(XFileTemplate *xtemplate) {
+  Token token;
+  while (get_token(token)) {
+    switch (token._type) {
+    case XBT_cbracket:
+      return true;
+
+    case XBT_dot:
+      // "..." appears as three separate dot tokens.
+      xtemplate->set_open(true);
+      break;
+
+    case XBT_comma:
+      break;
+
+    case XBT_name:
+      {
+        Token guid;
+        XFileTemplate *option = nullptr;
+        if (get_token(guid)) {
+          if (guid._type == XBT_guid) {
+            option = _x_file->find_template(guid._guid);
+          } else {
+            unget_token(guid);
+          }
+        }
+        if (option == nullptr) {
+          option = _x_file->find_template(token._str);
+        }
+        if (option == nullptr) {
+          error("Unknown template: " + token._str, token._offset);
+          return false;
+        }
+        xtemplate->add_option(option);
+      }
+      break;
+
+    default:
+      error("Unexpected token " + format_string(token._type) +
+            " in template options", token._offset);
+      return false;
+    }
+  }
+
+  error("Unexpected end of file", _scan.get_current_index());
+  return false;
+}
+
+/**
+ * Reads a data object, beginning with the name of its template, and adds it
+ * to the indicated parent.
+ */
+bool XFileBinaryReader::
+read_object(XFileNode *parent) {
+  Token template_name, token;
+  if (!expect_token(XBT_name, template_name)) {
+    return false;
+  }
+  string name;
+  if (!read_optional_name(name) ||
+      !expect_token(XBT_obrace, token)) {
+    return false;
+  }
+
+  XFileTemplate *xtemplate = _x_file->find_template(template_name._str);
+  if (xtemplate == nullptr) {
+    error("Unknown template: " + template_name._str, template_name._offset);
+    return false;
+  }
+
+  // Record the location of this object, so that XFileParseData can report it
+  // if finalize_parse_data() later finds a problem.
+  set_location(template_name._offset);
+
+  XFileDataNodeTemplate *object =
+    new XFileDataNodeTemplate(_x_file, name, xtemplate);
+  parent->add_child(object);
+
+  // The optional class id of the object is ignored, as it is by the parser.
+  if (get_token(token) && token._type != XBT_guid) {
+    unget_token(token);
+  }
+
+  while (get_token(token)) {
+    switch (token._type) {
+    case XBT_cbrace:
+      object->finalize_parse_data();
+      return true;
+
+    case XBT_obrace:
+      if (!read_data_reference(object)) {
+        return false;
+      }
+      break;
+
+    case XBT_name:
+      unget_token(token);
+      if (!read_object(object)) {
+        return false;
+      }
+      set_location(template_name._offset);
+      break;
+
+    case XBT_integer:
+      {
+        PTA_int int_list = PTA_int::empty_array(1);
+        int_list[0] = token._int;
+        object->add_parse_int(int_list);
+      }
+      break;
+
+    case XBT_integer_list:
+      object->add_parse_int(token._int_list);
+      break;
+
+    case XBT_float_list:
+      object->add_parse_double(token._double_list);
+      break;
+
+    case XBT_string:
+      object->add_parse_string(token._str);
+      break;
+
+    case XBT_semicolon:
+    case XBT_comma:
+      // The list separators following a string carry no information.
+      break;
+
+    default:
+      error("Unexpected token " + format_string(token._type) +
+            " in data object", token._offset);
+      return false;
+    }
+  }
+
+  error("Unexpected end of file in " + template_name._str,
+        _scan.get_current_index());
+  return false;
+}
+
+/**
+ * Reads a reference to a previously-defined data object, following the
+ * OBRACE token, and adds it to the indicated parent.
+ */
+bool XFileBinaryReader::
+read_data_reference(XFileNode *parent) {
+  Token token;
+  if (!get_token(token)) {
+    error("Unexpected end of file", _scan.get_current_index());
+    return false;
+  }
+
+  string name;
+  XFileDataNodeTemplate *data_object = nullptr;
+  if (token._type == XBT_guid) {
+    data_object = _x_file->find_data_object(token._guid);
+
+  } else {
+    unget_token(token);
+    if (!read_optional_name(name)) {
+      return false;
+    }
+    Token guid;
+    if (get_token(guid)) {
+      if (guid._type == XBT_guid) {
+        data_object = _x_file->find_data_object(guid._guid);
+      } else {
+        unget_token(guid);
+      }
+    }
+    if (data_object == nullptr) {
+      data_object = _x_file->find_data_object(name);
+    }
+  }
+
+  if (data_object == nullptr) {
+    error("Unknown data_object: " + name, token._offset);
+    return false;
+  }
+
+  parent->add_child(new XFileDataNodeReference(data_object));
+  return expect_token(XBT_cbrace, token);
+}
+
+/**
+ * Reads a sequence of zero or more NAME and INTEGER tokens, which together
+ * make up a (possibly multiword) name, as in the text format.
+ */
+bool XFileBinaryReader::
+read_optional_name(string &name) {
+  Token token;
+  while (get_token(token)) {
+    if (token._type == XBT_name) {
+      if (!name.empty()) {
+        name += " ";
+      }
+      name += token._str;
+
+    } else if (token._type == XBT_integer && !name.empty()) {
+      name += " " + format_string(token._int);
+
+    } else {
+      unget_token(token);
+      return true;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Maps a primitive type token to the corresponding XFileDataDef type.
+ * Returns true if the token names a primitive type, false otherwise.
+ */
+bool XFileBinaryReader::
+get_primitive_type(int token_type, XFileDataDef::Type &type) {
+  switch (token_type) {
+  case XBT_word:
+    type = XFileDataDef::T_word;
+    return true;
+
+  case XBT_dword:
+    type = XFileDataDef::T_dword;
+    return true;
+
+  case XBT_float:
+    type = XFileDataDef::T_float;
+    return true;
+
+  case XBT_double:
+    type = XFileDataDef::T_double;
+    return true;
+
+  case XBT_char:
+    type = XFileDataDef::T_char;
+    return true;
+
+  case XBT_uchar:
+    type = XFileDataDef::T_uchar;
+    return true;
+
+  case XBT_sword:
+    type = XFileDataDef::T_sword;
+    return true;
+
+  case XBT_sdword:
+    type = XFileDataDef::T_sdword;
+    return true;
+
+  case XBT_lpstr:
+    type = XFileDataDef::T_string;
+    return true;
+
+  case XBT_unicode:
+    type = XFileDataDef::T_unicode;
+    return true;
+
+  case XBT_cstring:
+    type = XFileDataDef::T_cstring;
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+/**
+ * Stores the indicated byte offset in the lexer's notion of the current
+ * location, which is what gets reported with any error messages.
+ */
+void XFileBinaryReader::
+set_location(size_t offset) {
+  x_line_number = 0;
+  x_col_number = 1;
+  sprintf(x_current_line, "(binary data at offset %lu)",
+          (unsigned long)offset);
+}
+
+/**
+ * Reports an error at the indicated byte offset within the binary data.
+ */
+void XFileBinaryReader::
+error(const string &message, size_t offset) {
+  set_location(offset);
+  xyyerror(message);
+}
@@ -0,0 +1,86 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file xFileBinaryReader.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef XFILEBINARYREADER_H
+#define XFILEBINARYREADER_H
+
+#include "pandatoolbase.h"
+#include "xFile.h"
+#include "xFileDataDef.h"
+#include "windowsGuid.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "pta_int.h"
+#include "pta_double.h"
+
+class XFileTemplate;
+class XFileDataNodeTemplate;
+
+/**
+ * Reads the body of a binary .x file (everything following the header) and
+ * builds the corresponding templates and data objects within an XFile.
+ *
+ * This takes the place of the bison parser for binary files: it tokenizes the
+ * binary stream directly and constructs the same XFileTemplate and
+ * XFileDataNodeTemplate objects the parser would, feeding the data values
+ * through the same add_parse_*() / finalize_parse_data() interface, so the
+ * resulting structure is identical to that read from the equivalent text
+ * file.
+ */
+class XFileBinaryReader {
+public:
+  XFileBinaryReader(XFile *x_file, XFile::FloatSize float_size);
+
+  bool read(std::istream &in, const std::string &filename);
+
+private:
+  class Token {
+  public:
+    int _type;
+    size_t _offset;
+    std::string _str;
+    int _int;
+    WindowsGuid _guid;
+    PTA_int _int_list;
+    PTA_double _double_list;
+  };
+
+  bool get_token(Token &token);
+  INLINE void unget_token(const Token &token);
+  bool expect_token(int type, Token &token);
+
+  bool read_template();
+  bool read_template_member(XFileTemplate *xtemplate, const Token &token);
+  bool read_template_options(XFileTemplate *xtemplate);
+  bool read_object(XFileNode *parent);
+  bool read_data_reference(XFileNode *parent);
+  bool read_optional_name(std::string &name);
+
+  static bool get_primitive_type(int token_type, XFileDataDef::Type &type);
+
+  void set_location(size_t offset);
+  void error(const std::string &message, size_t offset);
+
+  XFile *_x_file;
+  XFile::FloatSize _float_size;
+
+  Datagram _data;
+  DatagramIterator _scan;
+
+  Token _pushback;
+  bool _has_pushback;
+};
+
+#include "xFileBinaryReader.I"
+
+#endif
@@ -0,0 +1,315 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file xFileBinaryWriter.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "xFileBinaryWriter.h"
+#include "xBinaryDefs.h"
+#include "xFileTemplate.h"
+#include "xFileDataDef.h"
+#include "xFileArrayDef.h"
+#include "xFileDataNodeTemplate.h"
+#include "xFileDataNodeReference.h"
+#include "xFileDataObjectArray.h"
+#include "xFileDataObjectDouble.h"
+#include "xFileDataObjectString.h"
+#include "dcast.h"
+
+using std::string;
+
+/**
+ *
+ */
+XFileBinaryWriter::
+XFileBinaryWriter(XFile::FloatSize float_size) :
+  _float_size(float_size)
+{
+}
+
+/**
+ * Writes all of the templates and data objects within the indicated file to
+ * the internal datagram, which may then be retrieved with get_datagram().
+ */
+void XFileBinaryWriter::
+write_file(const XFile *x_file) {
+  for (int i = 0; i < x_file->get_num_children(); ++i) {
+    XFileNode *child = x_file->get_child(i);
+    if (child->is_of_type(XFileTemplate::get_class_type())) {
+      write_template(DCAST(XFileTemplate, child));
+
+    } else if (child->is_exact_type(XFileDataNodeTemplate::get_class_type())) {
+      write_object(DCAST(XFileDataNodeTemplate, child));
+    }
+  }
+}
+
+/**
+ * Writes the definition of the indicated template.
+ */
+void XFileBinaryWriter::
+write_template(const XFileTemplate *xtemplate) {
+  add_token(XBT_template);
+  add_name(xtemplate->get_name());
+  add_token(XBT_obrace);
+  add_token(XBT_guid);
+  xtemplate->get_guid().write_datagram(_dg);
+
+  for (int i = 0; i < xtemplate->get_num_children(); ++i) {
+    XFileNode *child = xtemplate->get_child(i);
+    if (child->is_of_type(XFileDataDef::get_class_type())) {
+      write_data_def(DCAST(XFileDataDef, child));
+    }
+  }
+
+  if (xtemplate->get_open()) {
+    add_token(XBT_obracket);
+    add_token(XBT_dot);
+    add_token(XBT_dot);
+    add_token(XBT_dot);
+    add_token(XBT_cbracket);
+
+  } else if (xtemplate->get_num_options() != 0) {
+    add_token(XBT_obracket);
+    for (int i = 0; i < xtemplate->get_num_options(); ++i) {
+      XFileTemplate *option = xtemplate->get_option(i);
+      if (i != 0) {
+        add_token(XBT_comma);
+      }
+      add_name(option->get_name());
+      add_token(XBT_guid);
+      option->get_guid().write_datagram(_dg);
+    }
+    add_token(XBT_cbracket);
+  }
+
+  add_token(XBT_cbrace);
+}
+
+/**
+ * Writes a single member of a template definition.
+ */
+void XFileBinaryWriter::
+write_data_def(const XFileDataDef *data_def) {
+  int num_array_defs = data_def->get_num_array_defs();
+  if (num_array_defs != 0) {
+    add_token(XBT_array);
+  }
+
+  switch (data_def->get_data_type()) {
+  case XFileDataDef::T_word:
+    add_token(XBT_word);
+    break;
+
+  case XFileDataDef::T_dword:
+    add_token(XBT_dword);
+    break;
+
+  case XFileDataDef::T_float:
+    add_token(XBT_float);
+    break;
+
+  case XFileDataDef::T_double:
+    add_token(XBT_double);
+    break;
+
+  case XFileDataDef::T_char:
+    add_token(XBT_char);
+    break;
+
+  case XFileDataDef::T_uchar:
+    add_token(XBT_uchar);
+    break;
+
+  case XFileDataDef::T_sword:
+    add_token(XBT_sword);
+    break;
+
+  case XFileDataDef::T_sdword:
+    add_token(XBT_sdword);
+    break;
+
+  case XFileDataDef::T_string:
+    add_token(XBT_lpstr);
+    break;
+
+  case XFileDataDef::T_cstring:
+    add_token(XBT_cstring);
+    break;
+
+  case XFileDataDef::T_unicode:
+    add_token(XBT_unicode);
+    break;
+
+  case XFileDataDef::T_template:
+    add_name(data_def->get_template()->get_name());
+    break;
+  }
+
+  if (data_def->has_name()) {
+    add_name(data_def->get_name());
+  }
+
+  for (int i = 0; i < num_array_defs; ++i) {
+    const XFileArrayDef &array_def = data_def->get_array_def(i);
+    add_token(XBT_obracket);
+    if (array_def.is_fixed_size()) {
+      add_integer(array_def.get_fixed_size());
+    } else {
+      add_name(array_def.get_dynamic_size()->get_name());
+    }
+    add_token(XBT_cbracket);
+  }
+
+  add_token(XBT_semicolon);
+}
+
+/**
+ * Writes the indicated data object, with all of its data values and child
+ * objects.
+ */
+void XFileBinaryWriter::
+write_object(const XFileDataNodeTemplate *object) {
+  add_name(object->get_template()->get_name());
+  if (object->has_name()) {
+    add_name(object->get_name());
+  }
+  add_token(XBT_obrace);
+
+  for (int i = 0; i < object->size(); ++i) {
+    write_data((*object)[i]);
+  }
+  flush_lists();
+
+  for (int i = 0; i < object->get_num_children(); ++i) {
+    XFileNode *child = object->get_child(i);
+    if (child->is_of_type(XFileDataNodeReference::get_class_type())) {
+      XFileDataNodeReference *ref = DCAST(XFileDataNodeReference, child);
+      add_token(XBT_obrace);
+      add_name(ref->get_object()->get_name());
+      add_token(XBT_cbrace);
+
+    } else if (child->is_exact_type(XFileDataNodeTemplate::get_class_type())) {
+      write_object(DCAST(XFileDataNodeTemplate, child));
+    }
+  }
+
+  add_token(XBT_cbrace);
+}
+
+/**
+ * Writes the indicated data value, recursing into its nested elements if it
+ * is an array or a structure.  Numeric values are accumulated into the
+ * pending lists, to be written as a single token by flush_lists().
+ */
+void XFileBinaryWriter::
+write_data(const XFileDataObject &data) {
+  if (data.get_type() == XFileDataObjectArray::get_class_type()) {
+    // A packed array can be copied straight into the pending list.
+    const XFileDataObjectArray &array = (const XFileDataObjectArray &)data;
+    if (array.get_packed_type() == XFileDataObjectArray::PT_int) {
+      if (!_double_list.empty()) {
+        flush_lists();
+      }
+      array.get_int_values(_int_list);
+      return;
+
+    } else if (array.get_packed_type() == XFileDataObjectArray::PT_double) {
+      if (!_int_list.empty()) {
+        flush_lists();
+      }
+      array.get_double_values(_double_list);
+      return;
+    }
+  }
+
+  if (data.is_complex_object()) {
+    for (int i = 0; i < data.size(); ++i) {
+      write_data(data[i]);
+    }
+
+  } else if (data.get_type() == XFileDataObjectDouble::get_class_type()) {
+    if (!_int_list.empty()) {
+      flush_lists();
+    }
+    _double_list.push_back(data.d());
+
+  } else if (data.get_type() == XFileDataObjectString::get_class_type()) {
+    flush_lists();
+    add_string(data.s());
+
+  } else {
+    if (!_double_list.empty()) {
+      flush_lists();
+    }
+    _int_list.push_back(data.i());
+  }
+}
+
+/**
+ * Writes out any integer or floating-point values accumulated by
+ * write_data().
+ */
+void XFileBinaryWriter::
+flush_lists() {
+  if (!_int_list.empty()) {
+    add_token(XBT_integer_list);
+    _dg.add_uint32((uint32_t)_int_list.size());
+    for (int value : _int_list) {
+      _dg.add_uint32((uint32_t)value);
+    }
+    _int_list.clear();
+  }
+
+  if (!_double_list.empty()) {
+    add_token(XBT_float_list);
+    _dg.add_uint32((uint32_t)_double_list.size());
+    if (_float_size == XFile::FS_32) {
+      for (double value : _double_list) {
+        _dg.add_float32((float)value);
+      }
+    } else {
+      for (double value : _double_list) {
+        _dg.add_float64(value);
+      }
+    }
+    _double_list.clear();
+  }
+}
+
+/**
+ * Appends a NAME token.
+ */
+void XFileBinaryWriter::
+add_name(const string &name) {
+  add_token(XBT_name);
+  _dg.add_uint32((uint32_t)name.length());
+  _dg.append_data(name.data(), name.length());
+}
+
+/**
+ * Appends a STRING token, followed by the semicolon that terminates it.
+ */
+void XFileBinaryWriter::
+add_string(const string &str) {
+  add_token(XBT_string);
+  _dg.add_uint32((uint32_t)str.length());
+  _dg.append_data(str.data(), str.length());
+  add_token(XBT_semicolon);
+}
+
+/**
+ * Appends an INTEGER token.
+ */
+void XFileBinaryWriter::
+add_integer(int value) {
+  add_token(XBT_integer);
+  _dg.add_uint32((uint32_t)value);
+}
@@ -0,0 +1,64 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file xFileBinaryWriter.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef XFILEBINARYWRITER_H
+#define XFILEBINARYWRITER_H
+
+#include "pandatoolbase.h"
+#include "xFile.h"
+#include "datagram.h"
+#include "pvector.h"
+
+class XFileTemplate;
+class XFileDataDef;
+class XFileDataNodeTemplate;
+class XFileDataObject;
+
+/**
+ * Writes the body of a binary .x file (everything following the header), the
+ * inverse of XFileBinaryReader.
+ *
+ * Runs of consecutive integer or floating-point data values are collapsed
+ * into a single INTEGER_LIST or FLOAT_LIST token each, which is what makes
+ * the binary format so much more compact, and faster to read, than the text
+ * format.
+ */
+class XFileBinaryWriter {
+public:
+  XFileBinaryWriter(XFile::FloatSize float_size);
+
+  void write_file(const XFile *x_file);
+  INLINE const Datagram &get_datagram() const;
+
+private:
+  void write_template(const XFileTemplate *xtemplate);
+  void write_data_def(const XFileDataDef *data_def);
+  void write_object(const XFileDataNodeTemplate *object);
+  void write_data(const XFileDataObject &data);
+  void flush_lists();
+
+  INLINE void add_token(int token);
+  void add_name(const std::string &name);
+  void add_string(const std::string &str);
+  void add_integer(int value);
+
+  XFile::FloatSize _float_size;
+  Datagram _dg;
+
+  pvector<int> _int_list;
+  pvector<double> _double_list;
+};
+
+#include "xFileBinaryWriter.I"
+
+#endif
@@ -400,9 +400,19 @@ unpack_value(const XFileParseDataList &parse_data_list, int array_index,
                                         index, sub_index);
 
   } else {
-    data_value = new XFileDataObjectArray(this);
     int array_size = _array_def[array_index].get_size(prev_data);
 
+    // The innermost dimension of an array of numbers is unpacked directly
+    // into a packed buffer, rather than into one object per value.
+    bool is_double;
+    int stride;
+    if (array_index + 1 == (int)_array_def.size() &&
+        (stride = get_packed_stride(is_double)) != 0) {
+      return unpack_packed_array(parse_data_list, array_size, stride,
+                                 is_double, index, sub_index);
+    }
+
+    data_value = new XFileDataObjectArray(this);
     for (int i = 0; i < array_size; i++) {
       if (index >= parse_data_list._list.size()) {
         xyyerror(std::string("Expected ") + format_string(array_size)
@@ -424,6 +434,138 @@ unpack_value(const XFileParseDataList &parse_data_list, int array_index,
   return data_value;
 }
 
+/**
+ * Determines whether the elements of this data element, if it is an array,
+ * may be stored packed: that is, whether it is an array of numbers, or of a
+ * template that consists solely of non-array numbers of one kind.  If so,
+ * returns the number of values per element, and sets is_double according to
+ * the kind of numbers; otherwise, returns 0.
+ */
+int XFileDataDef::
+get_packed_stride(bool &is_double) const {
+  if (_type != T_template) {
+    switch (_type) {
+    case T_float:
+    case T_double:
+      is_double = true;
+      return 1;
+
+    case T_string:
+    case T_cstring:
+    case T_unicode:
+      return 0;
+
+    default:
+      is_double = false;
+      return 1;
+    }
+  }
+
+  int num_members = _template->get_num_children();
+  for (int i = 0; i < num_members; i++) {
+    XFileNode *child = _template->get_child(i);
+    if (!child->is_of_type(XFileDataDef::get_class_type())) {
+      return 0;
+    }
+    XFileDataDef *member = DCAST(XFileDataDef, child);
+    bool member_is_double;
+    if (member->get_num_array_defs() != 0 ||
+        member->get_data_type() == T_template ||
+        member->get_packed_stride(member_is_double) == 0) {
+      return 0;
+    }
+    if (i == 0) {
+      is_double = member_is_double;
+    } else if (member_is_double != is_double) {
+      return 0;
+    }
+  }
+
+  return num_members;
+}
+
+/**
+ * Unpacks array_size elements of stride values each from the
+ * parse_data_list into a new packed XFileDataObjectArray.
+ */
+PT(XFileDataObject) XFileDataDef::
+unpack_packed_array(const XFileParseDataList &parse_data_list,
+                    int array_size, int stride, bool is_double,
+                    size_t &index, size_t &sub_index) const {
+  PT(XFileDataObjectArray) data_value = new XFileDataObjectArray(this);
+  size_t num_values = (size_t)array_size * stride;
+
+  pvector<int> *ints = nullptr;
+  pvector<double> *doubles = nullptr;
+  if (is_double) {
+    doubles = &data_value->modify_packed_doubles(stride);
+    doubles->reserve(num_values);
+  } else {
+    ints = &data_value->modify_packed_ints(stride);
+    ints->reserve(num_values);
+  }
+
+  size_t count = 0;
+  while (count < num_values) {
+    if (index >= parse_data_list._list.size()) {
+      xyyerror(std::string("Expected ") + format_string(array_size)
+               + " array elements, found " + format_string(count / stride));
+      break;
+    }
+
+    // Copy as many values as we can from the current parse list at once.
+    const XFileParseData &parse_data = parse_data_list._list[index];
+    size_t list_size;
+    if ((parse_data._parse_flags & XFileParseData::PF_double) != 0 &&
+        is_double) {
+      const pvector<double> &list = parse_data._double_list.v();
+      list_size = list.size();
+      size_t n = std::min(num_values - count, list_size - sub_index);
+      doubles->insert(doubles->end(), list.begin() + sub_index,
+                      list.begin() + sub_index + n);
+      sub_index += n;
+      count += n;
+
+    } else if ((parse_data._parse_flags & XFileParseData::PF_int) != 0) {
+      const pvector<int> &list = parse_data._int_list.v();
+      list_size = list.size();
+      size_t n = std::min(num_values - count, list_size - sub_index);
+      if (is_double) {
+        doubles->insert(doubles->end(), list.begin() + sub_index,
+                        list.begin() + sub_index + n);
+      } else {
+        ints->insert(ints->end(), list.begin() + sub_index,
+                     list.begin() + sub_index + n);
+      }
+      sub_index += n;
+      count += n;
+
+    } else {
+      if (is_double) {
+        parse_data.yyerror("Expected floating-point data for " + get_name());
+      } else {
+        parse_data.yyerror("Expected integer data for " + get_name());
+      }
+      break;
+    }
+
+    if (sub_index >= list_size) {
+      index++;
+      sub_index = 0;
+    }
+  }
+
+  // If we came up short, discard any partial element.
+  size_t num_complete = (count / stride) * stride;
+  if (is_double) {
+    doubles->resize(num_complete);
+  } else {
+    ints->resize(num_complete);
+  }
+
+  return data_value;
+}
+
 /**
  * Returns a newly-allocated zero integer value.
  */
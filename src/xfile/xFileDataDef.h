@@ -100,6 +100,12 @@ private:
                  size_t &index, size_t &sub_index,
                  UnpackMethod unpack_method) const;
 
+  int get_packed_stride(bool &is_double) const;
+  PT(XFileDataObject)
+    unpack_packed_array(const XFileParseDataList &parse_data_list,
+                        int array_size, int stride, bool is_double,
+                        size_t &index, size_t &sub_index) const;
+
   PT(XFileDataObject) zero_fill_integer_value() const;
   PT(XFileDataObject) zero_fill_double_value() const;
   PT(XFileDataObject) zero_fill_string_value() const;
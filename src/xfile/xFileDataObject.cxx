@@ -156,6 +156,42 @@ add_Coords2d(XFile *x_file, const LVecBase2d &coords) {
   return *node;
 }
 
+/**
+ * Appends all of the integer values nested within this object, recursively,
+ * to the indicated vector.  If the object is not complex, this appends its
+ * own value.
+ */
+void XFileDataObject::
+get_int_values(pvector<int> &values) const {
+  if (!is_complex_object()) {
+    values.push_back(get_int_value());
+    return;
+  }
+
+  int num_elements = get_num_elements();
+  for (int i = 0; i < num_elements; i++) {
+    ((XFileDataObject *)this)->get_element(i)->get_int_values(values);
+  }
+}
+
+/**
+ * Appends all of the floating-point values nested within this object,
+ * recursively, to the indicated vector.  If the object is not complex, this
+ * appends its own value.
+ */
+void XFileDataObject::
+get_double_values(pvector<double> &values) const {
+  if (!is_complex_object()) {
+    values.push_back(get_double_value());
+    return;
+  }
+
+  int num_elements = get_num_elements();
+  for (int i = 0; i < num_elements; i++) {
+    ((XFileDataObject *)this)->get_element(i)->get_double_values(values);
+  }
+}
+
 /**
  * Adds the indicated element as a nested data element, if this data object
  * type supports it.  Returns true if added successfully, false if the data
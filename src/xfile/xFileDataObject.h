@@ -19,6 +19,7 @@
 #include "pointerTo.h"
 #include "dcast.h"
 #include "luse.h"
+#include "pvector.h"
 
 class XFile;
 class XFileDataDef;
@@ -84,6 +85,13 @@ public:
                                     const LColor &color);
   XFileDataObject &add_Coords2d(XFile *x_file, const LVecBase2d &coords);
 
+  // These retrieve all of the numeric values nested within the object, in
+  // order, which is much faster than walking through a large array element
+  // by element.
+
+  virtual void get_int_values(pvector<int> &values) const;
+  virtual void get_double_values(pvector<double> &values) const;
+
 public:
   virtual bool add_element(XFileDataObject *element);
 
@@ -95,12 +103,12 @@ protected:
   virtual void set_int_value(int int_value);
   virtual void set_double_value(double double_value);
   virtual void set_string_value(const std::string &string_value);
-  void store_double_array(int num_elements, const double *values);
+  virtual void store_double_array(int num_elements, const double *values);
 
   virtual int get_int_value() const;
   virtual double get_double_value() const;
   virtual std::string get_string_value() const;
-  void get_double_array(int num_elements, double *values) const;
+  virtual void get_double_array(int num_elements, double *values) const;
 
   virtual int get_num_elements() const;
   virtual XFileDataObject *get_element(int n);
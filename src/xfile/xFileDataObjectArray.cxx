@@ -12,11 +12,42 @@
  */
 
 #include "xFileDataObjectArray.h"
+#include "xFileDataObjectInteger.h"
+#include "xFileDataObjectDouble.h"
+#include "xFileDataNodeTemplate.h"
+#include "xFileDataDef.h"
+#include "xFileTemplate.h"
 #include "string_utils.h"
 #include "indent.h"
 
 TypeHandle XFileDataObjectArray::_type_handle;
 
+/**
+ * Switches the array to packed integer storage, with the indicated number of
+ * values per element, and returns the buffer for the caller to fill.  The
+ * array must not already contain any elements.
+ */
+pvector<int> &XFileDataObjectArray::
+modify_packed_ints(int stride) {
+  nassertr(_nested_elements.empty() && stride > 0, _packed_ints);
+  _packed_type = PT_int;
+  _packed_stride = stride;
+  return _packed_ints;
+}
+
+/**
+ * Switches the array to packed floating-point storage, with the indicated
+ * number of values per element, and returns the buffer for the caller to
+ * fill.  The array must not already contain any elements.
+ */
+pvector<double> &XFileDataObjectArray::
+modify_packed_doubles(int stride) {
+  nassertr(_nested_elements.empty() && stride > 0, _packed_doubles);
+  _packed_type = PT_double;
+  _packed_stride = stride;
+  return _packed_doubles;
+}
+
 /**
  * Returns true if this kind of data object is a complex object that can hold
  * nested data elements, false otherwise.
@@ -33,16 +64,63 @@ is_complex_object() const {
  */
 bool XFileDataObjectArray::
 add_element(XFileDataObject *element) {
+  unpack_elements();
   _nested_elements.push_back(element);
   return true;
 }
 
+/**
+ * Appends all of the integer values nested within this object, recursively,
+ * to the indicated vector.
+ */
+void XFileDataObjectArray::
+get_int_values(pvector<int> &values) const {
+  switch (_packed_type) {
+  case PT_int:
+    values.insert(values.end(), _packed_ints.begin(), _packed_ints.end());
+    break;
+
+  case PT_double:
+    values.reserve(values.size() + _packed_doubles.size());
+    for (double value : _packed_doubles) {
+      values.push_back((int)value);
+    }
+    break;
+
+  default:
+    XFileDataObject::get_int_values(values);
+  }
+}
+
+/**
+ * Appends all of the floating-point values nested within this object,
+ * recursively, to the indicated vector.
+ */
+void XFileDataObjectArray::
+get_double_values(pvector<double> &values) const {
+  switch (_packed_type) {
+  case PT_int:
+    values.insert(values.end(), _packed_ints.begin(), _packed_ints.end());
+    break;
+
+  case PT_double:
+    values.insert(values.end(), _packed_doubles.begin(), _packed_doubles.end());
+    break;
+
+  default:
+    XFileDataObject::get_double_values(values);
+  }
+}
+
 /**
  * Writes a suitable representation of this node to an .x file in text mode.
  */
 void XFileDataObjectArray::
 write_data(std::ostream &out, int indent_level, const char *separator) const {
-  if (!_nested_elements.empty()) {
+  if (_packed_type != PT_none) {
+    write_packed_data(out, indent_level, separator);
+
+  } else if (!_nested_elements.empty()) {
     bool indented = false;
     for (size_t i = 0; i < _nested_elements.size() - 1; i++) {
       XFileDataObject *object = _nested_elements[i];
@@ -84,13 +162,64 @@ write_data(std::ostream &out, int indent_level, const char *separator) const {
   }
 }
 
+/**
+ * Stores the indicated array of values into the elements of the array.  This
+ * bypasses the element objects if the array is packed.
+ */
+void XFileDataObjectArray::
+store_double_array(int num_elements, const double *values) {
+  if (_packed_stride == 1 && num_elements == get_num_elements()) {
+    if (_packed_type == PT_double) {
+      _packed_doubles.assign(values, values + num_elements);
+      return;
+    }
+    if (_packed_type == PT_int) {
+      for (int i = 0; i < num_elements; i++) {
+        _packed_ints[i] = (int)values[i];
+      }
+      return;
+    }
+  }
+
+  XFileDataObject::store_double_array(num_elements, values);
+}
+
+/**
+ * Fills the indicated array with the values of the elements of the array.
+ * This bypasses the element objects if the array is packed.
+ */
+void XFileDataObjectArray::
+get_double_array(int num_elements, double *values) const {
+  if (_packed_stride == 1 && num_elements == get_num_elements()) {
+    if (_packed_type == PT_double) {
+      std::copy(_packed_doubles.begin(), _packed_doubles.end(), values);
+      return;
+    }
+    if (_packed_type == PT_int) {
+      std::copy(_packed_ints.begin(), _packed_ints.end(), values);
+      return;
+    }
+  }
+
+  XFileDataObject::get_double_array(num_elements, values);
+}
+
 /**
  * Returns the number of nested data elements within the object.  This may be,
  * e.g.  the size of the array, if it is an array.
  */
 int XFileDataObjectArray::
 get_num_elements() const {
-  return _nested_elements.size();
+  switch (_packed_type) {
+  case PT_int:
+    return _packed_ints.size() / _packed_stride;
+
+  case PT_double:
+    return _packed_doubles.size() / _packed_stride;
+
+  default:
+    return _nested_elements.size();
+  }
 }
 
 /**
@@ -98,6 +227,124 @@ get_num_elements() const {
  */
 XFileDataObject *XFileDataObjectArray::
 get_element(int n) {
+  unpack_elements();
   nassertr(n >= 0 && n < (int)_nested_elements.size(), nullptr);
   return _nested_elements[n];
 }
+
+/**
+ * If the array is currently stored packed, creates the individual element
+ * objects from the packed values, and discards the packed buffer.  This is
+ * necessary before the elements can be returned by get_element().
+ */
+void XFileDataObjectArray::
+unpack_elements() {
+  if (_packed_type == PT_none) {
+    return;
+  }
+
+  nassertv(_data_def != nullptr);
+  int num_elements = get_num_elements();
+  _nested_elements.reserve(num_elements);
+
+  XFileTemplate *xtemplate = nullptr;
+  if (_data_def->get_data_type() == XFileDataDef::T_template) {
+    xtemplate = _data_def->get_template();
+    nassertv(xtemplate->get_num_children() == _packed_stride);
+  }
+
+  for (int i = 0; i < num_elements; i++) {
+    int base = i * _packed_stride;
+    PT(XFileDataObject) element;
+
+    if (xtemplate == nullptr) {
+      if (_packed_type == PT_int) {
+        element = new XFileDataObjectInteger(_data_def, _packed_ints[base]);
+      } else {
+        element = new XFileDataObjectDouble(_data_def, _packed_doubles[base]);
+      }
+
+    } else {
+      element = new XFileDataNodeTemplate(_data_def->get_x_file(),
+                                          _data_def->get_name(), xtemplate);
+      for (int j = 0; j < _packed_stride; j++) {
+        const XFileDataDef *member =
+          DCAST(XFileDataDef, xtemplate->get_child(j));
+        if (_packed_type == PT_int) {
+          element->add_element
+            (new XFileDataObjectInteger(member, _packed_ints[base + j]));
+        } else {
+          element->add_element
+            (new XFileDataObjectDouble(member, _packed_doubles[base + j]));
+        }
+      }
+    }
+
+    _nested_elements.push_back(element);
+  }
+
+  _packed_type = PT_none;
+  _packed_stride = 1;
+  _packed_ints.clear();
+  _packed_doubles.clear();
+}
+
+/**
+ * Writes the packed values in the same form write_data() would produce for
+ * the equivalent individual elements.
+ */
+void XFileDataObjectArray::
+write_packed_data(std::ostream &out, int indent_level,
+                  const char *separator) const {
+  int num_elements = get_num_elements();
+  if (num_elements == 0) {
+    return;
+  }
+
+  if (_data_def->get_data_type() != XFileDataDef::T_template) {
+    // Up to 16 numbers are written on the same line; more than that, one
+    // per line.
+    bool one_line = (num_elements <= 16);
+    if (one_line) {
+      indent(out, indent_level);
+    }
+    for (int i = 0; i < num_elements - 1; i++) {
+      if (!one_line) {
+        indent(out, indent_level);
+      }
+      write_packed_value(out, i);
+      out << (one_line ? ", " : ",\n");
+    }
+    if (!one_line) {
+      indent(out, indent_level);
+    }
+    write_packed_value(out, num_elements - 1);
+    out << separator << "\n";
+
+  } else {
+    // Each template element is written on its own line, with its members
+    // separated by semicolons.
+    for (int i = 0; i < num_elements; i++) {
+      indent(out, indent_level);
+      int base = i * _packed_stride;
+      for (int j = 0; j < _packed_stride - 1; j++) {
+        write_packed_value(out, base + j);
+        out << "; ";
+      }
+      write_packed_value(out, base + _packed_stride - 1);
+      out << ";" << (i + 1 < num_elements ? "," : separator) << "\n";
+    }
+  }
+}
+
+/**
+ * Writes the nth packed value.
+ */
+void XFileDataObjectArray::
+write_packed_value(std::ostream &out, int n) const {
+  if (_packed_type == PT_int) {
+    out << _packed_ints[n];
+  } else {
+    out << XFileDataObjectDouble::format_value(_packed_doubles[n]);
+  }
+}
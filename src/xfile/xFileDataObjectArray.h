@@ -16,29 +16,66 @@
 
 #include "pandatoolbase.h"
 #include "xFileDataObject.h"
+#include "pvector.h"
 
 /**
  * An array of nested data elements.
+ *
+ * An array of numbers, or of a template made up only of numbers (like
+ * Vector or Coords2d), is normally stored packed, as a contiguous buffer of
+ * ints or doubles, rather than as one XFileDataObject per value.  The
+ * individual element objects are only created if they are requested with
+ * get_element(); code that reads large arrays should use get_int_values() or
+ * get_double_values() instead.
  */
 class XFileDataObjectArray : public XFileDataObject {
 public:
   INLINE XFileDataObjectArray(const XFileDataDef *data_def);
 
+  enum PackedType {
+    PT_none,
+    PT_int,
+    PT_double,
+  };
+
+  INLINE PackedType get_packed_type() const;
+  INLINE int get_packed_stride() const;
+  INLINE const pvector<int> &get_packed_ints() const;
+  INLINE const pvector<double> &get_packed_doubles() const;
+  pvector<int> &modify_packed_ints(int stride);
+  pvector<double> &modify_packed_doubles(int stride);
+
   virtual bool is_complex_object() const;
 
   virtual bool add_element(XFileDataObject *element);
 
+  virtual void get_int_values(pvector<int> &values) const;
+  virtual void get_double_values(pvector<double> &values) const;
+
   virtual void write_data(std::ostream &out, int indent_level,
                           const char *separator) const;
 
 protected:
+  virtual void store_double_array(int num_elements, const double *values);
+  virtual void get_double_array(int num_elements, double *values) const;
+
   virtual int get_num_elements() const;
   virtual XFileDataObject *get_element(int n);
 
 private:
+  void unpack_elements();
+  void write_packed_data(std::ostream &out, int indent_level,
+                         const char *separator) const;
+  void write_packed_value(std::ostream &out, int n) const;
+
   typedef pvector< PT(XFileDataObject) > NestedElements;
   NestedElements _nested_elements;
 
+  PackedType _packed_type;
+  int _packed_stride;
+  pvector<int> _packed_ints;
+  pvector<double> _packed_doubles;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -81,11 +81,20 @@ get_double_value() const {
  */
 std::string XFileDataObjectDouble::
 get_string_value() const {
+  return format_value(_value);
+}
+
+/**
+ * Returns the representation of the indicated value as it should be written
+ * to a text .x file.
+ */
+std::string XFileDataObjectDouble::
+format_value(double value) {
   // It's important to format with a decimal point, even if the value is
   // integral, since the DirectX .x reader differentiates betweens doubles and
   // integers on parsing.
   char buffer[128];
-  sprintf(buffer, "%f", _value);
+  sprintf(buffer, "%f", value);
 
   return buffer;
 }
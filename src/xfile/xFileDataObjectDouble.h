@@ -29,6 +29,8 @@ public:
   virtual void write_data(std::ostream &out, int indent_level,
                           const char *separator) const;
 
+  static std::string format_value(double value);
+
 protected:
   virtual void set_int_value(int int_value);
   virtual void set_double_value(double double_value);
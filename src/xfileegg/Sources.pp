@@ -1,6 +1,6 @@
 #begin ss_lib_target
   #define TARGET xfileegg
-  #define LOCAL_LIBS xfile eggbase progbase pandatoolbase
+  #define LOCAL_LIBS xfile eggbase progbase converter pandatoolbase
   #define OTHER_LIBS \
     egg:c pandaegg:m \
     mathutil:c linmath:c putil:c pipeline:c event:c \
@@ -46,6 +46,19 @@ XFileMaker::
 ~XFileMaker() {
 }
 
+/**
+ * Specifies the format in which write() will write the .x file: text or
+ * binary, optionally MSZIP-compressed, and with 32-bit or 64-bit floats (the
+ * latter only matters for binary files).
+ */
+void XFileMaker::
+set_output_format(XFile::FormatType format_type, bool compressed,
+                  XFile::FloatSize float_size) {
+  _x_file->set_format_type(format_type);
+  _x_file->set_compressed(compressed);
+  _x_file->set_float_size(float_size);
+}
+
 /**
  * Writes the .x file data to the indicated filename; returns true on success,
  * false otherwise.
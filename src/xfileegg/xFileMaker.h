@@ -38,6 +38,8 @@ public:
   XFileMaker();
   ~XFileMaker();
 
+  void set_output_format(XFile::FormatType format_type, bool compressed,
+                         XFile::FloatSize float_size);
   bool write(const Filename &filename);
 
   bool add_tree(EggData *egg_data);
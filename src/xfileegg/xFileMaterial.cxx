@@ -19,6 +19,13 @@
 #include "eggPrimitive.h"
 #include "datagram.h"
 #include "config_xfile.h"
+#include "texturePool.h"
+#include "textureAttrib.h"
+#include "material.h"
+#include "materialPool.h"
+#include "materialAttrib.h"
+#include "colorAttrib.h"
+#include "transparencyAttrib.h"
 
 #include <string.h>  // for strcmp, strdup
 
@@ -119,6 +126,57 @@ apply_to_egg(EggPrimitive *egg_prim, XFileToEggConverter *converter) {
   egg_prim->set_color(_face_color);
 }
 
+/**
+ * Returns the RenderState that corresponds to the properties apply_to_egg()
+ * would have assigned to an egg primitive, for converting directly to a
+ * PandaNode.  If vertex_colors is true, the vertices carry their own colors
+ * and the face color is not applied.
+ */
+CPT(RenderState) XFileMaterial::
+make_node_state(XFileToEggConverter *converter, bool vertex_colors) const {
+  CPT(RenderState) state;
+  if (vertex_colors) {
+    state = RenderState::make(ColorAttrib::make_vertex());
+  } else {
+    state = RenderState::make(ColorAttrib::make_flat(_face_color));
+  }
+  bool has_alpha = (_face_color[3] < 1.0f);
+
+  if (_has_texture) {
+    Filename texture = converter->convert_model_path(_texture);
+    Texture *tex = TexturePool::load_texture(texture);
+    if (tex != nullptr) {
+      state = state->add_attrib(TextureAttrib::make(tex));
+      if (Texture::has_alpha(tex->get_format())) {
+        has_alpha = true;
+      }
+    }
+  }
+
+  bool got_spec = (_specular_color != LRGBColor::zero());
+  bool got_emit = (_emissive_color != LRGBColor::zero());
+  if (got_spec || got_emit) {
+    PT(Material) material = new Material;
+    material->set_diffuse(_face_color);
+    if (got_spec) {
+      material->set_shininess(_power);
+      material->set_specular(LColor(_specular_color[0], _specular_color[1],
+                                    _specular_color[2], 1.0));
+    }
+    if (got_emit) {
+      material->set_emission(LColor(_emissive_color[0], _emissive_color[1],
+                                    _emissive_color[2], 1.0));
+    }
+    state = state->add_attrib(MaterialAttrib::make(MaterialPool::get_material(material)));
+  }
+
+  if (has_alpha) {
+    state = state->add_attrib(TransparencyAttrib::make(TransparencyAttrib::M_alpha));
+  }
+
+  return state;
+}
+
 /**
  *
  */
@@ -17,6 +17,7 @@
 #include "pandatoolbase.h"
 #include "luse.h"
 #include "filename.h"
+#include "renderState.h"
 
 class EggPrimitive;
 class Datagram;
@@ -35,6 +36,8 @@ public:
 
   void set_from_egg(EggPrimitive *egg_prim);
   void apply_to_egg(EggPrimitive *egg_prim, XFileToEggConverter *converter);
+  CPT(RenderState) make_node_state(XFileToEggConverter *converter,
+                                   bool vertex_colors) const;
 
   int compare_to(const XFileMaterial &other) const;
 
@@ -25,6 +25,9 @@
 #include "eggPolygon.h"
 #include "eggGroup.h"
 #include "eggGroupNode.h"
+#include "nodeGeomBuilder.h"
+#include "geomNode.h"
+#include "colorAttrib.h"
 
 using std::min;
 using std::string;
@@ -389,6 +392,87 @@ create_polygons(XFileToEggConverter *converter) {
   return true;
 }
 
+/**
+ * Builds Geoms for the faces in the mesh directly into the indicated
+ * GeomNode, for converting directly to a PandaNode.  Unlike
+ * create_polygons(), the vertices are left in the mesh's local space, and
+ * skinning is not supported.
+ */
+bool XFileMesh::
+create_node(XFileToEggConverter *converter, GeomNode *geom_node) {
+  NodeGeomBuilder builder(_cs);
+
+  // The DX spec doesn't mention anything about a crease angle for computed
+  // normals, so we are as generous as possible, as in create_polygons().
+  double smooth_angle = has_normals() ? 0.0 : 180.0;
+
+  CPT(RenderState) default_state;
+  if (_has_colors) {
+    default_state = RenderState::make(ColorAttrib::make_vertex());
+  } else {
+    default_state = RenderState::make_empty();
+  }
+
+  pvector<CPT(RenderState)> material_states(_materials.size());
+  pvector<NodeGeomBuilder::Vertex> vertices;
+
+  Faces::const_iterator fi;
+  for (fi = _faces.begin(); fi != _faces.end(); ++fi) {
+    XFileFace *face = (*fi);
+    vertices.clear();
+
+    XFileFace::Vertices::reverse_iterator vi;
+    for (vi = face->_vertices.rbegin(); vi != face->_vertices.rend(); ++vi) {
+      int vertex_index = (*vi)._vertex_index;
+      int normal_index = (*vi)._normal_index;
+      if (vertex_index < 0 || vertex_index >= (int)_vertices.size()) {
+        xfile_cat.warning()
+          << "Vertex index out of range in Mesh " << get_name() << "\n";
+        continue;
+      }
+      XFileVertex *vertex = _vertices[vertex_index];
+
+      NodeGeomBuilder::Vertex node_vtx(vertex->_point);
+      if (vertex->_has_color) {
+        node_vtx.set_color(vertex->_color);
+      }
+      if (vertex->_has_uv) {
+        LTexCoordd uv = vertex->_uv;
+        // Windows draws the UV's upside-down.
+        uv[1] = 1.0 - uv[1];
+        node_vtx.set_uv(uv);
+      }
+      if (normal_index >= 0 && normal_index < (int)_normals.size()) {
+        XFileNormal *normal = _normals[normal_index];
+        if (normal->_has_normal) {
+          node_vtx.set_normal(normal->_normal);
+        }
+      }
+
+      vertices.push_back(node_vtx);
+    }
+
+    if (vertices.empty()) {
+      continue;
+    }
+
+    const RenderState *state = default_state;
+    int material_index = face->_material_index;
+    if (material_index >= 0 && material_index < (int)_materials.size()) {
+      if (material_states[material_index] == nullptr) {
+        material_states[material_index] =
+          _materials[material_index]->make_node_state(converter, _has_colors);
+      }
+      state = material_states[material_index];
+    }
+
+    builder.add_polygon(state, &vertices[0], (int)vertices.size(), smooth_angle);
+  }
+
+  builder.build(geom_node);
+  return true;
+}
+
 /**
  * Returns true if any of the vertices or faces added to this mesh used a
  * normal, false otherwise.
@@ -621,22 +705,27 @@ fill_mesh(XFileDataNode *obj) {
 
   int i, j;
 
-  const XFileDataObject &vertices = (*obj)["vertices"];
-  for (i = 0; i < vertices.size(); i++) {
+  pvector<double> coords;
+  (*obj)["vertices"].get_double_values(coords);
+  int num_vertices = (int)coords.size() / 3;
+  for (i = 0; i < num_vertices; i++) {
     XFileVertex *vertex = new XFileVertex;
-    vertex->_point = vertices[i].vec3();
+    vertex->_point.set(coords[i * 3], coords[i * 3 + 1], coords[i * 3 + 2]);
     add_vertex(vertex);
   }
 
   const XFileDataObject &faces = (*obj)["faces"];
+  pvector<int> indices;
   for (i = 0; i < faces.size(); i++) {
     XFileFace *face = new XFileFace;
 
-    const XFileDataObject &faceIndices = faces[i]["faceVertexIndices"];
+    indices.clear();
+    faces[i]["faceVertexIndices"].get_int_values(indices);
+    face->_vertices.reserve(indices.size());
 
-    for (j = 0; j < faceIndices.size(); j++) {
+    for (j = 0; j < (int)indices.size(); j++) {
       XFileFace::Vertex vertex;
-      vertex._vertex_index = faceIndices[j].i();
+      vertex._vertex_index = indices[j];
       vertex._normal_index = -1;
 
       face->_vertices.push_back(vertex);
@@ -706,10 +795,12 @@ bool XFileMesh::
 fill_normals(XFileDataNode *obj) {
   int i, j;
 
-  const XFileDataObject &normals = (*obj)["normals"];
-  for (i = 0; i < normals.size(); i++) {
+  pvector<double> coords;
+  (*obj)["normals"].get_double_values(coords);
+  int num_coords = (int)coords.size() / 3;
+  for (i = 0; i < num_coords; i++) {
     XFileNormal *normal = new XFileNormal;
-    normal->_normal = normals[i].vec3();
+    normal->_normal.set(coords[i * 3], coords[i * 3 + 1], coords[i * 3 + 2]);
     normal->_has_normal = true;
     add_normal(normal);
   }
@@ -722,20 +813,22 @@ fill_normals(XFileDataNode *obj) {
   }
 
   int num_normals = min(faceNormals.size(), (int)_faces.size());
+  pvector<int> indices;
   for (i = 0; i < num_normals; i++) {
     XFileFace *face = _faces[i];
 
-    const XFileDataObject &faceIndices = faceNormals[i]["faceVertexIndices"];
+    indices.clear();
+    faceNormals[i]["faceVertexIndices"].get_int_values(indices);
 
-    if (faceIndices.size() != (int)face->_vertices.size()) {
+    if (indices.size() != face->_vertices.size()) {
       xfile_cat.warning()
         << "Incorrect number of vertices for face in MeshNormals within "
         << get_name() << "\n";
     }
 
-    int num_vertices = min(faceIndices.size(), (int)face->_vertices.size());
+    int num_vertices = min((int)indices.size(), (int)face->_vertices.size());
     for (j = 0; j < num_vertices; j++) {
-      face->_vertices[j]._normal_index = faceIndices[j].i();
+      face->_vertices[j]._normal_index = indices[j];
     }
   }
 
@@ -772,17 +865,18 @@ fill_colors(XFileDataNode *obj) {
  */
 bool XFileMesh::
 fill_uvs(XFileDataNode *obj) {
-  const XFileDataObject &textureCoords = (*obj)["textureCoords"];
-  if (textureCoords.size() != (int)_vertices.size()) {
+  pvector<double> coords;
+  (*obj)["textureCoords"].get_double_values(coords);
+  if (coords.size() != _vertices.size() * 2) {
     xfile_cat.warning()
       << "Wrong number of vertices in MeshTextureCoords within "
       << get_name() << "\n";
   }
 
-  int num_texcoords = min(textureCoords.size(), (int)_vertices.size());
+  int num_texcoords = min((int)coords.size() / 2, (int)_vertices.size());
   for (int i = 0; i < num_texcoords; i++) {
     XFileVertex *vertex = _vertices[i];
-    vertex->_uv = textureCoords[i].vec2();
+    vertex->_uv.set(coords[i * 2], coords[i * 2 + 1]);
     vertex->_has_uv = true;
   }
 
@@ -801,8 +895,10 @@ fill_skin_weights(XFileDataNode *obj) {
 
   data._joint_name = (*obj)["transformNodeName"].s();
 
-  const XFileDataObject &vertexIndices = (*obj)["vertexIndices"];
-  const XFileDataObject &weights = (*obj)["weights"];
+  pvector<int> vertexIndices;
+  pvector<double> weights;
+  (*obj)["vertexIndices"].get_int_values(vertexIndices);
+  (*obj)["weights"].get_double_values(weights);
 
   if (weights.size() != vertexIndices.size()) {
     xfile_cat.warning()
@@ -812,8 +908,8 @@ fill_skin_weights(XFileDataNode *obj) {
   // Unpack the weight for each vertex.
   size_t num_weights = min(weights.size(), vertexIndices.size());
   for (size_t i = 0; i < num_weights; i++) {
-    int vindex = vertexIndices[i].i();
-    double weight = weights[i].d();
+    int vindex = vertexIndices[i];
+    double weight = weights[i];
 
     if (vindex < 0 || vindex > (int)_vertices.size()) {
       xfile_cat.warning()
@@ -835,17 +931,18 @@ fill_skin_weights(XFileDataNode *obj) {
  */
 bool XFileMesh::
 fill_material_list(XFileDataNode *obj) {
-  const XFileDataObject &faceIndexes = (*obj)["faceIndexes"];
-  if (faceIndexes.size() > (int)_faces.size()) {
+  pvector<int> faceIndexes;
+  (*obj)["faceIndexes"].get_int_values(faceIndexes);
+  if (faceIndexes.size() > _faces.size()) {
     xfile_cat.warning()
       << "Too many faces in MeshMaterialList within " << get_name() << "\n";
   }
 
   int material_index = -1;
   int i = 0;
-  while (i < faceIndexes.size() && i < (int)_faces.size()) {
+  while (i < (int)faceIndexes.size() && i < (int)_faces.size()) {
     XFileFace *face = _faces[i];
-    material_index = faceIndexes[i].i();
+    material_index = faceIndexes[i];
     face->_material_index = material_index;
     i++;
   }
@@ -37,6 +37,7 @@ class EggGroupNode;
 class EggVertex;
 class EggPolygon;
 class EggPrimitive;
+class GeomNode;
 class Datagram;
 
 /**
@@ -61,6 +62,7 @@ public:
   void set_egg_parent(EggGroupNode *egg_parent);
 
   bool create_polygons(XFileToEggConverter *converter);
+  bool create_node(XFileToEggConverter *converter, GeomNode *geom_node);
 
   bool has_normals() const;
   bool has_colors() const;
@@ -26,6 +26,8 @@
 #include "eggMaterialCollection.h"
 #include "eggTextureCollection.h"
 #include "dcast.h"
+#include "geomNode.h"
+#include "transformState.h"
 
 using std::string;
 
@@ -149,6 +151,83 @@ convert_file(const Filename &filename) {
   return !had_error();
 }
 
+/**
+ * Returns true if this converter can directly convert the model type to
+ * internal Panda memory structures, given the indicated options, or false
+ * otherwise.  If this returns true, then convert_to_node() may be called to
+ * perform the conversion, which may be faster than calling convert_file() if
+ * the ultimate goal is a PandaNode anyway.
+ */
+bool XFileToEggConverter::
+supports_convert_to_node(const LoaderOptions &options) const {
+  return !_make_char;
+}
+
+/**
+ * Reads the input file and directly produces a ready-to-render model file as
+ * a PandaNode.  Returns NULL on failure, or if it is not supported.  (This
+ * functionality is not supported by all converter types; see
+ * supports_convert_to_node()).
+ *
+ * Only static geometry is handled this way; if the file contains any
+ * animation, this returns NULL, and the file should be loaded via
+ * convert_file() instead.
+ */
+PT(PandaNode) XFileToEggConverter::
+convert_to_node(const LoaderOptions &options, const Filename &filename) {
+  close();
+  clear_error();
+
+  if (!_x_file->read(filename)) {
+    nout << "Unable to open X file: " << filename << "\n";
+    return nullptr;
+  }
+
+  int num_objects = _x_file->get_num_objects();
+  int i;
+
+  _any_frames = false;
+  for (i = 0; i < num_objects; i++) {
+    XFileDataNode *child = _x_file->get_object(i);
+    if (child->is_standard_object("Frame")) {
+      _any_frames = true;
+    } else if (child->is_standard_object("AnimationSet")) {
+      // We need the egg path to build a character.
+      if (xfile_cat.is_debug()) {
+        xfile_cat.debug()
+          << filename << " contains animation; not converting directly.\n";
+      }
+      close();
+      return nullptr;
+    }
+  }
+
+  PT(PandaNode) root = new PandaNode("");
+  for (i = 0; i < num_objects; i++) {
+    XFileDataNode *obj = _x_file->get_object(i);
+    bool okflag = true;
+    if (obj->is_standard_object("Frame")) {
+      okflag = convert_node_frame(obj, root);
+
+    } else if (obj->is_standard_object("Mesh") && !_any_frames) {
+      // As in convert_toplevel_object(), a toplevel Mesh is only geometry
+      // if there are no Frames in the file.
+      okflag = convert_node_mesh(obj, root);
+    }
+
+    if (!okflag) {
+      close();
+      return nullptr;
+    }
+  }
+
+  close();
+  if (had_error()) {
+    return nullptr;
+  }
+  return root;
+}
+
 /**
  * Finalizes and closes the file previously opened via convert_file().
  */
@@ -703,6 +782,71 @@ convert_mesh(XFileDataNode *obj, EggGroupNode *egg_parent) {
   return true;
 }
 
+/**
+ * Converts the indicated object, the child of a Frame, directly to a
+ * PandaNode.  This is the equivalent of convert_object().
+ */
+bool XFileToEggConverter::
+convert_node_object(XFileDataNode *obj, PandaNode *parent) {
+  if (obj->is_standard_object("Frame")) {
+    return convert_node_frame(obj, parent);
+
+  } else if (obj->is_standard_object("FrameTransformMatrix")) {
+    // Convert the matrix into Panda's coordinate system.
+    LMatrix4 mat = LCAST(PN_stdfloat, (*obj)["frameMatrix"]["matrix"].mat4());
+    LMatrix4 from_default = LMatrix4::convert_mat(CS_default, CS_yup_left);
+    LMatrix4 to_default = LMatrix4::convert_mat(CS_yup_left, CS_default);
+    parent->set_transform(TransformState::make_mat(from_default * mat * to_default));
+
+  } else if (obj->is_standard_object("Mesh")) {
+    return convert_node_mesh(obj, parent);
+
+  } else {
+    if (xfile_cat.is_debug()) {
+      xfile_cat.debug()
+        << "Ignoring object of unknown type: "
+        << obj->get_template_name() << "\n";
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Converts the indicated frame directly to a PandaNode.
+ */
+bool XFileToEggConverter::
+convert_node_frame(XFileDataNode *obj, PandaNode *parent) {
+  PT(PandaNode) node = new PandaNode(obj->get_name());
+  parent->add_child(node);
+
+  int num_objects = obj->get_num_objects();
+  for (int i = 0; i < num_objects; i++) {
+    if (!convert_node_object(obj->get_object(i), node)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Converts the indicated mesh directly to a GeomNode.
+ */
+bool XFileToEggConverter::
+convert_node_mesh(XFileDataNode *obj, PandaNode *parent) {
+  XFileMesh mesh(CS_yup_left);
+  mesh.set_name(obj->get_name());
+
+  if (!mesh.fill_mesh(obj)) {
+    return false;
+  }
+
+  PT(GeomNode) geom_node = new GeomNode(obj->get_name());
+  parent->add_child(geom_node);
+  return mesh.create_node(this, geom_node);
+}
+
 /**
  * Creates all the polygons associated with previously-saved meshes.
  */
@@ -24,6 +24,7 @@
 #include "pmap.h"
 #include "luse.h"
 #include "pointerTo.h"
+#include "pandaNode.h"
 
 class Datagram;
 class XFileMesh;
@@ -48,8 +49,10 @@ public:
   virtual std::string get_name() const;
   virtual std::string get_extension() const;
   virtual bool supports_compressed() const;
+  virtual bool supports_convert_to_node(const LoaderOptions &options) const;
 
   virtual bool convert_file(const Filename &filename);
+  virtual PT(PandaNode) convert_to_node(const LoaderOptions &options, const Filename &filename);
   void close();
 
   EggGroup *get_dart_node() const;
@@ -91,6 +94,10 @@ private:
   bool create_polygons();
   bool create_hierarchy();
 
+  bool convert_node_object(XFileDataNode *obj, PandaNode *parent);
+  bool convert_node_frame(XFileDataNode *obj, PandaNode *parent);
+  bool convert_node_mesh(XFileDataNode *obj, PandaNode *parent);
+
   PT(XFile) _x_file;
 
   bool _any_frames;
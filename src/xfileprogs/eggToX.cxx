@@ -35,6 +35,24 @@ EggToX() : EggToSomething("DirectX", ".x", true, false) {
      "preserving the normal egg hierarchy.",
      &EggToX::dispatch_none, &xfile_one_mesh);
 
+  add_option
+    ("bin", "", 0,
+     "Write a binary .x file instead of a text file.  Binary files are "
+     "smaller and much faster to load.",
+     &EggToX::dispatch_none, &_binary);
+
+  add_option
+    ("z", "", 0,
+     "Compress the .x file with MSZIP (the tzip or bzip formats understood "
+     "by DirectX).",
+     &EggToX::dispatch_none, &_compressed);
+
+  add_option
+    ("f32", "", 0,
+     "Write 32-bit floating-point values instead of 64-bit values.  This "
+     "only affects binary files.",
+     &EggToX::dispatch_none, &_float32);
+
   // X files are always y-up-left.
   remove_option("cs");
   _got_coordinate_system = true;
@@ -44,6 +62,10 @@ EggToX() : EggToSomething("DirectX", ".x", true, false) {
   // external references.
   remove_option("f");
   _force_complete = true;
+
+  _binary = false;
+  _compressed = false;
+  _float32 = false;
 }
 
 
@@ -56,6 +78,9 @@ run() {
     exit(1);
   }
 
+  _x.set_output_format(_binary ? XFile::FT_binary : XFile::FT_text,
+                       _compressed, _float32 ? XFile::FS_32 : XFile::FS_64);
+
   if (!_x.add_tree(_data)) {
     nout << "Unable to define egg structure.\n";
     exit(1);
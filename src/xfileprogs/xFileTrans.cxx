@@ -13,6 +13,11 @@
 
 #include "xFileTrans.h"
 #include "xFile.h"
+#include "trueClock.h"
+
+using std::istringstream;
+using std::ostringstream;
+using std::string;
 
 /**
  *
@@ -41,6 +46,36 @@ XFileTrans() :
      "If this option is omitted, the last parameter name is taken to be the "
      "name of the output file.",
      &XFileTrans::dispatch_filename, &_got_output_filename, &_output_filename);
+
+  add_option
+    ("bin", "", 0,
+     "Write a binary .x file.  The default is to write a text file, "
+     "regardless of the format of the input file.",
+     &XFileTrans::dispatch_none, &_binary);
+
+  add_option
+    ("z", "", 0,
+     "Compress the output file with MSZIP (the tzip or bzip formats "
+     "understood by DirectX).",
+     &XFileTrans::dispatch_none, &_compressed);
+
+  add_option
+    ("f32", "", 0,
+     "Write 32-bit floating-point values instead of 64-bit values.  This "
+     "only affects binary files.",
+     &XFileTrans::dispatch_none, &_float32);
+
+  add_option
+    ("bench", "count", 0,
+     "After reading the input file, re-encode it in memory as both text "
+     "and binary, and parse each encoding the indicated number of times, "
+     "reporting the average time taken for each.",
+     &XFileTrans::dispatch_int, nullptr, &_benchmark_count);
+
+  _binary = false;
+  _compressed = false;
+  _float32 = false;
+  _benchmark_count = 0;
 }
 
 
@@ -57,6 +92,14 @@ run() {
     exit(1);
   }
 
+  if (_benchmark_count > 0) {
+    run_benchmark(file);
+  }
+
+  file.set_format_type(_binary ? XFile::FT_binary : XFile::FT_text);
+  file.set_compressed(_compressed);
+  file.set_float_size(_float32 ? XFile::FS_32 : XFile::FS_64);
+
   if (!file.write(get_output())) {
     nout << "Unable to write.\n";
     exit(1);
@@ -64,6 +107,57 @@ run() {
 }
 
 
+/**
+ * Writes the file into memory as text and as binary, and reports the time
+ * taken to parse each representation _benchmark_count times.
+ */
+void XFileTrans::
+run_benchmark(XFile &file) {
+  file.set_compressed(false);
+  file.set_float_size(_float32 ? XFile::FS_32 : XFile::FS_64);
+
+  ostringstream text_out;
+  file.set_format_type(XFile::FT_text);
+  file.write(text_out);
+  string text_data = text_out.str();
+
+  ostringstream binary_out;
+  file.set_format_type(XFile::FT_binary);
+  file.write(binary_out);
+  string binary_data = binary_out.str();
+
+  double text_time = time_read(text_data, "text");
+  double binary_time = time_read(binary_data, "binary");
+
+  nout << "text:   " << text_data.size() << " bytes, "
+       << text_time * 1000.0 << " ms per read\n"
+       << "binary: " << binary_data.size() << " bytes, "
+       << binary_time * 1000.0 << " ms per read\n";
+  if (binary_time > 0.0) {
+    nout << "binary is " << text_time / binary_time << "x faster\n";
+  }
+}
+
+/**
+ * Parses the indicated in-memory .x file _benchmark_count times, and returns
+ * the average time in seconds for each parse.
+ */
+double XFileTrans::
+time_read(const string &data, const string &name) {
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < _benchmark_count; ++i) {
+    istringstream in(data);
+    XFile file;
+    if (!file.read(in, name)) {
+      nout << "Unable to re-read " << name << " encoding.\n";
+      exit(1);
+    }
+  }
+  return (clock->get_short_time() - start) / _benchmark_count;
+}
+
+
 /**
  *
  */
@@ -19,6 +19,8 @@
 #include "programBase.h"
 #include "withOutputFile.h"
 
+class XFile;
+
 /**
  * A program to read a X file and output an essentially similar X file.  This
  * is mainly useful to test the X file parser used in Panda.
@@ -32,7 +34,14 @@ public:
 protected:
   virtual bool handle_args(Args &args);
 
+  void run_benchmark(XFile &file);
+  double time_read(const std::string &data, const std::string &name);
+
   Filename _input_filename;
+  bool _binary;
+  bool _compressed;
+  bool _float32;
+  int _benchmark_count;
 };
 
 #endif